@@ -19,8 +19,10 @@ SOURCES += \
     lower_case.cpp \
     normalize_unicode.cpp \
     object_tracker.cpp \
+    parallel_for_pool.cpp \
     resource_pool.cpp \
     runner.cpp \
+    shaped_text_cache.cpp \
     shared_buffer_manager.cpp \
     src_point.cpp \
     string_format.cpp \
@@ -40,6 +42,7 @@ HEADERS += \
     bits.hpp \
     buffer_vector.hpp \
     cache.hpp \
+    concurrent_lru_cache.hpp \
     cancellable.hpp \
     commands_queue.hpp \
     condition.hpp \
@@ -58,12 +61,14 @@ HEADERS += \
     mutex.hpp \
     object_tracker.hpp \
     observer_list.hpp \
+    parallel_for_pool.hpp \
     regexp.hpp \
     resource_pool.hpp \
     rolling_hash.hpp \
     runner.hpp \
     scope_guard.hpp \
     set_operations.hpp \
+    shaped_text_cache.hpp \
     shared_buffer_manager.hpp \
     src_point.hpp \
     stats.hpp \
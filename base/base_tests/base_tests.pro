@@ -19,6 +19,7 @@ SOURCES += \
   commands_queue_test.cpp \
   condition_test.cpp \
   const_helper.cpp \
+  concurrent_lru_cache_test.cpp \
   containers_test.cpp \
   deferred_task_test.cpp \
   fence_manager_test.cpp \
@@ -28,6 +29,7 @@ SOURCES += \
   mem_trie_test.cpp \
   mru_cache_test.cpp \
   observer_list_test.cpp \
+  parallel_for_pool_test.cpp \
   regexp_test.cpp \
   rolling_hash_test.cpp \
   scope_guard_test.cpp \
@@ -25,6 +25,16 @@ UNIT_TEST(Popcount32)
   }
 }
 
+UNIT_TEST(Popcount64)
+{
+  for (uint32_t i = 0; i < 10000; ++i)
+  {
+    uint64_t const x = (static_cast<uint64_t>(i) << 40) | (0xC2000000 | i);
+    TEST_EQUAL(bits::popcount(x), PopCountSimple(x), (x));
+  }
+  TEST_EQUAL(bits::popcount(~uint64_t(0)), 64, ());
+}
+
 UNIT_TEST(PopcountArray32)
 {
   for (uint32_t j = 0; j < 2777; ++j)
@@ -0,0 +1,109 @@
+#include "testing/testing.hpp"
+
+#include "base/concurrent_lru_cache.hpp"
+#include "base/shaped_text_cache.hpp"
+#include "base/thread.hpp"
+
+#include "std/atomic.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+
+namespace
+{
+typedef my::ConcurrentLRUCache<int, string> TCache;
+
+void FillValue(int key, string & value) { value = strings::to_string(key); }
+
+size_t GetWeight(string const &) { return 1; }
+}  // namespace
+
+UNIT_TEST(ConcurrentLRUCache_Smoke)
+{
+  TCache cache(3 /* maxWeight */, 1 /* shardsCount */);
+
+  TEST(!cache.Find(1), ());
+  TEST_EQUAL(*cache.Get(1, &FillValue, &GetWeight), "1", ());
+  TEST_EQUAL(*cache.Get(2, &FillValue, &GetWeight), "2", ());
+  TEST_EQUAL(*cache.Get(3, &FillValue, &GetWeight), "3", ());
+
+  // Touch 1, so 2 becomes the least recently used one.
+  TEST_EQUAL(*cache.Find(1), "1", ());
+  TEST_EQUAL(*cache.Get(4, &FillValue, &GetWeight), "4", ());
+
+  TEST(cache.Find(1), ());
+  TEST(!cache.Find(2), ());
+  TEST(cache.Find(3), ());
+  TEST(cache.Find(4), ());
+
+  TCache::Stats const stats = cache.GetStats();
+  TEST_EQUAL(stats.m_count, 3, ());
+  TEST_EQUAL(stats.m_weight, 3, ());
+  TEST_EQUAL(stats.m_hits, 4, ());
+  TEST_EQUAL(stats.m_misses, 6, ());
+
+  cache.Clear();
+  TEST(!cache.Find(1), ());
+  TEST_EQUAL(cache.GetStats().m_count, 0, ());
+}
+
+UNIT_TEST(ConcurrentLRUCache_ValueOutlivesEviction)
+{
+  TCache cache(1 /* maxWeight */, 1 /* shardsCount */);
+
+  TCache::TValuePtr value = cache.Get(1, &FillValue, &GetWeight);
+  cache.Get(2, &FillValue, &GetWeight);
+  TEST(!cache.Find(1), ());
+  TEST_EQUAL(*value, "1", ());
+}
+
+UNIT_TEST(ConcurrentLRUCache_MultiThreaded)
+{
+  TCache cache(100 /* maxWeight */);
+  atomic<int> errors(0);
+
+  vector<threads::SimpleThread> workers;
+  for (int t = 0; t < 4; ++t)
+  {
+    workers.emplace_back([&cache, &errors, t]()
+    {
+      for (int i = 0; i < 10000; ++i)
+      {
+        int const key = (i * (t + 1)) % 300;
+        if (*cache.Get(key, &FillValue, &GetWeight) != strings::to_string(key))
+          ++errors;
+      }
+    });
+  }
+  for (auto & worker : workers)
+    worker.join();
+
+  TEST_EQUAL(errors, 0, ());
+  TCache::Stats const stats = cache.GetStats();
+  TEST_EQUAL(stats.m_hits + stats.m_misses, 40000, ());
+  TEST_LESS_OR_EQUAL(stats.m_weight, 100, ());
+}
+
+UNIT_TEST(ShapedTextCache_Smoke)
+{
+  int calls = 0;
+  auto const shape = [&calls](strings::UniString const & text, strings::ShapedText & shaped)
+  {
+    ++calls;
+    shaped.m_visText = text;
+    shaped.m_advances.assign(text.size(), 2.0f);
+  };
+
+  strings::UniString const text = strings::MakeUniString("Main street");
+  strings::ShapedTextKey const key(text, 100 /* fontId */, 12 /* fontSize */);
+
+  auto const shaped = strings::GetShapedText(key, shape);
+  TEST_EQUAL(shaped->m_visText, text, ());
+  TEST_EQUAL(shaped->GetLength(), 2.0f * text.size(), ());
+
+  TEST_EQUAL(strings::GetShapedText(key, shape).get(), shaped.get(), ());
+  TEST_EQUAL(calls, 1, ());
+
+  strings::GetShapedText(strings::ShapedTextKey(text, 100 /* fontId */, 14 /* fontSize */), shape);
+  TEST_EQUAL(calls, 2, ());
+}
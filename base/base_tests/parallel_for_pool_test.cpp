@@ -0,0 +1,140 @@
+#include "testing/testing.hpp"
+
+#include "base/exception.hpp"
+#include "base/parallel_for_pool.hpp"
+
+#include "std/atomic.hpp"
+#include "std/thread.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+DECLARE_EXCEPTION(TestException, RootException);
+}  // namespace
+
+UNIT_TEST(ParallelForPool_ParallelFor)
+{
+  threads::ParallelForPool pool(3);
+
+  for (size_t count : {1, 2, 7, 100, 1000})
+  {
+    vector<atomic<int>> calls(count);
+    for (auto & c : calls)
+      c = 0;
+
+    pool.ParallelFor(count, [&calls](size_t i, size_t) { ++calls[i]; });
+
+    for (size_t i = 0; i < count; ++i)
+      TEST_EQUAL(calls[i], 1, (count, i));
+  }
+}
+
+UNIT_TEST(ParallelForPool_SeveralCallers)
+{
+  threads::ParallelForPool pool(2);
+  size_t const kCount = 500;
+  vector<size_t> results(4, 0);
+
+  vector<threads::SimpleThread> callers;
+  for (size_t t = 0; t < results.size(); ++t)
+  {
+    callers.emplace_back([&pool, &results, t, kCount]()
+    {
+      vector<size_t> values(kCount, 0);
+      for (int iteration = 0; iteration < 10; ++iteration)
+        pool.ParallelFor(kCount, [&values](size_t i, size_t) { values[i] += i; });
+
+      for (size_t v : values)
+        results[t] += v;
+    });
+  }
+
+  for (auto & caller : callers)
+    caller.join();
+
+  for (size_t r : results)
+    TEST_EQUAL(r, 10 * kCount * (kCount - 1) / 2, ());
+}
+
+UNIT_TEST(ParallelForPool_CallersDontWaitForEachOther)
+{
+  threads::ParallelForPool pool(1);
+  atomic<bool> secondJobDone(false);
+
+  // Iterations of the first job wait for the second job, so the test hangs if calls are
+  // serialized.
+  threads::SimpleThread first([&pool, &secondJobDone]()
+  {
+    pool.ParallelFor(2, [&secondJobDone](size_t, size_t)
+    {
+      while (!secondJobDone)
+        this_thread::yield();
+    });
+  });
+
+  atomic<size_t> sum(0);
+  pool.ParallelFor(3, [&sum](size_t i, size_t) { sum += i; });
+  secondJobDone = true;
+  first.join();
+
+  TEST_EQUAL(sum, 3, ());
+}
+
+UNIT_TEST(ParallelForPool_Slots)
+{
+  threads::ParallelForPool pool(4);
+  size_t const kMaxThreads = 3;
+  for (int iteration = 0; iteration < 20; ++iteration)
+  {
+    // A slot is used by one thread at a time, so its counter isn't raced.
+    vector<size_t> counts(kMaxThreads, 0);
+    atomic<size_t> badSlots(0);
+    pool.ParallelFor(300, [&](size_t, size_t slot)
+    {
+      if (slot >= kMaxThreads)
+      {
+        ++badSlots;
+        return;
+      }
+      ++counts[slot];
+    }, kMaxThreads);
+
+    TEST_EQUAL(badSlots, 0, ());
+    size_t sum = 0;
+    for (size_t c : counts)
+      sum += c;
+    TEST_EQUAL(sum, 300, ());
+  }
+
+  vector<size_t> slots;
+  pool.ParallelFor(10, [&slots](size_t, size_t slot) { slots.push_back(slot); },
+                   1 /* maxThreads */);
+  TEST_EQUAL(slots, vector<size_t>(10, 0), ());
+}
+
+UNIT_TEST(ParallelForPool_Exception)
+{
+  threads::ParallelForPool pool(2);
+  atomic<size_t> calls(0);
+  bool thrown = false;
+  try
+  {
+    pool.ParallelFor(1000, [&calls](size_t i, size_t)
+    {
+      ++calls;
+      if (i == 10)
+        MYTHROW(TestException, ("Iteration", i));
+    });
+  }
+  catch (TestException const &)
+  {
+    thrown = true;
+  }
+  TEST(thrown, ());
+  TEST_LESS(calls, 1000, ());
+
+  // The pool is usable after an exception.
+  calls = 0;
+  pool.ParallelFor(100, [&calls](size_t, size_t) { ++calls; });
+  TEST_EQUAL(calls, 100, ());
+}
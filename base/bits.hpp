@@ -61,8 +61,11 @@ namespace bits
     return static_cast<unsigned int>(SELECT1_ERROR);
   }
 
-  // Will be implemented when needed.
-  uint64_t popcount(uint64_t x);
+  inline uint64_t popcount(uint64_t x)
+  {
+    return popcount(static_cast<uint32_t>(x)) + popcount(static_cast<uint32_t>(x >> 32));
+  }
+
   // Will be implemented when needed.
   uint64_t popcount(uint64_t const * p, uint64_t n);
 
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+#include "std/cstdint.hpp"
+#include "std/functional.hpp"
+#include "std/list.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/unordered_map.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+
+namespace my
+{
+/// Thread-safe LRU cache of immutable values.
+/// Keys are distributed between shards by hash. Every shard has its own mutex, LRU list and
+/// weight limit, so lookups of different keys from different threads rarely wait each other.
+/// Values are returned as shared pointers and stay alive after eviction while somebody uses them.
+template <typename TKey, typename TValue, typename THash = hash<TKey>>
+class ConcurrentLRUCache
+{
+  DISALLOW_COPY_AND_MOVE(ConcurrentLRUCache);
+
+public:
+  typedef shared_ptr<TValue const> TValuePtr;
+
+  struct Stats
+  {
+    Stats() : m_hits(0), m_misses(0), m_count(0), m_weight(0) {}
+
+    double GetHitRate() const
+    {
+      uint64_t const total = m_hits + m_misses;
+      return total == 0 ? 0.0 : static_cast<double>(m_hits) / total;
+    }
+
+    uint64_t m_hits;
+    uint64_t m_misses;
+    size_t m_count;
+    size_t m_weight;
+  };
+
+  /// @param maxWeight Maximum summary weight (usually memory size in bytes) of cached values.
+  ConcurrentLRUCache(size_t maxWeight, size_t shardsCount = 16)
+    : m_hits(0), m_misses(0)
+  {
+    ASSERT_GREATER(shardsCount, 0, ());
+    m_shards.reserve(shardsCount);
+    for (size_t i = 0; i < shardsCount; ++i)
+      m_shards.emplace_back(new Shard(max(maxWeight / shardsCount, static_cast<size_t>(1))));
+  }
+
+  /// @return Cached value for the @key or nullptr.
+  TValuePtr Find(TKey const & key)
+  {
+    Shard & shard = GetShard(key);
+    lock_guard<mutex> lock(shard.m_mutex);
+
+    auto const it = shard.m_map.find(key);
+    if (it == shard.m_map.end())
+    {
+      ++m_misses;
+      return TValuePtr();
+    }
+
+    ++m_hits;
+    shard.m_list.splice(shard.m_list.begin(), shard.m_list, it->second);
+    return it->second->m_value;
+  }
+
+  /// Puts the @value into the cache. Least recently used values are evicted when summary weight
+  /// of the shard exceeds the limit. If the @key is already cached, the old value is kept.
+  /// @return Cached value for the @key.
+  TValuePtr Insert(TKey const & key, TValuePtr const & value, size_t weight)
+  {
+    Shard & shard = GetShard(key);
+    lock_guard<mutex> lock(shard.m_mutex);
+
+    auto const it = shard.m_map.find(key);
+    if (it != shard.m_map.end())
+      return it->second->m_value;
+
+    shard.m_list.push_front(Entry(key, value, weight));
+    shard.m_map.insert(make_pair(key, shard.m_list.begin()));
+    shard.m_weight += weight;
+
+    // Always keep the newest value even if it's heavier than the limit.
+    while (shard.m_weight > shard.m_maxWeight && shard.m_list.size() > 1)
+    {
+      Entry const & victim = shard.m_list.back();
+      shard.m_weight -= victim.m_weight;
+      shard.m_map.erase(victim.m_key);
+      shard.m_list.pop_back();
+    }
+    return value;
+  }
+
+  /// @return Cached value for the @key. On a miss a new value is filled with createFn(key, value)
+  /// outside of locks and is put into the cache with weightFn(value) weight.
+  template <typename TCreateFn, typename TWeightFn>
+  TValuePtr Get(TKey const & key, TCreateFn && createFn, TWeightFn && weightFn)
+  {
+    TValuePtr value = Find(key);
+    if (value)
+      return value;
+
+    shared_ptr<TValue> created(new TValue());
+    createFn(key, *created);
+    size_t const weight = weightFn(*created);
+    return Insert(key, created, weight);
+  }
+
+  void Clear()
+  {
+    for (auto & shard : m_shards)
+    {
+      lock_guard<mutex> lock(shard->m_mutex);
+      shard->m_map.clear();
+      shard->m_list.clear();
+      shard->m_weight = 0;
+    }
+  }
+
+  Stats GetStats() const
+  {
+    Stats stats;
+    stats.m_hits = m_hits;
+    stats.m_misses = m_misses;
+    for (auto const & shard : m_shards)
+    {
+      lock_guard<mutex> lock(shard->m_mutex);
+      stats.m_count += shard->m_list.size();
+      stats.m_weight += shard->m_weight;
+    }
+    return stats;
+  }
+
+private:
+  struct Entry
+  {
+    Entry(TKey const & key, TValuePtr const & value, size_t weight)
+      : m_key(key), m_value(value), m_weight(weight)
+    {
+    }
+
+    TKey m_key;
+    TValuePtr m_value;
+    size_t m_weight;
+  };
+
+  typedef list<Entry> TList;
+
+  struct Shard
+  {
+    explicit Shard(size_t maxWeight) : m_maxWeight(maxWeight), m_weight(0) {}
+
+    mutable mutex m_mutex;
+    TList m_list;
+    unordered_map<TKey, typename TList::iterator, THash> m_map;
+    size_t const m_maxWeight;
+    size_t m_weight;
+  };
+
+  Shard & GetShard(TKey const & key)
+  {
+    // Mix the hash, because std::hash of integers is an identity.
+    uint64_t const h = static_cast<uint64_t>(THash()(key)) * 0x9E3779B97F4A7C15ULL;
+    return *m_shards[(h >> 32) % m_shards.size()];
+  }
+
+  vector<unique_ptr<Shard>> m_shards;
+  atomic<uint64_t> m_hits;
+  atomic<uint64_t> m_misses;
+};
+}  // namespace my
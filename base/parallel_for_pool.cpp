@@ -0,0 +1,136 @@
+#include "base/parallel_for_pool.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+
+namespace threads
+{
+// static
+size_t constexpr ParallelForPool::kNoThreadsLimit;
+
+// static
+ParallelForPool & ParallelForPool::Instance()
+{
+  static ParallelForPool pool(max(thread::hardware_concurrency(), 2u) - 1);
+  return pool;
+}
+
+ParallelForPool::ParallelForPool(size_t threadsCount) : m_isStopped(false)
+{
+  for (size_t i = 0; i < threadsCount; ++i)
+    m_threads.emplace_back(&ParallelForPool::ThreadFunc, this);
+}
+
+ParallelForPool::~ParallelForPool()
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_isStopped = true;
+  }
+  m_jobCondition.notify_all();
+
+  for (threads::SimpleThread & thread : m_threads)
+    thread.join();
+}
+
+void ParallelForPool::ParallelFor(size_t count, TFn const & fn, size_t maxThreads)
+{
+  ASSERT_GREATER(maxThreads, 0, ());
+  if (count == 0)
+    return;
+
+  shared_ptr<Job> job = make_shared<Job>(count, fn, maxThreads);
+  bool const shared = count > 1 && maxThreads > 1 && !m_threads.empty();
+  if (shared)
+  {
+    {
+      lock_guard<mutex> lock(m_mutex);
+      m_jobs.push_back(job);
+    }
+    m_jobCondition.notify_all();
+  }
+
+  ProcessIterations(*job, 0 /* slot */);
+
+  if (shared)
+  {
+    // Pool threads may have not seen the job, so it has to be removed here.
+    lock_guard<mutex> lock(m_mutex);
+    auto const it = find(m_jobs.begin(), m_jobs.end(), job);
+    if (it != m_jobs.end())
+      m_jobs.erase(it);
+  }
+
+  {
+    unique_lock<mutex> lock(job->m_finishMutex);
+    job->m_finishCondition.wait(lock, [&job]()
+    {
+      return job->m_finishedCount == job->m_count;
+    });
+  }
+
+  if (job->m_error)
+    rethrow_exception(job->m_error);
+}
+
+void ParallelForPool::ThreadFunc()
+{
+  while (true)
+  {
+    shared_ptr<Job> job;
+    size_t slot;
+    {
+      unique_lock<mutex> lock(m_mutex);
+      m_jobCondition.wait(lock, [this]() { return m_isStopped || !m_jobs.empty(); });
+
+      if (m_isStopped)
+        return;
+
+      job = m_jobs.front();
+      // All iterations of the job are taken, so next threads have to help the next job.
+      if (!job->HasFreeIterations())
+      {
+        m_jobs.pop_front();
+        continue;
+      }
+      slot = job->m_threadsCount++;
+      if (job->m_threadsCount == job->m_maxThreads)
+        m_jobs.pop_front();
+    }
+
+    ProcessIterations(*job, slot);
+  }
+}
+
+void ParallelForPool::ProcessIterations(Job & job, size_t slot)
+{
+  while (true)
+  {
+    size_t const i = job.m_next++;
+    if (i >= job.m_count)
+      return;
+
+    if (!job.m_failed)
+    {
+      try
+      {
+        job.m_fn(i, slot);
+      }
+      catch (...)
+      {
+        lock_guard<mutex> lock(job.m_errorMutex);
+        if (!job.m_error)
+          job.m_error = current_exception();
+        job.m_failed = true;
+      }
+    }
+
+    if (++job.m_finishedCount == job.m_count)
+    {
+      lock_guard<mutex> lock(job.m_finishMutex);
+      job.m_finishCondition.notify_all();
+    }
+  }
+}
+}  // namespace threads
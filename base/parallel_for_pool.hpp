@@ -0,0 +1,88 @@
+#pragma once
+
+#include "base/macros.hpp"
+#include "base/thread.hpp"
+
+#include "std/atomic.hpp"
+#include "std/condition_variable.hpp"
+#include "std/deque.hpp"
+#include "std/exception.hpp"
+#include "std/function.hpp"
+#include "std/limits.hpp"
+#include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/vector.hpp"
+
+namespace threads
+{
+/// Pool of threads which runs iterations of parallel loops. A loop is a job which is split into
+/// iterations, they are claimed one by one through an atomic counter by the pool threads and by
+/// the calling thread itself. So a thread which has finished its iteration takes the next free
+/// one, and the caller never sleeps while there is work left.
+/// Several callers are served at the same time: jobs wait in a queue which pool threads take
+/// iterations from in order, and every caller waits for iterations of its own job only.
+class ParallelForPool
+{
+  DISALLOW_COPY_AND_MOVE(ParallelForPool);
+
+public:
+  /// Is called as fn(i, slot), where slot is in [0, maxThreads) and is unique among threads
+  /// running the job, so it may index state of a thread. The calling thread has slot 0.
+  using TFn = function<void(size_t i, size_t slot)>;
+
+  static size_t constexpr kNoThreadsLimit = numeric_limits<size_t>::max();
+
+  /// Pool of hardware_concurrency() - 1 threads for the loops which are run on all cores.
+  static ParallelForPool & Instance();
+
+  explicit ParallelForPool(size_t threadsCount);
+  ~ParallelForPool();
+
+  size_t GetThreadsCount() const { return m_threads.size(); }
+
+  /// Calls fn(i, slot) for every i in [0, count) on the calling thread and at most
+  /// maxThreads - 1 pool threads and returns when all calls are finished.
+  /// The first exception thrown by fn is rethrown then, the calls which weren't started
+  /// by that moment are skipped.
+  void ParallelFor(size_t count, TFn const & fn, size_t maxThreads = kNoThreadsLimit);
+
+private:
+  struct Job
+  {
+    Job(size_t count, TFn const & fn, size_t maxThreads)
+      : m_fn(fn), m_count(count), m_maxThreads(maxThreads), m_threadsCount(1), m_next(0),
+        m_finishedCount(0), m_failed(false)
+    {
+    }
+
+    bool HasFreeIterations() const { return m_next < m_count; }
+
+    TFn const & m_fn;
+    size_t const m_count;
+    size_t const m_maxThreads;
+    /// Number of threads which have joined the job, guarded by ParallelForPool::m_mutex.
+    size_t m_threadsCount;
+    atomic<size_t> m_next;
+    atomic<size_t> m_finishedCount;
+
+    atomic<bool> m_failed;
+    mutex m_errorMutex;
+    exception_ptr m_error;
+
+    mutex m_finishMutex;
+    condition_variable m_finishCondition;
+  };
+
+  void ThreadFunc();
+  /// Executes free iterations of the job.
+  void ProcessIterations(Job & job, size_t slot);
+
+  vector<threads::SimpleThread> m_threads;
+
+  mutex m_mutex;
+  condition_variable m_jobCondition;
+  /// Jobs which may be joined by pool threads, in order of calls.
+  deque<shared_ptr<Job>> m_jobs;
+  bool m_isStopped;
+};
+}  // namespace threads
@@ -0,0 +1,58 @@
+#include "base/shaped_text_cache.hpp"
+
+#include "std/numeric.hpp"
+
+
+namespace strings
+{
+namespace
+{
+size_t const kMaxCacheMemorySize = 4 * 1024 * 1024;
+}  // namespace
+
+size_t ShapedTextKeyHash::operator()(ShapedTextKey const & key) const
+{
+  // FNV-1a over font, size and symbols.
+  uint64_t h = 14695981039346656037ULL;
+  auto const add = [&h](uint32_t v)
+  {
+    h ^= v;
+    h *= 1099511628211ULL;
+  };
+
+  add(key.m_fontId);
+  add(key.m_fontSize);
+  for (UniChar c : key.m_text)
+    add(c);
+  return static_cast<size_t>(h);
+}
+
+float ShapedText::GetLength() const
+{
+  return accumulate(m_advances.begin(), m_advances.end(), 0.0f);
+}
+
+size_t ShapedText::GetMemorySize() const
+{
+  // Key text is stored in the cache too and usually has the same size as the visible one.
+  return sizeof(ShapedTextKey) + sizeof(ShapedText) + 2 * m_visText.size() * sizeof(UniChar) +
+         m_advances.size() * sizeof(float);
+}
+
+TShapedTextCache & GetShapedTextCache()
+{
+  static TShapedTextCache cache(kMaxCacheMemorySize);
+  return cache;
+}
+
+shared_ptr<ShapedText const> GetShapedText(ShapedTextKey const & key, TShapeTextFn const & fn)
+{
+  return GetShapedTextCache().Get(key, [&fn](ShapedTextKey const & k, ShapedText & shaped)
+  {
+    fn(k.m_text, shaped);
+  }, [](ShapedText const & shaped)
+  {
+    return shaped.GetMemorySize();
+  });
+}
+}  // namespace strings
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "base/concurrent_lru_cache.hpp"
+#include "base/string_utils.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/function.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/vector.hpp"
+
+
+namespace strings
+{
+struct ShapedTextKey
+{
+  ShapedTextKey() : m_fontId(0), m_fontSize(0) {}
+  ShapedTextKey(UniString const & text, uint32_t fontId, uint32_t fontSize)
+    : m_text(text), m_fontId(fontId), m_fontSize(fontSize)
+  {
+  }
+
+  bool operator==(ShapedTextKey const & r) const
+  {
+    return m_fontId == r.m_fontId && m_fontSize == r.m_fontSize && m_text == r.m_text;
+  }
+
+  /// Logical (not reordered) text.
+  UniString m_text;
+  /// Id of the font engine which is used for layout. Glyph metrics of different engines differ.
+  uint32_t m_fontId;
+  uint32_t m_fontSize;
+};
+
+struct ShapedTextKeyHash
+{
+  size_t operator()(ShapedTextKey const & key) const;
+};
+
+/// Text layed out for rendering: glyphs in visual order after bidi reordering and their advances.
+struct ShapedText
+{
+  float GetLength() const;
+  size_t GetMemorySize() const;
+
+  UniString m_visText;
+  vector<float> m_advances;
+};
+
+typedef my::ConcurrentLRUCache<ShapedTextKey, ShapedText, ShapedTextKeyHash> TShapedTextCache;
+typedef function<void (UniString const & text, ShapedText & shaped)> TShapeTextFn;
+
+/// @return Process-wide cache of shaped texts. The same street and city names are repeated
+/// in thousands of tiles, so both drape and graphics text layouts share it.
+TShapedTextCache & GetShapedTextCache();
+
+/// @return Cached shaped text for the @key. On a miss the text is shaped with @fn.
+shared_ptr<ShapedText const> GetShapedText(ShapedTextKey const & key, TShapeTextFn const & fn);
+}  // namespace strings
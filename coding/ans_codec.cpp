@@ -0,0 +1,230 @@
+#include "coding/ans_codec.hpp"
+
+#include "coding/endianness.hpp"
+
+#include "base/bits.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstring.hpp"
+#include "std/utility.hpp"
+
+namespace coding
+{
+namespace
+{
+// Writes bits starting from the least significant ones.
+class BitWriter
+{
+public:
+  explicit BitWriter(vector<uint8_t> & out) : m_out(out), m_bits(0), m_count(0) {}
+
+  void Write(uint32_t value, uint32_t count)
+  {
+    m_bits |= static_cast<uint64_t>(value) << m_count;
+    m_count += count;
+    for (; m_count >= 8; m_count -= 8, m_bits >>= 8)
+      m_out.push_back(static_cast<uint8_t>(m_bits));
+  }
+
+  void Flush()
+  {
+    if (m_count != 0)
+      m_out.push_back(static_cast<uint8_t>(m_bits));
+    m_bits = 0;
+    m_count = 0;
+  }
+
+private:
+  vector<uint8_t> & m_out;
+  uint64_t m_bits;
+  uint32_t m_count;
+};
+}  // namespace
+
+uint32_t const AnsTable::kStateBits;
+uint32_t const AnsTable::kAlphabetSize;
+uint32_t const AnsTable::kStates;
+
+AnsTable::AnsTable()
+{
+  fill(m_freqs, m_freqs + kAlphabetSize, 0);
+  fill(m_starts, m_starts + kAlphabetSize, 0);
+}
+
+AnsTable::AnsTable(vector<uint64_t> const & counts)
+{
+  CHECK_EQUAL(counts.size(), kAlphabetSize, ());
+  uint64_t total = 0;
+  for (uint64_t c : counts)
+    total += c;
+
+  // Every present byte gets at least one state, the rest is distributed proportionally.
+  int64_t sum = 0;
+  for (uint32_t i = 0; i < kAlphabetSize; ++i)
+  {
+    uint64_t freq = 0;
+    if (counts[i] != 0)
+      freq = max(static_cast<uint64_t>(1), counts[i] * kStates / total);
+    m_freqs[i] = static_cast<uint16_t>(freq);
+    sum += freq;
+  }
+
+  // Rounding errors are compensated by the most frequent bytes, where they cost least.
+  while (sum != 0 && sum != kStates)
+  {
+    uint16_t * maxFreq = max_element(m_freqs, m_freqs + kAlphabetSize);
+    if (sum < kStates)
+    {
+      *maxFreq += static_cast<uint16_t>(kStates - sum);
+      sum = kStates;
+    }
+    else
+    {
+      int64_t const delta = min(sum - kStates, static_cast<int64_t>(*maxFreq - 1));
+      *maxFreq -= static_cast<uint16_t>(delta);
+      sum -= delta;
+    }
+  }
+  if (sum == 0)
+    return;
+
+  BuildDecodingTable();
+
+  // The encoder is the inverse of the decoder: the i-th state which decodes a byte is
+  // the i-th encoding state of the byte.
+  uint32_t start = 0;
+  for (uint32_t i = 0; i < kAlphabetSize; ++i)
+  {
+    m_starts[i] = static_cast<uint16_t>(start);
+    start += m_freqs[i];
+  }
+  m_encoding.resize(kStates);
+  uint16_t next[kAlphabetSize];
+  copy(m_starts, m_starts + kAlphabetSize, next);
+  for (uint32_t state = 0; state < kStates; ++state)
+    m_encoding[next[m_decoding[state].m_byte]++] = static_cast<uint16_t>(kStates + state);
+}
+
+void AnsTable::Encode(uint8_t const * data, size_t size, vector<uint8_t> & out) const
+{
+  // Bytes are coded in reverse order, so the bits are written in reverse order too and
+  // the decoder reads them forward. Even and odd bytes are coded with separate states,
+  // which are decoded in parallel.
+  vector<pair<uint32_t, uint32_t>> chunks;
+  chunks.reserve(size);
+  uint32_t states[2] = {kStates, kStates};
+  for (size_t i = size; i != 0; --i)
+  {
+    uint8_t const b = data[i - 1];
+    uint32_t & state = states[(i - 1) % 2];
+    uint32_t const freq = m_freqs[b];
+    ASSERT_NOT_EQUAL(freq, 0, (b));
+    uint32_t bits = 0;
+    while ((state >> bits) >= 2 * freq)
+      ++bits;
+    chunks.emplace_back(state & ((1 << bits) - 1), bits);
+    state = m_encoding[m_starts[b] + (state >> bits) - freq];
+  }
+
+  BitWriter writer(out);
+  for (uint32_t state : states)
+    writer.Write(state - kStates, kStateBits);
+  for (auto it = chunks.rbegin(); it != chunks.rend(); ++it)
+    writer.Write(it->first, it->second);
+  writer.Flush();
+}
+
+uint8_t const * AnsTable::Decode(uint8_t const * beg, uint8_t const * end, uint8_t * data,
+                                 size_t size) const
+{
+  // |bits| contains |count| next bits of the code, zeroes are read after the end.
+  uint64_t bits = 0;
+  uint32_t count = 0;
+  uint8_t const * p = beg;
+  auto const refill = [&]()
+  {
+    if (end - p >= 8)
+    {
+      uint64_t word;
+      memcpy(&word, p, sizeof(word));
+      bits |= SwapIfBigEndian(word) << count;
+      p += (63 - count) >> 3;
+      count |= 56;
+      return;
+    }
+    for (; count <= 56; count += 8, ++p)
+      bits |= static_cast<uint64_t>(p < end ? *p : 0) << count;
+  };
+  auto const read = [&](uint32_t n)
+  {
+    uint32_t const value = static_cast<uint32_t>(bits & ((1 << n) - 1));
+    bits >>= n;
+    count -= n;
+    return value;
+  };
+
+  refill();
+  uint32_t states[2];
+  states[0] = read(kStateBits);
+  states[1] = read(kStateBits);
+  size_t i = 0;
+  for (; i + 1 < size; i += 2)
+  {
+    // Two bytes take at most 2 * kStateBits bits.
+    if (count < 2 * kStateBits)
+      refill();
+    DecodingEntry const & entry0 = m_decoding[states[0]];
+    DecodingEntry const & entry1 = m_decoding[states[1]];
+    data[i] = entry0.m_byte;
+    data[i + 1] = entry1.m_byte;
+    states[0] = entry0.m_state + read(entry0.m_bits);
+    states[1] = entry1.m_state + read(entry1.m_bits);
+  }
+  if (i < size)
+  {
+    if (count < kStateBits)
+      refill();
+    DecodingEntry const & entry = m_decoding[states[0]];
+    data[i] = entry.m_byte;
+    states[0] = entry.m_state + read(entry.m_bits);
+  }
+
+  // The decoder returns to the initial states of the encoder.
+  uint64_t const usedBits = static_cast<uint64_t>(p - beg) * 8 - count;
+  if (states[0] != 0 || states[1] != 0 || usedBits > static_cast<uint64_t>(end - beg) * 8)
+    return nullptr;
+  return beg + (usedBits + 7) / 8;
+}
+
+void AnsTable::BuildDecodingTable()
+{
+  // Bytes are spread over the states, so the frequent ones get states in all ranges.
+  vector<uint8_t> bytes(kStates);
+  uint32_t const step = (kStates >> 1) + (kStates >> 3) + 3;
+  uint32_t pos = 0;
+  for (uint32_t i = 0; i < kAlphabetSize; ++i)
+  {
+    for (uint32_t j = 0; j < m_freqs[i]; ++j)
+    {
+      bytes[pos] = static_cast<uint8_t>(i);
+      pos = (pos + step) & (kStates - 1);
+    }
+  }
+  ASSERT_EQUAL(pos, 0, ());
+
+  uint32_t next[kAlphabetSize];
+  copy(m_freqs, m_freqs + kAlphabetSize, next);
+  m_decoding.resize(kStates);
+  for (uint32_t state = 0; state < kStates; ++state)
+  {
+    uint8_t const b = bytes[state];
+    // The state of the encoder before b is in [next, 2 * next) shifted by bits of the code.
+    uint32_t const x = next[b]++;
+    uint32_t const bitsCount = kStateBits + 1 - bits::NumUsedBits(x);
+    DecodingEntry & entry = m_decoding[state];
+    entry.m_state = static_cast<uint16_t>((x << bitsCount) - kStates);
+    entry.m_byte = b;
+    entry.m_bits = static_cast<uint8_t>(bitsCount);
+  }
+}
+}  // namespace coding
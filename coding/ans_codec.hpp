@@ -0,0 +1,109 @@
+// Static order-0 tANS coder of bytes.
+// See J. Duda, "Asymmetric numeral systems: entropy coding combining speed of Huffman coding
+// with compression rate of arithmetic coding", and Y. Collet, Finite State Entropy.
+// One table of byte frequencies is shared by many small blocks of data, each block is coded
+// separately and can be decoded independently with a single table lookup per byte.
+// Usage:
+//   // counts[i] is a number of occurrences of the byte i in all blocks.
+//   coding::AnsTable table(counts);
+//   vector<uint8_t> encoded;
+//   table.Encode(block.data(), block.size(), encoded);
+//   // Number of decoded bytes should be provided outside.
+//   table.Decode(encoded.data(), encoded.data() + encoded.size(), decoded, block.size());
+
+#pragma once
+
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+namespace coding
+{
+class AnsTable
+{
+public:
+  // Frequencies of bytes are normalized to sum up to the number of coder states,
+  // which is (1 << kStateBits).
+  static uint32_t const kStateBits = 11;
+  static uint32_t const kAlphabetSize = 256;
+
+  // Empty table, Deserialize() should be called before decoding.
+  AnsTable();
+  // Builds the table for bytes counted in |counts|, counts.size() should be kAlphabetSize.
+  explicit AnsTable(vector<uint64_t> const & counts);
+
+  bool HasByte(uint8_t b) const { return m_freqs[b] != 0; }
+
+  // Appends the code of |size| bytes from |data| to |out|.
+  // All bytes of |data| should have nonzero frequencies.
+  void Encode(uint8_t const * data, size_t size, vector<uint8_t> & out) const;
+
+  // Decodes |size| bytes from the code at [beg, end) to |data|. Returns a pointer to the first
+  // byte after the code, or nullptr if the code is corrupted.
+  uint8_t const * Decode(uint8_t const * beg, uint8_t const * end, uint8_t * data,
+                         size_t size) const;
+
+  template <typename TSink>
+  void Serialize(TSink & sink) const
+  {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < kAlphabetSize; ++i)
+      count += m_freqs[i] != 0 ? 1 : 0;
+    WriteVarUint(sink, count);
+    for (uint32_t i = 0; i < kAlphabetSize; ++i)
+    {
+      if (m_freqs[i] == 0)
+        continue;
+      WriteToSink(sink, static_cast<uint8_t>(i));
+      WriteVarUint(sink, static_cast<uint32_t>(m_freqs[i] - 1));
+    }
+  }
+
+  // Only decoding tables are built.
+  template <typename TSource>
+  void Deserialize(TSource & src)
+  {
+    for (uint32_t i = 0; i < kAlphabetSize; ++i)
+      m_freqs[i] = 0;
+    uint32_t const count = ReadVarUint<uint32_t>(src);
+    CHECK_LESS_OR_EQUAL(count, kAlphabetSize, ());
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      uint8_t const b = ReadPrimitiveFromSource<uint8_t>(src);
+      uint32_t const freq = ReadVarUint<uint32_t>(src) + 1;
+      CHECK_LESS_OR_EQUAL(freq, kStates - sum, (b));
+      m_freqs[b] = static_cast<uint16_t>(freq);
+      sum += freq;
+    }
+    CHECK(count == 0 || sum == kStates, (count, sum));
+    BuildDecodingTable();
+  }
+
+private:
+  static uint32_t const kStates = 1 << kStateBits;
+
+  struct DecodingEntry
+  {
+    // The next state without the bits which are read from the code.
+    uint16_t m_state;
+    uint8_t m_byte;
+    uint8_t m_bits;
+  };
+
+  void BuildDecodingTable();
+
+  uint16_t m_freqs[kAlphabetSize];
+  // Decoding table, states are numbered from zero.
+  vector<DecodingEntry> m_decoding;
+  // States of the encoder are [kStates, 2 * kStates), states which encode byte b are
+  // m_encoding[m_starts[b]], ..., m_encoding[m_starts[b] + m_freqs[b] - 1].
+  uint16_t m_starts[kAlphabetSize];
+  vector<uint16_t> m_encoding;
+};
+}  // namespace coding
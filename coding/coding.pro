@@ -11,11 +11,13 @@ INCLUDEPATH *= $$ROOT_DIR/3party/tomcrypt/src/headers
 
 SOURCES += \
     $$ROOT_DIR/3party/lodepng/lodepng.cpp \
+    ans_codec.cpp \
     arithmetic_codec.cpp \
     base64.cpp \
 #    blob_indexer.cpp \
 #    blob_storage.cpp \
     compressed_bit_vector.cpp \
+    compressed_bitmap.cpp \
 #    compressed_varnum_vector.cpp \
     file_container.cpp \
     file_name_utils.cpp \
@@ -26,6 +28,7 @@ SOURCES += \
     internal/file_data.cpp \
     mmap_reader.cpp \
     multilang_utf8_string.cpp \
+    mwm_diff.cpp \
     png_memory_encoder.cpp \
     reader.cpp \
     reader_streambuf.cpp \
@@ -41,6 +44,7 @@ HEADERS += \
     $$ROOT_DIR/3party/lodepng/lodepng.hpp \
     $$ROOT_DIR/3party/lodepng/lodepng_io.hpp \
     $$ROOT_DIR/3party/lodepng/lodepng_io_private.hpp \
+    ans_codec.hpp \
     arithmetic_codec.hpp \
     base64.hpp \
     bit_streams.hpp \
@@ -51,6 +55,7 @@ HEADERS += \
     coder.hpp \
     coder_util.hpp \
     compressed_bit_vector.hpp \
+    compressed_bitmap.hpp \
 #    compressed_varnum_vector.hpp \
     constants.hpp \
     dd_vector.hpp \
@@ -68,12 +73,16 @@ HEADERS += \
     huffman.hpp \
     internal/file64_api.hpp \
     internal/file_data.hpp \
+    louds_trie.hpp \
+    louds_trie_builder.hpp \
     matrix_traversal.hpp \
     mmap_reader.hpp \
     multilang_utf8_string.hpp \
+    mwm_diff.hpp \
     parse_xml.hpp \
     png_memory_encoder.hpp \
     polymorph_reader.hpp \
+    rank_bit_vector.hpp \
     read_write_utils.hpp \
     reader.hpp \
     reader_cache.hpp \
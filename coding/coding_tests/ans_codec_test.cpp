@@ -0,0 +1,136 @@
+#include "testing/testing.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/ans_codec.hpp"
+
+#include "std/cmath.hpp"
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+using coding::AnsTable;
+
+namespace
+{
+vector<uint64_t> CountBytes(vector<uint8_t> const & data)
+{
+  vector<uint64_t> counts(AnsTable::kAlphabetSize);
+  for (uint8_t b : data)
+    ++counts[b];
+  return counts;
+}
+
+void TestRoundTrip(AnsTable const & table, vector<uint8_t> const & data)
+{
+  vector<uint8_t> encoded(1, 0xAB);
+  table.Encode(data.data(), data.size(), encoded);
+  // The code is appended to the existing data and can be followed by other data.
+  TEST_EQUAL(encoded[0], 0xAB, ());
+  encoded.push_back(0xCD);
+
+  vector<uint8_t> decoded(data.size());
+  uint8_t const * end = encoded.data() + encoded.size();
+  uint8_t const * p = table.Decode(encoded.data() + 1, end, decoded.data(), decoded.size());
+  TEST(p != nullptr, ());
+  TEST_EQUAL(p + 1, end, ());
+  TEST_EQUAL(data, decoded, ());
+}
+}  // namespace
+
+UNIT_TEST(AnsCodec_Smoke)
+{
+  vector<uint8_t> const data = {1, 2, 2, 3, 3, 3, 3, 3, 3, 200, 1};
+  AnsTable const table(CountBytes(data));
+  TestRoundTrip(table, data);
+  TestRoundTrip(table, {});
+  TestRoundTrip(table, {200});
+  TestRoundTrip(table, {3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3});
+}
+
+UNIT_TEST(AnsCodec_SingleByte)
+{
+  vector<uint8_t> const data(1000, 7);
+  AnsTable const table(CountBytes(data));
+  vector<uint8_t> encoded;
+  table.Encode(data.data(), data.size(), encoded);
+  // Only final states are written.
+  TEST_EQUAL(encoded.size(), 3, ());
+  TestRoundTrip(table, data);
+}
+
+UNIT_TEST(AnsCodec_Random)
+{
+  mt19937 rng(0);
+  // Small deltas dominate as in indexes and geometry.
+  geometric_distribution<int> dist(0.1);
+  vector<uint8_t> data(100000);
+  for (auto & b : data)
+    b = static_cast<uint8_t>(min(dist(rng), 255));
+  // Rare bytes get at least one slot.
+  data[500] = 255;
+  data[600] = 254;
+
+  vector<uint64_t> const counts = CountBytes(data);
+  AnsTable const table(counts);
+  TestRoundTrip(table, data);
+
+  double entropy = 0;
+  for (uint64_t c : counts)
+  {
+    if (c != 0)
+      entropy -= c * log2(static_cast<double>(c) / data.size());
+  }
+  vector<uint8_t> encoded;
+  table.Encode(data.data(), data.size(), encoded);
+  TEST_LESS(encoded.size(), 1.01 * entropy / 8 + 6, (entropy / 8));
+
+  for (size_t size = 0; size < 100; ++size)
+  {
+    uniform_int_distribution<size_t> pos(0, data.size() - size);
+    auto const it = data.begin() + pos(rng);
+    TestRoundTrip(table, vector<uint8_t>(it, it + size));
+  }
+}
+
+UNIT_TEST(AnsCodec_Corrupted)
+{
+  vector<uint8_t> const data = {1, 2, 2, 3, 3, 3, 3, 3, 3, 4, 1, 2, 5, 6, 7, 8, 9};
+  AnsTable const table(CountBytes(data));
+  vector<uint8_t> encoded;
+  table.Encode(data.data(), data.size(), encoded);
+
+  vector<uint8_t> decoded(data.size());
+  // The code is truncated.
+  TEST(table.Decode(encoded.data(), encoded.data() + encoded.size() - 1, decoded.data(),
+                    decoded.size()) == nullptr, ());
+  TEST(table.Decode(encoded.data(), encoded.data() + 2, decoded.data(), 0) == nullptr, ());
+  // The state doesn't return to the initial one.
+  encoded[0] ^= 0x10;
+  TEST(table.Decode(encoded.data(), encoded.data() + encoded.size(), decoded.data(),
+                    decoded.size()) == nullptr, ());
+}
+
+UNIT_TEST(AnsCodec_Serialization)
+{
+  vector<uint8_t> const data = {0, 0, 0, 1, 1, 255, 17, 17, 17, 17, 17, 17, 17, 17};
+  AnsTable const table(CountBytes(data));
+
+  vector<uint8_t> buffer;
+  {
+    PushBackByteSink<vector<uint8_t>> sink(buffer);
+    table.Serialize(sink);
+  }
+  AnsTable deserialized;
+  ArrayByteSource src(buffer.data());
+  deserialized.Deserialize(src);
+  TEST_EQUAL(static_cast<uint8_t const *>(src.Ptr()), buffer.data() + buffer.size(), ());
+
+  for (uint32_t i = 0; i < AnsTable::kAlphabetSize; ++i)
+    TEST_EQUAL(table.HasByte(i), deserialized.HasByte(i), (i));
+
+  vector<uint8_t> encoded;
+  table.Encode(data.data(), data.size(), encoded);
+  vector<uint8_t> decoded(data.size());
+  TEST(deserialized.Decode(encoded.data(), encoded.data() + encoded.size(), decoded.data(),
+                           decoded.size()) != nullptr, ());
+  TEST_EQUAL(data, decoded, ());
+}
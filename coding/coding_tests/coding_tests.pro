@@ -11,6 +11,7 @@ DEPENDENCIES = coding base minizip tomcrypt succinct
 include($$ROOT_DIR/common.pri)
 
 SOURCES += ../../testing/testingmain.cpp \
+    ans_codec_test.cpp \
     arithmetic_codec_test.cpp \
     base64_for_user_id_test.cpp \
     base64_test.cpp \
@@ -18,6 +19,7 @@ SOURCES += ../../testing/testingmain.cpp \
 #    blob_storage_test.cpp \
     coder_util_test.cpp \
     compressed_bit_vector_test.cpp \
+    compressed_bitmap_test.cpp \
 #    compressed_varnum_vector_test.cpp \
     dd_vector_test.cpp \
     diff_test.cpp \
@@ -28,9 +30,11 @@ SOURCES += ../../testing/testingmain.cpp \
     file_utils_test.cpp \
     hex_test.cpp \
     huffman_test.cpp \
+    louds_trie_test.cpp \
     mem_file_reader_test.cpp \
     mem_file_writer_test.cpp \
     multilang_utf8_string_test.cpp \
+    mwm_diff_test.cpp \
     png_decoder_test.cpp \
     reader_cache_test.cpp \
     reader_test.cpp \
@@ -0,0 +1,242 @@
+#include "testing/testing.hpp"
+#include "testing/benchmark.hpp"
+
+#include "coding/compressed_bit_vector.hpp"
+#include "coding/compressed_bitmap.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/iterator.hpp"
+#include "std/random.hpp"
+
+
+namespace
+{
+// Generates strictly increasing positions in [0, maxPos) where every position is taken
+// with |probability|.
+vector<uint32_t> GetRandomPositions(mt19937 & rng, uint32_t maxPos, double probability)
+{
+  bernoulli_distribution take(probability);
+  vector<uint32_t> res;
+  for (uint32_t pos = 0; pos < maxPos; ++pos)
+  {
+    if (take(rng))
+      res.push_back(pos);
+  }
+  return res;
+}
+
+// Positions with sparse, dense and full chunks to have all kinds of chunks.
+vector<uint32_t> GetMixedPositions(mt19937 & rng)
+{
+  vector<uint32_t> res;
+  double const probabilities[] = {0.001, 0.5, 0.01, 1.0, 0.07, 0.0, 0.2};
+  for (size_t chunk = 0; chunk < ARRAY_SIZE(probabilities); ++chunk)
+  {
+    uint32_t const high = static_cast<uint32_t>(chunk) << 16;
+    for (uint32_t pos : GetRandomPositions(rng, 1 << 16, probabilities[chunk]))
+      res.push_back(high | pos);
+  }
+  return res;
+}
+
+CompressedBitmap ReadWritten(CompressedBitmap const & bitmap)
+{
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  bitmap.Write(writer);
+
+  MemReader reader(buffer.data(), buffer.size());
+  ReaderSource<MemReader> src(reader);
+  CompressedBitmap res;
+  res.Read(src);
+  return res;
+}
+}  // namespace
+
+UNIT_TEST(CompressedBitmap_Smoke)
+{
+  CompressedBitmap empty;
+  TEST(empty.IsEmpty(), ());
+  TEST_EQUAL(empty.PopCount(), 0, ());
+  TEST_EQUAL(empty.Rank(100), 0, ());
+  TEST(!empty.Contains(0), ());
+
+  vector<uint32_t> const posOnes = {0, 5, 65535, 65536, 1000000, 0xFFFFFFFF};
+  CompressedBitmap bitmap(posOnes);
+  TEST_EQUAL(bitmap.PopCount(), posOnes.size(), ());
+  TEST_EQUAL(bitmap.ToVector(), posOnes, ());
+  TEST(bitmap.Contains(65536), ());
+  TEST(!bitmap.Contains(65537), ());
+  TEST_EQUAL(bitmap.Rank(6), 2, ());
+  TEST_EQUAL(bitmap.Rank(65536), 3, ());
+  TEST_EQUAL(bitmap.Rank(0xFFFFFFFF), 5, ());
+  TEST_EQUAL(bitmap.Select(4), 1000000, ());
+  TEST_EQUAL(bitmap.Select(5), 0xFFFFFFFF, ());
+  TEST(ReadWritten(bitmap) == bitmap, ());
+  TEST(ReadWritten(empty) == empty, ());
+}
+
+UNIT_TEST(CompressedBitmap_RankSelect)
+{
+  mt19937 rng(0);
+  vector<uint32_t> const posOnes = GetMixedPositions(rng);
+  CompressedBitmap const bitmap(posOnes);
+  TEST_EQUAL(bitmap.PopCount(), posOnes.size(), ());
+  TEST_EQUAL(bitmap.ToVector(), posOnes, ());
+
+  for (size_t i = 0; i < posOnes.size(); i += 7)
+  {
+    TEST_EQUAL(bitmap.Select(static_cast<uint32_t>(i)), posOnes[i], (i));
+    TEST_EQUAL(bitmap.Rank(posOnes[i]), i, (i));
+    TEST(bitmap.Contains(posOnes[i]), (i));
+  }
+
+  uniform_int_distribution<uint32_t> pos(0, 8 << 16);
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    uint32_t const p = pos(rng);
+    auto const it = lower_bound(posOnes.begin(), posOnes.end(), p);
+    TEST_EQUAL(bitmap.Rank(p), distance(posOnes.begin(), it), (p));
+    TEST_EQUAL(bitmap.Contains(p), it != posOnes.end() && *it == p, (p));
+  }
+
+  TEST(ReadWritten(bitmap) == bitmap, ());
+}
+
+UNIT_TEST(CompressedBitmap_SetOperations)
+{
+  mt19937 rng(1);
+  for (size_t test = 0; test < 10; ++test)
+  {
+    vector<uint32_t> const posOnes1 = GetMixedPositions(rng);
+    vector<uint32_t> const posOnes2 = GetRandomPositions(rng, 8 << 16, 0.02 * test);
+
+    vector<uint32_t> expected;
+    set_intersection(posOnes1.begin(), posOnes1.end(), posOnes2.begin(), posOnes2.end(),
+                     back_inserter(expected));
+    CompressedBitmap bitmap(posOnes1);
+    bitmap.Intersect(CompressedBitmap(posOnes2));
+    TEST_EQUAL(bitmap.ToVector(), expected, (test));
+    TEST(bitmap == CompressedBitmap(expected), (test));
+    TEST_EQUAL(bitmap.PopCount(), expected.size(), (test));
+
+    expected.clear();
+    set_union(posOnes1.begin(), posOnes1.end(), posOnes2.begin(), posOnes2.end(),
+              back_inserter(expected));
+    bitmap = CompressedBitmap(posOnes2);
+    bitmap.Unite(CompressedBitmap(posOnes1));
+    TEST_EQUAL(bitmap.ToVector(), expected, (test));
+    TEST(bitmap == CompressedBitmap(expected), (test));
+
+    expected.clear();
+    set_difference(posOnes1.begin(), posOnes1.end(), posOnes2.begin(), posOnes2.end(),
+                   back_inserter(expected));
+    bitmap = CompressedBitmap(posOnes1);
+    bitmap.Subtract(CompressedBitmap(posOnes2));
+    TEST_EQUAL(bitmap.ToVector(), expected, (test));
+    TEST(bitmap == CompressedBitmap(expected), (test));
+    if (!expected.empty())
+      TEST_EQUAL(bitmap.Select(static_cast<uint32_t>(expected.size() - 1)), expected.back(), ());
+  }
+}
+
+UNIT_TEST(GallopingIntersect)
+{
+  mt19937 rng(2);
+  vector<uint32_t> const large = GetRandomPositions(rng, 1000000, 0.3);
+  for (double probability : {0.00001, 0.001, 0.1, 0.5})
+  {
+    vector<uint32_t> const small = GetRandomPositions(rng, 1000000, probability);
+    vector<uint32_t> expected;
+    set_intersection(small.begin(), small.end(), large.begin(), large.end(),
+                     back_inserter(expected));
+
+    vector<uint32_t> actual;
+    GallopingIntersect(small.data(), small.size(), large.data(), large.size(), actual);
+    TEST_EQUAL(actual, expected, (probability));
+
+    actual.clear();
+    GallopingIntersect(large.data(), large.size(), small.data(), small.size(), actual);
+    TEST_EQUAL(actual, expected, (probability));
+  }
+}
+
+#ifndef DEBUG
+namespace
+{
+// Emulates intersection of features retrieved for query tokens: a few sparse sets of features
+// matching to names and a dense set of features of a popular category.
+struct RetrievalSets
+{
+  RetrievalSets()
+  {
+    mt19937 rng(3);
+    uint32_t const kFeaturesCount = 3000000;
+    double const probabilities[] = {0.3, 0.002, 0.0005, 0.05};
+    for (double probability : probabilities)
+    {
+      vector<uint32_t> const posOnes = GetRandomPositions(rng, kFeaturesCount, probability);
+
+      m_bitVectors.emplace_back();
+      MemWriter<vector<uint8_t>> bitVectorWriter(m_bitVectors.back());
+      BuildCompressedBitVector(bitVectorWriter, posOnes);
+
+      m_bitmaps.emplace_back();
+      MemWriter<vector<uint8_t>> bitmapWriter(m_bitmaps.back());
+      CompressedBitmap(posOnes).Write(bitmapWriter);
+    }
+  }
+
+  vector<vector<uint8_t>> m_bitVectors;
+  vector<vector<uint8_t>> m_bitmaps;
+};
+
+RetrievalSets const & GetRetrievalSets()
+{
+  static RetrievalSets sets;
+  return sets;
+}
+}  // namespace
+
+BENCHMARK_TEST(CompressedBitVector_DecodeAndIntersect)
+{
+  RetrievalSets const & sets = GetRetrievalSets();
+  BENCHMARK_N_TIMES(20, 10.0)
+  {
+    vector<uint32_t> result;
+    for (size_t i = 0; i < sets.m_bitVectors.size(); ++i)
+    {
+      MemReader reader(sets.m_bitVectors[i].data(), sets.m_bitVectors[i].size());
+      vector<uint32_t> const posOnes = DecodeCompressedBitVector(reader);
+      if (i == 0)
+        result = posOnes;
+      else
+        result = BitVectorsAnd(result.begin(), result.end(), posOnes.begin(), posOnes.end());
+    }
+    FORCE_USE_VALUE(result.size());
+  }
+}
+
+BENCHMARK_TEST(CompressedBitmap_ReadAndIntersect)
+{
+  RetrievalSets const & sets = GetRetrievalSets();
+  BENCHMARK_N_TIMES(20, 10.0)
+  {
+    CompressedBitmap result;
+    for (size_t i = 0; i < sets.m_bitmaps.size(); ++i)
+    {
+      MemReader reader(sets.m_bitmaps[i].data(), sets.m_bitmaps[i].size());
+      ReaderSource<MemReader> src(reader);
+      CompressedBitmap bitmap;
+      bitmap.Read(src);
+      if (i == 0)
+        result = move(bitmap);
+      else
+        result.Intersect(bitmap);
+    }
+    FORCE_USE_VALUE(result.PopCount());
+  }
+}
+#endif
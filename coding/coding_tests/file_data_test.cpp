@@ -58,6 +58,29 @@ UNIT_TEST(FileData_ApiSmoke)
   TEST(!my::GetFileSize(name2, sz), ());
 }
 
+UNIT_TEST(FileData_SyncAndPreallocate)
+{
+  {
+    my::FileData f(name1, my::FileData::OP_WRITE_TRUNCATE);
+    f.Write(name1.c_str(), name1.size());
+    f.Sync();
+    TEST_EQUAL(f.Size(), name1.size(), ());
+
+    uint64_t const size = 1000;
+    uint64_t const expectedSize = f.Preallocate(size) ? size : name1.size();
+    TEST_EQUAL(f.Size(), expectedSize, ());
+  }
+
+  {
+    my::FileData f(name1, my::FileData::OP_READ);
+    string buffer(name1.size(), ' ');
+    f.Read(0, &buffer[0], buffer.size());
+    TEST_EQUAL(buffer, name1, ());
+  }
+
+  TEST(my::DeleteFileX(name1), ());
+}
+
 /*
 UNIT_TEST(FileData_NoDiskSpace)
 {
@@ -0,0 +1,227 @@
+#include "testing/testing.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/louds_trie.hpp"
+#include "coding/louds_trie_builder.hpp"
+#include "coding/reader.hpp"
+#include "coding/trie.hpp"
+#include "coding/trie_builder.hpp"
+#include "coding/trie_reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/buffer_vector.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstring.hpp"
+#include "std/random.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+struct KeyValuePair
+{
+  KeyValuePair() : m_value(0) {}
+  KeyValuePair(vector<trie::TrieChar> const & key, uint32_t value) : m_key(key), m_value(value) {}
+
+  uint32_t GetKeySize() const { return static_cast<uint32_t>(m_key.size()); }
+  trie::TrieChar const * GetKeyData() const { return m_key.data(); }
+  uint32_t GetValue() const { return m_value; }
+
+  void const * value_data() const { return &m_value; }
+  size_t value_size() const { return sizeof(m_value); }
+
+  bool operator==(KeyValuePair const & rhs) const
+  {
+    return m_key == rhs.m_key && m_value == rhs.m_value;
+  }
+
+  bool operator<(KeyValuePair const & rhs) const
+  {
+    return m_key != rhs.m_key ? m_key < rhs.m_key : m_value < rhs.m_value;
+  }
+
+  void Swap(KeyValuePair & rhs)
+  {
+    m_key.swap(rhs.m_key);
+    swap(m_value, rhs.m_value);
+  }
+
+  vector<trie::TrieChar> m_key;
+  uint32_t m_value;
+};
+
+string DebugPrint(KeyValuePair const & p)
+{
+  return "KVP(" + ::DebugPrint(p.m_key) + ", " + ::DebugPrint(p.m_value) + ")";
+}
+
+class Uint32ValueList
+{
+public:
+  void Append(uint32_t value) { m_values.push_back(value); }
+
+  size_t size() const { return m_values.size(); }
+
+  bool empty() const { return m_values.empty(); }
+
+  template <typename TSink>
+  void Dump(TSink & sink) const
+  {
+    sink.Write(m_values.data(), m_values.size() * sizeof(uint32_t));
+  }
+
+private:
+  vector<uint32_t> m_values;
+};
+
+struct Uint32ValueReader
+{
+  using ValueType = uint32_t;
+
+  template <typename TSource>
+  void operator()(TSource & src, ValueType & value) const
+  {
+    value = ReadPrimitiveFromSource<uint32_t>(src);
+  }
+};
+
+using TIterator = trie::Iterator<uint32_t, trie::EmptyValueReader::ValueType>;
+using TLoudsTrie = trie::LoudsTrie<Uint32ValueReader>;
+
+struct Collector
+{
+  template <typename TString>
+  void operator()(TString const & s, uint32_t value)
+  {
+    m_pairs.push_back(KeyValuePair(vector<trie::TrieChar>(s.begin(), s.end()), value));
+  }
+
+  vector<KeyValuePair> m_pairs;
+};
+
+vector<KeyValuePair> GetRandomPairs(mt19937 & rng, size_t count, uint32_t alphabetSize,
+                                    size_t maxLength)
+{
+  // Chars are taken with geometric distribution, like letters of real words.
+  geometric_distribution<uint32_t> charDist(0.3);
+  uniform_int_distribution<size_t> lengthDist(0, maxLength);
+  uniform_int_distribution<uint32_t> valueDist(0, 50);
+
+  vector<KeyValuePair> pairs;
+  for (size_t i = 0; i < count; ++i)
+  {
+    vector<trie::TrieChar> key(lengthDist(rng));
+    for (auto & c : key)
+      c = 'a' + charDist(rng) % alphabetSize;
+    pairs.push_back(KeyValuePair(key, valueDist(rng)));
+  }
+  sort(pairs.begin(), pairs.end());
+  return pairs;
+}
+
+vector<uint8_t> BuildLouds(vector<KeyValuePair> const & pairs)
+{
+  vector<uint8_t> buffer;
+  MemWriter<vector<uint8_t>> writer(buffer);
+  trie::BuildLoudsTrie<MemWriter<vector<uint8_t>>, vector<KeyValuePair>::const_iterator,
+                       Uint32ValueList>(writer, pairs.begin(), pairs.end());
+  return buffer;
+}
+
+vector<KeyValuePair> CollectAll(TIterator const & root)
+{
+  Collector collector;
+  trie::ForEachRef(root, collector, vector<trie::TrieChar>());
+  sort(collector.m_pairs.begin(), collector.m_pairs.end());
+  return collector.m_pairs;
+}
+}  // namespace
+
+UNIT_TEST(LoudsTrie_Empty)
+{
+  vector<uint8_t> const buffer = BuildLouds(vector<KeyValuePair>());
+  TLoudsTrie const trie(reinterpret_cast<char const *>(buffer.data()), buffer.size(),
+                        Uint32ValueReader());
+  TEST(!trie.IsFinal(trie.GetRoot()), ());
+  TEST_EQUAL(trie.GoToChar(trie.GetRoot(), 'a'), TLoudsTrie::kInvalidNode, ());
+
+  size_t children = 0;
+  trie.ForEachChild(trie.GetRoot(), [&children](trie::TrieChar, TLoudsTrie::TNode) { ++children; });
+  TEST_EQUAL(children, 0, ());
+}
+
+UNIT_TEST(LoudsTrie_Smoke)
+{
+  vector<KeyValuePair> pairs;
+  for (auto const & p : vector<pair<string, uint32_t>>{
+           {"", 7}, {"a", 1}, {"a", 2}, {"aaa", 3}, {"abc", 4}, {"b", 5}, {"bab", 6}})
+  {
+    pairs.push_back(KeyValuePair(vector<trie::TrieChar>(p.first.begin(), p.first.end()), p.second));
+  }
+
+  vector<uint8_t> const buffer = BuildLouds(pairs);
+  TLoudsTrie const trie(reinterpret_cast<char const *>(buffer.data()), buffer.size(),
+                        Uint32ValueReader());
+
+  auto const getValues = [&trie](string const & s)
+  {
+    vector<uint32_t> values;
+    TLoudsTrie::TNode const node = trie.GoToString(trie.GetRoot(), s);
+    if (node != TLoudsTrie::kInvalidNode)
+      trie.ForEachValue(node, [&values](uint32_t value) { values.push_back(value); });
+    return values;
+  };
+
+  TEST_EQUAL(getValues(""), vector<uint32_t>{7}, ());
+  TEST_EQUAL(getValues("a"), vector<uint32_t>({1, 2}), ());
+  TEST_EQUAL(getValues("abc"), vector<uint32_t>{4}, ());
+  TEST_EQUAL(getValues("ab"), vector<uint32_t>(), ());
+  TEST_EQUAL(getValues("abcd"), vector<uint32_t>(), ());
+  TEST_EQUAL(getValues("x"), vector<uint32_t>(), ());
+  TEST(!trie.IsFinal(trie.GoToString(trie.GetRoot(), string("ba"))), ());
+
+  vector<trie::TrieChar> chars;
+  trie.ForEachChild(trie.GetRoot(), [&chars](trie::TrieChar c, TLoudsTrie::TNode) { chars.push_back(c); });
+  sort(chars.begin(), chars.end());
+  TEST_EQUAL(chars, vector<trie::TrieChar>({'a', 'b'}), ());
+}
+
+UNIT_TEST(LoudsTrie_CompareWithTrie)
+{
+  mt19937 rng(0);
+  for (uint32_t alphabetSize : {1, 2, 5, 40})
+  {
+    vector<KeyValuePair> pairs = GetRandomPairs(rng, 3000, alphabetSize, 8);
+    pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+    vector<uint8_t> serial;
+    PushBackByteSink<vector<uint8_t>> sink(serial);
+    trie::Build<PushBackByteSink<vector<uint8_t>>, vector<KeyValuePair>::iterator,
+                trie::EmptyEdgeBuilder, Uint32ValueList>(sink, pairs.begin(), pairs.end(),
+                                                         trie::EmptyEdgeBuilder());
+    reverse(serial.begin(), serial.end());
+    MemReader reader(serial.data(), serial.size());
+    unique_ptr<TIterator> const root(
+        trie::ReadTrie(reader, Uint32ValueReader(), trie::EmptyValueReader()));
+    vector<KeyValuePair> const expected = CollectAll(*root);
+    TEST_EQUAL(expected, pairs, (alphabetSize));
+
+    vector<uint8_t> const buffer = BuildLouds(pairs);
+    auto const trie = make_shared<TLoudsTrie>(reinterpret_cast<char const *>(buffer.data()),
+                                              buffer.size(), Uint32ValueReader());
+    trie::LoudsTrieIterator<Uint32ValueReader, trie::EmptyValueReader> const loudsRoot(
+        trie, trie->GetRoot());
+    TEST_EQUAL(CollectAll(loudsRoot), expected, (alphabetSize));
+
+    for (auto const & p : pairs)
+    {
+      TLoudsTrie::TNode const node = trie->GoToString(trie->GetRoot(), p.m_key);
+      TEST_NOT_EQUAL(node, TLoudsTrie::kInvalidNode, (p));
+      TEST(trie->IsFinal(node), (p));
+      bool found = false;
+      trie->ForEachValue(node, [&](uint32_t value) { found = found || value == p.m_value; });
+      TEST(found, (p));
+    }
+  }
+}
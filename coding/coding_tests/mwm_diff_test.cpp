@@ -0,0 +1,118 @@
+#include "testing/testing.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/mwm_diff.hpp"
+
+#include "coding/internal/file_data.hpp"
+
+#include "base/scope_guard.hpp"
+
+#include "std/random.hpp"
+#include "std/string.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+string const kOldFile = "mwm_diff_old.tmp";
+string const kNewFile = "mwm_diff_new.tmp";
+string const kDiffFile = "mwm_diff.tmp";
+string const kResultFile = "mwm_diff_result.tmp";
+
+using TSections = vector<pair<string, string>>;
+
+string GetRandomBytes(mt19937 & rng, size_t size)
+{
+  uniform_int_distribution<int> dist(0, 255);
+  string bytes(size, 0);
+  for (auto & c : bytes)
+    c = static_cast<char>(dist(rng));
+  return bytes;
+}
+
+void WriteContainer(string const & fileName, TSections const & sections)
+{
+  FilesContainerW writer(fileName);
+  for (auto const & section : sections)
+  {
+    FileWriter w = writer.GetWriter(section.first);
+    w.Write(section.second.data(), section.second.size());
+  }
+}
+
+string ReadFile(string const & fileName)
+{
+  string bytes;
+  FileReader(fileName).ReadAsString(bytes);
+  return bytes;
+}
+
+bool IsFileExist(string const & fileName)
+{
+  uint64_t size;
+  return my::GetFileSize(fileName, size);
+}
+
+void DeleteFiles()
+{
+  for (string const & file : {kOldFile, kNewFile, kDiffFile, kResultFile})
+    FileWriter::DeleteFileX(file);
+}
+}  // namespace
+
+UNIT_TEST(MwmDiff_Smoke)
+{
+  MY_SCOPE_GUARD(deleteFiles, &DeleteFiles);
+
+  mt19937 rng(0);
+  string const geometry = GetRandomBytes(rng, 100000);
+  string const index = GetRandomBytes(rng, 20000);
+
+  // A few features are changed in the middle of the geometry and a section is replaced.
+  string newGeometry = geometry;
+  newGeometry.insert(30000, GetRandomBytes(rng, 100));
+  newGeometry.erase(70000, 50);
+  newGeometry.replace(90000, 20, GetRandomBytes(rng, 20));
+
+  WriteContainer(kOldFile,
+                 {{"geom", geometry}, {"idx", index}, {"search", GetRandomBytes(rng, 5000)}});
+  WriteContainer(kNewFile,
+                 {{"geom", newGeometry}, {"idx", index}, {"meta", GetRandomBytes(rng, 300)}});
+
+  TEST(diff::MakeMwmDiff(kOldFile, kNewFile, kDiffFile), ());
+  // The diff contains changed bytes, the new section and some hundreds bytes of commands.
+  TEST_LESS(FileReader(kDiffFile).Size(), 2000, ());
+
+  TEST(diff::ApplyMwmDiff(kOldFile, kDiffFile, kResultFile), ());
+  TEST_EQUAL(ReadFile(kNewFile), ReadFile(kResultFile), ());
+
+  FilesContainerR const result(kResultFile);
+  TEST(result.IsExist("meta"), ());
+  TEST(!result.IsExist("search"), ());
+}
+
+UNIT_TEST(MwmDiff_WrongOldFile)
+{
+  MY_SCOPE_GUARD(deleteFiles, &DeleteFiles);
+
+  mt19937 rng(0);
+  string const geometry = GetRandomBytes(rng, 10000);
+  string newGeometry = geometry;
+  newGeometry.replace(5000, 10, GetRandomBytes(rng, 10));
+
+  WriteContainer(kOldFile, {{"geom", geometry}});
+  WriteContainer(kNewFile, {{"geom", newGeometry}});
+  TEST(diff::MakeMwmDiff(kOldFile, kNewFile, kDiffFile), ());
+
+  // The old file of the same size, but with other data, gives a wrong result.
+  WriteContainer(kOldFile, {{"geom", GetRandomBytes(rng, geometry.size())}});
+  TEST(!diff::ApplyMwmDiff(kOldFile, kDiffFile, kResultFile), ());
+  TEST(!IsFileExist(kResultFile), ());
+
+  // The old file of another size is rejected.
+  WriteContainer(kOldFile, {{"geom", geometry + "a"}});
+  TEST(!diff::ApplyMwmDiff(kOldFile, kDiffFile, kResultFile), ());
+  TEST(!IsFileExist(kResultFile), ());
+}
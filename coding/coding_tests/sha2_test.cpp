@@ -13,3 +13,17 @@ UNIT_TEST(Sha2_256)
   TEST_EQUAL(sha2::digest256("b", false),
              string(zero, ARRAY_SIZE(zero) - 1), ());
 }
+
+UNIT_TEST(Sha2_256_ByParts)
+{
+  string const data = "Hello, world!";
+  for (size_t split = 0; split <= data.size(); ++split)
+  {
+    sha2::Digest256 digest;
+    digest.Update(data.data(), split);
+    digest.Update(data.data() + split, data.size() - split);
+    TEST_EQUAL(digest.Finish(), sha2::digest256(data), (split));
+  }
+
+  TEST_EQUAL(sha2::Digest256().Finish(), sha2::digest256(""), ());
+}
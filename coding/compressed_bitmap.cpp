@@ -0,0 +1,409 @@
+#include "coding/compressed_bitmap.hpp"
+
+#include "std/utility.hpp"
+
+namespace
+{
+inline bool TestBit(vector<uint64_t> const & bitset, uint16_t low)
+{
+  return ((bitset[low >> 6] >> (low & 63)) & 1) != 0;
+}
+
+inline void SetBit(vector<uint64_t> & bitset, uint16_t low)
+{
+  bitset[low >> 6] |= uint64_t(1) << (low & 63);
+}
+
+inline void ClearBit(vector<uint64_t> & bitset, uint16_t low)
+{
+  bitset[low >> 6] &= ~(uint64_t(1) << (low & 63));
+}
+
+// Returns index of the lowest set bit of a non-zero |word|.
+inline uint32_t LowestBit(uint64_t word)
+{
+  return static_cast<uint32_t>(bits::popcount((word & (~word + 1)) - 1));
+}
+
+uint32_t CountBits(vector<uint64_t> const & bitset)
+{
+  uint64_t count = 0;
+  for (uint64_t word : bitset)
+    count += bits::popcount(word);
+  return static_cast<uint32_t>(count);
+}
+}  // namespace
+
+bool CompressedBitmap::Chunk::Contains(uint16_t low) const
+{
+  if (IsBitset())
+    return TestBit(m_bitset, low);
+  return binary_search(m_array.begin(), m_array.end(), low);
+}
+
+uint32_t CompressedBitmap::Chunk::Rank(uint16_t low) const
+{
+  if (!IsBitset())
+    return static_cast<uint32_t>(lower_bound(m_array.begin(), m_array.end(), low) - m_array.begin());
+
+  uint64_t rank = 0;
+  size_t const word = low >> 6;
+  for (size_t w = 0; w < word; ++w)
+    rank += bits::popcount(m_bitset[w]);
+  rank += bits::popcount(m_bitset[word] & ((uint64_t(1) << (low & 63)) - 1));
+  return static_cast<uint32_t>(rank);
+}
+
+uint16_t CompressedBitmap::Chunk::Select(uint32_t i) const
+{
+  ASSERT_LESS(i, m_count, ());
+  if (!IsBitset())
+    return m_array[i];
+
+  for (size_t w = 0; w < m_bitset.size(); ++w)
+  {
+    uint64_t word = m_bitset[w];
+    uint32_t const count = static_cast<uint32_t>(bits::popcount(word));
+    if (i < count)
+    {
+      for (; i > 0; --i)
+        word &= word - 1;
+      return static_cast<uint16_t>((w << 6) | LowestBit(word));
+    }
+    i -= count;
+  }
+
+  ASSERT(false, ("Chunk has less values than its count."));
+  return 0;
+}
+
+void CompressedBitmap::Chunk::And(Chunk const & rhs)
+{
+  if (IsBitset() && rhs.IsBitset())
+  {
+    for (size_t w = 0; w < m_bitset.size(); ++w)
+      m_bitset[w] &= rhs.m_bitset[w];
+    m_count = CountBits(m_bitset);
+  }
+  else if (IsBitset())
+  {
+    vector<uint16_t> array;
+    for (uint16_t low : rhs.m_array)
+    {
+      if (TestBit(m_bitset, low))
+        array.push_back(low);
+    }
+    m_array.swap(array);
+    vector<uint64_t>().swap(m_bitset);
+    m_count = static_cast<uint32_t>(m_array.size());
+  }
+  else if (rhs.IsBitset())
+  {
+    m_array.erase(remove_if(m_array.begin(), m_array.end(), [&rhs](uint16_t low)
+                  {
+                    return !TestBit(rhs.m_bitset, low);
+                  }), m_array.end());
+    m_count = static_cast<uint32_t>(m_array.size());
+  }
+  else
+  {
+    vector<uint16_t> array;
+    GallopingIntersect(m_array.data(), m_array.size(), rhs.m_array.data(), rhs.m_array.size(),
+                       array);
+    m_array.swap(array);
+    m_count = static_cast<uint32_t>(m_array.size());
+  }
+  Normalize();
+}
+
+void CompressedBitmap::Chunk::Or(Chunk const & rhs)
+{
+  if (IsBitset() && rhs.IsBitset())
+  {
+    for (size_t w = 0; w < m_bitset.size(); ++w)
+      m_bitset[w] |= rhs.m_bitset[w];
+    m_count = CountBits(m_bitset);
+  }
+  else if (IsBitset())
+  {
+    for (uint16_t low : rhs.m_array)
+    {
+      if (!TestBit(m_bitset, low))
+      {
+        SetBit(m_bitset, low);
+        ++m_count;
+      }
+    }
+  }
+  else if (rhs.IsBitset())
+  {
+    vector<uint64_t> bitset(rhs.m_bitset);
+    uint32_t count = rhs.m_count;
+    for (uint16_t low : m_array)
+    {
+      if (!TestBit(bitset, low))
+      {
+        SetBit(bitset, low);
+        ++count;
+      }
+    }
+    m_bitset.swap(bitset);
+    vector<uint16_t>().swap(m_array);
+    m_count = count;
+  }
+  else
+  {
+    vector<uint16_t> array;
+    array.reserve(m_array.size() + rhs.m_array.size());
+    set_union(m_array.begin(), m_array.end(), rhs.m_array.begin(), rhs.m_array.end(),
+              back_inserter(array));
+    m_array.swap(array);
+    m_count = static_cast<uint32_t>(m_array.size());
+  }
+  Normalize();
+}
+
+void CompressedBitmap::Chunk::AndNot(Chunk const & rhs)
+{
+  if (IsBitset() && rhs.IsBitset())
+  {
+    for (size_t w = 0; w < m_bitset.size(); ++w)
+      m_bitset[w] &= ~rhs.m_bitset[w];
+    m_count = CountBits(m_bitset);
+  }
+  else if (IsBitset())
+  {
+    for (uint16_t low : rhs.m_array)
+    {
+      if (TestBit(m_bitset, low))
+      {
+        ClearBit(m_bitset, low);
+        --m_count;
+      }
+    }
+  }
+  else if (rhs.IsBitset())
+  {
+    m_array.erase(remove_if(m_array.begin(), m_array.end(), [&rhs](uint16_t low)
+                  {
+                    return TestBit(rhs.m_bitset, low);
+                  }), m_array.end());
+    m_count = static_cast<uint32_t>(m_array.size());
+  }
+  else
+  {
+    vector<uint16_t> array;
+    set_difference(m_array.begin(), m_array.end(), rhs.m_array.begin(), rhs.m_array.end(),
+                   back_inserter(array));
+    m_array.swap(array);
+    m_count = static_cast<uint32_t>(m_array.size());
+  }
+  Normalize();
+}
+
+void CompressedBitmap::Chunk::Normalize()
+{
+  if (IsBitset() && m_count <= kMaxArraySize)
+  {
+    vector<uint16_t> array;
+    array.reserve(m_count);
+    for (size_t w = 0; w < m_bitset.size(); ++w)
+    {
+      for (uint64_t word = m_bitset[w]; word != 0; word &= word - 1)
+        array.push_back(static_cast<uint16_t>((w << 6) | LowestBit(word)));
+    }
+    m_array.swap(array);
+    vector<uint64_t>().swap(m_bitset);
+  }
+  else if (!IsBitset() && m_count > kMaxArraySize)
+  {
+    m_bitset.assign(kBitsetWords, 0);
+    for (uint16_t low : m_array)
+      SetBit(m_bitset, low);
+    vector<uint16_t>().swap(m_array);
+  }
+}
+
+CompressedBitmap::CompressedBitmap(vector<uint32_t> const & posOnes)
+{
+  for (size_t i = 0; i < posOnes.size(); ++i)
+  {
+    ASSERT(i == 0 || posOnes[i - 1] < posOnes[i], (i, posOnes[i]));
+    uint16_t const key = static_cast<uint16_t>(posOnes[i] >> 16);
+    if (m_keys.empty() || m_keys.back() != key)
+    {
+      m_keys.push_back(key);
+      m_chunks.emplace_back();
+    }
+    m_chunks.back().m_array.push_back(static_cast<uint16_t>(posOnes[i]));
+  }
+
+  for (Chunk & chunk : m_chunks)
+  {
+    chunk.m_count = static_cast<uint32_t>(chunk.m_array.size());
+    chunk.Normalize();
+  }
+  UpdateRanks();
+}
+
+bool CompressedBitmap::Contains(uint32_t pos) const
+{
+  uint16_t const key = static_cast<uint16_t>(pos >> 16);
+  auto const it = lower_bound(m_keys.begin(), m_keys.end(), key);
+  if (it == m_keys.end() || *it != key)
+    return false;
+  return m_chunks[it - m_keys.begin()].Contains(static_cast<uint16_t>(pos));
+}
+
+uint32_t CompressedBitmap::Rank(uint32_t pos) const
+{
+  if (IsEmpty())
+    return 0;
+
+  uint16_t const key = static_cast<uint16_t>(pos >> 16);
+  size_t const i = lower_bound(m_keys.begin(), m_keys.end(), key) - m_keys.begin();
+  if (i == m_keys.size() || m_keys[i] != key)
+    return m_ranks[i];
+  return m_ranks[i] + m_chunks[i].Rank(static_cast<uint16_t>(pos));
+}
+
+uint32_t CompressedBitmap::Select(uint32_t i) const
+{
+  ASSERT_LESS(i, PopCount(), ());
+  // Ranks of chunks strictly increase, because there are no empty chunks.
+  size_t const chunk = upper_bound(m_ranks.begin(), m_ranks.end(), i) - m_ranks.begin() - 1;
+  return (static_cast<uint32_t>(m_keys[chunk]) << 16) | m_chunks[chunk].Select(i - m_ranks[chunk]);
+}
+
+void CompressedBitmap::Intersect(CompressedBitmap const & rhs)
+{
+  vector<uint16_t> keys;
+  vector<Chunk> chunks;
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < m_keys.size() && j < rhs.m_keys.size())
+  {
+    if (m_keys[i] < rhs.m_keys[j])
+    {
+      i = GallopLowerBound(m_keys.data(), i, m_keys.size(), rhs.m_keys[j]);
+    }
+    else if (rhs.m_keys[j] < m_keys[i])
+    {
+      j = GallopLowerBound(rhs.m_keys.data(), j, rhs.m_keys.size(), m_keys[i]);
+    }
+    else
+    {
+      Chunk & chunk = m_chunks[i];
+      chunk.And(rhs.m_chunks[j]);
+      if (chunk.m_count != 0)
+      {
+        keys.push_back(m_keys[i]);
+        chunks.push_back(move(chunk));
+      }
+      ++i;
+      ++j;
+    }
+  }
+
+  m_keys.swap(keys);
+  m_chunks.swap(chunks);
+  UpdateRanks();
+}
+
+void CompressedBitmap::Unite(CompressedBitmap const & rhs)
+{
+  vector<uint16_t> keys;
+  vector<Chunk> chunks;
+  keys.reserve(m_keys.size() + rhs.m_keys.size());
+  chunks.reserve(m_chunks.size() + rhs.m_chunks.size());
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < m_keys.size() || j < rhs.m_keys.size())
+  {
+    if (j == rhs.m_keys.size() || (i < m_keys.size() && m_keys[i] < rhs.m_keys[j]))
+    {
+      keys.push_back(m_keys[i]);
+      chunks.push_back(move(m_chunks[i]));
+      ++i;
+    }
+    else if (i == m_keys.size() || rhs.m_keys[j] < m_keys[i])
+    {
+      keys.push_back(rhs.m_keys[j]);
+      chunks.push_back(rhs.m_chunks[j]);
+      ++j;
+    }
+    else
+    {
+      m_chunks[i].Or(rhs.m_chunks[j]);
+      keys.push_back(m_keys[i]);
+      chunks.push_back(move(m_chunks[i]));
+      ++i;
+      ++j;
+    }
+  }
+
+  m_keys.swap(keys);
+  m_chunks.swap(chunks);
+  UpdateRanks();
+}
+
+void CompressedBitmap::Subtract(CompressedBitmap const & rhs)
+{
+  vector<uint16_t> keys;
+  vector<Chunk> chunks;
+
+  size_t j = 0;
+  for (size_t i = 0; i < m_keys.size(); ++i)
+  {
+    Chunk & chunk = m_chunks[i];
+    j = GallopLowerBound(rhs.m_keys.data(), j, rhs.m_keys.size(), m_keys[i]);
+    if (j < rhs.m_keys.size() && rhs.m_keys[j] == m_keys[i])
+      chunk.AndNot(rhs.m_chunks[j]);
+
+    if (chunk.m_count != 0)
+    {
+      keys.push_back(m_keys[i]);
+      chunks.push_back(move(chunk));
+    }
+  }
+
+  m_keys.swap(keys);
+  m_chunks.swap(chunks);
+  UpdateRanks();
+}
+
+vector<uint32_t> CompressedBitmap::ToVector() const
+{
+  vector<uint32_t> result;
+  result.reserve(PopCount());
+  ForEach([&result](uint32_t pos) { result.push_back(pos); });
+  return result;
+}
+
+bool CompressedBitmap::operator==(CompressedBitmap const & rhs) const
+{
+  // Representation of a chunk depends only on its values.
+  if (m_keys != rhs.m_keys)
+    return false;
+  for (size_t i = 0; i < m_chunks.size(); ++i)
+  {
+    Chunk const & lhsChunk = m_chunks[i];
+    Chunk const & rhsChunk = rhs.m_chunks[i];
+    if (lhsChunk.m_count != rhsChunk.m_count || lhsChunk.m_array != rhsChunk.m_array ||
+        lhsChunk.m_bitset != rhsChunk.m_bitset)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void CompressedBitmap::UpdateRanks()
+{
+  m_ranks.resize(m_chunks.size() + 1);
+  m_ranks[0] = 0;
+  for (size_t i = 0; i < m_chunks.size(); ++i)
+    m_ranks[i + 1] = m_ranks[i] + m_chunks[i].m_count;
+}
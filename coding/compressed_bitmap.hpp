@@ -0,0 +1,231 @@
+// Compressed set of uint32_t values (positions of ones of a bit vector) which supports
+// intersection, union and difference without decoding to plain vectors of positions.
+// Usage:
+//   CompressedBitmap bitmap1(posOnes1), bitmap2(posOnes2);
+//   bitmap1.Intersect(bitmap2);
+//   uint32_t const count = bitmap1.PopCount();
+//   uint32_t const third = bitmap1.Select(2);
+//   bitmap1.ForEach([](uint32_t pos) { ... });
+
+#pragma once
+
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/bits.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstdint.hpp"
+#include "std/iterator.hpp"
+#include "std/vector.hpp"
+
+// Values are split into chunks by high 16 bits (the layout of Roaring bitmaps). A chunk keeps
+// low 16 bits of its values as a sorted array when there are at most kMaxArraySize values,
+// otherwise as a bitset of 2^16 bits. Set operations are done chunk by chunk, so chunks which
+// are present only in one operand are skipped or moved as a whole. Prefix counts of values in
+// chunks are kept for rank and select.
+class CompressedBitmap
+{
+public:
+  // A bitset takes the same memory as an array of this size.
+  static uint32_t const kMaxArraySize = 4096;
+
+  CompressedBitmap() = default;
+
+  // |posOnes| must be strictly increasing.
+  explicit CompressedBitmap(vector<uint32_t> const & posOnes);
+
+  bool IsEmpty() const { return m_chunks.empty(); }
+  uint32_t PopCount() const { return m_ranks.empty() ? 0 : m_ranks.back(); }
+
+  bool Contains(uint32_t pos) const;
+
+  // Returns number of ones at positions less than |pos|.
+  uint32_t Rank(uint32_t pos) const;
+
+  // Returns position of the |i|-th one (0-based), |i| must be less than PopCount().
+  uint32_t Select(uint32_t i) const;
+
+  // In-place set operations, the result is stored in this bitmap.
+  void Intersect(CompressedBitmap const & rhs);
+  void Unite(CompressedBitmap const & rhs);
+  void Subtract(CompressedBitmap const & rhs);
+
+  // Calls |toDo| for positions of ones in increasing order.
+  template <typename ToDo>
+  void ForEach(ToDo && toDo) const
+  {
+    for (size_t i = 0; i < m_chunks.size(); ++i)
+    {
+      uint32_t const high = static_cast<uint32_t>(m_keys[i]) << 16;
+      Chunk const & chunk = m_chunks[i];
+      if (chunk.IsBitset())
+      {
+        for (size_t w = 0; w < chunk.m_bitset.size(); ++w)
+        {
+          for (uint64_t word = chunk.m_bitset[w]; word != 0; word &= word - 1)
+          {
+            uint32_t const bit = static_cast<uint32_t>(bits::popcount((word & (~word + 1)) - 1));
+            toDo(high | static_cast<uint32_t>(w << 6) | bit);
+          }
+        }
+      }
+      else
+      {
+        for (uint16_t low : chunk.m_array)
+          toDo(high | low);
+      }
+    }
+  }
+
+  vector<uint32_t> ToVector() const;
+
+  bool operator==(CompressedBitmap const & rhs) const;
+
+  template <typename TSink>
+  void Write(TSink & sink) const
+  {
+    WriteVarUint(sink, static_cast<uint32_t>(m_chunks.size()));
+    uint32_t prevKey = 0;
+    for (size_t i = 0; i < m_chunks.size(); ++i)
+    {
+      Chunk const & chunk = m_chunks[i];
+      WriteVarUint(sink, m_keys[i] - prevKey);
+      WriteVarUint(sink, chunk.m_count - 1);
+      prevKey = m_keys[i];
+
+      if (chunk.IsBitset())
+      {
+        for (uint64_t word : chunk.m_bitset)
+          WriteToSink(sink, word);
+      }
+      else
+      {
+        uint32_t prev = 0;
+        for (uint16_t low : chunk.m_array)
+        {
+          WriteVarUint(sink, low - prev);
+          prev = low;
+        }
+      }
+    }
+  }
+
+  template <typename TSource>
+  void Read(TSource & src)
+  {
+    uint32_t const count = ReadVarUint<uint32_t>(src);
+    m_keys.resize(count);
+    m_chunks.assign(count, Chunk());
+    uint32_t key = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      Chunk & chunk = m_chunks[i];
+      key += ReadVarUint<uint32_t>(src);
+      m_keys[i] = static_cast<uint16_t>(key);
+      chunk.m_count = ReadVarUint<uint32_t>(src) + 1;
+
+      if (chunk.m_count > kMaxArraySize)
+      {
+        chunk.m_bitset.resize(kBitsetWords);
+        for (uint64_t & word : chunk.m_bitset)
+          word = ReadPrimitiveFromSource<uint64_t>(src);
+      }
+      else
+      {
+        chunk.m_array.resize(chunk.m_count);
+        uint32_t low = 0;
+        for (uint16_t & value : chunk.m_array)
+        {
+          low += ReadVarUint<uint32_t>(src);
+          value = static_cast<uint16_t>(low);
+        }
+      }
+    }
+    UpdateRanks();
+  }
+
+private:
+  static uint32_t const kBitsetWords = (1 << 16) / 64;
+
+  struct Chunk
+  {
+    Chunk() : m_count(0) {}
+
+    bool IsBitset() const { return !m_bitset.empty(); }
+
+    bool Contains(uint16_t low) const;
+    uint32_t Rank(uint16_t low) const;
+    uint16_t Select(uint32_t i) const;
+
+    void And(Chunk const & rhs);
+    void Or(Chunk const & rhs);
+    void AndNot(Chunk const & rhs);
+
+    // Switches between array and bitset representations according to m_count.
+    void Normalize();
+
+    uint32_t m_count;
+    vector<uint16_t> m_array;
+    vector<uint64_t> m_bitset;
+  };
+
+  void UpdateRanks();
+
+  // High 16 bits of values of chunks in increasing order.
+  vector<uint16_t> m_keys;
+  vector<Chunk> m_chunks;
+  // m_ranks[i] is a number of values in chunks before the i-th one,
+  // m_ranks.back() is a number of all values.
+  vector<uint32_t> m_ranks;
+};
+
+// Returns index of the first element of sorted |a| in [begin, size) which is not less than
+// |value|. Search starts with exponentially growing steps from |begin|, so it's fast when
+// the element is close to |begin|.
+template <typename T>
+size_t GallopLowerBound(T const * a, size_t begin, size_t size, T const & value)
+{
+  size_t lo = begin;
+  size_t hi = begin;
+  size_t step = 1;
+  while (hi < size && a[hi] < value)
+  {
+    lo = hi + 1;
+    hi += step;
+    step <<= 1;
+  }
+  return lower_bound(a + lo, a + min(hi, size), value) - a;
+}
+
+// Intersects sorted ranges of unique values. When one range is much smaller than another,
+// values of the smaller range are searched in the larger one by galloping, so the time is
+// O(smaller * log(larger / smaller)) instead of O(smaller + larger).
+template <typename T>
+void GallopingIntersect(T const * a, size_t aSize, T const * b, size_t bSize, vector<T> & result)
+{
+  // Linear merge is faster when sizes are close.
+  size_t const kGallopRatio = 32;
+
+  if (aSize > bSize)
+  {
+    swap(a, b);
+    swap(aSize, bSize);
+  }
+
+  if (aSize * kGallopRatio < bSize)
+  {
+    size_t j = 0;
+    for (size_t i = 0; i < aSize && j < bSize; ++i)
+    {
+      j = GallopLowerBound(b, j, bSize, a[i]);
+      if (j < bSize && b[j] == a[i])
+        result.push_back(a[i]);
+    }
+    return;
+  }
+
+  set_intersection(a, a + aSize, b, b + bSize, back_inserter(result));
+}
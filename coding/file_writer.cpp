@@ -58,6 +58,11 @@ void FileWriter::Flush()
   m_pFileData->Flush();
 }
 
+void FileWriter::Sync()
+{
+  m_pFileData->Sync();
+}
+
 void FileWriter::Reserve(uint64_t size)
 {
   if (size > 0)
@@ -68,6 +73,11 @@ void FileWriter::Reserve(uint64_t size)
   }
 }
 
+bool FileWriter::Preallocate(uint64_t size)
+{
+  return m_pFileData->Preallocate(size);
+}
+
 void FileWriter::DeleteFileX(string const & fName)
 {
   (void)my::DeleteFileX(fName);
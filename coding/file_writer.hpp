@@ -41,8 +41,12 @@ public:
 
   uint64_t Size() const;
   void Flush();
+  /// Flushes and writes the file to the storage device, it's slow.
+  void Sync();
 
   void Reserve(uint64_t size);
+  /// Allocates disk space for the file if it can be done quickly, @see my::FileData::Preallocate.
+  bool Preallocate(uint64_t size);
 
   static void DeleteFileX(string const & fName);
 
@@ -6,6 +6,7 @@
 
 #include "base/exception.hpp"
 #include "base/logging.hpp"
+#include "base/macros.hpp"
 
 #include "std/cerrno.hpp"
 #include "std/cstring.hpp"
@@ -17,6 +18,14 @@
   #include <io.h>
 #endif
 
+#ifdef OMIM_OS_LINUX
+  #include <fcntl.h>
+#endif
+
+#if !defined(OMIM_OS_WINDOWS) && !defined(OMIM_OS_TIZEN)
+  #include <unistd.h>
+#endif
+
 #ifdef OMIM_OS_TIZEN
 #include "tizen/inc/FIo.hpp"
 #endif
@@ -190,6 +199,22 @@ void FileData::Flush()
 #endif
 }
 
+void FileData::Sync()
+{
+  Flush();
+#ifdef OMIM_OS_TIZEN
+  // Flush() writes data to the storage on Tizen.
+#else
+#ifdef OMIM_OS_WINDOWS
+  int const res = _commit(fileno(m_File));
+#else
+  int const res = fsync(fileno(m_File));
+#endif
+  if (res)
+    MYTHROW(Writer::WriteException, (GetErrorProlog()));
+#endif
+}
+
 void FileData::Truncate(uint64_t sz)
 {
 #ifdef OMIM_OS_WINDOWS
@@ -204,6 +229,18 @@ void FileData::Truncate(uint64_t sz)
     MYTHROW(Writer::WriteException, (GetErrorProlog(), sz));
 }
 
+bool FileData::Preallocate(uint64_t sz)
+{
+#ifdef OMIM_OS_LINUX
+  // Extents are allocated without writing zeroes on modern file systems.
+  return posix_fallocate(fileno(m_File), 0, static_cast<off_t>(sz)) == 0;
+#else
+  // Writing of zeroes is too slow on devices.
+  UNUSED_VALUE(sz);
+  return false;
+#endif
+}
+
 bool GetFileSize(string const & fName, uint64_t & sz)
 {
   try
@@ -38,7 +38,12 @@ public:
   void Write(void const * p, size_t size);
 
   void Flush();
+  /// Flushes and writes the file data to the storage device.
+  void Sync();
   void Truncate(uint64_t sz);
+  /// Allocates disk space for the file without writing it, the file size becomes at least sz.
+  /// @return false if the platform can't do it quickly, the file isn't changed then.
+  bool Preallocate(uint64_t sz);
 
   string const & GetName() const { return m_FileName; }
 
@@ -0,0 +1,290 @@
+#pragma once
+
+#include "coding/rank_bit_vector.hpp"
+#include "coding/reader.hpp"
+#include "coding/trie.hpp"
+#include "coding/varint.hpp"
+
+#include "base/assert.hpp"
+#include "base/buffer_vector.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/limits.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+// Trie format (see louds_trie_builder.hpp). Every part starts at an 8-byte aligned position
+// and numbers are stored as little-endian, so the trie is traversed right over memory-mapped
+// data without decoding:
+//   -- Header: nodes count, final nodes count, size of the Huffman encoding and size of values
+//      [uint32_t each].
+//   -- Huffman encoding of chars in the coding::HuffmanCoder::WriteEncoding format.
+//   -- Topology of the binary trie built on Huffman-encoded keys [RankBitVector of 2 * nodes + 1
+//      bits]. It's the LOUDS of a binary tree: the bit 0 stands for the root, the bits 2i + 1
+//      and 2i + 2 tell whether the node i (in level order) has the left (0) and the right (1)
+//      child, so the id of a child is a number of ones before its bit.
+//   -- Final nodes, i.e. nodes where keys end [RankBitVector of nodes bits].
+//   -- Offsets of values of final nodes in level order [uint32_t each, final nodes count + 1].
+//   -- Values of final nodes in level order.
+
+namespace trie
+{
+namespace louds
+{
+uint32_t const kHeaderSize = 4 * sizeof(uint32_t);
+
+inline uint64_t AlignSize(uint64_t size) { return (size + 7) & ~static_cast<uint64_t>(7); }
+}  // namespace louds
+
+// Read-only trie over serialized data. Nodes are addressed by ids which are used as cursors,
+// so the traversal doesn't allocate memory. Data must be 8-byte aligned and must outlive
+// the trie.
+template <typename TValueReader>
+class LoudsTrie
+{
+public:
+  using TValue = typename TValueReader::ValueType;
+  using TNode = uint32_t;
+
+  static TNode const kInvalidNode = numeric_limits<TNode>::max();
+
+  LoudsTrie(char const * data, uint64_t size, TValueReader const & valueReader)
+    : m_valueReader(valueReader)
+  {
+    CHECK_GREATER_OR_EQUAL(size, louds::kHeaderSize, ());
+    uint32_t const * header = reinterpret_cast<uint32_t const *>(data);
+    uint32_t const nodesCount = header[0];
+    uint32_t const finalsCount = header[1];
+    uint32_t const huffmanSize = header[2];
+    uint32_t const valuesSize = header[3];
+
+    char const * p = data + louds::kHeaderSize;
+    ReadHuffmanTree(p, huffmanSize);
+    p += louds::AlignSize(huffmanSize);
+
+    uint64_t const topologySize = 2 * static_cast<uint64_t>(nodesCount) + 1;
+    m_topology.Map(p, topologySize);
+    p += RankBitVector::GetSerializedSize(topologySize);
+
+    m_finals.Map(p, nodesCount);
+    p += RankBitVector::GetSerializedSize(nodesCount);
+
+    m_offsets = reinterpret_cast<uint32_t const *>(p);
+    p += louds::AlignSize((static_cast<uint64_t>(finalsCount) + 1) * sizeof(uint32_t));
+
+    m_values = p;
+    p += valuesSize;
+    CHECK_LESS_OR_EQUAL(static_cast<uint64_t>(p - data), size, ());
+  }
+
+  TNode GetRoot() const { return 0; }
+
+  // Returns a child of |node| by |c| or kInvalidNode if there is no such child.
+  TNode GoToChar(TNode node, TrieChar c) const
+  {
+    auto const it = lower_bound(m_codes.begin(), m_codes.end(), c,
+                                [](CharCode const & code, TrieChar c) { return code.m_char < c; });
+    if (it == m_codes.end() || it->m_char != c)
+      return kInvalidNode;
+
+    for (uint32_t i = 0; i < it->m_len && node != kInvalidNode; ++i)
+      node = GoToBit(node, (it->m_bits >> i) & 1);
+    return node;
+  }
+
+  // Returns a node where |s| ends, if we start from |node|, or kInvalidNode.
+  template <typename TString>
+  TNode GoToString(TNode node, TString const & s) const
+  {
+    for (size_t i = 0; i < s.size() && node != kInvalidNode; ++i)
+      node = GoToChar(node, static_cast<TrieChar>(s[i]));
+    return node;
+  }
+
+  bool IsFinal(TNode node) const { return m_finals[node]; }
+
+  // Calls |toDo(value)| for all values of keys which end in |node|.
+  template <typename ToDo>
+  void ForEachValue(TNode node, ToDo && toDo) const
+  {
+    if (!m_finals[node])
+      return;
+
+    uint64_t const finalIndex = m_finals.Rank1(node);
+    uint32_t const begin = m_offsets[finalIndex];
+    MemReader reader(m_values + begin, m_offsets[finalIndex + 1] - begin);
+    ReaderSource<MemReader> src(reader);
+    while (src.Size() > 0)
+    {
+      TValue value;
+      m_valueReader(src, value);
+      toDo(value);
+    }
+  }
+
+  // Calls |toDo(c, child)| for all children of |node|. Every char is a path in the binary trie,
+  // so the binary trie is walked together with the Huffman tree and a char is reported when
+  // a leaf of the Huffman tree is reached. Children aren't sorted by chars.
+  template <typename ToDo>
+  void ForEachChild(TNode node, ToDo && toDo) const
+  {
+    // Code lengths are at most 32, so the stack doesn't grow beyond its static part.
+    buffer_vector<pair<uint32_t, TNode>, 64> stack;
+    stack.push_back(make_pair(0, node));
+    while (!stack.empty())
+    {
+      uint32_t const huffmanNode = stack.back().first;
+      TNode const trieNode = stack.back().second;
+      stack.pop_back();
+      for (uint32_t bit = 0; bit < 2; ++bit)
+      {
+        uint32_t const huffmanChild = m_huffmanTree[huffmanNode].m_children[bit];
+        if (huffmanChild == kNoChild)
+          continue;
+        TNode const trieChild = GoToBit(trieNode, bit);
+        if (trieChild == kInvalidNode)
+          continue;
+
+        HuffmanNode const & next = m_huffmanTree[huffmanChild];
+        if (next.IsLeaf())
+          toDo(next.m_char, trieChild);
+        else
+          stack.push_back(make_pair(huffmanChild, trieChild));
+      }
+    }
+  }
+
+private:
+  static uint32_t const kNoChild = numeric_limits<uint32_t>::max();
+
+  struct CharCode
+  {
+    TrieChar m_char;
+    uint32_t m_bits;
+    uint32_t m_len;
+  };
+
+  struct HuffmanNode
+  {
+    HuffmanNode() : m_char(0) { m_children[0] = m_children[1] = kNoChild; }
+
+    bool IsLeaf() const { return m_children[0] == kNoChild && m_children[1] == kNoChild; }
+
+    uint32_t m_children[2];
+    TrieChar m_char;
+  };
+
+  TNode GoToBit(TNode node, uint32_t bit) const
+  {
+    uint64_t const pos = 2 * static_cast<uint64_t>(node) + 1 + bit;
+    if (!m_topology[pos])
+      return kInvalidNode;
+    return static_cast<TNode>(m_topology.Rank1(pos));
+  }
+
+  void ReadHuffmanTree(char const * data, uint32_t size)
+  {
+    MemReader reader(data, size);
+    ReaderSource<MemReader> src(reader);
+    uint32_t const count = size == 0 ? 0 : ReadVarUint<uint32_t>(src);
+
+    m_codes.resize(count);
+    m_huffmanTree.assign(1, HuffmanNode());
+    for (CharCode & code : m_codes)
+    {
+      code.m_bits = ReadVarUint<uint32_t>(src);
+      code.m_len = ReadVarUint<uint32_t>(src);
+      code.m_char = ReadVarUint<uint32_t>(src);
+      CHECK_GREATER(code.m_len, 0, ());
+
+      uint32_t cur = 0;
+      for (uint32_t i = 0; i < code.m_len; ++i)
+      {
+        uint32_t const bit = (code.m_bits >> i) & 1;
+        if (m_huffmanTree[cur].m_children[bit] == kNoChild)
+        {
+          m_huffmanTree[cur].m_children[bit] = static_cast<uint32_t>(m_huffmanTree.size());
+          m_huffmanTree.push_back(HuffmanNode());
+        }
+        cur = m_huffmanTree[cur].m_children[bit];
+      }
+      m_huffmanTree[cur].m_char = code.m_char;
+    }
+
+    sort(m_codes.begin(), m_codes.end(),
+         [](CharCode const & lhs, CharCode const & rhs) { return lhs.m_char < rhs.m_char; });
+  }
+
+  TValueReader const m_valueReader;
+
+  // Encoding table sorted by chars and decoding tree, the root is m_huffmanTree[0].
+  vector<CharCode> m_codes;
+  vector<HuffmanNode> m_huffmanTree;
+
+  RankBitVector m_topology;
+  RankBitVector m_finals;
+  uint32_t const * m_offsets;
+  char const * m_values;
+};
+
+template <typename TValueReader>
+typename LoudsTrie<TValueReader>::TNode const LoudsTrie<TValueReader>::kInvalidNode;
+
+template <typename TValueReader>
+uint32_t const LoudsTrie<TValueReader>::kNoChild;
+
+// Adapter for the code which works with trie::Iterator. Every edge is labeled with one char.
+// *NOTE* Iterators hold the trie, so it's alive while at least one iterator is alive.
+template <typename TValueReader, typename TEdgeValueReader>
+class LoudsTrieIterator
+  : public Iterator<typename TValueReader::ValueType, typename TEdgeValueReader::ValueType>
+{
+public:
+  using TTrie = LoudsTrie<TValueReader>;
+  using TBase = Iterator<typename TValueReader::ValueType, typename TEdgeValueReader::ValueType>;
+
+  LoudsTrieIterator(shared_ptr<TTrie const> const & trie, typename TTrie::TNode node)
+    : m_trie(trie), m_node(node)
+  {
+    m_trie->ForEachValue(node, [this](typename TTrie::TValue const & value)
+    {
+      this->m_value.push_back(value);
+    });
+
+    buffer_vector<pair<TrieChar, typename TTrie::TNode>, 8> children;
+    m_trie->ForEachChild(node, [&children](TrieChar c, typename TTrie::TNode child)
+    {
+      children.push_back(make_pair(c, child));
+    });
+    sort(children.begin(), children.end());
+
+    for (auto const & child : children)
+    {
+      typename TBase::Edge edge;
+      edge.m_str.push_back(child.first);
+      edge.m_value = typename TEdgeValueReader::ValueType();
+      this->m_edge.push_back(edge);
+      m_children.push_back(child.second);
+    }
+  }
+
+  // Gives access to the underlying trie, so the code which knows about LOUDS tries can
+  // traverse it without iterators.
+  TTrie const & GetTrie() const { return *m_trie; }
+  typename TTrie::TNode GetNode() const { return m_node; }
+
+  TBase * Clone() const override { return new LoudsTrieIterator(*this); }
+
+  TBase * GoToEdge(size_t i) const override
+  {
+    ASSERT_LESS(i, m_children.size(), ());
+    return new LoudsTrieIterator(m_trie, m_children[i]);
+  }
+
+private:
+  shared_ptr<TTrie const> m_trie;
+  typename TTrie::TNode m_node;
+  buffer_vector<typename TTrie::TNode, 8> m_children;
+};
+}  // namespace trie
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "coding/huffman.hpp"
+#include "coding/louds_trie.hpp"
+#include "coding/rank_bit_vector.hpp"
+#include "coding/writer.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/string_utils.hpp"
+
+#include "std/limits.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace trie
+{
+// Builds a trie in the format described in louds_trie.hpp from entries sorted by keys.
+// Entries with equal keys are merged into one TValueList like trie::Build does.
+template <typename TWriter, typename TIter, typename TValueList>
+void BuildLoudsTrie(TWriter & writer, TIter const beg, TIter const end)
+{
+  using TEntry = typename TIter::value_type;
+  uint32_t const kNone = numeric_limits<uint32_t>::max();
+
+  // Keys are kept in memory because the Huffman encoding is built on all of them. Values of
+  // every key are dumped to |valuesBuf| at once and moved to the level order later.
+  vector<strings::UniString> keys;
+  vector<pair<uint32_t, uint32_t>> valueRanges;
+  vector<uint8_t> valuesBuf;
+  MemWriter<vector<uint8_t>> valuesWriter(valuesBuf);
+
+  TValueList valueList;
+  auto const dumpValues = [&]()
+  {
+    uint32_t const begin = static_cast<uint32_t>(valuesWriter.Pos());
+    valueList.Dump(valuesWriter);
+    valueRanges.push_back(make_pair(begin, static_cast<uint32_t>(valuesWriter.Pos())));
+    valueList = TValueList();
+  };
+
+  TEntry prevEntry;
+  for (TIter it = beg; it != end; ++it)
+  {
+    TEntry entry = *it;
+    if (it != beg && entry == prevEntry)
+      continue;
+
+    TrieChar const * const keyData = entry.GetKeyData();
+    strings::UniString key(keyData, keyData + entry.GetKeySize());
+    if (keys.empty() || key != keys.back())
+    {
+      CHECK(keys.empty() || keys.back() < key, (keys.back(), key));
+      if (!keys.empty())
+        dumpValues();
+      keys.push_back(move(key));
+    }
+    valueList.Append(entry.GetValue());
+    prevEntry.Swap(entry);
+  }
+  if (!keys.empty())
+    dumpValues();
+
+  // A code of the only char would be empty, so a fake char is added to the encoding.
+  bool hasTwoChars = false;
+  TrieChar firstChar = 0;
+  bool hasChars = false;
+  for (size_t i = 0; i < keys.size() && !hasTwoChars; ++i)
+  {
+    for (size_t j = 0; j < keys[i].size() && !hasTwoChars; ++j)
+    {
+      if (!hasChars)
+      {
+        firstChar = keys[i][j];
+        hasChars = true;
+      }
+      hasTwoChars = keys[i][j] != firstChar;
+    }
+  }
+  coding::HuffmanCoder huffman;
+  if (hasChars && !hasTwoChars)
+  {
+    keys.push_back(strings::UniString(1, firstChar + 1));
+    huffman.Init(keys);
+    keys.pop_back();
+  }
+  else
+  {
+    huffman.Init(keys);
+  }
+
+  // Binary trie on Huffman-encoded keys.
+  struct BinaryNode
+  {
+    uint32_t m_children[2];
+    uint32_t m_key;
+  };
+  vector<BinaryNode> nodes(1, BinaryNode{{kNone, kNone}, kNone});
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    uint32_t cur = 0;
+    for (strings::UniChar c : keys[i])
+    {
+      coding::HuffmanCoder::Code code;
+      CHECK(huffman.Encode(static_cast<uint32_t>(c), code), ());
+      for (uint32_t j = 0; j < code.len; ++j)
+      {
+        uint32_t const bit = (code.bits >> j) & 1;
+        if (nodes[cur].m_children[bit] == kNone)
+        {
+          nodes[cur].m_children[bit] = static_cast<uint32_t>(nodes.size());
+          nodes.push_back(BinaryNode{{kNone, kNone}, kNone});
+        }
+        cur = nodes[cur].m_children[bit];
+      }
+    }
+    nodes[cur].m_key = static_cast<uint32_t>(i);
+  }
+
+  vector<uint32_t> levelOrder;
+  levelOrder.reserve(nodes.size());
+  levelOrder.push_back(0);
+  vector<bool> topology(2 * nodes.size() + 1);
+  topology[0] = true;
+  for (size_t i = 0; i < levelOrder.size(); ++i)
+  {
+    BinaryNode const & node = nodes[levelOrder[i]];
+    for (uint32_t bit = 0; bit < 2; ++bit)
+    {
+      if (node.m_children[bit] == kNone)
+        continue;
+      topology[2 * i + 1 + bit] = true;
+      levelOrder.push_back(node.m_children[bit]);
+    }
+  }
+
+  vector<bool> finals(nodes.size());
+  vector<uint32_t> offsets(1, 0);
+  for (size_t i = 0; i < levelOrder.size(); ++i)
+  {
+    uint32_t const key = nodes[levelOrder[i]].m_key;
+    if (key == kNone)
+      continue;
+    finals[i] = true;
+    offsets.push_back(offsets.back() + valueRanges[key].second - valueRanges[key].first);
+  }
+
+  vector<uint8_t> huffmanBuf;
+  {
+    MemWriter<vector<uint8_t>> huffmanWriter(huffmanBuf);
+    huffman.WriteEncoding(huffmanWriter);
+  }
+
+  WriteToSink(writer, static_cast<uint32_t>(nodes.size()));
+  WriteToSink(writer, static_cast<uint32_t>(offsets.size() - 1));
+  WriteToSink(writer, static_cast<uint32_t>(huffmanBuf.size()));
+  WriteToSink(writer, offsets.back());
+
+  writer.Write(huffmanBuf.data(), huffmanBuf.size());
+  WriteZeroesToSink(writer, louds::AlignSize(huffmanBuf.size()) - huffmanBuf.size());
+
+  RankBitVector::Write(writer, topology);
+  RankBitVector::Write(writer, finals);
+
+  for (uint32_t offset : offsets)
+    WriteToSink(writer, offset);
+  if (offsets.size() % 2 != 0)
+    WriteToSink(writer, static_cast<uint32_t>(0));
+
+  for (size_t i = 0; i < levelOrder.size(); ++i)
+  {
+    uint32_t const key = nodes[levelOrder[i]].m_key;
+    if (key != kNone)
+    {
+      writer.Write(valuesBuf.data() + valueRanges[key].first,
+                   valueRanges[key].second - valueRanges[key].first);
+    }
+  }
+}
+}  // namespace trie
@@ -0,0 +1,341 @@
+#include "coding/mwm_diff.hpp"
+
+#include "coding/diff.hpp"
+#include "coding/file_container.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/reader.hpp"
+#include "coding/sha2.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/logging.hpp"
+#include "base/rolling_hash.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstring.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace diff
+{
+namespace
+{
+char const kMagic[] = "mwmdiff";
+size_t const kMagicSize = sizeof(kMagic) - 1;
+uint8_t const kFormatVersion = 0;
+size_t const kHashSize = 32;
+
+uint64_t const kCopy = 0;
+uint64_t const kInsert = 1;
+
+// Size of blocks which are looked for in the old section. Sections are shifted by changed
+// features, so blocks should be small enough to fit between changes.
+size_t const kBlockSize = 64;
+// Bytes to insert are accumulated up to this size before writing a command.
+size_t const kMaxInsertSize = 1 << 20;
+// Size of the buffer for copies and inserts when the diff is applied.
+size_t const kBufferSize = 1 << 16;
+
+struct Section
+{
+  FilesContainerBase::Tag m_tag;
+  uint64_t m_offset;
+  uint64_t m_size;
+};
+
+vector<Section> ReadSections(string const & fileName)
+{
+  FilesContainerR const cont(fileName);
+  vector<Section> sections;
+  cont.ForEachTag([&](FilesContainerBase::Tag const & tag)
+  {
+    auto const p = cont.GetAbsoluteOffsetAndSize(tag);
+    sections.push_back({tag, p.first, p.second});
+  });
+  return sections;
+}
+
+// Writes commands, adjacent copies and inserts are merged.
+class DiffWriter
+{
+public:
+  explicit DiffWriter(Writer & writer)
+    : m_writer(writer), m_copyEnd(0), m_copyOffset(0), m_copySize(0)
+  {
+  }
+
+  void Copy(uint64_t offset, uint64_t size)
+  {
+    if (size == 0)
+      return;
+    FlushInsert();
+    if (m_copySize != 0 && m_copyOffset + m_copySize == offset)
+    {
+      m_copySize += size;
+      return;
+    }
+    FlushCopy();
+    m_copyOffset = offset;
+    m_copySize = size;
+  }
+
+  void Insert(char const * data, uint64_t size)
+  {
+    FlushCopy();
+    m_insert.insert(m_insert.end(), data, data + size);
+    if (m_insert.size() >= kMaxInsertSize)
+      FlushInsert();
+  }
+
+  void Finish()
+  {
+    FlushCopy();
+    FlushInsert();
+  }
+
+private:
+  void FlushCopy()
+  {
+    if (m_copySize == 0)
+      return;
+    WriteVarUint(m_writer, (m_copySize << 1) | kCopy);
+    WriteVarInt(m_writer, static_cast<int64_t>(m_copyOffset - m_copyEnd));
+    m_copyEnd = m_copyOffset + m_copySize;
+    m_copySize = 0;
+  }
+
+  void FlushInsert()
+  {
+    if (m_insert.empty())
+      return;
+    WriteVarUint(m_writer, (static_cast<uint64_t>(m_insert.size()) << 1) | kInsert);
+    m_writer.Write(m_insert.data(), m_insert.size());
+    m_insert.clear();
+  }
+
+  Writer & m_writer;
+  uint64_t m_copyEnd;
+  uint64_t m_copyOffset;
+  uint64_t m_copySize;
+  vector<char> m_insert;
+};
+
+// Adapter of DiffWriter for differs from diff.hpp, which describe the new section as operations
+// over the old one.
+class SectionPatchCoder
+{
+public:
+  using size_type = uint64_t;
+
+  SectionPatchCoder(DiffWriter & writer, uint64_t oldOffset)
+    : m_writer(writer), m_oldPos(oldOffset)
+  {
+  }
+
+  void Copy(size_type n)
+  {
+    m_writer.Copy(m_oldPos, n);
+    m_oldPos += n;
+  }
+
+  void Delete(size_type n) { m_oldPos += n; }
+
+  template <typename TIter>
+  void Insert(TIter it, size_type n)
+  {
+    if (n != 0)
+      m_writer.Insert(&*it, n);
+  }
+
+private:
+  DiffWriter & m_writer;
+  uint64_t m_oldPos;
+};
+
+void ReadBytes(FileReader const & reader, uint64_t offset, uint64_t size, vector<char> & bytes)
+{
+  bytes.resize(size);
+  if (size != 0)
+    reader.Read(offset, bytes.data(), size);
+}
+
+void InsertFromFile(FileReader const & reader, uint64_t offset, uint64_t size, DiffWriter & writer)
+{
+  vector<char> buffer;
+  while (size != 0)
+  {
+    uint64_t const part = min(size, static_cast<uint64_t>(kMaxInsertSize));
+    ReadBytes(reader, offset, part, buffer);
+    writer.Insert(buffer.data(), part);
+    offset += part;
+    size -= part;
+  }
+}
+}  // namespace
+
+bool MakeMwmDiff(string const & oldFile, string const & newFile, string const & diffFile)
+{
+  try
+  {
+    vector<Section> const oldSections = ReadSections(oldFile);
+    vector<Section> newSections = ReadSections(newFile);
+    sort(newSections.begin(), newSections.end(), [](Section const & lhs, Section const & rhs)
+    {
+      return lhs.m_offset < rhs.m_offset;
+    });
+
+    FileReader const oldReader(oldFile);
+    FileReader const newReader(newFile);
+
+    // The hash of the new file is known after it's read, so it's calculated in advance.
+    sha2::Digest256 digest;
+    {
+      vector<char> buffer;
+      for (uint64_t pos = 0; pos < newReader.Size(); pos += buffer.size())
+      {
+        ReadBytes(newReader, pos, min(newReader.Size() - pos, static_cast<uint64_t>(kBufferSize)),
+                  buffer);
+        digest.Update(buffer.data(), buffer.size());
+      }
+    }
+    string const hash = digest.Finish(false /* returnAsHexString */);
+    CHECK_EQUAL(hash.size(), kHashSize, ());
+
+    FileWriter writer(diffFile);
+    writer.Write(kMagic, kMagicSize);
+    WriteToSink(writer, kFormatVersion);
+    WriteVarUint(writer, oldReader.Size());
+    WriteVarUint(writer, newReader.Size());
+    writer.Write(hash.data(), hash.size());
+
+    DiffWriter diffWriter(writer);
+    vector<char> oldBytes;
+    vector<char> newBytes;
+    uint64_t pos = 0;
+    for (Section const & section : newSections)
+    {
+      uint64_t const end = section.m_offset + section.m_size;
+      if (end <= pos)
+        continue;
+      if (section.m_offset > pos)
+        InsertFromFile(newReader, pos, section.m_offset - pos, diffWriter);
+      uint64_t const begin = max(pos, section.m_offset);
+      pos = end;
+
+      auto const it = find_if(oldSections.begin(), oldSections.end(),
+                              [&section](Section const & s) { return s.m_tag == section.m_tag; });
+      if (it == oldSections.end())
+      {
+        InsertFromFile(newReader, begin, end - begin, diffWriter);
+        continue;
+      }
+
+      ReadBytes(oldReader, it->m_offset, it->m_size, oldBytes);
+      ReadBytes(newReader, begin, end - begin, newBytes);
+      if (oldBytes == newBytes)
+      {
+        diffWriter.Copy(it->m_offset, it->m_size);
+        continue;
+      }
+
+      SectionPatchCoder coder(diffWriter, it->m_offset);
+      RollingHashDiffer<SimpleReplaceDiffer, RollingHasher64> differ(kBlockSize);
+      differ.Diff(oldBytes.cbegin(), oldBytes.cend(), newBytes.cbegin(), newBytes.cend(), coder);
+    }
+    if (pos < newReader.Size())
+      InsertFromFile(newReader, pos, newReader.Size() - pos, diffWriter);
+    diffWriter.Finish();
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("Can't make diff between", oldFile, "and", newFile, e.Msg()));
+    FileWriter::DeleteFileX(diffFile);
+    return false;
+  }
+  return true;
+}
+
+bool ApplyMwmDiff(string const & oldFile, string const & diffFile, string const & newFile)
+{
+  try
+  {
+    FileReader const oldReader(oldFile);
+    FileReader const diffReader(diffFile);
+    ReaderSource<FileReader> src(diffReader);
+
+    char magic[kMagicSize];
+    src.Read(magic, kMagicSize);
+    if (memcmp(magic, kMagic, kMagicSize) != 0 ||
+        ReadPrimitiveFromSource<uint8_t>(src) != kFormatVersion)
+    {
+      LOG(LWARNING, ("Unknown diff format", diffFile));
+      return false;
+    }
+    uint64_t const oldSize = ReadVarUint<uint64_t>(src);
+    uint64_t const newSize = ReadVarUint<uint64_t>(src);
+    string hash(kHashSize, 0);
+    src.Read(&hash[0], kHashSize);
+    if (oldSize != oldReader.Size())
+    {
+      LOG(LWARNING, ("Diff", diffFile, "is made for another version of", oldFile));
+      return false;
+    }
+
+    bool ok = true;
+    {
+      FileWriter writer(newFile);
+      writer.Preallocate(newSize);
+
+      sha2::Digest256 digest;
+      vector<char> buffer(kBufferSize);
+      uint64_t written = 0;
+      uint64_t copyEnd = 0;
+      while (ok && src.Size() > 0)
+      {
+        uint64_t const command = ReadVarUint<uint64_t>(src);
+        uint64_t size = command >> 1;
+        uint64_t offset = 0;
+        if ((command & 1) == kCopy)
+        {
+          offset = copyEnd + ReadVarInt<int64_t>(src);
+          copyEnd = offset + size;
+          if (copyEnd > oldSize || copyEnd < offset)
+            ok = false;
+        }
+        if (written + size > newSize || written + size < written)
+          ok = false;
+
+        while (ok && size != 0)
+        {
+          size_t const part = static_cast<size_t>(min(size, static_cast<uint64_t>(buffer.size())));
+          if ((command & 1) == kCopy)
+            oldReader.Read(offset, buffer.data(), part);
+          else
+            src.Read(buffer.data(), part);
+          writer.Write(buffer.data(), part);
+          digest.Update(buffer.data(), part);
+          offset += part;
+          size -= part;
+          written += part;
+        }
+      }
+      ok = ok && written == newSize && digest.Finish(false /* returnAsHexString */) == hash;
+    }
+
+    if (!ok)
+    {
+      LOG(LWARNING, ("Diff", diffFile, "is corrupted or doesn't match", oldFile));
+      FileWriter::DeleteFileX(newFile);
+    }
+    return ok;
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Can't apply diff", diffFile, "to", oldFile, e.Msg()));
+    FileWriter::DeleteFileX(newFile);
+    return false;
+  }
+}
+}  // namespace diff
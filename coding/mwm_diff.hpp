@@ -0,0 +1,26 @@
+#pragma once
+
+#include "std/string.hpp"
+
+// Delta between two versions of a files container (mwm or routing file).
+// Format:
+//   -- Header: magic "mwmdiff" [7 bytes], format version [uint8_t], sizes of the old and the new
+//      files [varuint each], SHA-256 of the new file [32 bytes].
+//   -- Commands till the end of the diff, each starts with varuint (size << 1) | op:
+//      kCopy - copy |size| bytes from the old file, the offset follows as a varint delta from
+//              the end of the previous copy;
+//      kInsert - |size| bytes of the new file follow.
+namespace diff
+{
+// Makes a diff which transforms |oldFile| into |newFile|. Sections of the new container are
+// diffed against sections of the old container with the same tags, all other bytes (header,
+// table of sections, sections which are absent in the old container) are stored as is.
+// *NOTE* Pairs of sections are loaded to memory, so it's a function for the generator.
+bool MakeMwmDiff(string const & oldFile, string const & newFile, string const & diffFile);
+
+// Writes the result of applying |diffFile| to |oldFile| into |newFile|. Files are streamed
+// with a fixed buffer, so memory usage doesn't depend on sizes of files.
+// Returns false and deletes |newFile| when the diff is made for another old file, or when the
+// result doesn't match the hash.
+bool ApplyMwmDiff(string const & oldFile, string const & diffFile, string const & newFile);
+}  // namespace diff
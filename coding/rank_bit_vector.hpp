@@ -0,0 +1,102 @@
+#pragma once
+
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/bits.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+// Read-only bit vector over serialized (usually memory-mapped) data which supports
+// constant-time rank queries and doesn't allocate memory.
+//
+// Serialized layout (little-endian, starts at 8-byte aligned position):
+//   -- ceil(size / 64) uint64_t words, bit i is (words[i / 64] >> (i % 64)) & 1;
+//   -- ceil(words / kBlockWords) + 1 uint32_t ranks, ranks[b] is a number of ones in blocks
+//      before the block b;
+//   -- zero padding to 8 bytes.
+class RankBitVector
+{
+public:
+  static uint64_t const kBlockWords = 8;
+  static uint64_t const kBlockBits = kBlockWords * 64;
+
+  RankBitVector() : m_words(nullptr), m_ranks(nullptr), m_size(0) {}
+
+  // Returns a number of bytes which a serialized bit vector of |size| bits takes.
+  static uint64_t GetSerializedSize(uint64_t size)
+  {
+    uint64_t const words = GetWordsCount(size);
+    uint64_t const ranksBytes = (GetBlocksCount(words) + 1) * sizeof(uint32_t);
+    return words * sizeof(uint64_t) + ((ranksBytes + 7) & ~static_cast<uint64_t>(7));
+  }
+
+  template <typename TWriter>
+  static void Write(TWriter & writer, vector<bool> const & bits)
+  {
+    uint64_t const words = GetWordsCount(bits.size());
+    uint32_t rank = 0;
+    vector<uint32_t> ranks;
+    ranks.reserve(GetBlocksCount(words) + 1);
+    for (uint64_t w = 0; w < words; ++w)
+    {
+      if (w % kBlockWords == 0)
+        ranks.push_back(rank);
+
+      uint64_t word = 0;
+      for (uint64_t i = w * 64; i < min(static_cast<uint64_t>(bits.size()), (w + 1) * 64); ++i)
+      {
+        if (bits[i])
+          word |= static_cast<uint64_t>(1) << (i % 64);
+      }
+      WriteToSink(writer, word);
+      rank += static_cast<uint32_t>(bits::popcount(word));
+    }
+    ranks.push_back(rank);
+
+    for (uint32_t r : ranks)
+      WriteToSink(writer, r);
+    if (ranks.size() % 2 != 0)
+      WriteToSink(writer, static_cast<uint32_t>(0));
+  }
+
+  // |data| must be 8-byte aligned and must outlive this instance.
+  void Map(char const * data, uint64_t size)
+  {
+    ASSERT_EQUAL(reinterpret_cast<uintptr_t>(data) % sizeof(uint64_t), 0, ());
+    m_size = size;
+    m_words = reinterpret_cast<uint64_t const *>(data);
+    m_ranks = reinterpret_cast<uint32_t const *>(data + GetWordsCount(size) * sizeof(uint64_t));
+  }
+
+  uint64_t Size() const { return m_size; }
+
+  bool operator[](uint64_t i) const
+  {
+    ASSERT_LESS(i, m_size, ());
+    return ((m_words[i >> 6] >> (i & 63)) & 1) != 0;
+  }
+
+  // Returns a number of ones at positions less than |i|.
+  uint64_t Rank1(uint64_t i) const
+  {
+    ASSERT_LESS_OR_EQUAL(i, m_size, ());
+    uint64_t const lastWord = i >> 6;
+    uint64_t rank = m_ranks[i / kBlockBits];
+    for (uint64_t w = (i / kBlockBits) * kBlockWords; w < lastWord; ++w)
+      rank += bits::popcount(m_words[w]);
+    if ((i & 63) != 0)
+      rank += bits::popcount(m_words[lastWord] & ((static_cast<uint64_t>(1) << (i & 63)) - 1));
+    return rank;
+  }
+
+private:
+  static uint64_t GetWordsCount(uint64_t size) { return (size + 63) / 64; }
+  static uint64_t GetBlocksCount(uint64_t words) { return (words + kBlockWords - 1) / kBlockWords; }
+
+  uint64_t const * m_words;
+  uint32_t const * m_ranks;
+  uint64_t m_size;
+};
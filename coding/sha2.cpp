@@ -1,6 +1,7 @@
 #include "coding/sha2.hpp"
 #include "coding/hex.hpp"
 
+#include "base/assert.hpp"
 #include "base/macros.hpp"
 
 #include "3party/tomcrypt/src/headers/tomcrypt.h"
@@ -22,4 +23,32 @@ namespace sha2
     }
     return string();
   }
+
+  struct Digest256::State
+  {
+    hash_state m_md;
+  };
+
+  Digest256::Digest256() : m_state(new State())
+  {
+    VERIFY(CRYPT_OK == sha256_init(&m_state->m_md), ());
+  }
+
+  Digest256::~Digest256()
+  {
+  }
+
+  void Digest256::Update(void const * data, size_t dataSize)
+  {
+    VERIFY(CRYPT_OK == sha256_process(&m_state->m_md, static_cast<unsigned char const *>(data),
+                                      dataSize), ());
+  }
+
+  string Digest256::Finish(bool returnAsHexString)
+  {
+    unsigned char out[256/8] = { 0 };
+    VERIFY(CRYPT_OK == sha256_done(&m_state->m_md, out), ());
+    string const digest(reinterpret_cast<char const *>(out), ARRAY_SIZE(out));
+    return returnAsHexString ? ToHex(digest) : digest;
+  }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "std/string.hpp"
+#include "std/unique_ptr.hpp"
 
 namespace sha2
 {
@@ -27,4 +28,20 @@ namespace sha2
   {
     return digest512(data.c_str(), data.size(), returnAsHexString);
   }
+
+  /// Calculates SHA-256 of data which comes by parts, e.g. while a file is downloaded.
+  class Digest256
+  {
+  public:
+    Digest256();
+    ~Digest256();
+
+    void Update(void const * data, size_t dataSize);
+    /// @return Digest of all data passed to Update(). Can be called only once.
+    string Finish(bool returnAsHexString = true);
+
+  private:
+    struct State;
+    unique_ptr<State> m_state;
+  };
 }
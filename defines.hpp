@@ -34,10 +34,14 @@
 
 #define ROUTING_FTSEG_FILE_TAG  "ftseg"
 #define ROUTING_NODEIND_TO_FTSEGIND_FILE_TAG  "node2ftseg"
+#define ROUTING_FTSEG_STARTS_FILE_TAG "ftsegstarts"
+#define ROUTING_FTSEG_BACKWARD_FILE_TAG "ftsegbackward"
+#define ROUTING_SPEED_PROFILES_FILE_TAG "speedprofiles"
 
 #define READY_FILE_EXTENSION ".ready"
 #define RESUME_FILE_EXTENSION ".resume"
 #define DOWNLOADING_FILE_EXTENSION ".downloading"
+#define DIFF_FILE_EXTENSION ".mwmdiff"
 #define BOOKMARKS_FILE_EXTENSION ".kml"
 #define ROUTING_FILE_EXTENSION ".routing"
 
@@ -56,6 +60,7 @@
 
 #define PACKED_POLYGONS_FILE "packed_polygons.bin"
 #define PACKED_POLYGONS_INFO_TAG "info"
+#define PACKED_POLYGONS_GRID_TAG "grid"
 
 #define EXTERNAL_RESOURCES_FILE "external_resources.txt"
 
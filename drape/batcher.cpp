@@ -139,6 +139,26 @@ void Batcher::InsertListOfStrip(GLState const & state, RefPointer<AttributeProvi
   InsertTriangles<TriangleListOfStripBatch>(state, params, handle, vertexStride);
 }
 
+void * Batcher::ReserveTriangleList(GLState const & state, BindingInfo const & info, uint32_t vertexCount)
+{
+  return ReserveTriangles(state, info, vertexCount, vertexCount,
+                          [](uint16_t * indexStorage, uint16_t count, uint16_t startIndex)
+  {
+    GenerateListIndexes(indexStorage, count, startIndex);
+  });
+}
+
+void * Batcher::ReserveListOfStrip(GLState const & state, BindingInfo const & info, uint32_t vertexCount,
+                                   uint8_t vertexStride)
+{
+  uint32_t const indexCount = GetListOfStripIndexCount(vertexCount, vertexStride);
+  return ReserveTriangles(state, info, vertexCount, indexCount,
+                          [vertexStride](uint16_t * indexStorage, uint16_t count, uint16_t startIndex)
+  {
+    GenerateListOfStripIndexes(indexStorage, count, startIndex, vertexStride);
+  });
+}
+
 void Batcher::StartSession(flush_fn const & flusher)
 {
   m_flushInterface = flusher;
@@ -174,6 +194,18 @@ RefPointer<RenderBucket> Batcher::GetBucket(GLState const & state)
   return buffer.GetRefPointer();
 }
 
+RefPointer<RenderBucket> Batcher::GetNotFilledBucket(GLState const & state)
+{
+  // Reserved vertexes can fill the buffer up, but it can't be finalized until they are written.
+  RefPointer<RenderBucket> bucket = GetBucket(state);
+  if (bucket->GetBuffer()->IsFilled())
+  {
+    FinalizeBucket(state);
+    bucket = GetBucket(state);
+  }
+  return bucket;
+}
+
 void Batcher::FinalizeBucket(GLState const & state)
 {
   ASSERT(m_buckets.find(state) != m_buckets.end(), ("Have no bucket for finalize with given state"));
@@ -201,7 +233,7 @@ void Batcher::InsertTriangles(GLState const & state,
                               TransferPointer<OverlayHandle> transferHandle,
                               uint8_t vertexStride)
 {
-  RefPointer<RenderBucket> bucket = GetBucket(state);
+  RefPointer<RenderBucket> bucket = GetNotFilledBucket(state);
   RefPointer<VertexArrayBuffer> vao = bucket->GetBuffer();
 
   MasterPointer<OverlayHandle> handle(transferHandle);
@@ -228,4 +260,27 @@ void Batcher::InsertTriangles(GLState const & state,
     bucket->AddOverlayHandle(handle.Move());
 }
 
+template <typename TGenerateIndexesFn>
+void * Batcher::ReserveTriangles(GLState const & state, BindingInfo const & info,
+                                 uint32_t vertexCount, uint32_t indexCount,
+                                 TGenerateIndexesFn const & generateIndexes)
+{
+  ASSERT(!info.IsDynamic(), ("Dynamic attributes are mutated by overlay handles, use Insert* for them"));
+  if (vertexCount == 0 || vertexCount > m_vertexBufferSize || indexCount > m_indexBufferSize)
+    return NULL;
+
+  RefPointer<VertexArrayBuffer> vao = GetNotFilledBucket(state)->GetBuffer();
+  if (vao->GetAvailableVertexCount() < vertexCount || vao->GetAvailableIndexCount() < indexCount)
+  {
+    FinalizeBucket(state);
+    vao = GetBucket(state)->GetBuffer();
+  }
+
+  m_indexStorage.resize(indexCount);
+  generateIndexes(m_indexStorage.data(), indexCount, vao->GetStartIndexValue());
+  vao->UploadIndexes(m_indexStorage.data(), indexCount);
+
+  return vao->ReserveData(info, vertexCount);
+}
+
 } // namespace dp
@@ -8,6 +8,7 @@
 
 #include "std/map.hpp"
 #include "std/function.hpp"
+#include "std/vector.hpp"
 
 namespace dp
 {
@@ -38,6 +39,16 @@ public:
   void InsertListOfStrip(GLState const & state, RefPointer<AttributeProvider> params,
                          TransferPointer<OverlayHandle> handle, uint8_t vertexStride);
 
+  ///{@
+  /// Reserve memory for vertexCount vertexes of one stream right in the vertex buffer of the state's
+  /// bucket, so a shape writes its vertexes in place instead of a temporary array. Indexes are
+  /// generated at once. The memory must be filled before the next call of the batcher.
+  /// @return NULL if there are no vertexes or they don't fit into one vertex buffer.
+  /// Insert* must be used then.
+  void * ReserveTriangleList(GLState const & state, BindingInfo const & info, uint32_t vertexCount);
+  void * ReserveListOfStrip(GLState const & state, BindingInfo const & info, uint32_t vertexCount,
+                            uint8_t vertexStride);
+  ///@}
 
   typedef function<void (GLState const &, TransferPointer<RenderBucket> )> flush_fn;
   void StartSession(flush_fn const & flusher);
@@ -51,6 +62,13 @@ private:
                        TransferPointer<OverlayHandle> handle,
                        uint8_t vertexStride = 0);
 
+  template <typename TGenerateIndexesFn>
+  void * ReserveTriangles(GLState const & state, BindingInfo const & info,
+                          uint32_t vertexCount, uint32_t indexCount,
+                          TGenerateIndexesFn const & generateIndexes);
+
+  RefPointer<RenderBucket> GetNotFilledBucket(GLState const & state);
+
   class CallbacksWrapper;
   void ChangeBuffer(RefPointer<CallbacksWrapper> wrapper, bool checkFilledBuffer);
   RefPointer<RenderBucket> GetBucket(GLState const & state);
@@ -67,6 +85,8 @@ private:
 
   uint32_t m_indexBufferSize;
   uint32_t m_vertexBufferSize;
+
+  vector<uint16_t> m_indexStorage;
 };
 
 class BatcherFactory
@@ -92,6 +92,25 @@ private:
 
 } // namespace
 
+void GenerateListIndexes(uint16_t * indexStorage, uint16_t count, uint16_t startIndex)
+{
+  generate(indexStorage, indexStorage + count, ListIndexGenerator(startIndex));
+}
+
+void GenerateListOfStripIndexes(uint16_t * indexStorage, uint16_t count, uint16_t startIndex,
+                                uint8_t vertexStride)
+{
+  uint16_t const indexPerStrip = GetListOfStripIndexCount(vertexStride, vertexStride);
+  generate(indexStorage, indexStorage + count, ListOfStriptGenerator(startIndex, vertexStride, indexPerStrip));
+}
+
+uint32_t GetListOfStripIndexCount(uint32_t vertexCount, uint8_t vertexStride)
+{
+  ASSERT_GREATER_OR_EQUAL(vertexStride, 4, ());
+  ASSERT_EQUAL(vertexCount % vertexStride, 0, ());
+  return (vertexCount / vertexStride) * 3 * (vertexStride - 2);
+}
+
 TriangleBatch::TriangleBatch(BatchCallbacks const & callbacks)
   : m_callbacks(callbacks)
   , m_canDevideStreams(true)
@@ -188,7 +207,7 @@ void TriangleListBatch::BatchData(RefPointer<AttributeProvider> streams)
 
     uint16_t startIndex = 0;
     uint16_t * pIndexStorage = GetIndexStorage(vertexCount, startIndex);
-    generate(pIndexStorage, pIndexStorage + vertexCount, ListIndexGenerator(startIndex));
+    GenerateListIndexes(pIndexStorage, vertexCount, startIndex);
     SubmitIndex();
 
     FlushData(streams, vertexCount);
@@ -451,8 +470,7 @@ uint16_t TriangleListOfStripBatch::AlignVCount(uint16_t vCount) const
 
 void TriangleListOfStripBatch::GenerateIndexes(uint16_t * indexStorage, uint16_t count, uint16_t startIndex) const
 {
-  uint8_t const vertexStride = GetVertexStride();
-  generate(indexStorage, indexStorage + count, ListOfStriptGenerator(startIndex, vertexStride, VtoICount(vertexStride)));
+  GenerateListOfStripIndexes(indexStorage, count, startIndex, GetVertexStride());
 }
 
 } // namespace dp
@@ -27,6 +27,13 @@ public:
   ChangeBufferFn     m_changeBuffer;
 };
 
+/// Index generators for vertexes which are written right into the buffer (see Batcher::Reserve*).
+void GenerateListIndexes(uint16_t * indexStorage, uint16_t count, uint16_t startIndex);
+void GenerateListOfStripIndexes(uint16_t * indexStorage, uint16_t count, uint16_t startIndex,
+                                uint8_t vertexStride);
+/// @return Count of indexes for vertexCount vertexes of a list of strips.
+uint32_t GetListOfStripIndexCount(uint32_t vertexCount, uint8_t vertexStride);
+
 class TriangleBatch
 {
 public:
@@ -1,11 +1,70 @@
 #include "drape/data_buffer.hpp"
+#include "drape/glfunctions.hpp"
+
+#include "base/assert.hpp"
+#include "base/math.hpp"
+#include "base/shared_buffer_manager.hpp"
+
+#include "std/cstring.hpp"
 
 namespace dp
 {
 
 DataBuffer::DataBuffer(uint8_t elementSize, uint16_t capacity)
   : GPUBuffer(GPUBuffer::ElementBuffer, elementSize, capacity)
+  , m_gpuSize(0)
+{
+}
+
+DataBuffer::~DataBuffer()
+{
+  FreeCpuMemory();
+}
+
+void DataBuffer::UploadData(void const * data, uint16_t elementCount)
+{
+  memcpy(Reserve(elementCount), data, elementCount * GetElementSize());
+}
+
+void * DataBuffer::Reserve(uint16_t elementCount)
+{
+  if (m_cpuMemory == nullptr)
+  {
+    uint32_t const memorySize = my::NextPowOf2(GetCapacity() * GetElementSize());
+    m_cpuMemory = SharedBufferManager::instance().reserveSharedBuffer(memorySize);
+  }
+
+  uint32_t const byteOffset = (GetCurrentSize() - m_gpuSize) * static_cast<uint32_t>(GetElementSize());
+  BufferBase::UploadData(elementCount);
+  ASSERT_LESS_OR_EQUAL(byteOffset + elementCount * GetElementSize(), m_cpuMemory->size(), ());
+  return &(*m_cpuMemory)[byteOffset];
+}
+
+void DataBuffer::Flush()
 {
+  if (m_cpuMemory == nullptr)
+    return;
+
+  uint16_t const elementCount = GetCurrentSize() - m_gpuSize;
+  if (elementCount > 0)
+  {
+    uint8_t const elementSize = GetElementSize();
+    Bind();
+    GLFunctions::glBufferSubData(gl_const::GLArrayBuffer, elementCount * elementSize,
+                                 &(*m_cpuMemory)[0], m_gpuSize * elementSize);
+  }
+
+  m_gpuSize = GetCurrentSize();
+  FreeCpuMemory();
 }
 
+void DataBuffer::FreeCpuMemory()
+{
+  if (m_cpuMemory == nullptr)
+    return;
+
+  SharedBufferManager::instance().freeSharedBuffer(m_cpuMemory->size(), m_cpuMemory);
+  m_cpuMemory.reset();
 }
+
+} // namespace dp
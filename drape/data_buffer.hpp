@@ -2,14 +2,33 @@
 
 #include "drape/gpu_buffer.hpp"
 
+#include "std/shared_ptr.hpp"
+#include "std/vector.hpp"
+
 namespace dp
 {
 
+/// Vertex data is collected in CPU memory while the buffer is filled on the reading thread
+/// and is moved to GPU by one call in Flush.
 class DataBuffer : public GPUBuffer
 {
 public:
   DataBuffer(uint8_t elementSize, uint16_t capacity);
+  ~DataBuffer();
+
+  void UploadData(void const * data, uint16_t elementCount);
+  /// @return Memory for elementCount elements at the end of the buffer.
+  /// It must be filled before Flush.
+  void * Reserve(uint16_t elementCount);
+  /// Moves collected data to GPU.
+  void Flush();
+
+private:
+  void FreeCpuMemory();
+
+  shared_ptr<vector<unsigned char> > m_cpuMemory;
+  /// Count of elements which are already moved to GPU.
+  uint16_t m_gpuSize;
 };
 
 } // namespace dp
-
@@ -385,3 +385,100 @@ UNIT_TEST(BatchListOfStript_partial)
       vaoAcceptor.m_vao[i].Destroy();
   }
 }
+
+UNIT_TEST(BatchReservedListOfStript)
+{
+  int const VERTEX_COUNT = 12;
+  int const INDEX_COUNT = 18;
+
+  float data[3 * VERTEX_COUNT];
+  for (int i = 0; i < VERTEX_COUNT * 3; ++i)
+    data[i] = (float)i;
+
+  unsigned short indexes[INDEX_COUNT] =
+    { 0, 1, 2, 1, 2, 3, 4, 5, 6, 5, 6, 7, 8, 9, 10, 9, 10, 11};
+
+  BatcherExpectations expectations;
+  expectations.RunTest(data, indexes, VERTEX_COUNT, 3, INDEX_COUNT,
+                       [](Batcher * batcher, GLState const & state, RefPointer<AttributeProvider> provider)
+  {
+    BindingInfo const & info = provider->GetBindingInfo(0);
+    uint16_t const vertexCount = provider->GetVertexCount();
+    void * reserved = batcher->ReserveListOfStrip(state, info, vertexCount, 4);
+    TEST(reserved != NULL, ());
+    memcpy(reserved, provider->GetRawPointer(0), vertexCount * info.GetElementSize());
+  });
+}
+
+UNIT_TEST(BatchReservedListOfStript_partial)
+{
+  uint32_t const VertexCount = 16;
+  uint32_t const ComponentCount = 3;
+  uint32_t const VertexArraySize = VertexCount * ComponentCount;
+  uint32_t const IndexCount = 24;
+
+  uint32_t const FirstBufferVertexPortion = 12;
+  uint32_t const SecondBufferVertexPortion = VertexCount - FirstBufferVertexPortion;
+  uint32_t const FirstBufferIndexPortion = 18;
+  uint32_t const SecondBufferIndexPortion = IndexCount - FirstBufferIndexPortion;
+
+  float vertexData[VertexArraySize];
+  for (uint32_t i = 0; i < VertexArraySize; ++i)
+    vertexData[i] = (float)i;
+
+  uint16_t indexData[IndexCount] =
+    { 0, 1, 2,
+      1, 2, 3,
+      4, 5, 6,
+      5, 6, 7,
+      8, 9, 10,
+      9, 10, 11,
+      0, 1, 2, // start new buffer
+      1, 2, 3};
+
+  PartialBatcherTest::BufferNode node1(FirstBufferIndexPortion * sizeof(uint16_t),
+                                       FirstBufferVertexPortion * ComponentCount * sizeof(float),
+                                       indexData, vertexData);
+
+  PartialBatcherTest::BufferNode node2(SecondBufferIndexPortion * sizeof(uint16_t),
+                                       SecondBufferVertexPortion * ComponentCount * sizeof(float),
+                                       indexData + FirstBufferIndexPortion,
+                                       vertexData + FirstBufferVertexPortion * ComponentCount);
+
+  InSequence seq;
+  PartialBatcherTest test;
+  test.AddBufferNode(node1);
+  test.AddBufferNode(node2);
+  test.CloseExpection();
+
+  GLState state(0, GLState::GeometryLayer);
+
+  BindingInfo binding(1);
+  BindingDecl & decl = binding.GetBindingDecl(0);
+  decl.m_attributeName = "position";
+  decl.m_componentCount = ComponentCount;
+  decl.m_componentType = gl_const::GLFloatType;
+  decl.m_offset = 0;
+  decl.m_stride = 0;
+
+  VAOAcceptor vaoAcceptor;
+  // The second portion doesn't fit into the rest of the first buffer.
+  Batcher batcher(20, 30);
+  batcher.StartSession(bind(&VAOAcceptor::FlushFullBucket, &vaoAcceptor, _1, _2));
+
+  void * reserved = batcher.ReserveListOfStrip(state, binding, FirstBufferVertexPortion, 4);
+  TEST(reserved != NULL, ());
+  memcpy(reserved, vertexData, FirstBufferVertexPortion * binding.GetElementSize());
+
+  reserved = batcher.ReserveListOfStrip(state, binding, SecondBufferVertexPortion, 4);
+  TEST(reserved != NULL, ());
+  memcpy(reserved, vertexData + FirstBufferVertexPortion * ComponentCount,
+         SecondBufferVertexPortion * binding.GetElementSize());
+
+  // Vertexes which don't fit into an empty buffer can't be reserved.
+  TEST(batcher.ReserveListOfStrip(state, binding, 32, 4) == NULL, ());
+  batcher.EndSession();
+
+  for (size_t i = 0; i < vaoAcceptor.m_vao.size(); ++i)
+    vaoAcceptor.m_vao[i].Destroy();
+}
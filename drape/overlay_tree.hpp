@@ -3,7 +3,7 @@
 #include "drape/overlay_handle.hpp"
 
 #include "geometry/screenbase.hpp"
-#include "geometry/tree4d.hpp"
+#include "geometry/packed_rtree.hpp"
 
 
 namespace dp
@@ -24,9 +24,9 @@ struct OverlayTraits
 
 }
 
-class OverlayTree : public m4::Tree<RefPointer<OverlayHandle>, detail::OverlayTraits>
+class OverlayTree : public m4::PackedRTree<RefPointer<OverlayHandle>, detail::OverlayTraits>
 {
-  typedef m4::Tree<RefPointer<OverlayHandle>, detail::OverlayTraits> BaseT;
+  typedef m4::PackedRTree<RefPointer<OverlayHandle>, detail::OverlayTraits> BaseT;
 
 public:
   void StartOverlayPlacing(ScreenBase const & screen, bool canOverlap = false);
@@ -34,6 +34,9 @@ VertexArrayBuffer::~VertexArrayBuffer()
 
 void VertexArrayBuffer::Preflush()
 {
+  FlushBuffers(m_staticBuffers);
+  FlushBuffers(m_dynamicBuffers);
+
   GLFunctions::glBindBuffer(0, gl_const::GLElementArrayBuffer);
   GLFunctions::glBindBuffer(0, gl_const::GLArrayBuffer);
 }
@@ -82,6 +85,11 @@ void VertexArrayBuffer::UploadData(BindingInfo const & bindingInfo, void const *
   buffer->UploadData(data, count);
 }
 
+void * VertexArrayBuffer::ReserveData(BindingInfo const & bindingInfo, uint16_t count)
+{
+  return GetOrCreateBuffer(bindingInfo, bindingInfo.IsDynamic())->Reserve(count);
+}
+
 RefPointer<DataBuffer> VertexArrayBuffer::GetOrCreateDynamicBuffer(BindingInfo const & bindingInfo)
 {
   return GetOrCreateBuffer(bindingInfo, true);
@@ -211,6 +219,12 @@ void VertexArrayBuffer::Bind() const
   GLFunctions::glBindVertexArray(m_VAO);
 }
 
+void VertexArrayBuffer::FlushBuffers(TBuffersMap const & buffers)
+{
+  for (TBuffersMap::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+    it->second.GetRefPointer()->Flush();
+}
+
 void VertexArrayBuffer::BindStaticBuffers() const
 {
   BindBuffers(m_staticBuffers);
@@ -38,6 +38,9 @@ public:
   bool IsFilled() const;
 
   void UploadData(BindingInfo const & bindingInfo, void const * data, uint16_t count);
+  /// @return Memory for count vertexes of the binding right in the buffer.
+  /// It must be filled before Preflush.
+  void * ReserveData(BindingInfo const & bindingInfo, uint16_t count);
   void UploadIndexes(uint16_t const * data, uint16_t count);
 
   void ApplyMutation(RefPointer<IndexBufferMutator> indexMutator,
@@ -51,6 +54,7 @@ private:
   RefPointer<DataBuffer> GetOrCreateBuffer(BindingInfo const & bindingInfo, bool isDynamic);
   RefPointer<DataBuffer> GetBuffer(BindingInfo const & bindingInfo, bool isDynamic) const;
   void Bind() const;
+  void FlushBuffers(TBuffersMap const & buffers);
   void BindStaticBuffers() const;
   void BindDynamicBuffers() const;
   void BindBuffers(TBuffersMap const & buffers) const;
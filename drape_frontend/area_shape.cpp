@@ -1,4 +1,5 @@
 #include "drape_frontend/area_shape.hpp"
+#include "drape_frontend/shape_builder_pool.hpp"
 
 #include "drape/shader_def.hpp"
 #include "drape/glstate.hpp"
@@ -15,6 +16,12 @@
 namespace df
 {
 
+namespace
+{
+  // Must be a multiple of 3 to keep triangles in one chunk.
+  size_t const VERTEXES_CHUNK_SIZE = 3 * 4096;
+}
+
 AreaShape::AreaShape(vector<m2::PointF> && triangleList, AreaViewParams const & params)
   : m_vertexes(triangleList)
   , m_params(params)
@@ -27,17 +34,34 @@ void AreaShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::Tex
   textures->GetColorRegion(m_params.m_color, region);
   glsl::vec2 const colorPoint = glsl::ToVec2(region.GetTexRect().Center());
 
+  dp::GLState state(gpu::TEXTURING_PROGRAM, dp::GLState::GeometryLayer);
+  state.SetColorTexture(region.GetTexture());
+
+  // Vertexes are written right into the vertex buffer of the batcher when they fit into it.
   buffer_vector<gpu::SolidTexturingVertex, 128> vertexes;
-  vertexes.resize(m_vertexes.size());
-  transform(m_vertexes.begin(), m_vertexes.end(), vertexes.begin(), [&colorPoint, this](m2::PointF const & vertex)
+  void * reserved = batcher->ReserveTriangleList(state, gpu::SolidTexturingVertex::GetBindingInfo(),
+                                                 m_vertexes.size());
+  gpu::SolidTexturingVertex * data = static_cast<gpu::SolidTexturingVertex *>(reserved);
+  if (data == nullptr)
+  {
+    vertexes.resize(m_vertexes.size());
+    data = vertexes.data();
+  }
+
+  // Big areas (forests, lakes) are converted by chunks in parallel.
+  BuildInChunks(m_vertexes.size(), VERTEXES_CHUNK_SIZE, [&](size_t begin, size_t end)
   {
-    return gpu::SolidTexturingVertex(glsl::vec3(glsl::ToVec2(vertex), m_params.m_depth),
-                                     glsl::vec2(0.0, 0.0),
-                                     colorPoint);
+    transform(m_vertexes.begin() + begin, m_vertexes.begin() + end, data + begin,
+              [&colorPoint, this](m2::PointF const & vertex)
+    {
+      return gpu::SolidTexturingVertex(glsl::vec3(glsl::ToVec2(vertex), m_params.m_depth),
+                                       glsl::vec2(0.0, 0.0),
+                                       colorPoint);
+    });
   });
 
-  dp::GLState state(gpu::TEXTURING_PROGRAM, dp::GLState::GeometryLayer);
-  state.SetColorTexture(region.GetTexture());
+  if (reserved != nullptr)
+    return;
 
   dp::AttributeProvider provider(1, m_vertexes.size());
   provider.InitStream(0, gpu::SolidTexturingVertex::GetBindingInfo(), dp::MakeStackRefPointer<void>(vertexes.data()));
@@ -39,6 +39,7 @@ SOURCES += \
     path_symbol_shape.cpp \
     text_layout.cpp \
     map_data_provider.cpp \
+    shape_builder_pool.cpp \
 
 HEADERS += \
     engine_context.hpp \
@@ -75,3 +76,4 @@ HEADERS += \
     text_layout.hpp \
     intrusive_vector.hpp \
     map_data_provider.hpp \
+    shape_builder_pool.hpp \
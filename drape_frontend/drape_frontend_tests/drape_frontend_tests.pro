@@ -13,3 +13,4 @@ SOURCES += \
     memory_feature_index_tests.cpp \
     fribidi_tests.cpp \
     object_pool_tests.cpp \
+    shape_builder_pool_tests.cpp \
@@ -2,13 +2,16 @@
 
 #include "drape_frontend/memory_feature_index.hpp"
 
+#include "base/logging.hpp"
 #include "base/thread.hpp"
 #include "base/thread_pool.hpp"
 #include "base/condition.hpp"
+#include "base/timer.hpp"
 
 #include "std/vector.hpp"
 #include "std/set.hpp"
 #include "std/bind.hpp"
+#include "std/map.hpp"
 
 #include <cstdlib>
 #include <ctime>
@@ -213,3 +216,135 @@ UNIT_TEST(MemoryFeatureIndex_MT_Test)
 
   TEST_EQUAL(allFeatures.size(), readedFeatures.size(), ());
 }
+
+namespace
+{
+  int const kGridSize = 24;
+  int const kViewportSize = 5;
+
+  /// Emulates features of the tile (x, y): small features belong to one tile only,
+  /// big ones (roads, rivers, areas) cover blocks of neighbouring tiles.
+  void GenerateTileFeatures(int x, int y, vector<df::FeatureInfo> & features)
+  {
+    for (int i = 0; i < 200; ++i)
+      features.push_back(df::FeatureInfo(FeatureID(MwmSet::MwmId(), (y * kGridSize + x) * 200 + i)));
+
+    uint32_t const bigFeaturesOffset = kGridSize * kGridSize * 200;
+    for (int blockSize = 2; blockSize <= 8; blockSize *= 2)
+    {
+      uint32_t const block = (y / blockSize) * kGridSize + x / blockSize;
+      for (int i = 0; i < 50; ++i)
+        features.push_back(df::FeatureInfo(FeatureID(MwmSet::MwmId(),
+                                                     bigFeaturesOffset * blockSize + block * 50 + i)));
+    }
+    sort(features.begin(), features.end());
+  }
+
+  typedef pair<int, int> TTile;
+
+  void ReadTiles(vector<vector<df::FeatureInfo> *> const & tiles, size_t begin, size_t step,
+                 df::MemoryFeatureIndex & index)
+  {
+    for (size_t i = begin; i < tiles.size(); i += step)
+    {
+      vector<size_t> result;
+      index.ReadFeaturesRequest(*tiles[i], result);
+      TEST(is_sorted(result.begin(), result.end()), ());
+    }
+  }
+
+  void CancelTiles(vector<vector<df::FeatureInfo> *> const & tiles, size_t begin, size_t step,
+                   df::MemoryFeatureIndex & index)
+  {
+    for (size_t i = begin; i < tiles.size(); i += step)
+      index.RemoveFeatures(*tiles[i]);
+  }
+
+  template <typename TFn>
+  void RunInThreads(size_t threadsCount, vector<vector<df::FeatureInfo> *> const & tiles,
+                    df::MemoryFeatureIndex & index, TFn const & fn)
+  {
+    vector<threads::SimpleThread> workers;
+    for (size_t i = 0; i < threadsCount; ++i)
+      workers.emplace_back(fn, cref(tiles), i, threadsCount, ref(index));
+    for (auto & worker : workers)
+      worker.join();
+  }
+}
+
+/// Replays a coverage-change trace of a viewport moving over the tiles grid:
+/// on every step tiles which left the viewport are cancelled and new tiles are read
+/// concurrently by several read threads, like ReadManager does.
+UNIT_TEST(MemoryFeatureIndex_CoverageChangeTest)
+{
+  size_t const kThreadsCount = 8;
+
+  df::MemoryFeatureIndex index;
+  map<TTile, vector<df::FeatureInfo>> coverage;
+
+  my::Timer timer;
+  size_t requestsCount = 0;
+  for (int step = 0; step + kViewportSize <= kGridSize; ++step)
+  {
+    // Pan diagonally, so both rows and columns of tiles change.
+    int const minX = step;
+    int const minY = step / 2;
+
+    vector<vector<df::FeatureInfo> *> outdated;
+    for (auto & tile : coverage)
+    {
+      if (tile.first.first < minX || tile.first.first >= minX + kViewportSize ||
+          tile.first.second < minY || tile.first.second >= minY + kViewportSize)
+        outdated.push_back(&tile.second);
+    }
+    RunInThreads(kThreadsCount, outdated, index, &CancelTiles);
+    requestsCount += outdated.size();
+
+    for (auto it = coverage.begin(); it != coverage.end();)
+    {
+      if (it->first.first < minX || it->first.second < minY)
+        it = coverage.erase(it);
+      else
+        ++it;
+    }
+
+    // Tiles which stay in the viewport are requested again to pick up features
+    // released by the cancelled tiles.
+    vector<vector<df::FeatureInfo> *> tilesToRead;
+    for (int x = minX; x < minX + kViewportSize; ++x)
+    {
+      for (int y = minY; y < minY + kViewportSize; ++y)
+      {
+        auto res = coverage.insert(make_pair(TTile(x, y), vector<df::FeatureInfo>()));
+        if (res.second)
+          GenerateTileFeatures(x, y, res.first->second);
+        tilesToRead.push_back(&res.first->second);
+      }
+    }
+    RunInThreads(kThreadsCount, tilesToRead, index, &ReadTiles);
+    requestsCount += tilesToRead.size();
+
+    // Every feature of the current coverage must be owned by exactly one tile.
+    set<FeatureID> allFeatures;
+    set<FeatureID> ownedFeatures;
+    for (auto const & tile : coverage)
+    {
+      for (df::FeatureInfo const & info : tile.second)
+      {
+        allFeatures.insert(info.m_id);
+        if (info.m_isOwner)
+          TEST(ownedFeatures.insert(info.m_id).second, (info.m_id));
+      }
+    }
+    TEST_EQUAL(allFeatures.size(), ownedFeatures.size(), ());
+    TEST_EQUAL(index.GetFeaturesCount(), ownedFeatures.size(), ());
+  }
+
+  vector<vector<df::FeatureInfo> *> rest;
+  for (auto & tile : coverage)
+    rest.push_back(&tile.second);
+  RunInThreads(kThreadsCount, rest, index, &CancelTiles);
+  TEST_EQUAL(index.GetFeaturesCount(), 0, ());
+
+  LOG(LINFO, ("Coverage trace:", requestsCount, "tile requests in", timer.ElapsedSeconds(), "seconds"));
+}
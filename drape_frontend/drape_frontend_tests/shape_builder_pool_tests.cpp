@@ -0,0 +1,26 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/shape_builder_pool.hpp"
+
+#include "std/atomic.hpp"
+#include "std/vector.hpp"
+
+UNIT_TEST(BuildInChunks_CoversAllElements)
+{
+  for (size_t count : {0, 1, 10, 11, 1000})
+  {
+    vector<atomic<int>> calls(count);
+    for (auto & c : calls)
+      c = 0;
+
+    df::BuildInChunks(count, 10 /* chunkSize */, [&calls](size_t begin, size_t end)
+    {
+      TEST_LESS_OR_EQUAL(end - begin, 10, ());
+      for (size_t i = begin; i < end; ++i)
+        ++calls[i];
+    });
+
+    for (size_t i = 0; i < count; ++i)
+      TEST_EQUAL(calls[i], 1, (count, i));
+  }
+}
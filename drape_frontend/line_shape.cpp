@@ -1,4 +1,5 @@
 #include "drape_frontend/line_shape.hpp"
+#include "drape_frontend/shape_builder_pool.hpp"
 
 #include "drape/utils/vertex_decl.hpp"
 #include "drape/glsl_types.hpp"
@@ -20,6 +21,10 @@ namespace
   float const RIGHT_WIDTH = -1.0f;
   size_t const TEX_BEG_IDX = 0;
   size_t const TEX_END_IDX = 1;
+  /// Count of segments of a solid line which are generated by one task.
+  size_t const SEGMENTS_CHUNK_SIZE = 1024;
+
+  typedef gpu::LineVertex LV;
 
   struct TexDescription
   {
@@ -82,95 +87,151 @@ namespace
     bool m_isSolid = true;
     float m_pxCursor = 0.0f;
   };
-}
 
-LineShape::LineShape(m2::SharedSpline const & spline,
-                     LineViewParams const & params)
-  : m_params(params)
-  , m_spline(spline)
-{
-  ASSERT_GREATER(m_spline->GetPath().size(), 1, ());
-}
+  /// Writes vertexes into preallocated memory.
+  class VertexWriter
+  {
+  public:
+    VertexWriter(LV * data) : m_data(data) {}
+    void push_back(LV const & v) { *m_data++ = v; }
 
-void LineShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const
-{
-  typedef gpu::LineVertex LV;
-  buffer_vector<gpu::LineVertex, 128> geometry;
-  vector<m2::PointD> const & path = m_spline->GetPath();
+  private:
+    LV * m_data;
+  };
 
-  dp::TextureManager::ColorRegion colorRegion;
-  textures->GetColorRegion(m_params.m_color, colorRegion);
-  glsl::vec2 colorCoord(glsl::ToVec2(colorRegion.GetTexRect().Center()));
+  class LineGeometryGenerator
+  {
+  public:
+    LineGeometryGenerator(df::LineViewParams const & params, glsl::vec2 const & colorCoord,
+                          TextureCoordGenerator const & texCoordGen)
+      : m_params(params)
+      , m_colorCoord(colorCoord)
+      , m_texCoordGen(texCoordGen)
+      , m_halfWidth(params.m_width / 2.0f)
+      , m_capType(params.m_cap == dp::RoundCap ? CAP : SEGMENT)
+      , m_leftSegment(SEGMENT, LEFT_WIDTH)
+      , m_rightSegment(SEGMENT, RIGHT_WIDTH)
+    {
+    }
 
-  TextureCoordGenerator texCoordGen(m_params.m_baseGtoPScale);
-  dp::TextureManager::StippleRegion maskRegion;
-  if (m_params.m_pattern.empty())
-    textures->GetStippleRegion(dp::TextureManager::TStipplePattern{1}, maskRegion);
-  else
-    textures->GetStippleRegion(m_params.m_pattern, maskRegion);
+    /// Count of vertexes for the join and the segment which ends in path[i] of a solid line.
+    static size_t GetSolidSegmentSize(size_t i) { return i > 1 ? 8 : 4; }
 
-  texCoordGen.SetRegion(maskRegion, m_params.m_pattern.empty());
-  float const halfWidth = m_params.m_width / 2.0f;
-  float const glbHalfWidth = halfWidth / m_params.m_baseGtoPScale;
-  bool generateCap = m_params.m_cap != dp::ButtCap;
+    template <typename TGeometry>
+    void GenerateStartCap(vector<m2::PointD> const & path, TGeometry & geometry)
+    {
+      glsl::vec2 tangent, leftNormal, rightNormal;
+      CalcTangentAndNormals(glsl::ToVec2(path[0]), glsl::ToVec2(path[1]), tangent, leftNormal, rightNormal);
+      tangent = -m_halfWidth * tangent;
+
+      glsl::vec3 pivot = glsl::vec3(glsl::ToVec2(path[0]), m_params.m_depth);
+      TexDescription texCoords[2];
+      GenerateCapTexCoords(texCoords);
+
+      glsl::vec2 leftCap(m_capType, LEFT_WIDTH);
+      glsl::vec2 rightCap(m_capType, RIGHT_WIDTH);
+      geometry.push_back(LV(pivot, leftNormal + tangent, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, leftCap));
+      geometry.push_back(LV(pivot, rightNormal + tangent, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, rightCap));
+      geometry.push_back(LV(pivot, leftNormal, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, m_leftSegment));
+      geometry.push_back(LV(pivot, rightNormal, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, m_rightSegment));
+    }
 
-  auto const calcTangentAndNormals = [&halfWidth](glsl::vec2 const & pt0, glsl::vec2 const & pt1,
-                                        glsl::vec2 & tangent, glsl::vec2 & leftNormal,
-                                        glsl::vec2 & rightNormal)
-  {
-    tangent = glsl::normalize(pt1 - pt0);
-    leftNormal = halfWidth * glsl::vec2(tangent.y, -tangent.x);
-    rightNormal = -leftNormal;
-  };
+    template <typename TGeometry>
+    void GenerateEndCap(vector<m2::PointD> const & path, TGeometry & geometry)
+    {
+      size_t const lastPointIndex = path.size() - 1;
+      glsl::vec2 const endPoint = glsl::ToVec2(path[lastPointIndex]);
+      glsl::vec2 tangent, leftNormal, rightNormal;
+      CalcTangentAndNormals(glsl::ToVec2(path[lastPointIndex - 1]), endPoint, tangent, leftNormal, rightNormal);
+      tangent = m_halfWidth * tangent;
+
+      glsl::vec3 pivot = glsl::vec3(endPoint, m_params.m_depth);
+      TexDescription texCoords[2];
+      GenerateCapTexCoords(texCoords);
+
+      glsl::vec2 leftCap(m_capType, LEFT_WIDTH);
+      glsl::vec2 rightCap(m_capType, RIGHT_WIDTH);
+      geometry.push_back(LV(pivot, leftNormal, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, m_leftSegment));
+      geometry.push_back(LV(pivot, rightNormal, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, m_rightSegment));
+      geometry.push_back(LV(pivot, leftNormal + tangent, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, leftCap));
+      geometry.push_back(LV(pivot, rightNormal + tangent, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, rightCap));
+    }
 
-  float capType = m_params.m_cap == dp::RoundCap ? CAP : SEGMENT;
+    /// Generates the join with the previous segment and the segment [path[i - 1], path[i]].
+    template <typename TGeometry>
+    void GenerateSegment(vector<m2::PointD> const & path, size_t i, TGeometry & geometry)
+    {
+      ASSERT_GREATER(i, 0, ());
+      glsl::vec2 startPoint = glsl::ToVec2(path[i - 1]);
+      glsl::vec2 endPoint = glsl::ToVec2(path[i]);
+      glsl::vec2 tangent, leftNormal, rightNormal;
+      CalcTangentAndNormals(startPoint, endPoint, tangent, leftNormal, rightNormal);
 
-  glsl::vec2 leftSegment(SEGMENT, LEFT_WIDTH);
-  glsl::vec2 rightSegment(SEGMENT, RIGHT_WIDTH);
+      glsl::vec3 startPivot = glsl::vec3(startPoint, m_params.m_depth);
+      glsl::vec3 endPivot = glsl::vec3(endPoint, m_params.m_depth);
 
-  TexDescription texCoords[2];
+      TexDescription texCoords[2];
 
-  if (generateCap)
-  {
-    glsl::vec2 startPoint = glsl::ToVec2(path[0]);
-    glsl::vec2 endPoint = glsl::ToVec2(path[1]);
-    glsl::vec2 tangent, leftNormal, rightNormal;
-    calcTangentAndNormals(startPoint, endPoint, tangent, leftNormal, rightNormal);
-    tangent = -halfWidth * tangent;
-
-    glsl::vec3 pivot = glsl::vec3(startPoint, m_params.m_depth);
-    glsl::vec2 leftCap(capType, LEFT_WIDTH);
-    glsl::vec2 rightCap(capType, RIGHT_WIDTH);
-
-    texCoords[TEX_BEG_IDX].m_globalLength = 0.0;
-    texCoords[TEX_END_IDX].m_globalLength = glbHalfWidth;
-
-    VERIFY(texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
-    VERIFY(texCoordGen.GetTexCoords(texCoords[TEX_END_IDX]), ());
-
-    geometry.push_back(LV(pivot, leftNormal + tangent, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, leftCap));
-    geometry.push_back(LV(pivot, rightNormal + tangent, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, rightCap));
-    geometry.push_back(LV(pivot, leftNormal, colorCoord, texCoords[TEX_END_IDX].m_texCoord, leftSegment));
-    geometry.push_back(LV(pivot, rightNormal, colorCoord, texCoords[TEX_END_IDX].m_texCoord, rightSegment));
-  }
+      // Create join beetween current segment and previous
+      if (i > 1)
+      {
+        glsl::vec2 prevTangent, prevLeftNormal, prevRightNormal;
+        CalcTangentAndNormals(glsl::ToVec2(path[i - 2]), startPoint, prevTangent, prevLeftNormal, prevRightNormal);
+        GenerateJoin(startPivot, tangent, prevLeftNormal, prevRightNormal, leftNormal, rightNormal, geometry);
+      }
 
-  glsl::vec2 prevPoint;
-  glsl::vec2 prevLeftNormal;
-  glsl::vec2 prevRightNormal;
+      texCoords[TEX_BEG_IDX].m_globalLength = 0.0;
+      texCoords[TEX_END_IDX].m_globalLength = glsl::length(endPoint - startPoint);
+      VERIFY(m_texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
+      while (!m_texCoordGen.GetTexCoords(texCoords[TEX_END_IDX]))
+      {
+        glsl::vec2 newEndPoint = startPoint + tangent * texCoords[TEX_END_IDX].m_globalLength;
+        glsl::vec3 newEndPivot = glsl::vec3(newEndPoint, m_params.m_depth);
 
-  for (size_t i = 1; i < path.size(); ++i)
-  {
-    glsl::vec2 startPoint = glsl::ToVec2(path[i - 1]);
-    glsl::vec2 endPoint = glsl::ToVec2(path[i]);
-    glsl::vec2 tangent, leftNormal, rightNormal;
-    calcTangentAndNormals(startPoint, endPoint, tangent, leftNormal, rightNormal);
+        geometry.push_back(LV(startPivot, leftNormal, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, m_leftSegment));
+        geometry.push_back(LV(startPivot, rightNormal, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, m_rightSegment));
+        geometry.push_back(LV(newEndPivot, leftNormal, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, m_leftSegment));
+        geometry.push_back(LV(newEndPivot, rightNormal, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, m_rightSegment));
 
-    glsl::vec3 startPivot = glsl::vec3(startPoint, m_params.m_depth);
-    glsl::vec3 endPivot = glsl::vec3(endPoint, m_params.m_depth);
+        startPoint = newEndPoint;
+        startPivot = newEndPivot;
 
-    // Create join beetween current segment and previous
-    if (i > 1)
+        VERIFY(m_texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
+        texCoords[TEX_END_IDX].m_globalLength = glsl::length(endPoint - startPoint);
+      }
+
+      geometry.push_back(LV(startPivot, leftNormal, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, m_leftSegment));
+      geometry.push_back(LV(startPivot, rightNormal, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, m_rightSegment));
+      geometry.push_back(LV(endPivot, leftNormal, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, m_leftSegment));
+      geometry.push_back(LV(endPivot, rightNormal, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, m_rightSegment));
+    }
+
+  private:
+    void CalcTangentAndNormals(glsl::vec2 const & pt0, glsl::vec2 const & pt1,
+                               glsl::vec2 & tangent, glsl::vec2 & leftNormal,
+                               glsl::vec2 & rightNormal) const
     {
+      tangent = glsl::normalize(pt1 - pt0);
+      leftNormal = m_halfWidth * glsl::vec2(tangent.y, -tangent.x);
+      rightNormal = -leftNormal;
+    }
+
+    void GenerateCapTexCoords(TexDescription * texCoords)
+    {
+      texCoords[TEX_BEG_IDX].m_globalLength = 0.0;
+      texCoords[TEX_END_IDX].m_globalLength = m_halfWidth / m_params.m_baseGtoPScale;
+
+      VERIFY(m_texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
+      VERIFY(m_texCoordGen.GetTexCoords(texCoords[TEX_END_IDX]), ());
+    }
+
+    template <typename TGeometry>
+    void GenerateJoin(glsl::vec3 const & startPivot, glsl::vec2 const & tangent,
+                      glsl::vec2 const & prevLeftNormal, glsl::vec2 const & prevRightNormal,
+                      glsl::vec2 const & leftNormal, glsl::vec2 const & rightNormal,
+                      TGeometry & geometry)
+    {
+      TexDescription texCoords[2];
       glsl::vec2 zeroNormal(0.0, 0.0);
       glsl::vec2 prevForming, nextForming;
       if (glsl::dot(prevLeftNormal, tangent) < 0)
@@ -188,13 +249,13 @@ void LineShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::Tex
       {
         texCoords[TEX_BEG_IDX].m_globalLength = 0.0f;
         texCoords[TEX_END_IDX].m_globalLength = glsl::length(nextForming - prevForming) / m_params.m_baseGtoPScale;
-        VERIFY(texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
-        VERIFY(texCoordGen.GetTexCoords(texCoords[TEX_END_IDX]), ());
+        VERIFY(m_texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
+        VERIFY(m_texCoordGen.GetTexCoords(texCoords[TEX_END_IDX]), ());
 
-        geometry.push_back(LV(startPivot, prevForming, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, leftSegment));
-        geometry.push_back(LV(startPivot, zeroNormal, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, leftSegment));
-        geometry.push_back(LV(startPivot, nextForming, colorCoord, texCoords[TEX_END_IDX].m_texCoord, leftSegment));
-        geometry.push_back(LV(startPivot, nextForming, colorCoord, texCoords[TEX_END_IDX].m_texCoord, leftSegment));
+        geometry.push_back(LV(startPivot, prevForming, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, m_leftSegment));
+        geometry.push_back(LV(startPivot, zeroNormal, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, m_leftSegment));
+        geometry.push_back(LV(startPivot, nextForming, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, m_leftSegment));
+        geometry.push_back(LV(startPivot, nextForming, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, m_leftSegment));
       }
       else
       {
@@ -205,9 +266,9 @@ void LineShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::Tex
         texCoords[TEX_END_IDX].m_globalLength = glsl::length(nextForming - prevForming) / m_params.m_baseGtoPScale;
         TexDescription middle;
         middle.m_globalLength = texCoords[TEX_END_IDX].m_globalLength / 2.0f;
-        VERIFY(texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
-        VERIFY(texCoordGen.GetTexCoords(middle), ());
-        VERIFY(texCoordGen.GetTexCoords(texCoords[TEX_END_IDX]), ());
+        VERIFY(m_texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
+        VERIFY(m_texCoordGen.GetTexCoords(middle), ());
+        VERIFY(m_texCoordGen.GetTexCoords(texCoords[TEX_END_IDX]), ());
 
         if (m_params.m_join == dp::MiterJoin)
         {
@@ -215,10 +276,10 @@ void LineShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::Tex
           float const a = glsl::length(prevForming);
           middleForming *= static_cast<float>(sqrt(a * a + b * b));
 
-          geometry.push_back(LV(startPivot, prevForming, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, zeroDxDy));
-          geometry.push_back(LV(startPivot, zeroNormal, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, zeroDxDy));
-          geometry.push_back(LV(startPivot, middleForming, colorCoord, middle.m_texCoord, zeroDxDy));
-          geometry.push_back(LV(startPivot, nextForming, colorCoord, texCoords[TEX_END_IDX].m_texCoord, zeroDxDy));
+          geometry.push_back(LV(startPivot, prevForming, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, zeroDxDy));
+          geometry.push_back(LV(startPivot, zeroNormal, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, zeroDxDy));
+          geometry.push_back(LV(startPivot, middleForming, m_colorCoord, middle.m_texCoord, zeroDxDy));
+          geometry.push_back(LV(startPivot, nextForming, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, zeroDxDy));
         }
         else
         {
@@ -227,74 +288,112 @@ void LineShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::Tex
           glsl::vec2 dxdyLeft(0.0, -1.0);
           glsl::vec2 dxdyRight(0.0, -1.0);
           glsl::vec2 dxdyMiddle(1.0, 1.0);
-          geometry.push_back(LV(startPivot, zeroNormal, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, zeroDxDy));
-          geometry.push_back(LV(startPivot, prevForming, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, dxdyLeft));
-          geometry.push_back(LV(startPivot, nextForming, colorCoord, texCoords[TEX_END_IDX].m_texCoord, dxdyRight));
-          geometry.push_back(LV(startPivot, middleForming, colorCoord, middle.m_texCoord, dxdyMiddle));
+          geometry.push_back(LV(startPivot, zeroNormal, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, zeroDxDy));
+          geometry.push_back(LV(startPivot, prevForming, m_colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, dxdyLeft));
+          geometry.push_back(LV(startPivot, nextForming, m_colorCoord, texCoords[TEX_END_IDX].m_texCoord, dxdyRight));
+          geometry.push_back(LV(startPivot, middleForming, m_colorCoord, middle.m_texCoord, dxdyMiddle));
         }
       }
     }
 
-    texCoords[TEX_BEG_IDX].m_globalLength = 0.0;
-    texCoords[TEX_END_IDX].m_globalLength = glsl::length(endPoint - startPoint);
-    VERIFY(texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
-    while (!texCoordGen.GetTexCoords(texCoords[TEX_END_IDX]))
-    {
-      glsl::vec2 newEndPoint = startPoint + tangent * texCoords[TEX_END_IDX].m_globalLength;
-      glsl::vec3 newEndPivot = glsl::vec3(newEndPoint, m_params.m_depth);
-
-      geometry.push_back(LV(startPivot, leftNormal, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, leftSegment));
-      geometry.push_back(LV(startPivot, rightNormal, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, rightSegment));
-      geometry.push_back(LV(newEndPivot, leftNormal, colorCoord, texCoords[TEX_END_IDX].m_texCoord, leftSegment));
-      geometry.push_back(LV(newEndPivot, rightNormal, colorCoord, texCoords[TEX_END_IDX].m_texCoord, rightSegment));
+    df::LineViewParams const & m_params;
+    glsl::vec2 const m_colorCoord;
+    TextureCoordGenerator m_texCoordGen;
+    float const m_halfWidth;
+    float const m_capType;
+    glsl::vec2 const m_leftSegment;
+    glsl::vec2 const m_rightSegment;
+  };
+}
 
-      startPoint = newEndPoint;
-      startPivot = newEndPivot;
+LineShape::LineShape(m2::SharedSpline const & spline,
+                     LineViewParams const & params)
+  : m_params(params)
+  , m_spline(spline)
+{
+  ASSERT_GREATER(m_spline->GetPath().size(), 1, ());
+}
 
-      VERIFY(texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
-      texCoords[TEX_END_IDX].m_globalLength = glsl::length(endPoint - startPoint);
-    }
+void LineShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::TextureManager> textures) const
+{
+  buffer_vector<gpu::LineVertex, 128> geometry;
+  vector<m2::PointD> const & path = m_spline->GetPath();
 
-    geometry.push_back(LV(startPivot, leftNormal, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, leftSegment));
-    geometry.push_back(LV(startPivot, rightNormal, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, rightSegment));
-    geometry.push_back(LV(endPivot, leftNormal, colorCoord, texCoords[TEX_END_IDX].m_texCoord, leftSegment));
-    geometry.push_back(LV(endPivot, rightNormal, colorCoord, texCoords[TEX_END_IDX].m_texCoord, rightSegment));
+  dp::TextureManager::ColorRegion colorRegion;
+  textures->GetColorRegion(m_params.m_color, colorRegion);
+  glsl::vec2 colorCoord(glsl::ToVec2(colorRegion.GetTexRect().Center()));
 
-    prevPoint = startPoint;
-    prevLeftNormal = leftNormal;
-    prevRightNormal = rightNormal;
-  }
+  TextureCoordGenerator texCoordGen(m_params.m_baseGtoPScale);
+  dp::TextureManager::StippleRegion maskRegion;
+  if (m_params.m_pattern.empty())
+    textures->GetStippleRegion(dp::TextureManager::TStipplePattern{1}, maskRegion);
+  else
+    textures->GetStippleRegion(m_params.m_pattern, maskRegion);
 
-  if (generateCap)
-  {
-    size_t lastPointIndex = path.size() - 1;
-    glsl::vec2 startPoint = glsl::ToVec2(path[lastPointIndex - 1]);
-    glsl::vec2 endPoint = glsl::ToVec2(path[lastPointIndex]);
-    glsl::vec2 tangent, leftNormal, rightNormal;
-    calcTangentAndNormals(startPoint, endPoint, tangent, leftNormal, rightNormal);
-    tangent = halfWidth * tangent;
-
-    glsl::vec3 pivot = glsl::vec3(endPoint, m_params.m_depth);
-    glsl::vec2 leftCap(capType, LEFT_WIDTH);
-    glsl::vec2 rightCap(capType, RIGHT_WIDTH);
-
-    texCoords[TEX_BEG_IDX].m_globalLength = 0.0;
-    texCoords[TEX_END_IDX].m_globalLength = glbHalfWidth;
-
-    VERIFY(texCoordGen.GetTexCoords(texCoords[TEX_BEG_IDX]), ());
-    VERIFY(texCoordGen.GetTexCoords(texCoords[TEX_END_IDX]), ());
-
-    geometry.push_back(LV(pivot, leftNormal, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, leftSegment));
-    geometry.push_back(LV(pivot, rightNormal, colorCoord, texCoords[TEX_BEG_IDX].m_texCoord, rightSegment));
-    geometry.push_back(LV(pivot, leftNormal + tangent, colorCoord, texCoords[TEX_END_IDX].m_texCoord, leftCap));
-    geometry.push_back(LV(pivot, rightNormal + tangent, colorCoord, texCoords[TEX_END_IDX].m_texCoord, rightCap));
-  }
+  texCoordGen.SetRegion(maskRegion, m_params.m_pattern.empty());
+  bool generateCap = m_params.m_cap != dp::ButtCap;
 
   dp::GLState state(gpu::LINE_PROGRAM, dp::GLState::GeometryLayer);
   state.SetBlending(true);
   state.SetColorTexture(colorRegion.GetTexture());
   state.SetMaskTexture(maskRegion.GetTexture());
 
+  LineGeometryGenerator generator(m_params, colorCoord, texCoordGen);
+
+  if (m_params.m_pattern.empty())
+  {
+    // Segments of a solid line don't depend on each other, so every chunk of them is generated
+    // by its own task right into its place in the vertex buffer of the batcher.
+    size_t const capSize = generateCap ? 4 : 0;
+    size_t geometrySize = 2 * capSize;
+    for (size_t i = 1; i < path.size(); ++i)
+      geometrySize += LineGeometryGenerator::GetSolidSegmentSize(i);
+
+    void * reserved = batcher->ReserveListOfStrip(state, gpu::LineVertex::GetBindingInfo(), geometrySize, 4);
+    LV * data = static_cast<LV *>(reserved);
+    if (data == nullptr)
+    {
+      geometry.resize(geometrySize);
+      data = geometry.data();
+    }
+
+    if (generateCap)
+    {
+      VertexWriter startCapWriter(data);
+      VertexWriter endCapWriter(data + geometrySize - capSize);
+      generator.GenerateStartCap(path, startCapWriter);
+      generator.GenerateEndCap(path, endCapWriter);
+    }
+
+    BuildInChunks(path.size() - 1, SEGMENTS_CHUNK_SIZE, [&](size_t begin, size_t end)
+    {
+      // Segment with index k ends in path[k + 1].
+      size_t offset = capSize;
+      if (begin > 0)
+        offset += 4 + 8 * (begin - 1);
+
+      LineGeometryGenerator chunkGenerator(m_params, colorCoord, texCoordGen);
+      VertexWriter writer(data + offset);
+      for (size_t k = begin; k < end; ++k)
+        chunkGenerator.GenerateSegment(path, k + 1, writer);
+    });
+
+    if (reserved != nullptr)
+      return;
+  }
+  else
+  {
+    // Texture coordinates of a stipple line depend on all previous segments.
+    if (generateCap)
+      generator.GenerateStartCap(path, geometry);
+
+    for (size_t i = 1; i < path.size(); ++i)
+      generator.GenerateSegment(path, i, geometry);
+
+    if (generateCap)
+      generator.GenerateEndCap(path, geometry);
+  }
+
   dp::AttributeProvider provider(1, geometry.size());
   provider.InitStream(0, gpu::LineVertex::GetBindingInfo(), dp::MakeStackRefPointer<void>(geometry.data()));
 
@@ -302,4 +401,3 @@ void LineShape::Draw(dp::RefPointer<dp::Batcher> batcher, dp::RefPointer<dp::Tex
 }
 
 } // namespace df
-
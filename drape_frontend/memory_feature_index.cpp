@@ -1,37 +1,105 @@
 #include "drape_frontend/memory_feature_index.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/cstdint.hpp"
+
 namespace df
 {
 
-void MemoryFeatureIndex::ReadFeaturesRequest(vector<FeatureInfo> & features, vector<size_t> & indexes)
+size_t MemoryFeatureIndex::GetShardIndex(FeatureID const & id)
 {
-  threads::MutexGuard lock(m_mutex);
+  // Features of a tile usually come from one mwm with close indexes,
+  // so mix bits to spread them uniformly between shards.
+  uint64_t const mwm = reinterpret_cast<uintptr_t>(id.m_mwmId.GetInfo().get());
+  uint64_t const key = (mwm >> 4) ^ id.m_index;
+  return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> (64 - kShardsCountBits));
+}
 
+void MemoryFeatureIndex::GroupByShards(vector<FeatureInfo> const & features, vector<size_t> & order,
+                                       vector<size_t> & bounds)
+{
+  bounds.assign(kShardsCount + 1, 0);
+  vector<size_t> shards(features.size());
   for (size_t i = 0; i < features.size(); ++i)
   {
-    FeatureInfo & info = features[i];
-    ASSERT(m_features.find(info.m_id) != m_features.end() || !info.m_isOwner,());
-    if (!info.m_isOwner && m_features.insert(info.m_id).second)
+    shards[i] = GetShardIndex(features[i].m_id);
+    ++bounds[shards[i] + 1];
+  }
+
+  for (size_t i = 1; i <= kShardsCount; ++i)
+    bounds[i] += bounds[i - 1];
+
+  vector<size_t> positions(bounds.begin(), bounds.end() - 1);
+  order.resize(features.size());
+  for (size_t i = 0; i < features.size(); ++i)
+    order[positions[shards[i]]++] = i;
+}
+
+void MemoryFeatureIndex::ReadFeaturesRequest(vector<FeatureInfo> & features, vector<size_t> & indexes)
+{
+  vector<size_t> order, bounds;
+  GroupByShards(features, order, bounds);
+
+  size_t const initialSize = indexes.size();
+  for (size_t shardIndex = 0; shardIndex < kShardsCount; ++shardIndex)
+  {
+    if (bounds[shardIndex] == bounds[shardIndex + 1])
+      continue;
+
+    Shard & shard = m_shards[shardIndex];
+    threads::MutexGuard lock(shard.m_mutex);
+
+    for (size_t j = bounds[shardIndex]; j < bounds[shardIndex + 1]; ++j)
     {
-      indexes.push_back(i);
-      info.m_isOwner = true;
+      size_t const i = order[j];
+      FeatureInfo & info = features[i];
+      ASSERT(shard.m_features.find(info.m_id) != shard.m_features.end() || !info.m_isOwner,());
+      if (!info.m_isOwner && shard.m_features.insert(info.m_id).second)
+      {
+        indexes.push_back(i);
+        info.m_isOwner = true;
+      }
     }
   }
+
+  // Keep features order of the tile for the reading.
+  sort(indexes.begin() + initialSize, indexes.end());
 }
 
 void MemoryFeatureIndex::RemoveFeatures(vector<FeatureInfo> & features)
 {
-  threads::MutexGuard lock(m_mutex);
+  vector<size_t> order, bounds;
+  GroupByShards(features, order, bounds);
 
-  for (size_t i = 0; i < features.size(); ++i)
+  for (size_t shardIndex = 0; shardIndex < kShardsCount; ++shardIndex)
   {
-    FeatureInfo & info = features[i];
-    if (info.m_isOwner)
+    if (bounds[shardIndex] == bounds[shardIndex + 1])
+      continue;
+
+    Shard & shard = m_shards[shardIndex];
+    threads::MutexGuard lock(shard.m_mutex);
+
+    for (size_t j = bounds[shardIndex]; j < bounds[shardIndex + 1]; ++j)
     {
-      VERIFY(m_features.erase(info.m_id) == 1, ());
-      info.m_isOwner = false;
+      FeatureInfo & info = features[order[j]];
+      if (info.m_isOwner)
+      {
+        VERIFY(shard.m_features.erase(info.m_id) == 1, ());
+        info.m_isOwner = false;
+      }
     }
   }
 }
 
+size_t MemoryFeatureIndex::GetFeaturesCount() const
+{
+  size_t count = 0;
+  for (Shard const & shard : m_shards)
+  {
+    threads::MutexGuard lock(shard.m_mutex);
+    count += shard.m_features.size();
+  }
+  return count;
+}
+
 } // namespace df
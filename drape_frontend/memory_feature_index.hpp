@@ -28,15 +28,40 @@ struct FeatureInfo
   bool m_isOwner;
 };
 
+/// Set of features which are currently owned by some tile.
+/// Features are distributed between shards by hash of FeatureID, every shard has its own mutex,
+/// so read threads which process different tiles rarely wait each other.
+/// Claim (ReadFeaturesRequest) and release (RemoveFeatures) are batched:
+/// every touched shard is locked only once per call.
 class MemoryFeatureIndex : private noncopyable
 {
 public:
+  /// Claims all not owned features from @features.
+  /// @param indexes receives sorted indexes of features which were claimed by this call.
   void ReadFeaturesRequest(vector<FeatureInfo> & features, vector<size_t> & indexes);
   void RemoveFeatures(vector<FeatureInfo> & features);
 
+  /// @return Total count of owned features. Locks all shards, use for tests and debug only.
+  size_t GetFeaturesCount() const;
+
 private:
-  threads::Mutex m_mutex;
-  set<FeatureID> m_features;
+  static size_t const kShardsCountBits = 5;
+  static size_t const kShardsCount = 1 << kShardsCountBits;
+
+  struct Shard
+  {
+    mutable threads::Mutex m_mutex;
+    set<FeatureID> m_features;
+  };
+
+  static size_t GetShardIndex(FeatureID const & id);
+
+  /// Fills @order with indexes of @features grouped by shards,
+  /// @bounds[i], @bounds[i + 1] is a range in @order for the i-th shard.
+  static void GroupByShards(vector<FeatureInfo> const & features, vector<size_t> & order,
+                            vector<size_t> & bounds);
+
+  Shard m_shards[kShardsCount];
 };
 
 } // namespace df
@@ -0,0 +1,15 @@
+#include "drape_frontend/shape_builder_pool.hpp"
+
+#include "platform/platform.hpp"
+
+namespace df
+{
+
+threads::ParallelForPool & GetShapeBuilderPool()
+{
+  // Read threads and renderers occupy other cores, so use only a half of them.
+  static threads::ParallelForPool pool(max(GetPlatform().CpuCores() / 2, 1u));
+  return pool;
+}
+
+} // namespace df
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "base/parallel_for_pool.hpp"
+
+#include "std/algorithm.hpp"
+
+namespace df
+{
+
+/// Pool of threads which helps to build vertex data of big shapes (forests, lakes, long roads).
+threads::ParallelForPool & GetShapeBuilderPool();
+
+/// Calls fn(begin, end) for consecutive ranges of [0, count) with at most chunkSize elements each.
+/// Ranges are processed in the shape builder pool when there are more than one of them.
+template <typename TFn>
+void BuildInChunks(size_t count, size_t chunkSize, TFn const & fn)
+{
+  if (count <= chunkSize)
+  {
+    fn(0, count);
+    return;
+  }
+
+  size_t const chunksCount = (count + chunkSize - 1) / chunkSize;
+  GetShapeBuilderPool().ParallelFor(chunksCount, [&](size_t chunk, size_t /* slot */)
+  {
+    size_t const begin = chunk * chunkSize;
+    fn(begin, min(begin + chunkSize, count));
+  });
+}
+
+} // namespace df
@@ -5,6 +5,8 @@
 
 #include "drape/overlay_handle.hpp"
 
+#include "base/shaped_text_cache.hpp"
+
 #include "std/numeric.hpp"
 #include "std/algorithm.hpp"
 #include "std/bind.hpp"
@@ -17,6 +19,8 @@ namespace
 
 float const BASE_HEIGHT = 20.0f;
 float const VALID_SPLINE_TURN = 0.96f;
+/// Id of the drape glyphs in the shared shaped text cache.
+uint32_t const SHAPED_TEXT_FONT_ID = 1;
 
 class TextGeometryGenerator
 {
@@ -250,11 +254,30 @@ void CalculateOffsets(dp::Anchor anchor,
 
 } // namespace
 
-void TextLayout::Init(strings::UniString const & text, float fontSize,
+shared_ptr<strings::ShapedText const> TextLayout::GetShapedText(strings::UniString const & text,
+                                                                dp::RefPointer<dp::TextureManager> textures)
+{
+  // All glyphs are rendered with one base size and are scaled by m_textSizeRatio.
+  strings::ShapedTextKey const key(text, SHAPED_TEXT_FONT_ID, static_cast<uint32_t>(BASE_HEIGHT));
+  return strings::GetShapedText(key, [&textures](strings::UniString const & logText,
+                                                 strings::ShapedText & shaped)
+  {
+    shaped.m_visText = fribidi::log2vis(logText);
+
+    dp::TextureManager::TGlyphsBuffer regions;
+    textures->GetGlyphRegions(shaped.m_visText, regions);
+    shaped.m_advances.reserve(regions.size());
+    for (GlyphRegion const & glyph : regions)
+      shaped.m_advances.push_back(glyph.GetAdvanceX());
+  });
+}
+
+void TextLayout::Init(strings::ShapedText const & shapedText, float fontSize,
                       dp::RefPointer<dp::TextureManager> textures)
 {
   m_textSizeRatio = fontSize / BASE_HEIGHT;
-  textures->GetGlyphRegions(text, m_metrics);
+  m_pixelLength = m_textSizeRatio * shapedText.GetLength();
+  textures->GetGlyphRegions(shapedText.m_visText, m_metrics);
 }
 
 dp::RefPointer<dp::Texture> TextLayout::GetMaskTexture() const
@@ -276,10 +299,7 @@ uint32_t TextLayout::GetGlyphCount() const
 
 float TextLayout::GetPixelLength() const
 {
-  return m_textSizeRatio * accumulate(m_metrics.begin(), m_metrics.end(), 0.0, [](double const & v, GlyphRegion const & glyph)
-  {
-    return v + glyph.GetAdvanceX();
-  });
+  return m_pixelLength;
 }
 
 float TextLayout::GetPixelHeight() const
@@ -290,14 +310,27 @@ float TextLayout::GetPixelHeight() const
 StraightTextLayout::StraightTextLayout(strings::UniString const & text, float fontSize,
                                        dp::RefPointer<dp::TextureManager> textures, dp::Anchor anchor)
 {
-  strings::UniString visibleText = fribidi::log2vis(text);
+  shared_ptr<strings::ShapedText const> shapedText = GetShapedText(text, textures);
+  strings::UniString visibleText = shapedText->m_visText;
   buffer_vector<size_t, 2> delimIndexes;
   if (visibleText == text)
     SplitText(visibleText, delimIndexes);
   else
     delimIndexes.push_back(visibleText.size());
 
-  TBase::Init(visibleText, fontSize, textures);
+  if (delimIndexes.size() > 1)
+  {
+    // Delimiter symbol was removed from the text.
+    strings::ShapedText splitText;
+    splitText.m_visText = visibleText;
+    splitText.m_advances = shapedText->m_advances;
+    splitText.m_advances.erase(splitText.m_advances.begin() + delimIndexes[0]);
+    TBase::Init(splitText, fontSize, textures);
+  }
+  else
+  {
+    TBase::Init(*shapedText, fontSize, textures);
+  }
   CalculateOffsets(anchor, m_textSizeRatio, m_metrics, delimIndexes, m_offsets, m_pixelSize);
 }
 
@@ -323,7 +356,7 @@ void StraightTextLayout::Cache(glm::vec3 const & pivot, glm::vec2 const & pixelO
 PathTextLayout::PathTextLayout(strings::UniString const & text, float fontSize,
                                dp::RefPointer<dp::TextureManager> textures)
 {
-  Init(fribidi::log2vis(text), fontSize, textures);
+  Init(*GetShapedText(text, textures), fontSize, textures);
 }
 
 void PathTextLayout::CacheStaticGeometry(glm::vec3 const & pivot,
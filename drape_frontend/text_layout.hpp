@@ -11,6 +11,7 @@
 #include "geometry/spline.hpp"
 #include "geometry/screenbase.hpp"
 
+#include "base/shaped_text_cache.hpp"
 #include "base/string_utils.hpp"
 #include "base/buffer_vector.hpp"
 
@@ -39,7 +40,11 @@ public:
   float GetPixelHeight() const;
 
 protected:
-  void Init(strings::UniString const & text,
+  /// @return Text after bidi reordering with glyph advances in base size from the shared cache.
+  static shared_ptr<strings::ShapedText const> GetShapedText(strings::UniString const & text,
+                                                             dp::RefPointer<dp::TextureManager> textures);
+
+  void Init(strings::ShapedText const & shapedText,
             float fontSize,
             dp::RefPointer<dp::TextureManager> textures);
 
@@ -48,6 +53,7 @@ protected:
 
   dp::TextureManager::TGlyphsBuffer m_metrics;
   float m_textSizeRatio = 0.0;
+  float m_pixelLength = 0.0;
 };
 
 class StraightTextLayout : public TextLayout
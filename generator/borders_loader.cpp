@@ -5,6 +5,7 @@
 
 #include "platform/platform.hpp"
 
+#include "storage/country_grid.hpp"
 #include "storage/country_polygon.hpp"
 
 #include "indexer/geometry_serialization.hpp"
@@ -17,6 +18,8 @@
 #include "coding/file_container.hpp"
 #include "coding/read_write_utils.hpp"
 #include "coding/file_name_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
 
 #include "base/logging.hpp"
 #include "base/string_utils.hpp"
@@ -105,6 +108,7 @@ class PackedBordersGenerator
   FilesContainerW m_writer;
 
   vector<storage::CountryDef> m_polys;
+  storage::CountryGrid::Builder m_gridBuilder;
 
 public:
   PackedBordersGenerator(string const & baseDir)
@@ -126,6 +130,9 @@ public:
     // store polygon info
     m_polys.push_back(storage::CountryDef(name, rect));
 
+    // grid is built from the stored paths, which are rounded while coding
+    vector<m2::RegionD> stored;
+
     // write polygons as paths
     WriteVarUint(w, borders.size());
     for (m2::RegionD const & border : borders)
@@ -142,8 +149,19 @@ public:
       SimplifyNearOptimal(20, in.begin(), in.end(), eps, dist,
                           AccumulateSkipSmallTrg<DistanceT, m2::PointD>(dist, out, eps));
 
-      serial::SaveOuterPath(out, cp, w);
+      vector<char> buffer;
+      MemWriter<vector<char>> memWriter(buffer);
+      serial::SaveOuterPath(out, cp, memWriter);
+      w.Write(buffer.data(), buffer.size());
+
+      MemReader memReader(buffer.data(), buffer.size());
+      ReaderSource<MemReader> src(memReader);
+      VectorT points;
+      serial::LoadOuterPath(src, cp, points);
+      stored.emplace_back(move(points));
     }
+
+    m_gridBuilder.AddCountry(stored);
   }
 
   void Finish() {}
@@ -153,6 +171,15 @@ public:
     FileWriter w = m_writer.GetWriter(PACKED_POLYGONS_INFO_TAG);
     rw::Write(w, m_polys);
   }
+
+  void WriteGrid()
+  {
+    storage::CountryGrid grid;
+    m_gridBuilder.Finish(grid);
+
+    FileWriter w = m_writer.GetWriter(PACKED_POLYGONS_GRID_TAG);
+    grid.Write(w);
+  }
 };
 
 void GeneratePackedBorders(string const & baseDir)
@@ -160,6 +187,7 @@ void GeneratePackedBorders(string const & baseDir)
   PackedBordersGenerator generator(baseDir);
   ForEachCountry(baseDir, generator);
   generator.WritePolygonsInfo();
+  generator.WriteGrid();
 }
 
 } // namespace borders
@@ -201,8 +201,7 @@ namespace feature
     serial::CodingParams cp(trie::GetCodingParams(header.GetDefCodingParams()));
 
     unique_ptr<trie::DefaultIterator> const pTrieRoot(
-        trie::ReadTrie(container.GetReader(SEARCH_INDEX_FILE_TAG), trie::ValueReader(cp),
-                       trie::TEdgeValueReader()));
+        trie::ReadSearchTrie(container, header.GetFormat(), cp));
 
     SearchTokensCollector f;
     trie::ForEachRef(*pTrieRoot, f, strings::UniString());
@@ -21,6 +21,7 @@
 #include "indexer/search_index_builder.hpp"
 
 #include "coding/file_name_utils.hpp"
+#include "coding/mwm_diff.hpp"
 
 #include "base/timer.hpp"
 
@@ -48,6 +49,8 @@ DEFINE_bool(emit_coasts, false, "push coasts features from intermediate file to
 DEFINE_bool(generate_features, false, "2nd pass - generate intermediate features");
 DEFINE_bool(generate_geometry, false, "3rd pass - split and simplify geometry and triangles for features");
 DEFINE_bool(generate_index, false, "4rd pass - generate index");
+DEFINE_bool(btree_index, false, "Store geometry index as B+-tree with page sized nodes");
+DEFINE_bool(ans_index_leaves, false, "Entropy code leaves of geometry index (slower to decode)");
 DEFINE_bool(generate_search_index, false, "5th pass - generate search index");
 DEFINE_bool(calc_statistics, false, "Calculate feature statistics for specified mwm bucket files");
 DEFINE_bool(type_statistics, false, "Calculate statistics by type for specified mwm bucket files");
@@ -65,11 +68,13 @@ DEFINE_bool(unpack_mwm, false, "Unpack each section of mwm into a separate file
 DEFINE_bool(generate_packed_borders, false, "Generate packed file with country polygons.");
 DEFINE_bool(check_mwm, false, "Check map file to be correct.");
 DEFINE_string(delete_section, "", "Delete specified section (defines.hpp) from container.");
+DEFINE_string(make_mwm_diff_from, "", "Make diff from the specified old mwm to the '--output' one, the diff is written to the file with the '.mwmdiff' ext.");
 DEFINE_bool(fail_on_coasts, false, "Stop and exit with '255' code if some coastlines are not merged.");
 DEFINE_bool(generate_addresses_file, false, "Generate .addr file (for '--output' option) with full addresses list.");
 DEFINE_string(osrm_file_name, "", "Input osrm file to generate routing info");
 DEFINE_bool(make_routing, false, "Make routing info based on osrm file");
 DEFINE_bool(make_cross_section, false, "Make corss section in routing file for cross mwm routing");
+DEFINE_string(speed_profiles, "", "Write speed profiles of features from the file to the routing file without rebuilding it");
 DEFINE_string(osm_file_name, "", "Input osm area file");
 DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m]");
 DEFINE_string(user_resource_path, "", "User defined resource path for classificator.txt and etc.");
@@ -191,7 +196,12 @@ int main(int argc, char ** argv)
     {
       LOG(LINFO, ("Generating index for", datFile));
 
-      if (!indexer::BuildIndexFromDatFile(datFile, FLAGS_intermediate_data_path + country))
+      covering::IndexLayout layout = covering::IndexLayout::Tree;
+      if (FLAGS_btree_index)
+        layout = covering::IndexLayout::BTree;
+      else if (FLAGS_ans_index_leaves)
+        layout = covering::IndexLayout::TreeWithAnsLeaves;
+      if (!indexer::BuildIndexFromDatFile(datFile, FLAGS_intermediate_data_path + country, layout))
         LOG(LCRITICAL, ("Error generating index."));
     }
 
@@ -249,6 +259,15 @@ int main(int argc, char ** argv)
   if (!FLAGS_delete_section.empty())
     DeleteSection(datFile, FLAGS_delete_section);
 
+  if (!FLAGS_make_mwm_diff_from.empty())
+  {
+    LOG(LINFO, ("Making diff from", FLAGS_make_mwm_diff_from, "to", datFile));
+
+    string const diffFile = path + FLAGS_output + DIFF_FILE_EXTENSION;
+    if (!diff::MakeMwmDiff(FLAGS_make_mwm_diff_from, datFile, diffFile))
+      LOG(LCRITICAL, ("Error making mwm diff."));
+  }
+
   if (FLAGS_generate_packed_borders)
     borders::GeneratePackedBorders(path);
 
@@ -261,5 +280,8 @@ int main(int argc, char ** argv)
   if (!FLAGS_osrm_file_name.empty() && FLAGS_make_cross_section)
     routing::BuildCrossRoutingIndex(path, FLAGS_output, FLAGS_osrm_file_name);
 
+  if (!FLAGS_speed_profiles.empty())
+    routing::BuildSpeedProfiles(path, FLAGS_output, FLAGS_speed_profiles);
+
   return 0;
 }
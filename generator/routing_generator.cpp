@@ -8,6 +8,7 @@
 #include "routing/osrm_data_facade.hpp"
 #include "routing/osrm_engine.hpp"
 #include "routing/cross_routing_context.hpp"
+#include "routing/speed_profiles.hpp"
 
 #include "indexer/classificator_loader.hpp"
 #include "indexer/data_header.hpp"
@@ -25,6 +26,7 @@
 #include "base/logging.hpp"
 
 #include "std/fstream.hpp"
+#include "std/sstream.hpp"
 
 #include "3party/osrm/osrm-backend/data_structures/edge_based_node_data.hpp"
 #include "3party/osrm/osrm-backend/data_structures/query_edge.hpp"
@@ -447,4 +449,52 @@ void BuildRoutingIndex(string const & baseDir, string const & countryName, strin
   VERIFY(my::GetFileSize(fPath, sz), ());
   LOG(LINFO, ("Nodes stored:", stored, "Routing index file size:", sz));
 }
+
+bool BuildSpeedProfiles(string const & baseDir, string const & countryName,
+                        string const & profilesFile)
+{
+  LOG(LINFO, ("Speed profiles section builder"));
+
+  ifstream stream(profilesFile);
+  if (!stream)
+  {
+    LOG(LERROR, ("Can't open speed profiles", profilesFile));
+    return false;
+  }
+
+  SpeedProfilesBuilder builder;
+  string line;
+  for (size_t lineNumber = 1; getline(stream, line); ++lineNumber)
+  {
+    if (line.empty())
+      continue;
+    istringstream lineStream(line);
+    uint32_t featureId;
+    SpeedProfiles::TProfile profile;
+    bool ok = static_cast<bool>(lineStream >> featureId);
+    for (auto & speed : profile)
+    {
+      uint32_t value = 0;
+      ok = ok && lineStream >> value && value <= numeric_limits<uint8_t>::max();
+      speed = static_cast<uint8_t>(value);
+    }
+    if (!ok)
+    {
+      LOG(LERROR, ("Wrong speed profile at line", lineNumber, "of", profilesFile));
+      return false;
+    }
+    builder.SetProfile(featureId, profile);
+  }
+
+  CountryFile countryFile(countryName);
+  LocalCountryFile localFile(baseDir, countryFile, 0 /* version */);
+  localFile.SyncWithDisk();
+  FilesContainerW routingCont(localFile.GetPath(MapOptions::CarRouting),
+                              FileWriter::OP_WRITE_EXISTING);
+  FileWriter w = routingCont.GetWriter(ROUTING_SPEED_PROFILES_FILE_TAG);
+  size_t const startSize = w.Pos();
+  builder.Serialize(w);
+  LOG(LINFO, ("Have written speed profiles, bytes written:", w.Pos() - startSize, "bytes"));
+  return true;
+}
 }
@@ -17,4 +17,13 @@ void BuildRoutingIndex(string const & baseDir, string const & countryName, strin
 /// perform if it's emplty.
 void BuildCrossRoutingIndex(string const & baseDir, string const & countryName,
                             string const & osrmFile);
+
+/// Writes weekly speed profiles of features to the routing file, see SpeedProfiles. Every line of
+/// the profiles file is a feature id and SpeedProfiles::kBucketsCount speeds in percents of the
+/// free flow speed. Routing indexes are not rebuilt.
+/// @param[in]  baseDir      Full path to .mwm files directory.
+/// @param[in]  countryName   Country name same with .mwm and .border file name.
+/// @param[in]  profilesFile  Full path to the profiles file.
+bool BuildSpeedProfiles(string const & baseDir, string const & countryName,
+                        string const & profilesFile);
 }
@@ -6,14 +6,18 @@
 
 #include "storage/country.hpp"
 
+#include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/sha2.hpp"
 
 #include "base/string_utils.hpp"
 #include "base/logging.hpp"
 #include "base/macros.hpp"
 #include "base/timer.hpp"
 
+#include "std/algorithm.hpp"
 #include "std/iterator.hpp"
+#include "std/vector.hpp"
 
 using namespace storage;
 
@@ -57,6 +61,26 @@ namespace update
       return sz;
     }
 
+    // Downloader checks files with these hashes.
+    string GetFileHash(platform::CountryFile const & cnt, MapOptions opt) const
+    {
+      string const fPath = m_dataDir + cnt.GetNameWithExt(opt);
+      if (!GetPlatform().IsFileExistsByFullPath(fPath))
+        return string();
+
+      FileReader reader(fPath);
+      sha2::Digest256 digest;
+      vector<char> buffer(1024 * 1024);
+      for (uint64_t pos = 0; pos < reader.Size(); pos += buffer.size())
+      {
+        size_t const sz = static_cast<size_t>(min(reader.Size() - pos,
+                                                  static_cast<uint64_t>(buffer.size())));
+        reader.Read(pos, buffer.data(), sz);
+        digest.Update(buffer.data(), sz);
+      }
+      return digest.Finish();
+    }
+
   public:
     SizeUpdater(string const & dataDir, Platform::FilesList & files)
       : m_processedFiles(0), m_dataDir(dataDir), m_files(files)
@@ -64,7 +88,7 @@ namespace update
     }
     ~SizeUpdater()
     {
-      LOG(LINFO, (m_processedFiles, "file sizes were updated in the country list"));
+      LOG(LINFO, (m_processedFiles, "file sizes and hashes were updated in the country list"));
 
       if (!m_files.empty())
         LOG(LWARNING, ("Files left unprocessed:", m_files));
@@ -86,6 +110,8 @@ namespace update
 
         cnt.SetRemoteSizes(static_cast<uint32_t>(szMap),
                            static_cast<uint32_t>(szRouting));
+        cnt.SetRemoteHashes(GetFileHash(cnt, MapOptions::Map),
+                            GetFileHash(cnt, MapOptions::CarRouting));
 
         string const fName = cnt.GetNameWithExt(MapOptions::Map);
         auto found = find(m_files.begin(), m_files.end(), fName);
@@ -29,6 +29,7 @@ HEADERS += \
   distance_on_sphere.hpp \
   latlon.hpp \
   packer.hpp \
+  packed_rtree.hpp \
   point2d.hpp \
   pointu_to_uint64.hpp \
   polygon.hpp \
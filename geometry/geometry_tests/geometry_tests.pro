@@ -28,6 +28,7 @@ SOURCES += \
   distance_test.cpp \
   intersect_test.cpp \
   latlon_test.cpp \
+  packed_rtree_test.cpp \
   packer_test.cpp \
   point_test.cpp \
   pointu_to_uint64_test.cpp \
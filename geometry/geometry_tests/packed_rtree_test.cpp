@@ -0,0 +1,247 @@
+#include "testing/testing.hpp"
+#include "testing/benchmark.hpp"
+
+#include "geometry/packed_rtree.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/random.hpp"
+
+
+namespace
+{
+  typedef m2::RectD R;
+
+  struct traits_t { m2::RectD LimitRect(m2::RectD const & r) const { return r; }};
+  typedef m4::PackedRTree<R, traits_t> TreeT;
+
+  template <class T> bool RTrue(T const &, T const &) { return true; }
+  template <class T> bool RFalse(T const &, T const &) { return false; }
+
+  struct TestObj
+  {
+    m2::RectD m_rect;
+    int m_id;
+
+    TestObj(m2::RectD const & r, int id) : m_rect(r), m_id(id) {}
+
+    m2::RectD const & GetLimitRect() const { return m_rect; }
+    bool operator==(TestObj const & r) const { return m_id == r.m_id; }
+    bool operator<(TestObj const & r) const { return m_id < r.m_id; }
+  };
+
+  R GetRandomRect(mt19937 & rng, double size)
+  {
+    uniform_real_distribution<double> coord(0.0, 1000.0);
+    uniform_real_distribution<double> side(0.0, size);
+    double const x = coord(rng);
+    double const y = coord(rng);
+    return R(x, y, x + side(rng), y + side(rng));
+  }
+
+  template <class TTree>
+  vector<TestObj> GetSortedInRect(TTree const & tree, R const & rect)
+  {
+    vector<TestObj> res;
+    tree.ForEachInRect(rect, MakeBackInsertFunctor(res));
+    sort(res.begin(), res.end());
+    return res;
+  }
+
+  /// Emulates overlay placing: an object is inserted when there are no intersected objects
+  /// with greater priority, intersected objects with less priority are erased.
+  template <class TTree>
+  size_t PlaceOverlays(vector<TestObj> const & objects, TTree & tree)
+  {
+    for (TestObj const & obj : objects)
+    {
+      vector<TestObj> isect;
+      bool skip = false;
+      tree.ForEachInRect(obj.m_rect, [&](TestObj const & r)
+      {
+        if (r.m_id % 7 > obj.m_id % 7)
+          skip = true;
+        else
+          isect.push_back(r);
+      });
+
+      if (skip)
+        continue;
+
+      for (TestObj const & r : isect)
+        tree.Erase(r, r.m_rect);
+      tree.Add(obj, obj.m_rect);
+    }
+
+    size_t const count = tree.GetSize();
+    tree.Clear();
+    return count;
+  }
+}
+
+UNIT_TEST(PackedRTree_Smoke)
+{
+  TreeT theTree;
+
+  R arr[] = {
+    R(0, 0, 1, 1),
+    R(1, 1, 2, 2),
+    R(2, 2, 3, 3)
+  };
+
+  for (size_t i = 0; i < ARRAY_SIZE(arr); ++i)
+    theTree.ReplaceAllInRect(arr[i], &RTrue<R>);
+
+  vector<R> test;
+  theTree.ForEach(MakeBackInsertFunctor(test));
+  TEST_EQUAL(3, test.size(), ());
+
+  test.clear();
+  R const searchR(1.5, 1.5, 1.5, 1.5);
+  theTree.ForEachInRect(searchR, MakeBackInsertFunctor(test));
+  TEST_EQUAL(1, test.size(), ());
+  TEST_EQUAL(test[0], arr[1], ());
+
+  R const replaceR(0.5, 0.5, 2.5, 2.5);
+  theTree.ReplaceAllInRect(replaceR, &RTrue<R>);
+
+  test.clear();
+  theTree.ForEach(MakeBackInsertFunctor(test));
+  TEST_EQUAL(1, test.size(), ());
+  TEST_EQUAL(test[0], replaceR, ());
+
+  test.clear();
+  theTree.ForEachInRect(searchR, MakeBackInsertFunctor(test));
+  TEST_EQUAL(1, test.size(), ());
+}
+
+UNIT_TEST(PackedRTree_ForEachInRect)
+{
+  R arr[] =
+  {
+    R(0, 0, 1, 1), R(5, 5, 10, 10), R(-1, -1, 0, 0), R(-10, -10, -5, -5)
+  };
+
+  // Insert enough copies to have objects in runs as well as in the buffer.
+  TreeT theTree;
+  size_t const copies = TreeT::kBufferSize + 3;
+  for (size_t i = 0; i < copies; ++i)
+  {
+    for (R const & r : arr)
+      theTree.Add(r, r);
+  }
+
+  auto const count = [&theTree](R const & r)
+  {
+    size_t res = 0;
+    theTree.ForEachInRect(r, [&res](R const &) { ++res; });
+    return res;
+  };
+
+  TEST_EQUAL(count(R(1, 1, 5, 5)), 0, ());
+  TEST_EQUAL(count(R(-5, -5, -1, -1)), 0, ());
+  TEST_EQUAL(count(R(3, 3, 3, 3)), 0, ());
+  TEST_EQUAL(count(R(0.5, 0.5, 0.5, 0.5)), copies, ());
+  TEST_EQUAL(count(R(-8, -8, -8, -8)), copies, ());
+  TEST_EQUAL(count(R(0.5, 0.5, 5.5, 5.5)), 2 * copies, ());
+}
+
+UNIT_TEST(PackedRTree_EraseEmptyRects)
+{
+  typedef m4::PackedRTree<TestObj> TObjTree;
+  TObjTree theTree;
+
+  for (int i = 0; i < 1000; ++i)
+    theTree.Add(TestObj(R(i % 10, i % 10, i % 10, i % 10), i));
+  TEST_EQUAL(theTree.GetSize(), 1000, ());
+
+  for (int i = 0; i < 1000; i += 2)
+    theTree.Erase(TestObj(R(i % 10, i % 10, i % 10, i % 10), i));
+  TEST_EQUAL(theTree.GetSize(), 500, ());
+
+  vector<TestObj> test;
+  theTree.ForEach(MakeBackInsertFunctor(test));
+  TEST_EQUAL(test.size(), 500, ());
+  for (TestObj const & obj : test)
+    TEST_EQUAL(obj.m_id % 2, 1, ());
+}
+
+UNIT_TEST(PackedRTree_CompareWithTree4D)
+{
+  mt19937 rng(0);
+  m4::Tree<TestObj> tree4d;
+  m4::PackedRTree<TestObj> packedTree;
+
+  vector<TestObj> objects;
+  for (int i = 0; i < 5000; ++i)
+  {
+    objects.emplace_back(GetRandomRect(rng, 50.0), i);
+    tree4d.Add(objects.back());
+    packedTree.Add(objects.back());
+
+    // Erase some objects to check runs with erased values.
+    if (i % 3 == 0)
+    {
+      TestObj const & obj = objects[i / 2];
+      tree4d.Erase(obj);
+      packedTree.Erase(obj);
+    }
+
+    TEST_EQUAL(tree4d.GetSize(), packedTree.GetSize(), ());
+    if (i % 500 == 0)
+    {
+      for (int j = 0; j < 20; ++j)
+      {
+        R const rect = GetRandomRect(rng, 200.0);
+        TEST(GetSortedInRect(tree4d, rect) == GetSortedInRect(packedTree, rect), (rect));
+      }
+    }
+  }
+}
+
+UNIT_TEST(PackedRTree_OverlayPlacing)
+{
+  mt19937 rng(1);
+  vector<TestObj> objects;
+  for (int i = 0; i < 3000; ++i)
+    objects.emplace_back(GetRandomRect(rng, 30.0), i);
+
+  m4::Tree<TestObj> tree4d;
+  m4::PackedRTree<TestObj> packedTree;
+  TEST_EQUAL(PlaceOverlays(objects, tree4d), PlaceOverlays(objects, packedTree), ());
+}
+
+#ifndef DEBUG
+namespace
+{
+  vector<TestObj> const & GetBenchmarkLabels()
+  {
+    static vector<TestObj> objects;
+    if (objects.empty())
+    {
+      mt19937 rng(2);
+      for (int i = 0; i < 5000; ++i)
+        objects.emplace_back(GetRandomRect(rng, 15.0), i);
+    }
+    return objects;
+  }
+}
+
+BENCHMARK_TEST(Tree4D_OverlayPlacing)
+{
+  m4::Tree<TestObj> tree;
+  BENCHMARK_N_TIMES(20, 10.0)
+  {
+    FORCE_USE_VALUE(PlaceOverlays(GetBenchmarkLabels(), tree));
+  }
+}
+
+BENCHMARK_TEST(PackedRTree_OverlayPlacing)
+{
+  m4::PackedRTree<TestObj> tree;
+  BENCHMARK_N_TIMES(20, 10.0)
+  {
+    FORCE_USE_VALUE(PlaceOverlays(GetBenchmarkLabels(), tree));
+  }
+}
+#endif
@@ -0,0 +1,506 @@
+#pragma once
+
+#include "geometry/rect2d.hpp"
+#include "geometry/tree4d.hpp"
+
+#include "base/assert.hpp"
+#include "base/buffer_vector.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/cstdint.hpp"
+#include "std/sstream.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+
+namespace m4
+{
+  /// Rects index with the same interface as m4::Tree.
+  /// Objects live in several static packed R-trees (runs) bulk-loaded with Sort-Tile-Recursive
+  /// algorithm and in a small unsorted buffer for the recent insertions. When the buffer is full
+  /// it's merged with all runs which are not bigger than it into a new run (like a binary counter
+  /// increment), so sizes of runs strictly decrease and a query visits O(log N) runs.
+  /// Erased objects are marked in their runs and are dropped on the next merge.
+  /// Nodes of a run are stored level by level in flat arrays by coordinate, so rects of node
+  /// children are tested in a branchless loop which compilers vectorize.
+  template <class T, typename Traits = TraitsDef<T> >
+  class PackedRTree
+  {
+  public:
+    static size_t const kNodeSize = 16;
+    static size_t const kBufferSize = 64;
+
+  private:
+    struct ValueT
+    {
+      ValueT(T const & t, m2::RectD const & r) : m_val(t), m_rect(r) {}
+      ValueT(T && t, m2::RectD const & r) : m_val(move(t)), m_rect(r) {}
+
+      // The same condition as in m4::Tree: touching rects are not intersected.
+      bool IsIntersect(m2::RectD const & r) const
+      {
+        return !((m_rect.maxX() <= r.minX()) || (m_rect.minX() >= r.maxX()) ||
+                 (m_rect.maxY() <= r.minY()) || (m_rect.minY() >= r.maxY()));
+      }
+
+      T m_val;
+      m2::RectD m_rect;
+    };
+
+    /// Sets mask[i] if i-th box intersects the rect (see ValueT::IsIntersect).
+    struct IntersectChecker
+    {
+      m2::RectD const & m_rect;
+
+      void operator()(double const * minX, double const * minY, double const * maxX,
+                      double const * maxY, size_t count, uint8_t * mask) const
+      {
+        double const rMinX = m_rect.minX(), rMinY = m_rect.minY();
+        double const rMaxX = m_rect.maxX(), rMaxY = m_rect.maxY();
+        for (size_t i = 0; i < count; ++i)
+        {
+          mask[i] = static_cast<uint8_t>((maxX[i] > rMinX) & (minX[i] < rMaxX) &
+                                         (maxY[i] > rMinY) & (minY[i] < rMaxY));
+        }
+      }
+    };
+
+    /// Sets mask[i] if i-th box contains the rect. Used to find objects with exactly
+    /// the same rect, which may be empty.
+    struct ContainChecker
+    {
+      m2::RectD const & m_rect;
+
+      void operator()(double const * minX, double const * minY, double const * maxX,
+                      double const * maxY, size_t count, uint8_t * mask) const
+      {
+        double const rMinX = m_rect.minX(), rMinY = m_rect.minY();
+        double const rMaxX = m_rect.maxX(), rMaxY = m_rect.maxY();
+        for (size_t i = 0; i < count; ++i)
+        {
+          mask[i] = static_cast<uint8_t>((minX[i] <= rMinX) & (minY[i] <= rMinY) &
+                                         (maxX[i] >= rMaxX) & (maxY[i] >= rMaxY));
+        }
+      }
+    };
+
+    class Run
+    {
+    public:
+      explicit Run(vector<ValueT> && values) : m_values(move(values)), m_erasedCount(0)
+      {
+        ASSERT(!m_values.empty(), ());
+        SortTileRecursive();
+        m_erased.resize(m_values.size(), 0);
+        BuildLevels();
+      }
+
+      size_t GetSize() const { return m_values.size() - m_erasedCount; }
+      size_t GetErasedCount() const { return m_erasedCount; }
+
+      template <class ToDo>
+      void ForEach(ToDo && toDo) const
+      {
+        for (size_t i = 0; i < m_values.size(); ++i)
+        {
+          if (!m_erased[i])
+            toDo(m_values[i]);
+        }
+      }
+
+      /// Moves all not erased values to the end of @values.
+      void MoveTo(vector<ValueT> & values)
+      {
+        for (size_t i = 0; i < m_values.size(); ++i)
+        {
+          if (!m_erased[i])
+            values.push_back(move(m_values[i]));
+        }
+        m_values.clear();
+      }
+
+      template <class ToDo>
+      void ForEachInRect(m2::RectD const & rect, ToDo && toDo) const
+      {
+        ForEachIndex(IntersectChecker{rect}, [&](size_t i)
+        {
+          if (m_values[i].IsIntersect(rect))
+            toDo(m_values[i]);
+        });
+      }
+
+      bool Erase(T const & obj, m2::RectD const & rect)
+      {
+        bool erased = false;
+        ForEachIndex(ContainChecker{rect}, [&](size_t i)
+        {
+          if (!erased && m_values[i].m_rect == rect && m_values[i].m_val == obj)
+          {
+            m_erased[i] = 1;
+            ++m_erasedCount;
+            erased = true;
+          }
+        });
+        return erased;
+      }
+
+    private:
+      void SortTileRecursive()
+      {
+        size_t const count = m_values.size();
+        size_t const leavesCount = (count + kNodeSize - 1) / kNodeSize;
+        size_t const slicesCount = static_cast<size_t>(ceil(sqrt(static_cast<double>(leavesCount))));
+        size_t const sliceSize = slicesCount * kNodeSize;
+
+        sort(m_values.begin(), m_values.end(), [](ValueT const & v1, ValueT const & v2)
+        {
+          return v1.m_rect.minX() + v1.m_rect.maxX() < v2.m_rect.minX() + v2.m_rect.maxX();
+        });
+
+        for (size_t i = 0; i < count; i += sliceSize)
+        {
+          sort(m_values.begin() + i, m_values.begin() + min(i + sliceSize, count),
+               [](ValueT const & v1, ValueT const & v2)
+          {
+            return v1.m_rect.minY() + v1.m_rect.maxY() < v2.m_rect.minY() + v2.m_rect.maxY();
+          });
+        }
+      }
+
+      void AddBox(double minX, double minY, double maxX, double maxY)
+      {
+        m_minX.push_back(minX);
+        m_minY.push_back(minY);
+        m_maxX.push_back(maxX);
+        m_maxY.push_back(maxY);
+      }
+
+      /// Level 0 holds rects of values, every next level holds bounding boxes of
+      /// kNodeSize consecutive boxes of the previous one, the last level is a root.
+      void BuildLevels()
+      {
+        size_t const count = m_values.size();
+        size_t boxesCount = count;
+        for (size_t n = count; n > 1; n = (n + kNodeSize - 1) / kNodeSize)
+          boxesCount += (n + kNodeSize - 1) / kNodeSize;
+
+        m_minX.reserve(boxesCount);
+        m_minY.reserve(boxesCount);
+        m_maxX.reserve(boxesCount);
+        m_maxY.reserve(boxesCount);
+
+        for (ValueT const & v : m_values)
+          AddBox(v.m_rect.minX(), v.m_rect.minY(), v.m_rect.maxX(), v.m_rect.maxY());
+
+        m_levels.push_back(0);
+        m_levels.push_back(count);
+
+        size_t begin = 0;
+        size_t end = count;
+        while (end - begin > 1)
+        {
+          for (size_t i = begin; i < end; i += kNodeSize)
+          {
+            size_t const last = min(i + kNodeSize, end);
+            double minX = m_minX[i], minY = m_minY[i], maxX = m_maxX[i], maxY = m_maxY[i];
+            for (size_t j = i + 1; j < last; ++j)
+            {
+              minX = min(minX, m_minX[j]);
+              minY = min(minY, m_minY[j]);
+              maxX = max(maxX, m_maxX[j]);
+              maxY = max(maxY, m_maxY[j]);
+            }
+            AddBox(minX, minY, maxX, maxY);
+          }
+
+          begin = end;
+          end = m_minX.size();
+          m_levels.push_back(end);
+        }
+      }
+
+      /// Calls toDo(i) for every not erased value which box passes the checker.
+      template <class CheckerT, class ToDo>
+      void ForEachIndex(CheckerT const & checker, ToDo && toDo) const
+      {
+        uint8_t mask[kNodeSize];
+
+        size_t const rootLevel = m_levels.size() - 2;
+        size_t const root = m_levels[rootLevel];
+        checker(&m_minX[root], &m_minY[root], &m_maxX[root], &m_maxY[root], 1, mask);
+        if (!mask[0])
+          return;
+
+        if (rootLevel == 0)
+        {
+          if (!m_erased[0])
+            toDo(0);
+          return;
+        }
+
+        // Stack of (level, index in level) of nodes which boxes passed the checker.
+        buffer_vector<pair<size_t, size_t>, 64> st;
+        st.push_back(make_pair(rootLevel, 0));
+        while (!st.empty())
+        {
+          size_t const level = st.back().first;
+          size_t const index = st.back().second;
+          st.pop_back();
+
+          size_t const childLevelBegin = m_levels[level - 1];
+          size_t const childLevelSize = m_levels[level] - childLevelBegin;
+          size_t const first = index * kNodeSize;
+          size_t const count = min(first + kNodeSize, childLevelSize) - first;
+          size_t const offset = childLevelBegin + first;
+
+          checker(&m_minX[offset], &m_minY[offset], &m_maxX[offset], &m_maxY[offset], count, mask);
+
+          for (size_t i = 0; i < count; ++i)
+          {
+            if (!mask[i])
+              continue;
+
+            if (level == 1)
+            {
+              if (!m_erased[first + i])
+                toDo(first + i);
+            }
+            else
+            {
+              st.push_back(make_pair(level - 1, first + i));
+            }
+          }
+        }
+      }
+
+      vector<ValueT> m_values;
+      vector<uint8_t> m_erased;
+      size_t m_erasedCount;
+
+      vector<double> m_minX, m_minY, m_maxX, m_maxY;
+      /// Offsets of levels in boxes arrays, the last one is a total count of boxes.
+      vector<size_t> m_levels;
+    };
+
+    /// Runs in decreasing order of their sizes.
+    vector<Run> m_runs;
+    vector<ValueT> m_buffer;
+    size_t m_size;
+    size_t m_erasedCount;
+
+    void Flush()
+    {
+      vector<ValueT> values;
+      values.swap(m_buffer);
+
+      while (!m_runs.empty() && m_runs.back().GetSize() <= values.size())
+      {
+        m_erasedCount -= m_runs.back().GetErasedCount();
+        m_runs.back().MoveTo(values);
+        m_runs.pop_back();
+      }
+
+      if (!values.empty())
+        m_runs.push_back(Run(move(values)));
+    }
+
+    /// Merges all runs into one when erased values take more space than alive ones.
+    void Rebuild()
+    {
+      vector<ValueT> values;
+      values.reserve(m_size);
+      for (Run & run : m_runs)
+        run.MoveTo(values);
+      m_runs.clear();
+      m_erasedCount = 0;
+
+      if (!values.empty())
+        m_runs.push_back(Run(move(values)));
+    }
+
+  protected:
+    Traits m_traits;
+    m2::RectD GetLimitRect(T const & t) const { return m_traits.LimitRect(t); }
+
+  public:
+    PackedRTree(Traits const & traits = Traits())
+      : m_size(0), m_erasedCount(0), m_traits(traits)
+    {
+    }
+
+    typedef T elem_t;
+
+    void Add(T const & obj)
+    {
+      Add(obj, GetLimitRect(obj));
+    }
+    void Add(T && obj)
+    {
+      m2::RectD const rect = GetLimitRect(obj);
+      Add(move(obj), rect);
+    }
+
+    void Add(T const & obj, m2::RectD const & rect)
+    {
+      m_buffer.push_back(ValueT(obj, rect));
+      ++m_size;
+      if (m_buffer.size() >= kBufferSize)
+        Flush();
+    }
+    void Add(T && obj, m2::RectD const & rect)
+    {
+      m_buffer.push_back(ValueT(move(obj), rect));
+      ++m_size;
+      if (m_buffer.size() >= kBufferSize)
+        Flush();
+    }
+
+  private:
+    template <class CompareT>
+    void ReplaceImpl(T const & obj, m2::RectD const & rect, CompareT comp)
+    {
+      bool skip = false;
+      vector<pair<T, m2::RectD> > isect;
+
+      ForEachValueInRect(rect, [&] (ValueT const & v)
+      {
+        if (skip)
+          return;
+
+        switch (comp(obj, v.m_val))
+        {
+        case 1:
+          isect.push_back(make_pair(v.m_val, v.m_rect));
+          break;
+        case -1:
+          skip = true;
+          break;
+        }
+      });
+
+      if (skip)
+        return;
+
+      for (auto const & v : isect)
+        Erase(v.first, v.second);
+
+      Add(obj, rect);
+    }
+
+    template <class ToDo>
+    void ForEachValueInRect(m2::RectD const & rect, ToDo && toDo) const
+    {
+      for (Run const & run : m_runs)
+        run.ForEachInRect(rect, toDo);
+
+      for (ValueT const & v : m_buffer)
+      {
+        if (v.IsIntersect(rect))
+          toDo(v);
+      }
+    }
+
+  public:
+    template <class CompareT>
+    void ReplaceAllInRect(T const & obj, CompareT comp)
+    {
+      ReplaceImpl(obj, GetLimitRect(obj), [&comp] (T const & t1, T const & t2)
+      {
+        return comp(t1, t2) ? 1 : -1;
+      });
+    }
+
+    template <class EqualT, class CompareT>
+    void ReplaceEqualInRect(T const & obj, EqualT eq, CompareT comp)
+    {
+      ReplaceImpl(obj, GetLimitRect(obj), [&] (T const & t1, T const & t2)
+      {
+        if (eq(t1, t2))
+          return comp(t1, t2) ? 1 : -1;
+        else
+          return 0;
+      });
+    }
+
+    void Erase(T const & obj, m2::RectD const & r)
+    {
+      for (size_t i = 0; i < m_buffer.size(); ++i)
+      {
+        if (m_buffer[i].m_rect == r && m_buffer[i].m_val == obj)
+        {
+          swap(m_buffer[i], m_buffer.back());
+          m_buffer.pop_back();
+          --m_size;
+          return;
+        }
+      }
+
+      for (Run & run : m_runs)
+      {
+        if (run.Erase(obj, r))
+        {
+          --m_size;
+          if (++m_erasedCount > m_size)
+            Rebuild();
+          return;
+        }
+      }
+    }
+
+    void Erase(T const & obj)
+    {
+      Erase(obj, m_traits.LimitRect(obj));
+    }
+
+    template <class ToDo>
+    void ForEach(ToDo toDo) const
+    {
+      ForEachWithRect([&toDo] (m2::RectD const &, T const & t) { toDo(t); });
+    }
+
+    template <class ToDo>
+    void ForEachWithRect(ToDo toDo) const
+    {
+      auto const fn = [&toDo] (ValueT const & v) { toDo(v.m_rect, v.m_val); };
+      for (Run const & run : m_runs)
+        run.ForEach(fn);
+      for_each(m_buffer.begin(), m_buffer.end(), fn);
+    }
+
+    template <class ToDo>
+    void ForEachInRect(m2::RectD const & rect, ToDo toDo) const
+    {
+      ForEachValueInRect(rect, [&toDo] (ValueT const & v) { toDo(v.m_val); });
+    }
+
+    bool IsEmpty() const { return m_size == 0; }
+
+    size_t GetSize() const { return m_size; }
+
+    void Clear()
+    {
+      m_runs.clear();
+      m_buffer.clear();
+      m_size = 0;
+      m_erasedCount = 0;
+    }
+
+    string DebugPrint() const
+    {
+      ostringstream out;
+      ForEachWithRect([&out] (m2::RectD const & r, T const & t)
+      {
+        using ::DebugPrint;
+        out << DebugPrint(t) << ", " << DebugPrint(r) << ", ";
+      });
+      return out.str();
+    }
+  };
+
+  template <typename T, typename Traits>
+  string DebugPrint(PackedRTree<T, Traits> const & t)
+  {
+    return t.DebugPrint();
+  }
+}
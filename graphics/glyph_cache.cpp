@@ -6,6 +6,12 @@
 
 namespace graphics
 {
+  namespace
+  {
+    /// Id of the FreeType glyphs in the shared shaped text cache.
+    uint32_t const SHAPED_TEXT_FONT_ID = 0;
+  }
+
   GlyphKey::GlyphKey(strings::UniChar symbolCode,
                      int fontSize,
                      bool isMask,
@@ -87,15 +93,25 @@ namespace graphics
 
   double GlyphCache::getTextLength(double fontSize, string const & text)
   {
-    strings::UniString const s = strings::MakeUniString(text);
-    double len = 0;
-    for (unsigned i = 0; i < s.size(); ++i)
-    {
-      GlyphKey k(s[i], static_cast<uint32_t>(fontSize), false, graphics::Color(0, 0, 0, 255));
-      len += getGlyphMetrics(k).m_xAdvance;
-    }
+    // Length of the visible text, which is actually drawn.
+    return getShapedText(strings::MakeUniString(text), static_cast<int>(fontSize))->GetLength();
+  }
 
-    return len;
+  shared_ptr<strings::ShapedText const> GlyphCache::getShapedText(strings::UniString const & logText,
+                                                                  int fontSize)
+  {
+    strings::ShapedTextKey const key(logText, SHAPED_TEXT_FONT_ID, static_cast<uint32_t>(fontSize));
+    return strings::GetShapedText(key, [this, fontSize](strings::UniString const & text,
+                                                        strings::ShapedText & shaped)
+    {
+      shaped.m_visText = log2vis(text);
+      shaped.m_advances.reserve(shaped.m_visText.size());
+      for (strings::UniChar c : shaped.m_visText)
+      {
+        GlyphKey k(c, fontSize, false, graphics::Color(0, 0, 0, 255));
+        shaped.m_advances.push_back(getGlyphMetrics(k).m_xAdvance);
+      }
+    });
   }
 
   threads::Mutex GlyphCache::s_fribidiMutex;
@@ -4,6 +4,7 @@
 
 #include "graphics/defines.hpp"
 
+#include "base/shaped_text_cache.hpp"
 #include "base/string_utils.hpp"
 #include "base/mutex.hpp"
 
@@ -98,6 +99,9 @@ namespace graphics
 
     double getTextLength(double fontSize, string const & text);
 
+    /// @return text in visual order with advances of glyphs from the shared shaped text cache.
+    shared_ptr<strings::ShapedText const> getShapedText(strings::UniString const & logText, int fontSize);
+
     static strings::UniString log2vis(strings::UniString const & str);
   };
 }
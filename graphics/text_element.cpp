@@ -20,9 +20,9 @@ namespace graphics
   {
     if (m_log2vis)
     {
-      visText = m_glyphCache->log2vis(m_logText);
+      visText = m_glyphCache->getShapedText(m_logText, m_fontDesc.m_size)->m_visText;
       if (!m_auxLogText.empty())
-        auxVisText = m_glyphCache->log2vis(m_auxLogText);
+        auxVisText = m_glyphCache->getShapedText(m_auxLogText, m_auxFontDesc.m_size)->m_visText;
 
       return make_pair(visText != m_logText, auxVisText != m_auxLogText);
     }
@@ -0,0 +1,198 @@
+#pragma once
+#include "indexer/interval_index.hpp"
+#include "indexer/interval_index_iface.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/endianness.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+
+#include "base/assert.hpp"
+#include "base/buffer_vector.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+/// Interval index stored as a static B+-tree with kNodeSize nodes over sorted (cell, value)
+/// pairs, see btree_interval_index_builder.hpp for the layout. The root is kept in memory,
+/// a lookup reads one node per level, and intervals of a batch are looked up in the order of
+/// cells, so every node is read once and leaves are read in the file order.
+class BTreeIntervalIndexBase
+{
+public:
+  enum : uint32_t
+  {
+    kNodeSize = 4096,
+    kFanout = kNodeSize / sizeof(uint64_t)
+  };
+};
+
+template <class ReaderT>
+class BTreeIntervalIndex : public IntervalIndexIFace, public BTreeIntervalIndexBase
+{
+public:
+  explicit BTreeIntervalIndex(ReaderT const & reader) : m_reader(reader)
+  {
+    ReaderSource<ReaderT> src(reader);
+    uint8_t const version = ReadPrimitiveFromSource<uint8_t>(src);
+    CHECK_EQUAL(version, static_cast<uint8_t>(IntervalIndexBase::kBTreeVersion), ());
+    uint8_t const innerLevels = ReadPrimitiveFromSource<uint8_t>(src);
+    uint32_t count = ReadPrimitiveFromSource<uint32_t>(src);
+    for (uint32_t i = 0; i <= innerLevels; ++i)
+    {
+      m_levels.emplace_back(ReadPrimitiveFromSource<uint32_t>(src), count);
+      count = (count + kFanout - 1) / kFanout;
+    }
+    if (innerLevels != 0)
+      ReadNode(innerLevels, 0, m_root);
+  }
+
+  template <typename F>
+  void ForEach(F const & f, uint64_t beg, uint64_t end) const
+  {
+    ForEachInIntervals(f, IntervalsT(1, make_pair(beg, end)));
+  }
+
+  template <typename F>
+  void ForEachInIntervals(F const & f, IntervalsT const & intervals) const
+  {
+    if (GetLeavesCount() == 0)
+      return;
+
+    IntervalsT sorted;
+    IntervalsT const * batch = &intervals;
+    if (!is_sorted(intervals.begin(), intervals.end()))
+    {
+      sorted = intervals;
+      sort(sorted.begin(), sorted.end());
+      batch = &sorted;
+    }
+
+    Cursor cursor(m_levels.size());
+    for (auto const & interval : *batch)
+    {
+      uint64_t const beg = static_cast<uint64_t>(max(interval.first, static_cast<int64_t>(0)));
+      uint64_t const end = static_cast<uint64_t>(max(interval.second, static_cast<int64_t>(0)));
+      if (beg >= end)
+        continue;
+
+      uint32_t leaf = FindLeaf(beg, cursor);
+      LoadLeaf(leaf, cursor);
+      auto it = lower_bound(cursor.m_pairs.begin(), cursor.m_pairs.end(), make_pair(beg, 0U));
+      while (true)
+      {
+        for (; it != cursor.m_pairs.end() && it->first < end; ++it)
+          f(it->second);
+        if (it != cursor.m_pairs.end() || ++leaf == GetLeavesCount())
+          break;
+        LoadLeaf(leaf, cursor);
+        it = cursor.m_pairs.begin();
+      }
+    }
+  }
+
+  uint32_t GetLeavesCount() const { return m_levels[0].m_count; }
+
+  virtual void DoForEach(FunctionT const & f, uint64_t beg, uint64_t end)
+  {
+    ForEach(f, beg, end);
+  }
+
+  virtual void DoForEachInIntervals(FunctionT const & f, IntervalsT const & intervals)
+  {
+    ForEachInIntervals(f, intervals);
+  }
+
+private:
+  struct Level
+  {
+    Level(uint32_t offset, uint32_t count) : m_offset(offset), m_count(count) {}
+
+    uint32_t m_offset;
+    uint32_t m_count;
+  };
+
+  // Nodes which were read last on every level.
+  struct Cursor
+  {
+    explicit Cursor(size_t levelsCount)
+      : m_nodeIndexes(levelsCount, kNoNode), m_nodes(levelsCount), m_leafIndex(kNoNode)
+    {
+    }
+
+    static uint32_t const kNoNode = static_cast<uint32_t>(-1);
+
+    vector<uint32_t> m_nodeIndexes;
+    vector<vector<uint64_t>> m_nodes;
+    uint32_t m_leafIndex;
+    vector<pair<uint64_t, uint32_t>> m_pairs;
+  };
+
+  // Returns the first leaf which can contain |cell|. Duplicates of the first cell of a node
+  // can end the previous node, so it's the last node which starts before |cell|.
+  uint32_t FindLeaf(uint64_t cell, Cursor & cursor) const
+  {
+    uint32_t node = 0;
+    for (size_t level = m_levels.size() - 1; level > 0; --level)
+    {
+      vector<uint64_t> const * keys = &m_root;
+      if (level + 1 != m_levels.size())
+      {
+        if (cursor.m_nodeIndexes[level] != node)
+        {
+          ReadNode(level, node, cursor.m_nodes[level]);
+          cursor.m_nodeIndexes[level] = node;
+        }
+        keys = &cursor.m_nodes[level];
+      }
+      auto const it = lower_bound(keys->begin(), keys->end(), cell);
+      uint32_t const child = it == keys->begin() ? 0 : static_cast<uint32_t>(it - keys->begin() - 1);
+      node = node * kFanout + child;
+    }
+    return node;
+  }
+
+  void ReadNode(size_t level, uint32_t node, vector<uint64_t> & keys) const
+  {
+    ASSERT_GREATER(level, 0, ());
+    uint32_t const childrenCount = m_levels[level - 1].m_count;
+    keys.resize(min(static_cast<uint32_t>(kFanout), childrenCount - node * kFanout));
+    m_reader.Read(m_levels[level].m_offset + static_cast<uint64_t>(node) * kNodeSize, keys.data(),
+                  keys.size() * sizeof(uint64_t));
+    for (auto & key : keys)
+      key = SwapIfBigEndian(key);
+  }
+
+  void LoadLeaf(uint32_t leaf, Cursor & cursor) const
+  {
+    if (cursor.m_leafIndex == leaf)
+      return;
+    cursor.m_leafIndex = leaf;
+
+    uint64_t const offset = m_levels[0].m_offset + static_cast<uint64_t>(leaf) * kNodeSize;
+    buffer_vector<uint8_t, kNodeSize> data;
+    data.resize_no_init(static_cast<size_t>(min(static_cast<uint64_t>(kNodeSize),
+                                                m_reader.Size() - offset)));
+    m_reader.Read(offset, &data[0], data.size());
+
+    ArrayByteSource src(&data[0]);
+    uint16_t const count = ReadPrimitiveFromSource<uint16_t>(src);
+    cursor.m_pairs.resize(count);
+    uint64_t cell = ReadVarUint<uint64_t>(src);
+    uint32_t value = ReadVarUint<uint32_t>(src);
+    cursor.m_pairs[0] = make_pair(cell, value);
+    for (uint16_t i = 1; i < count; ++i)
+    {
+      cell += ReadVarUint<uint64_t>(src);
+      value += ReadVarInt<int32_t>(src);
+      cursor.m_pairs[i] = make_pair(cell, value);
+    }
+    ASSERT_LESS_OR_EQUAL(src.PtrUC(), &data[0] + data.size(), ());
+  }
+
+  ReaderT m_reader;
+  // Leaves are the level 0, the root level has one node.
+  vector<Level> m_levels;
+  vector<uint64_t> m_root;
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include "indexer/btree_interval_index.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/limits.hpp"
+#include "std/vector.hpp"
+
+// +------------------------------+
+// |            Header            |
+// +------------------------------+
+// |        Leaves  offset        |
+// +------------------------------+
+// |        Level 1 offset        |
+// +------------------------------+
+// |             ...              |
+// +------------------------------+
+// |        Root level offset     |
+// +------------------------------+
+// |        Leaves  data          |
+// +------------------------------+
+// |        Level 1 data          |
+// +------------------------------+
+// |             ...              |
+// +------------------------------+
+// |        Root node             |
+// +------------------------------+
+//
+// Header is the version, the number of inner levels and the number of leaves.
+// Every node but the last one of a level takes exactly kNodeSize bytes.
+// Leaf contains the number of pairs, the first cell and value as varuints and
+// next ones as varuint deltas of cells and varint deltas of values.
+// Inner node contains uint64 first cells of up to kFanout children, i-th node of a level
+// is the parent of nodes [i * kFanout, (i + 1) * kFanout) of the level below.
+
+class BTreeIntervalIndexBuilder : public BTreeIntervalIndexBase
+{
+public:
+  template <class TWriter, typename TCellIdValueIter>
+  void BuildIndex(TWriter & writer, TCellIdValueIter const & beg, TCellIdValueIter const & end)
+  {
+    vector<uint8_t> leaves;
+    vector<uint64_t> firstCells;
+    BuildLeaves(beg, end, leaves, firstCells);
+    uint32_t const leavesCount = static_cast<uint32_t>(firstCells.size());
+
+    vector<vector<uint8_t>> levels;
+    while (firstCells.size() > 1)
+    {
+      vector<uint64_t> parentFirstCells;
+      levels.emplace_back();
+      BuildLevel(firstCells, levels.back(), parentFirstCells);
+      firstCells.swap(parentFirstCells);
+    }
+
+    uint64_t const initialPos = writer.Pos();
+    WriteToSink(writer, static_cast<uint8_t>(IntervalIndexBase::kBTreeVersion));
+    WriteToSink(writer, static_cast<uint8_t>(levels.size()));
+    WriteToSink(writer, leavesCount);
+
+    uint64_t offset = writer.Pos() - initialPos + sizeof(uint32_t) * (levels.size() + 1);
+    WriteToSink(writer, static_cast<uint32_t>(offset));
+    offset += leaves.size();
+    for (auto const & level : levels)
+    {
+      WriteToSink(writer, static_cast<uint32_t>(offset));
+      offset += level.size();
+    }
+    CHECK_LESS_OR_EQUAL(offset, numeric_limits<uint32_t>::max(), ());
+
+    writer.Write(leaves.data(), leaves.size());
+    for (auto const & level : levels)
+      writer.Write(level.data(), level.size());
+    CHECK_EQUAL(writer.Pos() - initialPos, offset, ());
+  }
+
+  template <typename TCellIdValueIter>
+  void BuildLeaves(TCellIdValueIter const & beg, TCellIdValueIter const & end,
+                   vector<uint8_t> & leaves, vector<uint64_t> & firstCells) const
+  {
+    vector<uint8_t> leaf;
+    uint16_t count = 0;
+    uint64_t prevCell = 0;
+    uint32_t prevValue = 0;
+    auto const writePair = [&](uint64_t cell, uint32_t value)
+    {
+      PushBackByteSink<vector<uint8_t>> sink(leaf);
+      if (count == 0)
+      {
+        WriteVarUint(sink, cell);
+        WriteVarUint(sink, value);
+      }
+      else
+      {
+        WriteVarUint(sink, cell - prevCell);
+        WriteVarInt(sink, static_cast<int64_t>(value) - static_cast<int64_t>(prevValue));
+      }
+    };
+
+    for (TCellIdValueIter it = beg; it != end; ++it)
+    {
+      uint64_t const cell = it->GetCell();
+      uint32_t const value = it->GetFeature();
+      CHECK_LESS_OR_EQUAL(prevCell, cell, ());
+
+      size_t const leafSize = leaf.size();
+      writePair(cell, value);
+      if (sizeof(count) + leaf.size() > kNodeSize)
+      {
+        // The pair doesn't fit and starts the next leaf.
+        leaf.resize(leafSize);
+        AppendLeaf(count, leaf, true /* pad */, leaves);
+        leaf.clear();
+        count = 0;
+        writePair(cell, value);
+      }
+      if (count == 0)
+        firstCells.push_back(cell);
+      ++count;
+      prevCell = cell;
+      prevValue = value;
+    }
+    // The last leaf isn't padded.
+    if (count != 0)
+      AppendLeaf(count, leaf, false /* pad */, leaves);
+  }
+
+  void BuildLevel(vector<uint64_t> const & childFirstCells, vector<uint8_t> & level,
+                  vector<uint64_t> & firstCells) const
+  {
+    PushBackByteSink<vector<uint8_t>> sink(level);
+    for (size_t i = 0; i < childFirstCells.size(); ++i)
+    {
+      if (i % kFanout == 0)
+        firstCells.push_back(childFirstCells[i]);
+      WriteToSink(sink, childFirstCells[i]);
+    }
+  }
+
+private:
+  static void AppendLeaf(uint16_t count, vector<uint8_t> const & leaf, bool pad,
+                         vector<uint8_t> & leaves)
+  {
+    size_t const begin = leaves.size();
+    {
+      PushBackByteSink<vector<uint8_t>> sink(leaves);
+      WriteToSink(sink, count);
+    }
+    leaves.insert(leaves.end(), leaf.begin(), leaf.end());
+    ASSERT_LESS_OR_EQUAL(leaves.size() - begin, kNodeSize, ());
+    if (pad)
+      leaves.resize(begin + kNodeSize);
+  }
+};
+
+template <class TWriter, typename TCellIdValueIter>
+void BuildBTreeIntervalIndex(TCellIdValueIter const & beg, TCellIdValueIter const & end,
+                             TWriter & writer)
+{
+  BTreeIntervalIndexBuilder().BuildIndex(writer, beg, end);
+}
@@ -1,4 +1,5 @@
 #include "indexer/data_factory.hpp"
+#include "indexer/btree_interval_index.hpp"
 #include "indexer/interval_index.hpp"
 #include "indexer/old/interval_index_101.hpp"
 
@@ -13,5 +14,7 @@ IntervalIndexIFace * IndexFactory::CreateIndex(ModelReaderPtr reader) const
 {
   if (m_version.format == version::v1)
     return new old_101::IntervalIndex<uint32_t, ModelReaderPtr>(reader);
+  if (ReadPrimitiveFromPos<uint8_t>(reader, 0) == IntervalIndexBase::kBTreeVersion)
+    return new BTreeIntervalIndex<ModelReaderPtr>(reader);
   return new IntervalIndex<ModelReaderPtr>(reader);
 }
@@ -71,6 +71,33 @@ string FeatureBase::DebugString() const
   return (res + m_params.DebugString());
 }
 
+string FeatureBase::GetHouseNumber() const
+{
+  ParseCommon();
+  return m_params.house.Get();
+}
+
+bool FeatureBase::GetName(int8_t lang, string & name) const
+{
+  if (!HasName())
+    return false;
+
+  ParseCommon();
+  return m_params.name.GetString(lang, name);
+}
+
+uint8_t FeatureBase::GetRank() const
+{
+  ParseCommon();
+  return m_params.rank;
+}
+
+string FeatureBase::GetRoadNumber() const
+{
+  ParseCommon();
+  return m_params.ref;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // FeatureType implementation
@@ -321,39 +348,12 @@ void FeatureType::GetReadableName(string & name) const
     name.swap(matcher.m_englishName);
 }
 
-string FeatureType::GetHouseNumber() const
-{
-  ParseCommon();
-  return m_params.house.Get();
-}
-
-bool FeatureType::GetName(int8_t lang, string & name) const
-{
-  if (!HasName())
-    return false;
-
-  ParseCommon();
-  return m_params.name.GetString(lang, name);
-}
-
-uint8_t FeatureType::GetRank() const
-{
-  ParseCommon();
-  return m_params.rank;
-}
-
 uint32_t FeatureType::GetPopulation() const
 {
   uint8_t const r = GetRank();
   return (r == 0 ? 1 : static_cast<uint32_t>(pow(1.1, r)));
 }
 
-string FeatureType::GetRoadNumber() const
-{
-  ParseCommon();
-  return m_params.ref;
-}
-
 bool FeatureType::HasInternet() const
 {
   ParseTypes();
@@ -461,3 +461,31 @@ void FeatureType::SwapGeometry(FeatureType & r)
   if (m_bTrianglesParsed)
     m_triangles.swap(r.m_triangles);
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FeatureView implementation
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FeatureView::Deserialize(feature::LoaderBase * pLoader, TBuffer buffer)
+{
+  base_type::Deserialize(pLoader, buffer);
+
+  m_pLoader->InitFeature(static_cast<FeatureBase *>(this));
+
+  m_buffer = buffer;
+  m_feature.reset();
+}
+
+FeatureType const & FeatureView::GetFeature() const
+{
+  if (!m_feature)
+  {
+    // The loader is switched to the feature, so all columns of the view are parsed before.
+    ParseCommon();
+
+    m_feature.reset(new FeatureType());
+    m_feature->Deserialize(m_pLoader, m_buffer);
+    m_feature->SetID(m_id);
+  }
+  return *m_feature;
+}
@@ -8,6 +8,7 @@
 #include "base/buffer_vector.hpp"
 
 #include "std/string.hpp"
+#include "std/unique_ptr.hpp"
 
 
 namespace feature
@@ -90,6 +91,13 @@ public:
     return true;
   }
 
+  static int8_t const DEFAULT_LANG = StringUtf8Multilang::DEFAULT_CODE;
+  bool GetName(int8_t lang, string & name) const;
+
+  string GetHouseNumber() const;
+  uint8_t GetRank() const;
+  string GetRoadNumber() const;
+
   inline m2::RectD GetLimitRect() const
   {
     ASSERT ( m_limitRect.IsValid(), () );
@@ -243,8 +251,6 @@ public:
   string DebugString(int scale) const;
   friend string DebugPrint(FeatureType const & ft);
 
-  string GetHouseNumber() const;
-
   /// @name Get names for feature.
   /// @param[out] defaultName corresponds to osm tag "name"
   /// @param[out] intName optionally choosen from tags "name:<lang_code>" by the algorithm
@@ -253,14 +259,9 @@ public:
   void GetPreferredNames(string & defaultName, string & intName) const;
   /// Get one most suitable name for user.
   void GetReadableName(string & name) const;
-
-  static int8_t const DEFAULT_LANG = StringUtf8Multilang::DEFAULT_CODE;
-  bool GetName(int8_t lang, string & name) const;
   //@}
 
-  uint8_t GetRank() const;
   uint32_t GetPopulation() const;
-  string GetRoadNumber() const;
   bool HasInternet() const;
 
   inline feature::Metadata const & GetMetadata() const { return m_metadata; }
@@ -330,6 +331,30 @@ private:
   friend class old_101::feature::LoaderImpl;
 };
 
+/// Lightweight read-only feature for filters which check most features by types, names or
+/// centers. Only the header is read on Deserialize, types, common params and the center are
+/// decoded from the record on the first access like in FeatureBase, and geometry with metadata
+/// are read by the FeatureType which is made on demand from the same record. The view is valid
+/// while the record is, i.e. inside of the callback which got it.
+class FeatureView : public FeatureBase
+{
+  typedef FeatureBase base_type;
+
+public:
+  void Deserialize(feature::LoaderBase * pLoader, TBuffer buffer);
+
+  inline void SetID(FeatureID const & id) { m_id = id; }
+  inline FeatureID GetID() const { return m_id; }
+
+  /// @return Full feature for geometry and metadata.
+  FeatureType const & GetFeature() const;
+
+private:
+  TBuffer m_buffer;
+  FeatureID m_id;
+  mutable unique_ptr<FeatureType> m_feature;
+};
+
 namespace feature
 {
   template <class IterT>
@@ -6,6 +6,7 @@
 
 #include "geometry/covering_utils.hpp"
 
+#include "std/algorithm.hpp"
 #include "std/vector.hpp"
 
 
@@ -203,6 +204,37 @@ void CoverViewportAndAppendLowerLevels(m2::RectD const & r, int cellDepth, Inter
   SortAndMergeIntervals(intervals, res);
 }
 
+void CoverViewportsAndAppendLowerLevels(vector<m2::RectD> const & rects, int cellDepth,
+                                        IntervalsT & res)
+{
+  IntervalsT intervals;
+  vector<RectId> ids;
+  for (m2::RectD const & r : rects)
+  {
+    ids.clear();
+    CoverRect<MercatorBounds, RectId>(r.minX(), r.minY(), r.maxX(), r.maxY(), 8, cellDepth, ids);
+    for (RectId const & id : ids)
+      AppendLowerLevels(id, cellDepth, intervals);
+  }
+
+  // Intervals of cells are either nested or disjoint, so after sorting by the beginning and
+  // then by the length an interval is nested iff it begins before the end of the last one.
+  sort(intervals.begin(), intervals.end(),
+       [](IntervalsT::value_type const & lhs, IntervalsT::value_type const & rhs)
+  {
+    if (lhs.first != rhs.first)
+      return lhs.first < rhs.first;
+    return lhs.second > rhs.second;
+  });
+
+  ASSERT(res.empty(), ());
+  for (auto const & interval : intervals)
+  {
+    if (res.empty() || res.back().second <= interval.first)
+      res.push_back(interval);
+  }
+}
+
 RectId GetRectIdAsIs(m2::RectD const & r)
 {
   double const eps = MercatorBounds::GetCellID2PointAbsEpsilon();
@@ -24,6 +24,12 @@ namespace covering
   void CoverViewportAndAppendLowerLevels(m2::RectD const & rect, int cellDepth,
                                          IntervalsT & intervals);
 
+  // Cover every viewport like CoverViewportAndAppendLowerLevels(), but don't merge intervals
+  // of different cells: result is sorted, cells and their ancestors are taken once and cells
+  // which are nested into other ones are dropped.
+  void CoverViewportsAndAppendLowerLevels(vector<m2::RectD> const & rects, int cellDepth,
+                                          IntervalsT & res);
+
   // Given a vector of intervals [a, b), sort them and merge overlapping intervals.
   IntervalsT SortAndMergeIntervals(IntervalsT const & intervals);
 
@@ -28,9 +28,9 @@ void LoaderCurrent::ParseTypes()
 
   ArrayByteSource source(DataPtr() + m_TypesOffset);
 
-  size_t const count = m_pF->GetTypesCount();
+  size_t const count = m_pBase->GetTypesCount();
   for (size_t i = 0; i < count; ++i)
-    m_pF->m_types[i] = c.GetTypeForIndex(ReadVarUint<uint32_t>(source));
+    m_pBase->m_types[i] = c.GetTypeForIndex(ReadVarUint<uint32_t>(source));
 
   m_CommonOffset = CalcOffset(source);
 }
@@ -40,12 +40,12 @@ void LoaderCurrent::ParseCommon()
   ArrayByteSource source(DataPtr() + m_CommonOffset);
 
   uint8_t const h = Header();
-  m_pF->m_params.Read(source, h);
+  m_pBase->m_params.Read(source, h);
 
-  if (m_pF->GetFeatureType() == GEOM_POINT)
+  if (m_pBase->GetFeatureType() == GEOM_POINT)
   {
-    m_pF->m_center = serial::LoadPoint(source, GetDefCodingParams());
-    m_pF->m_limitRect.Add(m_pF->m_center);
+    m_pBase->m_center = serial::LoadPoint(source, GetDefCodingParams());
+    m_pBase->m_limitRect.Add(m_pBase->m_center);
   }
 
   m_Header2Offset = CalcOffset(source);
@@ -1,6 +1,7 @@
 #include "base/SRC_FIRST.hpp"
 
 #include "indexer/feature_loader_base.hpp"
+#include "indexer/feature.hpp"
 #include "indexer/feature_loader.hpp"
 #include "indexer/feature_impl.hpp"
 
@@ -67,13 +68,14 @@ void SharedLoadInfo::CreateLoader()
 ////////////////////////////////////////////////////////////////////////////////////////////
 
 LoaderBase::LoaderBase(SharedLoadInfo const & info)
-  : m_Info(info), m_pF(0), m_Data(0)
+  : m_Info(info), m_pBase(0), m_pF(0), m_Data(0)
 {
 }
 
 void LoaderBase::Init(TBuffer data)
 {
   m_Data = data;
+  m_pBase = 0;
   m_pF = 0;
 
   m_CommonOffset = m_Header2Offset = 0;
@@ -81,6 +83,18 @@ void LoaderBase::Init(TBuffer data)
   ResetGeometry();
 }
 
+void LoaderBase::InitFeature(FeatureType * p)
+{
+  m_pBase = p;
+  m_pF = p;
+}
+
+void LoaderBase::InitFeature(FeatureBase * p)
+{
+  m_pBase = p;
+  m_pF = 0;
+}
+
 void LoaderBase::ResetGeometry()
 {
   m_ptsSimpMask = 0;
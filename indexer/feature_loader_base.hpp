@@ -7,6 +7,7 @@
 #include "std/noncopyable.hpp"
 
 
+class FeatureBase;
 class FeatureType;
 class ArrayByteSource;
 
@@ -63,7 +64,9 @@ namespace feature
     /// @name Initialize functions.
     //@{
     void Init(TBuffer data);
-    inline void InitFeature(FeatureType * p) { m_pF = p; }
+    void InitFeature(FeatureType * p);
+    /// Only types and common params can be parsed into FeatureBase.
+    void InitFeature(FeatureBase * p);
 
     void ResetGeometry();
     //@}
@@ -97,6 +100,7 @@ namespace feature
 
   protected:
     SharedLoadInfo const & m_Info;
+    FeatureBase * m_pBase;
     FeatureType * m_pF;
 
     TBuffer m_Data;
@@ -7,11 +7,21 @@
 
 
 void FeaturesVector::GetByIndex(uint32_t index, FeatureType & ft) const
+{
+  ft.Deserialize(m_LoadInfo.GetLoader(), ReadRecord(index));
+}
+
+void FeaturesVector::GetByIndex(uint32_t index, FeatureView & ft) const
+{
+  ft.Deserialize(m_LoadInfo.GetLoader(), ReadRecord(index));
+}
+
+char const * FeaturesVector::ReadRecord(uint32_t index) const
 {
   uint32_t offset = 0, size = 0;
   auto const ftOffset = m_table ? m_table->GetFeatureOffset(index) : index;
   m_RecordReader.ReadRecord(ftOffset, m_buffer, offset, size);
-  ft.Deserialize(m_LoadInfo.GetLoader(), &m_buffer[offset]);
+  return &m_buffer[offset];
 }
 
 
@@ -21,6 +21,7 @@ public:
   }
 
   void GetByIndex(uint32_t index, FeatureType & ft) const;
+  void GetByIndex(uint32_t index, FeatureView & ft) const;
 
   template <class ToDo> void ForEach(ToDo && toDo) const
   {
@@ -45,6 +46,8 @@ public:
 private:
   friend class FeaturesVectorTest;
 
+  char const * ReadRecord(uint32_t index) const;
+
   feature::SharedLoadInfo m_LoadInfo;
   VarRecordReader<FilesContainerR::ReaderT, &VarRecordSizeReaderVarint> m_RecordReader;
   mutable vector<char> m_buffer;
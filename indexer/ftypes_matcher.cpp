@@ -30,7 +30,7 @@ bool BaseChecker::operator() (feature::TypesHolder const & types) const
   return false;
 }
 
-bool BaseChecker::operator() (FeatureType const & ft) const
+bool BaseChecker::operator() (FeatureBase const & ft) const
 {
   return this->operator() (feature::TypesHolder(ft));
 }
@@ -248,7 +248,7 @@ Type IsLocalityChecker::GetType(feature::TypesHolder const & types) const
   return NONE;
 }
 
-Type IsLocalityChecker::GetType(const FeatureType & f) const
+Type IsLocalityChecker::GetType(FeatureBase const & f) const
 {
   feature::TypesHolder types(f);
   return GetType(types);
@@ -381,7 +381,7 @@ HighwayClass GetHighwayClass(feature::TypesHolder const & types)
   return HighwayClass::Error;
 }
 
-HighwayClass GetHighwayClass(FeatureType const & ft)
+HighwayClass GetHighwayClass(FeatureBase const & ft)
 {
   return GetHighwayClass(feature::TypesHolder(ft));
 }
@@ -6,6 +6,7 @@
 #include "std/string.hpp"
 
 namespace feature { class TypesHolder; }
+class FeatureBase;
 class FeatureType;
 
 namespace ftypes
@@ -24,7 +25,7 @@ public:
   virtual ~BaseChecker() {}
 
   bool operator() (feature::TypesHolder const & types) const;
-  bool operator() (FeatureType const & ft) const;
+  bool operator() (FeatureBase const & ft) const;
   bool operator() (vector<uint32_t> const & types) const;
 
   static uint32_t PrepareToMatch(uint32_t type, uint8_t level);
@@ -127,7 +128,7 @@ public:
   IsLocalityChecker();
 
   Type GetType(feature::TypesHolder const & types) const;
-  Type GetType(FeatureType const & f) const;
+  Type GetType(FeatureBase const & f) const;
 
   static IsLocalityChecker const & Instance();
 };
@@ -163,7 +164,7 @@ enum class HighwayClass
 string DebugPrint(HighwayClass const cls);
 
 HighwayClass GetHighwayClass(feature::TypesHolder const & types);
-HighwayClass GetHighwayClass(FeatureType const & ft);
+HighwayClass GetHighwayClass(FeatureBase const & ft);
 
 //@}
 }  // namespace ftypes
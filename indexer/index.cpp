@@ -38,6 +38,16 @@ void MwmValue::SetTable(MwmInfoEx & info)
   m_table = info.m_table.get();
 }
 
+trie::SearchTrie const & MwmValue::GetSearchTrie() const
+{
+  if (!m_searchTrie)
+  {
+    m_searchTrie = make_unique<trie::SearchTrie>(m_cont, GetHeader().GetFormat(),
+                                                 GetHeader().GetDefCodingParams());
+  }
+  return *m_searchTrie;
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 // Index implementation
 //////////////////////////////////////////////////////////////////////////////////
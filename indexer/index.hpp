@@ -6,6 +6,7 @@
 #include "indexer/features_vector.hpp"
 #include "indexer/mwm_set.hpp"
 #include "indexer/scale_index.hpp"
+#include "indexer/search_trie.hpp"
 #include "indexer/unique_index.hpp"
 
 #include "coding/file_container.hpp"
@@ -41,6 +42,13 @@ public:
   inline feature::DataHeader const & GetHeader() const { return m_factory.GetHeader(); }
   inline version::MwmVersion const & GetMwmVersion() const { return m_factory.GetMwmVersion(); }
   inline string const & GetCountryFileName() const { return m_file.GetCountryFile().GetNameWithoutExt(); }
+
+  /// Search index is built on the first call and is kept while the value is cached.
+  /// A value is used by one handle at a time, so no locks are needed.
+  trie::SearchTrie const & GetSearchTrie() const;
+
+private:
+  mutable unique_ptr<trie::SearchTrie> m_searchTrie;
 };
 
 class Index : public MwmSet
@@ -89,7 +97,7 @@ public:
 
 private:
 
-  template <typename F> class ReadMWMFunctor
+  template <typename F, typename TFeature = FeatureType> class ReadMWMFunctor
   {
     F & m_f;
   public:
@@ -120,21 +128,18 @@ private:
         CheckUniqueIndexes checkUnique(header.GetFormat() >= version::v5);
         MwmId const mwmID = handle.GetId();
 
-        for (auto const & i : interval)
+        index.ForEachInIntervalsAndScale([&] (uint32_t index)
         {
-          index.ForEachInIntervalAndScale([&] (uint32_t index)
+          if (checkUnique(index))
           {
-            if (checkUnique(index))
-            {
-              FeatureType feature;
+            TFeature feature;
 
-              fv.GetByIndex(index, feature);
-              feature.SetID(FeatureID(mwmID, index));
+            fv.GetByIndex(index, feature);
+            feature.SetID(FeatureID(mwmID, index));
 
-              m_f(feature);
-            }
-          }, i.first, i.second, scale);
-        }
+            m_f(feature);
+          }
+        }, interval, scale);
       }
     }
   };
@@ -167,14 +172,11 @@ private:
         CheckUniqueIndexes checkUnique(header.GetFormat() >= version::v5);
         MwmId const mwmID = handle.GetId();
 
-        for (auto const & i : interval)
+        index.ForEachInIntervalsAndScale([&] (uint32_t index)
         {
-          index.ForEachInIntervalAndScale([&] (uint32_t index)
-          {
-            if (checkUnique(index))
-              m_f(FeatureID(mwmID, index));
-          }, i.first, i.second, scale);
-        }
+          if (checkUnique(index))
+            m_f(FeatureID(mwmID, index));
+        }, interval, scale);
       }
     }
   };
@@ -188,6 +190,15 @@ public:
     ForEachInIntervals(implFunctor, covering::ViewportWithLowLevels, rect, scale);
   }
 
+  /// Same as ForEachInRect, but features are passed as FeatureViews. Use it for filters
+  /// which check types, names or centers of all features and read geometry of few ones.
+  template <typename F>
+  void ForEachViewInRect(F & f, m2::RectD const & rect, uint32_t scale) const
+  {
+    ReadMWMFunctor<F, FeatureView> implFunctor(f);
+    ForEachInIntervals(implFunctor, covering::ViewportWithLowLevels, rect, scale);
+  }
+
   template <typename F>
   void ForEachInRect_TileDrawing(F & f, m2::RectD const & rect, uint32_t scale) const
   {
@@ -246,6 +257,55 @@ public:
     }
   }
 
+  /// Calls f(handle) for every mwm which contains features of the scale in the rect:
+  /// countries go first, then WorldCoasts and World.
+  template <typename F>
+  void ForEachMwmInRect(F && f, m2::RectD const & rect, uint32_t scale) const
+  {
+    vector<shared_ptr<MwmInfo>> mwms;
+    GetMwmsInfo(mwms);
+
+    MwmId worldID[2];
+
+    for (shared_ptr<MwmInfo> const & info : mwms)
+    {
+      if (info->m_minScale <= scale && scale <= info->m_maxScale &&
+          rect.IsIntersect(info->m_limitRect))
+      {
+        MwmId id(info);
+        switch (info->GetType())
+        {
+          case MwmInfo::COUNTRY:
+          {
+            MwmHandle const handle = GetMwmHandleById(id);
+            f(handle);
+          }
+          break;
+
+          case MwmInfo::COASTS:
+            worldID[0] = id;
+            break;
+
+          case MwmInfo::WORLD:
+            worldID[1] = id;
+            break;
+        }
+      }
+    }
+
+    if (worldID[0].IsAlive())
+    {
+      MwmHandle const handle = GetMwmHandleById(worldID[0]);
+      f(handle);
+    }
+
+    if (worldID[1].IsAlive())
+    {
+      MwmHandle const handle = GetMwmHandleById(worldID[1]);
+      f(handle);
+    }
+  }
+
 private:
 
   // "features" must be sorted using FeatureID::operator< as predicate
@@ -289,50 +349,11 @@ private:
   void ForEachInIntervals(F & f, covering::CoveringMode mode, m2::RectD const & rect,
                           uint32_t scale) const
   {
-    vector<shared_ptr<MwmInfo>> mwms;
-    GetMwmsInfo(mwms);
-
     covering::CoveringGetter cov(rect, mode);
-
-    MwmId worldID[2];
-
-    for (shared_ptr<MwmInfo> const & info : mwms)
+    ForEachMwmInRect([&](MwmHandle const & handle)
     {
-      if (info->m_minScale <= scale && scale <= info->m_maxScale &&
-          rect.IsIntersect(info->m_limitRect))
-      {
-        MwmId id(info);
-        switch (info->GetType())
-        {
-          case MwmInfo::COUNTRY:
-          {
-            MwmHandle const handle = GetMwmHandleById(id);
-            f(handle, cov, scale);
-          }
-          break;
-
-          case MwmInfo::COASTS:
-            worldID[0] = id;
-            break;
-
-          case MwmInfo::WORLD:
-            worldID[1] = id;
-            break;
-        }
-      }
-    }
-
-    if (worldID[0].IsAlive())
-    {
-      MwmHandle const handle = GetMwmHandleById(worldID[0]);
       f(handle, cov, scale);
-    }
-
-    if (worldID[1].IsAlive())
-    {
-      MwmHandle const handle = GetMwmHandleById(worldID[1]);
-      f(handle, cov, scale);
-    }
+    }, rect, scale);
   }
 
   my::ObserverList<Observer> m_observers;
@@ -7,18 +7,20 @@ namespace indexer
 {
 template <class TFeaturesVector, typename TWriter>
 void BuildIndex(feature::DataHeader const & header, TFeaturesVector const & features,
-                TWriter & writer, string const & tmpFilePrefix)
+                TWriter & writer, string const & tmpFilePrefix,
+                covering::IndexLayout layout = covering::IndexLayout::Tree)
   {
     LOG(LINFO, ("Building scale index."));
     uint64_t indexSize;
     {
       SubWriter<TWriter> subWriter(writer);
-      covering::IndexScales(header, features, subWriter, tmpFilePrefix);
+      covering::IndexScales(header, features, subWriter, tmpFilePrefix, layout);
       indexSize = subWriter.Size();
     }
     LOG(LINFO, ("Built scale index. Size =", indexSize));
   }
 
   // doesn't throw exceptions
-  bool BuildIndexFromDatFile(string const & datFile, string const & tmpFile);
+  bool BuildIndexFromDatFile(string const & datFile, string const & tmpFile,
+                             covering::IndexLayout layout = covering::IndexLayout::Tree);
 }
@@ -0,0 +1,125 @@
+#include "indexer/index_query_cache.hpp"
+
+#include "indexer/scale_index.hpp"
+#include "indexer/unique_index.hpp"
+
+#include "defines.hpp"
+
+#include "base/stl_add.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/shared_ptr.hpp"
+
+
+namespace
+{
+// Approximate size of a cache entry besides ids: key, list and map nodes.
+size_t const kEntryOverhead = 96;
+}  // namespace
+
+size_t IndexQueryCache::KeyHash::operator()(Key const & key) const
+{
+  // FNV-1a over the mwm, the cell and the scale.
+  uint64_t h = 14695981039346656037ULL;
+  auto const add = [&h](uint64_t v)
+  {
+    h ^= v;
+    h *= 1099511628211ULL;
+  };
+
+  add(reinterpret_cast<uintptr_t>(key.m_mwmId.GetInfo().get()));
+  add(static_cast<uint64_t>(key.m_beg));
+  add(static_cast<uint64_t>(key.m_end));
+  add(key.m_scale);
+  return static_cast<size_t>(h);
+}
+
+IndexQueryCache::IndexQueryCache(Index const & index, size_t maxBytes)
+  : m_index(index), m_cache(maxBytes)
+{
+}
+
+IndexQueryCache::Covering::Covering(vector<m2::RectD> const & rects) : m_rects(rects)
+{
+  for (m2::RectD const & rect : m_rects)
+    m_limitRect.Add(rect);
+}
+
+covering::IntervalsT const & IndexQueryCache::Covering::Get(int scale)
+{
+  int const cellDepth = covering::GetCodingDepth(scale);
+  int const ind = (cellDepth == RectId::DEPTH_LEVELS ? 0 : 1);
+
+  if (m_res[ind].empty())
+    covering::CoverViewportsAndAppendLowerLevels(m_rects, cellDepth, m_res[ind]);
+  return m_res[ind];
+}
+
+bool IndexQueryCache::Covering::IsIntersect(m2::RectD const & rect) const
+{
+  return any_of(m_rects.begin(), m_rects.end(), [&rect](m2::RectD const & r)
+  {
+    return r.IsIntersect(rect);
+  });
+}
+
+void IndexQueryCache::GetFeatureIndexes(MwmSet::MwmHandle const & handle, Covering & cov,
+                                        uint32_t scale, vector<uint32_t> & indexes) const
+{
+  MwmValue const * pValue = handle.GetValue<MwmValue>();
+  if (!pValue)
+    return;
+
+  MwmSet::MwmId const mwmId = handle.GetId();
+  // Limit rect of the batch intersects the mwm, but rects may not.
+  if (!cov.IsIntersect(mwmId.GetInfo()->m_limitRect))
+    return;
+
+  feature::DataHeader const & header = pValue->GetHeader();
+
+  // In case of WorldCoasts we should pass correct scale in ForEachInIntervalAndScale.
+  uint32_t const lastScale = header.GetLastScale();
+  if (scale > lastScale)
+    scale = lastScale;
+
+  // Use last coding scale for covering (see index_builder.cpp).
+  covering::IntervalsT const & cells = cov.Get(lastScale);
+
+  vector<TCache::TValuePtr> lists(cells.size());
+  vector<size_t> misses;
+  for (size_t i = 0; i < cells.size(); ++i)
+  {
+    lists[i] = m_cache.Find(Key(mwmId, cells[i], scale));
+    if (!lists[i])
+      misses.push_back(i);
+  }
+
+  if (!misses.empty())
+  {
+    // The index is opened only when some cells are missed.
+    ScaleIndex<ModelReaderPtr> index(pValue->m_cont.GetReader(INDEX_FILE_TAG),
+                                     pValue->m_factory);
+    for (size_t i : misses)
+    {
+      shared_ptr<vector<uint32_t>> ids = make_shared<vector<uint32_t>>();
+      index.ForEachInIntervalAndScale(MakeBackInsertFunctor(*ids), cells[i].first,
+                                      cells[i].second, scale);
+      sort(ids->begin(), ids->end());
+      ids->erase(unique(ids->begin(), ids->end()), ids->end());
+      ids->shrink_to_fit();
+      size_t const weight = kEntryOverhead + ids->size() * sizeof(uint32_t);
+      lists[i] = m_cache.Insert(Key(mwmId, cells[i], scale), ids, weight);
+    }
+  }
+
+  // Features are indexed in several cells, so there are duplicates between cells.
+  CheckUniqueIndexes checkUnique(header.GetFormat() >= version::v5);
+  for (auto const & list : lists)
+  {
+    for (uint32_t index : *list)
+    {
+      if (checkUnique(index))
+        indexes.push_back(index);
+    }
+  }
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include "indexer/feature_covering.hpp"
+#include "indexer/features_vector.hpp"
+#include "indexer/index.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include "base/concurrent_lru_cache.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+
+/// Reads features of rects from the Index like Index::ForEachInRect, but keeps ids of features
+/// of every covering cell, so the next queries over the same cells don't touch the geometry
+/// index. Rects of a batch are covered at once and every feature is visited once per batch.
+/// Cache is thread-safe, ids of maps which are deregistered or updated are just never asked
+/// again and are evicted.
+class IndexQueryCache
+{
+public:
+  struct Key
+  {
+    Key() : m_beg(0), m_end(0), m_scale(0) {}
+    Key(MwmSet::MwmId const & mwmId, pair<int64_t, int64_t> const & cell, uint32_t scale)
+      : m_mwmId(mwmId), m_beg(cell.first), m_end(cell.second), m_scale(scale)
+    {
+    }
+
+    bool operator==(Key const & rhs) const
+    {
+      return m_mwmId == rhs.m_mwmId && m_beg == rhs.m_beg && m_end == rhs.m_end &&
+             m_scale == rhs.m_scale;
+    }
+
+    MwmSet::MwmId m_mwmId;
+    // Interval of cell ids of the cell and its subtree, see covering::AppendLowerLevels.
+    int64_t m_beg;
+    int64_t m_end;
+    uint32_t m_scale;
+  };
+
+  struct KeyHash
+  {
+    size_t operator()(Key const & key) const;
+  };
+
+  typedef my::ConcurrentLRUCache<Key, vector<uint32_t>, KeyHash> TCache;
+
+  /// @param maxBytes Memory limit of cached ids.
+  explicit IndexQueryCache(Index const & index, size_t maxBytes = 4 * 1024 * 1024);
+
+  template <typename F>
+  void ForEachInRect(F & f, m2::RectD const & rect, uint32_t scale) const
+  {
+    ForEachInRects(f, vector<m2::RectD>(1, rect), scale);
+  }
+
+  template <typename F>
+  void ForEachInRects(F & f, vector<m2::RectD> const & rects, uint32_t scale) const
+  {
+    Covering cov(rects);
+    m_index.ForEachMwmInRect([&](MwmSet::MwmHandle const & handle)
+    {
+      ReadFeatures<FeatureType>(f, handle, cov, scale);
+    }, cov.GetLimitRect(), scale);
+  }
+
+  template <typename F>
+  void ForEachViewInRect(F & f, m2::RectD const & rect, uint32_t scale) const
+  {
+    Covering cov(vector<m2::RectD>(1, rect));
+    m_index.ForEachMwmInRect([&](MwmSet::MwmHandle const & handle)
+    {
+      ReadFeatures<FeatureView>(f, handle, cov, scale);
+    }, cov.GetLimitRect(), scale);
+  }
+
+  template <typename F>
+  void ForEachFeatureIDInRects(F & f, vector<m2::RectD> const & rects, uint32_t scale) const
+  {
+    Covering cov(rects);
+    m_index.ForEachMwmInRect([&](MwmSet::MwmHandle const & handle)
+    {
+      vector<uint32_t> indexes;
+      GetFeatureIndexes(handle, cov, scale, indexes);
+      MwmSet::MwmId const mwmId = handle.GetId();
+      for (uint32_t index : indexes)
+        f(FeatureID(mwmId, index));
+    }, cov.GetLimitRect(), scale);
+  }
+
+  template <typename F>
+  void ForEachInRectForMWM(F & f, m2::RectD const & rect, uint32_t scale,
+                           MwmSet::MwmId const & id) const
+  {
+    MwmSet::MwmHandle const handle = m_index.GetMwmHandleById(id);
+    if (handle.IsAlive())
+    {
+      Covering cov(vector<m2::RectD>(1, rect));
+      ReadFeatures<FeatureType>(f, handle, cov, scale);
+    }
+  }
+
+  TCache::Stats GetStats() const { return m_cache.GetStats(); }
+  void Clear() { m_cache.Clear(); }
+
+private:
+  /// Union covering of a batch of rects for both coding depths, like covering::CoveringGetter.
+  class Covering
+  {
+  public:
+    explicit Covering(vector<m2::RectD> const & rects);
+
+    covering::IntervalsT const & Get(int scale);
+    m2::RectD const & GetLimitRect() const { return m_limitRect; }
+    bool IsIntersect(m2::RectD const & rect) const;
+
+  private:
+    vector<m2::RectD> const m_rects;
+    m2::RectD m_limitRect;
+    covering::IntervalsT m_res[2];
+  };
+
+  template <typename TFeature, typename F>
+  void ReadFeatures(F & f, MwmSet::MwmHandle const & handle, Covering & cov, uint32_t scale) const
+  {
+    vector<uint32_t> indexes;
+    GetFeatureIndexes(handle, cov, scale, indexes);
+    if (indexes.empty())
+      return;
+
+    MwmValue const * pValue = handle.GetValue<MwmValue>();
+    FeaturesVector fv(pValue->m_cont, pValue->GetHeader(), pValue->m_table);
+    MwmSet::MwmId const mwmId = handle.GetId();
+    for (uint32_t index : indexes)
+    {
+      TFeature feature;
+      fv.GetByIndex(index, feature);
+      feature.SetID(FeatureID(mwmId, index));
+      f(feature);
+    }
+  }
+
+  /// Fills indexes of features of the mwm in the covering, every index is taken once.
+  void GetFeatureIndexes(MwmSet::MwmHandle const & handle, Covering & cov, uint32_t scale,
+                         vector<uint32_t> & indexes) const;
+
+  Index const & m_index;
+  mutable TCache m_cache;
+};
@@ -38,6 +38,7 @@ SOURCES += \
     geometry_serialization.cpp \
     index.cpp \
     index_builder.cpp \
+    index_query_cache.cpp \
     map_style.cpp \
     map_style_reader.cpp \
     mercator.cpp \
@@ -48,9 +49,12 @@ SOURCES += \
     search_delimiters.cpp \
     search_index_builder.cpp \
     search_string_utils.cpp \
+    search_trie.cpp \
     types_mapping.cpp \
 
 HEADERS += \
+    btree_interval_index.hpp \
+    btree_interval_index_builder.hpp \
     categories_holder.hpp \
     cell_coverer.hpp \
     cell_id.hpp \
@@ -83,6 +87,7 @@ HEADERS += \
     geometry_serialization.hpp \
     index.hpp \
     index_builder.hpp \
+    index_query_cache.hpp \
     interval_index.hpp \
     interval_index_builder.hpp \
     interval_index_iface.hpp \
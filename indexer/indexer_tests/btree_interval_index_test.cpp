@@ -0,0 +1,318 @@
+#include "testing/testing.hpp"
+#include "testing/benchmark.hpp"
+
+#include "indexer/btree_interval_index.hpp"
+#include "indexer/btree_interval_index_builder.hpp"
+#include "indexer/interval_index.hpp"
+#include "indexer/interval_index_builder.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/macros.hpp"
+#include "base/scope_guard.hpp"
+#include "base/stl_add.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/random.hpp"
+#include "std/target_os.hpp"
+#include "std/type_traits.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+#if defined(OMIM_OS_LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+struct CellIdFeaturePairForTest
+{
+  CellIdFeaturePairForTest(uint64_t cell, uint32_t feature) : m_Cell(cell), m_Feature(feature) {}
+  uint64_t GetCell() const { return m_Cell; }
+  uint32_t GetFeature() const { return m_Feature; }
+  uint64_t m_Cell;
+  uint32_t m_Feature;
+};
+
+using TIntervals = IntervalIndexIFace::IntervalsT;
+
+vector<CellIdFeaturePairForTest> GetRandomCells(size_t count, uint64_t maxCell)
+{
+  mt19937 rng(0);
+  uniform_int_distribution<uint64_t> cellDist(1, maxCell - 1);
+  uniform_int_distribution<uint32_t> featureDist(0, static_cast<uint32_t>(count));
+  vector<uint64_t> cells(count);
+  for (auto & cell : cells)
+    cell = cellDist(rng);
+  sort(cells.begin(), cells.end());
+
+  vector<CellIdFeaturePairForTest> data;
+  for (uint64_t cell : cells)
+    data.emplace_back(cell, featureDist(rng));
+  return data;
+}
+
+TIntervals GetRandomIntervals(size_t count, uint64_t maxCell, uint64_t maxLength)
+{
+  mt19937 rng(1);
+  uniform_int_distribution<uint64_t> begDist(0, maxCell);
+  uniform_int_distribution<uint64_t> lengthDist(0, maxLength);
+  TIntervals intervals;
+  for (size_t i = 0; i < count; ++i)
+  {
+    uint64_t const beg = begDist(rng);
+    intervals.emplace_back(beg, beg + lengthDist(rng));
+  }
+  return intervals;
+}
+
+vector<char> BuildBTreeIndex(vector<CellIdFeaturePairForTest> const & data)
+{
+  vector<char> serialIndex;
+  MemWriter<vector<char> > writer(serialIndex);
+  BuildBTreeIntervalIndex(data.begin(), data.end(), writer);
+  return serialIndex;
+}
+
+vector<uint32_t> GetExpected(vector<CellIdFeaturePairForTest> const & data,
+                             TIntervals const & intervals)
+{
+  vector<uint32_t> values;
+  for (auto const & interval : intervals)
+  {
+    for (auto const & p : data)
+    {
+      if (static_cast<int64_t>(p.GetCell()) >= interval.first &&
+          static_cast<int64_t>(p.GetCell()) < interval.second)
+      {
+        values.push_back(p.GetFeature());
+      }
+    }
+  }
+  sort(values.begin(), values.end());
+  return values;
+}
+
+template <class TIndex>
+vector<uint32_t> GetValues(TIndex const & index, TIntervals const & intervals)
+{
+  vector<uint32_t> values;
+  index.ForEachInIntervals(MakeBackInsertFunctor(values), intervals);
+  sort(values.begin(), values.end());
+  return values;
+}
+}  // namespace
+
+UNIT_TEST(BTreeIntervalIndex_Empty)
+{
+  vector<CellIdFeaturePairForTest> const data;
+  vector<char> const serialIndex = BuildBTreeIndex(data);
+  MemReader reader(serialIndex.data(), serialIndex.size());
+  BTreeIntervalIndex<MemReader> index(reader);
+  TEST_EQUAL(index.GetLeavesCount(), 0, ());
+
+  vector<uint32_t> values;
+  index.ForEach(MakeBackInsertFunctor(values), 0, 0xFFFFFFFFFFULL);
+  TEST(values.empty(), ());
+}
+
+UNIT_TEST(BTreeIntervalIndex_Simple)
+{
+  vector<CellIdFeaturePairForTest> data;
+  data.emplace_back(0x1537U, 0);
+  data.emplace_back(0x1538U, 1);
+  data.emplace_back(0x1538U, 3);
+  data.emplace_back(0x1637U, 2);
+  vector<char> const serialIndex = BuildBTreeIndex(data);
+  MemReader reader(serialIndex.data(), serialIndex.size());
+  BTreeIntervalIndex<MemReader> index(reader);
+  TEST_EQUAL(index.GetLeavesCount(), 1, ());
+
+  {
+    vector<uint32_t> values;
+    index.ForEach(MakeBackInsertFunctor(values), 0, 0xFFFFFFFFFFULL);
+    TEST_EQUAL(values, vector<uint32_t>({0, 1, 3, 2}), ());
+  }
+  {
+    vector<uint32_t> values;
+    index.ForEach(MakeBackInsertFunctor(values), 0x1538U, 0x1637U);
+    TEST_EQUAL(values, vector<uint32_t>({1, 3}), ());
+  }
+  {
+    vector<uint32_t> values;
+    index.ForEach(MakeBackInsertFunctor(values), 0x1638U, 0x2000U);
+    TEST(values.empty(), ());
+  }
+  {
+    // Intervals aren't sorted.
+    TIntervals const intervals = {{0x1637, 0x1638}, {0x1500, 0x1538}, {0x1538, 0x1537}};
+    TEST_EQUAL(GetValues(index, intervals), vector<uint32_t>({0, 2}), ());
+  }
+}
+
+UNIT_TEST(BTreeIntervalIndex_LongRunsOfCell)
+{
+  // Pairs of the same cell span several leaves.
+  vector<CellIdFeaturePairForTest> data;
+  for (uint32_t i = 0; i < 10000; ++i)
+    data.emplace_back(i < 5000 ? 10 : 20, i);
+  vector<char> const serialIndex = BuildBTreeIndex(data);
+  MemReader reader(serialIndex.data(), serialIndex.size());
+  BTreeIntervalIndex<MemReader> index(reader);
+  TEST_GREATER(index.GetLeavesCount(), 2, ());
+
+  vector<uint32_t> values;
+  index.ForEach(MakeBackInsertFunctor(values), 20, 21);
+  TEST_EQUAL(values.size(), 5000, ());
+  TEST_EQUAL(values.front(), 5000, ());
+  TEST_EQUAL(values.back(), 9999, ());
+}
+
+UNIT_TEST(BTreeIntervalIndex_Random)
+{
+  uint64_t const maxCell = 1ULL << 40;
+  // Sparse cells take several bytes, so there are two inner levels.
+  vector<CellIdFeaturePairForTest> const data = GetRandomCells(500000, maxCell);
+  vector<char> const serialIndex = BuildBTreeIndex(data);
+  MemReader reader(serialIndex.data(), serialIndex.size());
+  BTreeIntervalIndex<MemReader> index(reader);
+  TEST_GREATER(index.GetLeavesCount(), BTreeIntervalIndexBase::kFanout, ());
+
+  TIntervals const intervals = GetRandomIntervals(100, maxCell, maxCell / 10000);
+  for (auto const & interval : intervals)
+  {
+    TIntervals const single(1, interval);
+    TEST_EQUAL(GetExpected(data, single), GetValues(index, single), (interval));
+  }
+  TEST_EQUAL(GetExpected(data, intervals), GetValues(index, intervals), ());
+}
+
+UNIT_TEST(BTreeIntervalIndex_SameAsIntervalIndex)
+{
+  uint64_t const maxCell = 1ULL << 30;
+  vector<CellIdFeaturePairForTest> const data = GetRandomCells(100000, maxCell);
+
+  vector<char> treeIndex;
+  {
+    MemWriter<vector<char> > writer(treeIndex);
+    IntervalIndexBuilder(32, 1, 8).BuildIndex(writer, data.begin(), data.end());
+  }
+  MemReader treeReader(treeIndex.data(), treeIndex.size());
+  IntervalIndex<MemReader> tree(treeReader);
+
+  vector<char> const btreeIndex = BuildBTreeIndex(data);
+  MemReader btreeReader(btreeIndex.data(), btreeIndex.size());
+  BTreeIntervalIndex<MemReader> btree(btreeReader);
+
+  for (auto const & interval : GetRandomIntervals(1000, maxCell, maxCell / 1000))
+  {
+    vector<uint32_t> expected, values;
+    tree.ForEach(MakeBackInsertFunctor(expected), interval.first, interval.second);
+    btree.ForEach(MakeBackInsertFunctor(values), interval.first, interval.second);
+    TEST_EQUAL(expected, values, (interval));
+  }
+}
+
+#ifndef DEBUG
+namespace
+{
+string const kIndexFile = "btree_interval_index_benchmark.tmp";
+uint64_t const kMaxCell = 1ULL << 32;
+
+void WriteIndexFile(vector<CellIdFeaturePairForTest> const & data, bool btree)
+{
+  FileWriter writer(kIndexFile);
+  if (btree)
+    BuildBTreeIntervalIndex(data.begin(), data.end(), writer);
+  else
+    IntervalIndexBuilder(32, 1, 8).BuildIndex(writer, data.begin(), data.end());
+}
+
+// Drops pages of the index file from the page cache. Where it isn't supported the cold run
+// only starts with empty caches of FileReader.
+void DropPageCache()
+{
+#if defined(OMIM_OS_LINUX)
+  int const fd = open(kIndexFile.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+#endif
+}
+
+// Every query is a batch of intervals of a rect covering.
+template <template <class> class TIndex>
+void BenchmarkForEach(bool cold)
+{
+  vector<CellIdFeaturePairForTest> const data = GetRandomCells(2000000, kMaxCell);
+  WriteIndexFile(data, is_same<TIndex<FileReader>, BTreeIntervalIndex<FileReader>>::value);
+  MY_SCOPE_GUARD(deleteFile, bind(&FileWriter::DeleteFileX, kIndexFile));
+
+  mt19937 rng(0);
+  uniform_int_distribution<uint64_t> begDist(0, kMaxCell);
+  FileReader warmReader(kIndexFile);
+  TIndex<FileReader> warmIndex(warmReader);
+  BENCHMARK_N_TIMES(cold ? 1000 : 10000, 20.0)
+  {
+    TIntervals intervals;
+    uint64_t const beg = begDist(rng);
+    for (uint64_t i = 0; i < 8; ++i)
+      intervals.emplace_back(beg + i * 100000, beg + i * 100000 + 10000);
+
+    vector<uint32_t> values;
+    if (cold)
+    {
+      DropPageCache();
+      FileReader reader(kIndexFile);
+      TIndex<FileReader>(reader).ForEachInIntervals(MakeBackInsertFunctor(values), intervals);
+    }
+    else
+    {
+      warmIndex.ForEachInIntervals(MakeBackInsertFunctor(values), intervals);
+    }
+    FORCE_USE_VALUE(values.size());
+  }
+}
+
+// IntervalIndex with the interface of BTreeIntervalIndex for batches.
+template <class ReaderT>
+class TreeIndex : public IntervalIndex<ReaderT>
+{
+public:
+  explicit TreeIndex(ReaderT const & reader) : IntervalIndex<ReaderT>(reader) {}
+
+  template <typename F>
+  void ForEachInIntervals(F const & f, TIntervals const & intervals) const
+  {
+    for (auto const & interval : intervals)
+      this->ForEach(f, interval.first, interval.second);
+  }
+};
+}  // namespace
+
+BENCHMARK_TEST(BTreeIntervalIndex_TreeWarmCache)
+{
+  BenchmarkForEach<TreeIndex>(false /* cold */);
+}
+
+BENCHMARK_TEST(BTreeIntervalIndex_BTreeWarmCache)
+{
+  BenchmarkForEach<BTreeIntervalIndex>(false /* cold */);
+}
+
+BENCHMARK_TEST(BTreeIntervalIndex_TreeColdCache)
+{
+  BenchmarkForEach<TreeIndex>(true /* cold */);
+}
+
+BENCHMARK_TEST(BTreeIntervalIndex_BTreeColdCache)
+{
+  BenchmarkForEach<BTreeIntervalIndex>(true /* cold */);
+}
+#endif
@@ -0,0 +1,150 @@
+#include "testing/testing.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/index.hpp"
+#include "indexer/index_query_cache.hpp"
+#include "indexer/scales.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "base/macros.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/map.hpp"
+#include "std/set.hpp"
+#include "std/sstream.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace
+{
+class FeatureIDsCollector
+{
+public:
+  void operator()(FeatureType const & ft) { m_ids.push_back(ft.GetID()); }
+  void operator()(FeatureID const & id) { m_ids.push_back(id); }
+
+  vector<FeatureID> m_ids;
+};
+
+// Collects attributes of features, geometry and metadata of lines are taken from full features.
+class FeatureDescriptionsCollector
+{
+public:
+  void operator()(FeatureType const & ft) { Add(ft, ft, ft.GetID()); }
+  void operator()(FeatureView const & ft) { Add(ft, ft.GetFeature(), ft.GetID()); }
+
+  map<FeatureID, string> m_descriptions;
+
+private:
+  void Add(FeatureBase const & ft, FeatureType const & full, FeatureID const & id)
+  {
+    ostringstream os;
+    ft.ForEachType([&os](uint32_t type) { os << type << ' '; });
+    string name;
+    ft.GetName(FeatureBase::DEFAULT_LANG, name);
+    os << name << ' ' << ft.GetHouseNumber() << ' ' << static_cast<int>(ft.GetRank()) << ' ';
+    if (ft.GetFeatureType() == feature::GEOM_POINT)
+      os << DebugPrint(ft.GetCenter());
+    if (ft.GetFeatureType() == feature::GEOM_LINE)
+    {
+      full.ParseGeometry(FeatureType::BEST_GEOMETRY);
+      full.ParseMetadata();
+      os << full.GetPointsCount() << ' ' << DebugPrint(full.GetPoint(0)) << ' '
+         << full.GetMetadata().Size();
+    }
+    TEST(m_descriptions.emplace(id, os.str()).second, (id));
+  }
+};
+
+set<FeatureID> ToSet(vector<FeatureID> const & ids) { return set<FeatureID>(ids.begin(), ids.end()); }
+
+vector<m2::RectD> GetGrid(m2::RectD const & rect, size_t n)
+{
+  vector<m2::RectD> rects;
+  double const w = rect.SizeX() / n;
+  double const h = rect.SizeY() / n;
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (size_t j = 0; j < n; ++j)
+    {
+      m2::PointD const p(rect.minX() + w * i, rect.minY() + h * j);
+      rects.emplace_back(p, p + m2::PointD(w / 3, h / 3));
+    }
+  }
+  return rects;
+}
+}  // namespace
+
+UNIT_TEST(IndexQueryCache_SameAsIndex)
+{
+  Index index;
+  auto const p = index.RegisterMap(platform::LocalCountryFile::MakeForTesting("minsk-pass"));
+  TEST_EQUAL(p.second, MwmSet::RegResult::Success, ());
+  m2::RectD const limitRect = p.first.GetInfo()->m_limitRect;
+
+  IndexQueryCache cache(index);
+  vector<m2::RectD> const rects = GetGrid(limitRect, 4);
+  for (uint32_t scale : {10U, 15U, static_cast<uint32_t>(scales::GetUpperScale())})
+  {
+    set<FeatureID> batchExpected;
+    for (m2::RectD const & rect : rects)
+    {
+      FeatureIDsCollector expected;
+      index.ForEachInRect(expected, rect, scale);
+      FeatureIDsCollector actual;
+      cache.ForEachInRect(actual, rect, scale);
+      TEST_EQUAL(ToSet(expected.m_ids), ToSet(actual.m_ids), (rect, scale));
+      TEST_EQUAL(actual.m_ids.size(), ToSet(actual.m_ids).size(), (rect, scale));
+      batchExpected.insert(expected.m_ids.begin(), expected.m_ids.end());
+    }
+
+    // Every feature of a batch is visited once.
+    FeatureIDsCollector batch;
+    cache.ForEachFeatureIDInRects(batch, rects, scale);
+    TEST_EQUAL(batchExpected, ToSet(batch.m_ids), (scale));
+    TEST_EQUAL(batch.m_ids.size(), batchExpected.size(), (scale));
+  }
+
+  // Same queries are answered from the cache.
+  uint64_t const misses = cache.GetStats().m_misses;
+  FeatureIDsCollector ids;
+  cache.ForEachFeatureIDInRects(ids, rects, scales::GetUpperScale());
+  TEST_EQUAL(cache.GetStats().m_misses, misses, ());
+  TEST(!ids.m_ids.empty(), ());
+
+  // Ids of a deregistered map aren't returned.
+  TEST(index.DeregisterMap(p.first.GetInfo()->GetLocalFile().GetCountryFile()), ());
+  FeatureIDsCollector empty;
+  cache.ForEachFeatureIDInRects(empty, rects, scales::GetUpperScale());
+  TEST(empty.m_ids.empty(), ());
+}
+
+UNIT_TEST(IndexQueryCache_FeatureViews)
+{
+  classificator::Load();
+
+  Index index;
+  auto const p = index.RegisterMap(platform::LocalCountryFile::MakeForTesting("minsk-pass"));
+  TEST_EQUAL(p.second, MwmSet::RegResult::Success, ());
+  m2::RectD const limitRect = p.first.GetInfo()->m_limitRect;
+
+  IndexQueryCache cache(index);
+  for (uint32_t scale : {10U, static_cast<uint32_t>(scales::GetUpperScale())})
+  {
+    for (m2::RectD const & rect : GetGrid(limitRect, 3))
+    {
+      FeatureDescriptionsCollector expected;
+      index.ForEachInRect(expected, rect, scale);
+
+      FeatureDescriptionsCollector views;
+      index.ForEachViewInRect(views, rect, scale);
+      TEST_EQUAL(expected.m_descriptions, views.m_descriptions, (rect, scale));
+
+      FeatureDescriptionsCollector cachedViews;
+      cache.ForEachViewInRect(cachedViews, rect, scale);
+      TEST_EQUAL(expected.m_descriptions, cachedViews.m_descriptions, (rect, scale));
+    }
+  }
+}
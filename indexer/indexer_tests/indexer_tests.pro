@@ -17,6 +17,7 @@ HEADERS += \
 
 SOURCES += \
     ../../testing/testingmain.cpp \
+    btree_interval_index_test.cpp \
     categories_test.cpp \
     cell_coverer_test.cpp \
     cell_id_test.cpp \
@@ -26,6 +27,7 @@ SOURCES += \
     geometry_coding_test.cpp \
     geometry_serialization_test.cpp \
     index_builder_test.cpp \
+    index_query_cache_test.cpp \
     index_test.cpp \
     interval_index_test.cpp \
     mercator_test.cpp \
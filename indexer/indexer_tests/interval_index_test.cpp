@@ -1,10 +1,16 @@
 #include "testing/testing.hpp"
+#include "testing/benchmark.hpp"
 #include "indexer/interval_index.hpp"
 #include "indexer/interval_index_builder.hpp"
+#include "coding/byte_stream.hpp"
+#include "coding/endianness.hpp"
 #include "coding/reader.hpp"
+#include "coding/varint.hpp"
 #include "coding/writer.hpp"
 #include "base/macros.hpp"
 #include "base/stl_add.hpp"
+#include "std/algorithm.hpp"
+#include "std/random.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
 
@@ -18,6 +24,32 @@ struct CellIdFeaturePairForTest
   uint64_t m_Cell;
   uint32_t m_Feature;
 };
+
+// Leaves contain tens of cells, a half of cells is coarse, and features are numbered along
+// the cells like in mwm, so deltas of values are small.
+vector<CellIdFeaturePairForTest> GetRandomCells(size_t count)
+{
+  mt19937 rng(0);
+  uniform_int_distribution<uint64_t> cellDist(0x10, 8 * count);
+  geometric_distribution<uint32_t> noiseDist(0.3);
+  vector<uint64_t> cells(count);
+  for (size_t i = 0; i < cells.size(); ++i)
+    cells[i] = i % 2 == 0 ? cellDist(rng) : (cellDist(rng) | 0xF) - 0xF;
+  sort(cells.begin(), cells.end());
+
+  vector<CellIdFeaturePairForTest> data;
+  for (size_t i = 0; i < cells.size(); ++i)
+    data.emplace_back(cells[i], static_cast<uint32_t>(i / 4 + noiseDist(rng)));
+  return data;
+}
+
+vector<char> BuildIndex(vector<CellIdFeaturePairForTest> const & data, bool allowAnsLeaves)
+{
+  vector<char> serialIndex;
+  MemWriter<vector<char> > writer(serialIndex);
+  IntervalIndexBuilder(32, 1, 8, allowAnsLeaves).BuildIndex(writer, data.begin(), data.end());
+  return serialIndex;
+}
 }
 
 UNIT_TEST(IntervalIndex_LevelCount)
@@ -276,3 +308,101 @@ UNIT_TEST(IntervalIndex_Simple5)
   }
 }
 
+UNIT_TEST(IntervalIndex_AnsLeaves)
+{
+  vector<CellIdFeaturePairForTest> const data = GetRandomCells(20000);
+  vector<char> const plainIndex = BuildIndex(data, false /* allowAnsLeaves */);
+  vector<char> const ansIndex = BuildIndex(data, true /* allowAnsLeaves */);
+  TEST_EQUAL(plainIndex[0], IntervalIndexBase::kVersion, ());
+  TEST_EQUAL(ansIndex[0], IntervalIndexBase::kAnsVersion, ());
+  TEST_LESS(ansIndex.size(), plainIndex.size(), ());
+
+  MemReader plainReader(plainIndex.data(), plainIndex.size());
+  IntervalIndex<MemReader> plain(plainReader);
+  MemReader ansReader(ansIndex.data(), ansIndex.size());
+  IntervalIndex<MemReader> ans(ansReader);
+
+  mt19937 rng(1);
+  uniform_int_distribution<uint64_t> keyDist(0, data.back().GetCell() + 1);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    uint64_t beg = keyDist(rng);
+    uint64_t end = i % 2 == 0 ? keyDist(rng) : beg + 1000;
+    if (beg > end)
+      swap(beg, end);
+    vector<uint32_t> expected, values;
+    plain.ForEach(MakeBackInsertFunctor(expected), beg, end);
+    ans.ForEach(MakeBackInsertFunctor(values), beg, end);
+    TEST_EQUAL(expected, values, (beg, end));
+  }
+}
+
+UNIT_TEST(IntervalIndex_CorruptedAnsLeaf)
+{
+  vector<CellIdFeaturePairForTest> const data = GetRandomCells(20000);
+  vector<char> ansIndex = BuildIndex(data, true /* allowAnsLeaves */);
+  TEST_EQUAL(ansIndex[0], IntervalIndexBase::kAnsVersion, ());
+
+  // Doubles the decoded size of the first leaf, so its code ends too early.
+  uint32_t leavesOffset;
+  memcpy(&leavesOffset, &ansIndex[sizeof(IntervalIndexBase::Header)], sizeof(leavesOffset));
+  leavesOffset = SwapIfBigEndian(leavesOffset);
+  ArrayByteSource src(&ansIndex[leavesOffset]);
+  uint32_t const sizeAndFlag = ReadVarUint<uint32_t>(src);
+  TEST_EQUAL(sizeAndFlag & 1, 1, ());
+  vector<char> corrupted;
+  {
+    MemWriter<vector<char>> writer(corrupted);
+    WriteVarUint(writer, sizeAndFlag * 2 - 1);
+  }
+  TEST_EQUAL(corrupted.size(), static_cast<char const *>(src.Ptr()) - &ansIndex[leavesOffset],
+             ());
+  copy(corrupted.begin(), corrupted.end(), ansIndex.begin() + leavesOffset);
+
+  MemReader reader(ansIndex.data(), ansIndex.size());
+  IntervalIndex<MemReader> index(reader);
+  vector<uint32_t> values;
+  bool thrown = false;
+  try
+  {
+    index.ForEach(MakeBackInsertFunctor(values), 0, data.front().GetCell() + 1);
+  }
+  catch (Reader::ReadException const &)
+  {
+    thrown = true;
+  }
+  TEST(thrown, ());
+}
+
+#ifndef DEBUG
+namespace
+{
+void BenchmarkForEach(bool allowAnsLeaves)
+{
+  vector<CellIdFeaturePairForTest> const data = GetRandomCells(200000);
+  vector<char> const serialIndex = BuildIndex(data, allowAnsLeaves);
+  MemReader reader(serialIndex.data(), serialIndex.size());
+  IntervalIndex<MemReader> index(reader);
+
+  mt19937 rng(0);
+  uniform_int_distribution<uint64_t> keyDist(0, data.back().GetCell());
+  BENCHMARK_N_TIMES(10000, 10.0)
+  {
+    uint64_t const beg = keyDist(rng);
+    vector<uint32_t> values;
+    index.ForEach(MakeBackInsertFunctor(values), beg, beg + 10000);
+    FORCE_USE_VALUE(values.size());
+  }
+}
+}  // namespace
+
+BENCHMARK_TEST(IntervalIndex_ForEachPlainLeaves)
+{
+  BenchmarkForEach(false /* allowAnsLeaves */);
+}
+
+BENCHMARK_TEST(IntervalIndex_ForEachAnsLeaves)
+{
+  BenchmarkForEach(true /* allowAnsLeaves */);
+}
+#endif
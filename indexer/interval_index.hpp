@@ -3,6 +3,7 @@
 
 #include "coding/endianness.hpp"
 #include "coding/byte_stream.hpp"
+#include "coding/ans_codec.hpp"
 #include "coding/reader.hpp"
 #include "coding/varint.hpp"
 
@@ -30,7 +31,10 @@ public:
     return 1 << (bitsPerLevel - 3);
   }
 
-  enum { kVersion = 1 };
+  // In kAnsVersion every leaf is prefixed with (leaf size << 1) | (is leaf coded) and coded
+  // leaves are decoded with the table which follows level offsets.
+  // kBTreeVersion is another layout, see btree_interval_index.hpp.
+  enum { kVersion = 1, kAnsVersion = 2, kBTreeVersion = 3 };
 };
 
 template <class ReaderT>
@@ -43,10 +47,13 @@ public:
   {
     ReaderSource<ReaderT> src(reader);
     src.Read(&m_Header, sizeof(Header));
-    CHECK_EQUAL(m_Header.m_Version, static_cast<uint8_t>(kVersion), ());
+    CHECK(m_Header.m_Version == kVersion || m_Header.m_Version == kAnsVersion,
+          (m_Header.m_Version));
     if (m_Header.m_Levels != 0)
       for (int i = 0; i <= m_Header.m_Levels + 1; ++i)
         m_LevelOffsets.push_back(ReadPrimitiveFromSource<uint32_t>(src));
+    if (m_Header.m_Version == kAnsVersion)
+      m_LeavesTable.Deserialize(src);
   }
 
   uint64_t KeyEnd() const
@@ -86,11 +93,30 @@ private:
     data.resize_no_init(size);
 
     m_Reader.Read(offset, &data[0], size);
-    ArrayByteSource src(&data[0]);
+    uint8_t const * pBeg = &data[0];
+    uint8_t const * pEnd = pBeg + size;
+
+    buffer_vector<uint8_t, 1024> decoded;
+    if (m_Header.m_Version == kAnsVersion)
+    {
+      ArrayByteSource sizeSrc(pBeg);
+      uint32_t const sizeAndFlag = ReadVarUint<uint32_t>(sizeSrc);
+      pBeg = sizeSrc.PtrUC();
+      if (sizeAndFlag & 1)
+      {
+        decoded.resize_no_init(sizeAndFlag >> 1);
+        if (m_LeavesTable.Decode(pBeg, pEnd, &decoded[0], decoded.size()) != pEnd)
+        {
+          MYTHROW(Reader::ReadException, ("Corrupted leaf", offset, size));
+        }
+        pBeg = &decoded[0];
+        pEnd = pBeg + decoded.size();
+      }
+    }
 
-    void const * pEnd = &data[0] + size;
+    ArrayByteSource src(pBeg);
     uint32_t value = 0;
-    while (src.Ptr() < pEnd)
+    while (src.PtrUC() < pEnd)
     {
       uint32_t key = 0;
       src.Read(&key, m_Header.m_LeafBytes);
@@ -177,4 +203,5 @@ private:
   ReaderT m_Reader;
   Header m_Header;
   buffer_vector<uint32_t, 7> m_LevelOffsets;
+  coding::AnsTable m_LeavesTable;
 };
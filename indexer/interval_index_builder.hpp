@@ -2,8 +2,10 @@
 #include "indexer/interval_index.hpp"
 #include "coding/byte_stream.hpp"
 #include "coding/endianness.hpp"
+#include "coding/ans_codec.hpp"
 #include "coding/varint.hpp"
 #include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
 #include "base/assert.hpp"
 #include "base/base.hpp"
 #include "base/bits.hpp"
@@ -21,6 +23,8 @@
 // +------------------------------+
 // |        Level N offset        |
 // +------------------------------+
+// |   Leaves ANS table or none   |
+// +------------------------------+
 // |        Leaves  data          |
 // +------------------------------+
 // |        Level 1 data          |
@@ -33,8 +37,11 @@
 class IntervalIndexBuilder
 {
 public:
-  IntervalIndexBuilder(uint32_t keyBits, uint32_t leafBytes, uint32_t bitsPerLevel = 8)
-    : m_BitsPerLevel(bitsPerLevel), m_LeafBytes(leafBytes)
+  // When |allowAnsLeaves| is true, leaves are entropy coded if it makes them at least
+  // kMinAnsGainPercent smaller.
+  IntervalIndexBuilder(uint32_t keyBits, uint32_t leafBytes, uint32_t bitsPerLevel = 8,
+                       bool allowAnsLeaves = false)
+    : m_BitsPerLevel(bitsPerLevel), m_LeafBytes(leafBytes), m_AllowAnsLeaves(allowAnsLeaves)
   {
     CHECK_GREATER(leafBytes, 0, ());
     CHECK_LESS(keyBits, 63, ());
@@ -67,11 +74,24 @@ public:
     WriteZeroesToSink(writer, 4 * (m_Levels + 2));
     uint64_t const afterHeaderPos = writer.Pos();
 
+    uint8_t version = IntervalIndexBase::kVersion;
     vector<uint32_t> levelOffset;
     {
+      // Leaves are built in memory to choose their coding.
       vector<uint32_t> offsets;
+      vector<uint8_t> leaves;
+      {
+        MemWriter<vector<uint8_t>> leavesWriter(leaves);
+        BuildLeaves(leavesWriter, beg, end, offsets);
+      }
+      coding::AnsTable table;
+      if (m_AllowAnsLeaves && EncodeAnsLeaves(leaves, offsets, table))
+      {
+        version = IntervalIndexBase::kAnsVersion;
+        table.Serialize(writer);
+      }
       levelOffset.push_back(static_cast<uint32_t>(writer.Pos()));
-      BuildLeaves(writer, beg, end, offsets);
+      writer.Write(leaves.data(), leaves.size());
       levelOffset.push_back(static_cast<uint32_t>(writer.Pos()));
       for (int i = 1; i <= static_cast<int>(m_Levels); ++i)
       {
@@ -88,7 +108,7 @@ public:
     // Write header.
     {
       IntervalIndexBase::Header header;
-      header.m_Version = IntervalIndexBase::kVersion;
+      header.m_Version = version;
       header.m_BitsPerLevel = static_cast<uint8_t>(m_BitsPerLevel);
       ASSERT_EQUAL(header.m_BitsPerLevel, m_BitsPerLevel, ());
       header.m_Levels = static_cast<uint8_t>(m_Levels);
@@ -231,6 +251,54 @@ public:
     sizes.push_back(static_cast<uint32_t>(writer.Pos() - prevPos));
   }
 
+  // Codes every leaf with the table of all leaves bytes and prefixes it with its size.
+  // Returns false and leaves |leaves| and |sizes| untouched if the gain is too small.
+  bool EncodeAnsLeaves(vector<uint8_t> & leaves, vector<uint32_t> & sizes,
+                       coding::AnsTable & table) const
+  {
+    vector<uint64_t> counts(coding::AnsTable::kAlphabetSize);
+    for (uint8_t b : leaves)
+      ++counts[b];
+    table = coding::AnsTable(counts);
+
+    vector<uint8_t> encoded;
+    encoded.reserve(leaves.size());
+    {
+      PushBackByteSink<vector<uint8_t>> sink(encoded);
+      table.Serialize(sink);
+    }
+    size_t const tableSize = encoded.size();
+
+    vector<uint32_t> encodedSizes;
+    encodedSizes.reserve(sizes.size());
+    vector<uint8_t> code;
+    uint8_t const * leaf = leaves.data();
+    for (uint32_t const size : sizes)
+    {
+      code.clear();
+      table.Encode(leaf, size, code);
+      // The leaf stays plain if coding doesn't make it smaller.
+      bool const isCoded = code.size() < size;
+      size_t const leafPos = encoded.size();
+      {
+        PushBackByteSink<vector<uint8_t>> sink(encoded);
+        WriteVarUint(sink, (size << 1) | (isCoded ? 1 : 0));
+      }
+      if (isCoded)
+        encoded.insert(encoded.end(), code.begin(), code.end());
+      else
+        encoded.insert(encoded.end(), leaf, leaf + size);
+      encodedSizes.push_back(static_cast<uint32_t>(encoded.size() - leafPos));
+      leaf += size;
+    }
+
+    if (encoded.size() * 100 > leaves.size() * (100 - kMinAnsGainPercent))
+      return false;
+    leaves.assign(encoded.begin() + tableSize, encoded.end());
+    sizes.swap(encodedSizes);
+    return true;
+  }
+
   template <class SinkT>
   void WriteBitmapNode(SinkT & sink, uint32_t offset, uint32_t * childSizes)
   {
@@ -261,13 +329,19 @@ public:
     }
   }
 
+  // Coded leaves are decoded about two times slower than plain ones, so a small gain
+  // isn't worth it.
+  static uint32_t const kMinAnsGainPercent = 10;
+
 private:
   uint32_t m_Levels, m_BitsPerLevel, m_LeafBytes, m_LastBitsMask;
+  bool m_AllowAnsLeaves;
 };
 
 template <class WriterT, typename CellIdValueIterT>
 void BuildIntervalIndex(CellIdValueIterT const & beg, CellIdValueIterT const & end,
-                        WriterT & writer, uint32_t keyBits)
+                        WriterT & writer, uint32_t keyBits, bool allowAnsLeaves = false)
 {
-  IntervalIndexBuilder(keyBits, 1).BuildIndex(writer, beg, end);
+  IntervalIndexBuilder(keyBits, 1, 8 /* bitsPerLevel */, allowAnsLeaves)
+      .BuildIndex(writer, beg, end);
 }
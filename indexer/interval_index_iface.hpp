@@ -2,6 +2,8 @@
 
 #include "std/cstdint.hpp"
 #include "std/function.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
 
 
 class IntervalIndexIFace
@@ -10,6 +12,14 @@ public:
   virtual ~IntervalIndexIFace() {}
 
   typedef function<void (uint32_t)> FunctionT;
+  typedef vector<pair<int64_t, int64_t> > IntervalsT;
 
   virtual void DoForEach(FunctionT const & f, uint64_t beg, uint64_t end) = 0;
+
+  /// Calls f for values in all [beg, end) |intervals|. Values are passed in any order.
+  virtual void DoForEachInIntervals(FunctionT const & f, IntervalsT const & intervals)
+  {
+    for (auto const & interval : intervals)
+      DoForEach(f, interval.first, interval.second);
+  }
 };
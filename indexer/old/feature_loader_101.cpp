@@ -147,9 +147,9 @@ void LoaderImpl::ParseTypes()
 
   static TypeConvertor typeC;
 
-  size_t const count = m_pF->GetTypesCount();
+  size_t const count = m_pBase->GetTypesCount();
   for (size_t i = 0; i < count; ++i)
-    m_pF->m_types[i] = typeC.Convert(ReadVarUint<uint32_t>(source));
+    m_pBase->m_types[i] = typeC.Convert(ReadVarUint<uint32_t>(source));
 
   m_CommonOffset = CalcOffset(source);
 }
@@ -161,22 +161,22 @@ void LoaderImpl::ParseCommon()
   uint8_t const h = Header();
 
   if (h & HEADER_HAS_LAYER)
-    m_pF->m_params.layer = ReadVarInt<int32_t>(source);
+    m_pBase->m_params.layer = ReadVarInt<int32_t>(source);
 
   if (h & HEADER_HAS_NAME)
   {
     string name;
     name.resize(ReadVarUint<uint32_t>(source) + 1);
     source.Read(&name[0], name.size());
-    m_pF->m_params.name.AddString(StringUtf8Multilang::DEFAULT_CODE, name);
+    m_pBase->m_params.name.AddString(StringUtf8Multilang::DEFAULT_CODE, name);
   }
 
   if (h & HEADER_HAS_POINT)
   {
-    m_pF->m_center = Int64ToPoint(
+    m_pBase->m_center = Int64ToPoint(
           ReadVarInt<int64_t>(source) + GetDefCodingParams().GetBasePointInt64(), POINT_COORD_BITS);
 
-    m_pF->m_limitRect.Add(m_pF->m_center);
+    m_pBase->m_limitRect.Add(m_pBase->m_center);
   }
 
   m_Header2Offset = CalcOffset(source);
@@ -69,6 +69,21 @@ public:
     }
   }
 
+  /// Features of a bucket are visited for all intervals at once, so indexes which support
+  /// batches read every node once.
+  template <typename F>
+  void ForEachInIntervalsAndScale(F const & f, IntervalIndexIFace::IntervalsT const & intervals,
+                                  uint32_t scale) const
+  {
+    size_t const scaleBucket = BucketByScale(scale);
+    if (scaleBucket < m_IndexForScale.size())
+    {
+      IntervalIndexIFace::FunctionT f1(cref(f));
+      for (size_t i = 0; i <= scaleBucket; ++i)
+        m_IndexForScale[i]->DoForEachInIntervals(f1, intervals);
+    }
+  }
+
 private:
   vector<IntervalIndexIFace *> m_IndexForScale;
 };
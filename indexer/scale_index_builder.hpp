@@ -4,6 +4,7 @@
 #include "indexer/feature.hpp"
 #include "indexer/feature_covering.hpp"
 #include "indexer/feature_visibility.hpp"
+#include "indexer/btree_interval_index_builder.hpp"
 #include "indexer/interval_index_builder.hpp"
 
 #include "defines.hpp"
@@ -26,6 +27,18 @@
 
 namespace covering
 {
+// Layout of interval indexes of scale buckets.
+enum class IndexLayout
+{
+  // Tree of varint coded nodes, see interval_index_builder.hpp.
+  Tree,
+  // Tree whose leaves are entropy coded when it makes them smaller. Such leaves are decoded
+  // about two times slower, so this layout is opt-in.
+  TreeWithAnsLeaves,
+  // Static B+-tree with page sized nodes, see btree_interval_index_builder.hpp.
+  BTree
+};
+
 class CellFeaturePair
 {
 public:
@@ -194,7 +207,8 @@ private:
 
 template <class TFeaturesVector, class TWriter>
 void IndexScales(feature::DataHeader const & header, TFeaturesVector const & features,
-                 TWriter & writer, string const & tmpFilePrefix)
+                 TWriter & writer, string const & tmpFilePrefix,
+                 IndexLayout layout = IndexLayout::Tree)
 {
   // TODO: Make scale bucketing dynamic.
 
@@ -251,8 +265,12 @@ void IndexScales(feature::DataHeader const & header, TFeaturesVector const & fea
       DDVector<CellFeaturePair, FileReader, uint64_t> cellsToFeatures(reader);
       SubWriter<TWriter> subWriter(writer);
       LOG(LINFO, ("Building interval index for bucket:", bucket));
-      BuildIntervalIndex(cellsToFeatures.begin(), cellsToFeatures.end(), subWriter,
-                         RectId::DEPTH_LEVELS * 2 + 1);
+      if (layout == IndexLayout::BTree)
+        BuildBTreeIntervalIndex(cellsToFeatures.begin(), cellsToFeatures.end(), subWriter);
+      else
+        BuildIntervalIndex(cellsToFeatures.begin(), cellsToFeatures.end(), subWriter,
+                           RectId::DEPTH_LEVELS * 2 + 1,
+                           layout == IndexLayout::TreeWithAnsLeaves /* allowAnsLeaves */);
     }
     recordWriter.FinishRecord();
   }
@@ -2,6 +2,7 @@
 
 #include "indexer/categories_holder.hpp"
 #include "indexer/classificator.hpp"
+#include "indexer/data_header.hpp"
 #include "indexer/feature_algo.hpp"
 #include "indexer/feature_utils.hpp"
 #include "indexer/feature_visibility.hpp"
@@ -18,6 +19,7 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/louds_trie_builder.hpp"
 #include "coding/reader_writer_ops.hpp"
 #include "coding/trie_builder.hpp"
 #include "coding/writer.hpp"
@@ -405,10 +407,19 @@ void BuildSearchIndex(FilesContainerR const & cont, CategoriesHolder const & cat
 
     names.EndAdding();
     names.OpenForRead();
-    
-    trie::Build<Writer, typename StringsFile<SerializedFeatureInfoValue>::IteratorT,
-                trie::EmptyEdgeBuilder, ValueList<SerializedFeatureInfoValue>>(
-        writer, names.Begin(), names.End(), trie::EmptyEdgeBuilder());
+
+    if (search::IsLoudsSearchIndex(header.GetFormat()))
+    {
+      trie::BuildLoudsTrie<Writer, typename StringsFile<SerializedFeatureInfoValue>::IteratorT,
+                           ValueList<SerializedFeatureInfoValue>>(writer, names.Begin(),
+                                                                  names.End());
+    }
+    else
+    {
+      trie::Build<Writer, typename StringsFile<SerializedFeatureInfoValue>::IteratorT,
+                  trie::EmptyEdgeBuilder, ValueList<SerializedFeatureInfoValue>>(
+          writer, names.Begin(), names.End(), trie::EmptyEdgeBuilder());
+    }
 
     // at this point all readers of StringsFile should be dead
   }
@@ -427,6 +438,7 @@ bool BuildSearchIndexFromDatFile(string const & datFile, bool forceRebuild)
     Platform & pl = GetPlatform();
     string const tmpFile1 = datFile + ".search_index_1.tmp";
     string const tmpFile2 = datFile + ".search_index_2.tmp";
+    bool isLoudsIndex = false;
 
     {
       FilesContainerR readCont(datFile);
@@ -434,6 +446,8 @@ bool BuildSearchIndexFromDatFile(string const & datFile, bool forceRebuild)
       if (!forceRebuild && readCont.IsExist(SEARCH_INDEX_FILE_TAG))
         return true;
 
+      isLoudsIndex = search::IsLoudsSearchIndex(feature::DataHeader(readCont).GetFormat());
+
       FileWriter writer(tmpFile2);
 
       CategoriesHolder catHolder(pl.GetReader(SEARCH_CATEGORIES_FILE_NAME));
@@ -443,6 +457,13 @@ bool BuildSearchIndexFromDatFile(string const & datFile, bool forceRebuild)
       LOG(LINFO, ("Search index size = ", writer.Size()));
     }
 
+    if (isLoudsIndex)
+    {
+      // Louds trie is written in the direct order to be mapped as is.
+      FilesContainerW writeCont(datFile, FileWriter::OP_WRITE_EXISTING);
+      writeCont.Write(tmpFile2, SEARCH_INDEX_FILE_TAG);
+    }
+    else
     {
       // Write to container in reversed order.
       FilesContainerW writeCont(datFile, FileWriter::OP_WRITE_EXISTING);
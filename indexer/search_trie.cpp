@@ -0,0 +1,96 @@
+#include "indexer/search_trie.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/louds_trie.hpp"
+
+#include "base/logging.hpp"
+
+#include "defines.hpp"
+
+#include "std/shared_ptr.hpp"
+#include "std/vector.hpp"
+
+namespace trie
+{
+using TLoudsTrie = LoudsTrie<ValueReader>;
+
+// Keeps the search index section mapped (or read to memory when the container
+// can't be mapped) while the trie is used.
+class LoudsTrieHolder
+{
+public:
+  LoudsTrieHolder(FilesContainerR const & cont, serial::CodingParams const & cp) : m_cp(cp)
+  {
+    char const * data = nullptr;
+    uint64_t size = 0;
+    try
+    {
+      m_file.Open(cont.GetFileName());
+      auto const p = cont.GetAbsoluteOffsetAndSize(SEARCH_INDEX_FILE_TAG);
+      m_handle.Assign(m_file.Map(p.first, p.second, SEARCH_INDEX_FILE_TAG));
+      data = m_handle.GetData<char>();
+      size = m_handle.GetSize();
+    }
+    catch (Reader::OpenException const & e)
+    {
+      LOG(LWARNING, ("Can't map search index of", cont.GetFileName(), e.Msg()));
+      ModelReaderPtr reader = cont.GetReader(SEARCH_INDEX_FILE_TAG);
+      size = reader.Size();
+      // Words of uint64_t make the buffer aligned as the trie requires.
+      m_buffer.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+      reader.Read(0, m_buffer.data(), size);
+      data = reinterpret_cast<char const *>(m_buffer.data());
+    }
+    m_trie = make_unique<TLoudsTrie>(data, size, ValueReader(m_cp));
+  }
+
+  TLoudsTrie const & GetTrie() const { return *m_trie; }
+
+private:
+  serial::CodingParams const m_cp;
+  detail::MappedFile m_file;
+  detail::MappedFile::Handle m_handle;
+  vector<uint64_t> m_buffer;
+  unique_ptr<TLoudsTrie> m_trie;
+};
+
+namespace
+{
+unique_ptr<DefaultIterator> GetLoudsRoot(shared_ptr<LoudsTrieHolder const> const & holder)
+{
+  // The trie shares ownership of the holder, so the section is mapped while iterators are alive.
+  shared_ptr<TLoudsTrie const> const trie(holder, &holder->GetTrie());
+  return make_unique<LoudsTrieIterator<ValueReader, TEdgeValueReader>>(trie, trie->GetRoot());
+}
+
+unique_ptr<DefaultIterator> ReadOldTrie(FilesContainerR const & cont,
+                                        serial::CodingParams const & cp)
+{
+  return unique_ptr<DefaultIterator>(
+      ReadTrie(cont.GetReader(SEARCH_INDEX_FILE_TAG), ValueReader(cp), TEdgeValueReader()));
+}
+}  // namespace
+
+SearchTrie::SearchTrie(FilesContainerR const & cont, version::Format format,
+                       serial::CodingParams const & defCodingParams)
+  : m_cont(cont), m_cp(GetCodingParams(defCodingParams))
+{
+  if (search::IsLoudsSearchIndex(format))
+    m_loudsTrie = make_shared<LoudsTrieHolder>(cont, m_cp);
+}
+
+unique_ptr<DefaultIterator> SearchTrie::GetRoot() const
+{
+  if (m_loudsTrie)
+    return GetLoudsRoot(m_loudsTrie);
+  return ReadOldTrie(m_cont, m_cp);
+}
+
+unique_ptr<DefaultIterator> ReadSearchTrie(FilesContainerR const & cont, version::Format format,
+                                           serial::CodingParams const & cp)
+{
+  if (!search::IsLoudsSearchIndex(format))
+    return ReadOldTrie(cont, cp);
+  return GetLoudsRoot(make_shared<LoudsTrieHolder>(cont, cp));
+}
+}  // namespace trie
@@ -6,11 +6,23 @@
 #include "coding/trie.hpp"
 #include "coding/trie_reader.hpp"
 
+#include "platform/mwm_version.hpp"
+
+#include "base/macros.hpp"
+
+#include "std/shared_ptr.hpp"
+#include "std/unique_ptr.hpp"
+
+class FilesContainerR;
 
 namespace search
 {
 static const uint8_t kCategoriesLang = 128;
 static const uint8_t kPointCodingBits = 20;
+
+// Since version::v7 search index is stored as trie::LoudsTrie which is read right from
+// memory-mapped data. Older mwms keep the index in the trie::Build format.
+inline bool IsLoudsSearchIndex(version::Format format) { return format >= version::v7; }
 }  // namespace search
 
 namespace trie
@@ -58,4 +70,33 @@ inline serial::CodingParams GetCodingParams(serial::CodingParams const & orig)
                               PointU2PointD(orig.GetBasePoint(), orig.GetCoordBits()));
 }
 
+class LoudsTrieHolder;
+
+/// Search index of an mwm. A LOUDS trie is mapped and built once, so roots are cheap and all
+/// iterators share it; the trie is alive while the index or any iterator is alive.
+/// Older indexes are read from |cont| for every root, their iterators must not outlive the index.
+class SearchTrie
+{
+  DISALLOW_COPY_AND_MOVE(SearchTrie);
+
+public:
+  /// @param defCodingParams Default coding params of the mwm.
+  SearchTrie(FilesContainerR const & cont, version::Format format,
+             serial::CodingParams const & defCodingParams);
+
+  unique_ptr<DefaultIterator> GetRoot() const;
+
+private:
+  FilesContainerR const & m_cont;
+  serial::CodingParams const m_cp;
+  shared_ptr<LoudsTrieHolder const> m_loudsTrie;
+};
+
+/// Returns the root of the search index from |cont| of the mwm with |format|.
+/// LOUDS tries are memory-mapped and the mapping is alive while the root or any iterator
+/// obtained from it is alive. |cp| must outlive all iterators.
+/// Use it for one-off reads only, mwm values keep SearchTrie.
+unique_ptr<DefaultIterator> ReadSearchTrie(FilesContainerR const & cont, version::Format format,
+                                           serial::CodingParams const & cp);
+
 }  // namespace trie
@@ -12,11 +12,17 @@
 namespace downloader
 {
 
-ChunksDownloadStrategy::ChunksDownloadStrategy(vector<string> const & urls)
+ChunksDownloadStrategy::ChunksDownloadStrategy(vector<string> const & urls,
+                                               size_t connectionsPerServer)
 {
-  // init servers list
-  for (size_t i = 0; i < urls.size(); ++i)
-    m_servers.push_back(ServerT(urls[i], SERVER_READY));
+  ASSERT_GREATER(connectionsPerServer, 0, ());
+
+  // init servers list, every connection is a separate server which fails independently
+  for (size_t i = 0; i < connectionsPerServer; ++i)
+  {
+    for (size_t j = 0; j < urls.size(); ++j)
+      m_servers.push_back(ServerT(urls[j], SERVER_READY));
+  }
 }
 
 pair<ChunksDownloadStrategy::ChunkT *, int>
@@ -129,6 +135,19 @@ int64_t ChunksDownloadStrategy::LoadOrInitChunks( string const & fName,
   return 0;
 }
 
+int64_t ChunksDownloadStrategy::GetCompletePrefixSize() const
+{
+  if (m_chunks.empty())
+    return 0;
+
+  for (size_t i = 0; i < m_chunks.size() - 1; ++i)
+  {
+    if (m_chunks[i].m_status != CHUNK_COMPLETE)
+      return m_chunks[i].m_pos;
+  }
+  return m_chunks.back().m_pos;
+}
+
 void ChunksDownloadStrategy::ChunkFinished(bool success, RangeT const & range)
 {
   pair<ChunkT *, int> res = GetChunk(range);
@@ -58,7 +58,8 @@ private:
   pair<ChunkT *, int> GetChunk(RangeT const & range);
 
 public:
-  ChunksDownloadStrategy(vector<string> const & urls);
+  /// @param[in] connectionsPerServer  Number of chunks downloaded from one server simultaneously.
+  ChunksDownloadStrategy(vector<string> const & urls, size_t connectionsPerServer = 1);
 
   /// Init chunks vector for fileSize.
   void InitChunks(int64_t fileSize, int64_t chunkSize, ChunkStatusT status = CHUNK_FREE);
@@ -70,6 +71,9 @@ public:
   /// @return Already downloaded size.
   int64_t LoadOrInitChunks(string const & fName, int64_t fileSize, int64_t chunkSize);
 
+  /// @return Size of the file beginning which is downloaded completely.
+  int64_t GetCompletePrefixSize() const;
+
   /// Should be called for every completed chunk (no matter successful or not).
   void ChunkFinished(bool success, RangeT const & range);
 
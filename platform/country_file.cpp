@@ -42,6 +42,26 @@ uint32_t CountryFile::GetRemoteSize(MapOptions filesMask) const
   return size;
 }
 
+void CountryFile::SetRemoteHashes(string const & mapSha256, string const & routingSha256)
+{
+  m_mapSha256 = mapSha256;
+  m_routingSha256 = routingSha256;
+}
+
+string CountryFile::GetRemoteHash(MapOptions file) const
+{
+  switch (file)
+  {
+    case MapOptions::Map:
+      return m_mapSha256;
+    case MapOptions::CarRouting:
+      return m_routingSha256;
+    default:
+      ASSERT(false, ("Can't get hash for:", file));
+      return string();
+  }
+}
+
 string DebugPrint(CountryFile const & file)
 {
   ostringstream os;
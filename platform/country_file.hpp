@@ -5,7 +5,7 @@
 
 namespace platform
 {
-// This class represents a country file name and sizes of
+// This class represents a country file name and sizes and hashes of
 // corresponding map files on a server, which should correspond to an
 // entry in countries.txt file. Also, this class can be used to
 // represent a hand-made-country name. Instances of this class don't
@@ -22,6 +22,10 @@ public:
   void SetRemoteSizes(uint32_t mapSize, uint32_t routingSize);
   uint32_t GetRemoteSize(MapOptions filesMask) const;
 
+  // Hashes are SHA-256 hex strings, an empty string means that the hash is unknown.
+  void SetRemoteHashes(string const & mapSha256, string const & routingSha256);
+  string GetRemoteHash(MapOptions file) const;
+
   inline bool operator<(const CountryFile & rhs) const { return m_name < rhs.m_name; }
   inline bool operator==(const CountryFile & rhs) const { return m_name == rhs.m_name; }
   inline bool operator!=(const CountryFile & rhs) const { return !(*this == rhs); }
@@ -33,6 +37,8 @@ private:
   string m_name;
   uint32_t m_mapSize;
   uint32_t m_routingSize;
+  string m_mapSha256;
+  string m_routingSha256;
 };
 
 string DebugPrint(CountryFile const & file);
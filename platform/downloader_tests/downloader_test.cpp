@@ -13,9 +13,11 @@
 
 #include "base/logging.hpp"
 #include "base/std_serialization.hpp"
+#include "base/string_utils.hpp"
 
 #include "std/bind.hpp"
 #include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
 
 #include <QtCore/QCoreApplication>
 
@@ -328,6 +330,56 @@ UNIT_TEST(ChunksDownloadStrategyFAIL)
   TEST_EQUAL(strategy.NextChunk(s2, r2), ChunksDownloadStrategy::EDownloadFailed, ());
 }
 
+UNIT_TEST(ChunksDownloadStrategyConnectionsPerServer)
+{
+  string const S1 = "UrlOfServer1";
+
+  typedef pair<int64_t, int64_t> RangeT;
+  RangeT const R1(0, 249), R2(250, 499), R3(500, 749), R4(750, 799);
+
+  vector<string> servers;
+  servers.push_back(S1);
+
+  int64_t const FILE_SIZE = 800;
+  int64_t const CHUNK_SIZE = 250;
+  ChunksDownloadStrategy strategy(servers, 2 /* connectionsPerServer */);
+  strategy.InitChunks(FILE_SIZE, CHUNK_SIZE);
+  TEST_EQUAL(strategy.GetCompletePrefixSize(), 0, ());
+
+  string s1, s2, sEmpty;
+  RangeT r1, r2, rEmpty;
+  TEST_EQUAL(strategy.NextChunk(s1, r1), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(strategy.NextChunk(s2, r2), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(strategy.NextChunk(sEmpty, rEmpty), ChunksDownloadStrategy::ENoFreeServers, ());
+  TEST_EQUAL(s1, S1, ());
+  TEST_EQUAL(s2, S1, ());
+  TEST_EQUAL(r1, R1, ());
+  TEST_EQUAL(r2, R2, ());
+
+  // The beginning of the file isn't complete until the first chunk is.
+  strategy.ChunkFinished(true, r2);
+  TEST_EQUAL(strategy.GetCompletePrefixSize(), 0, ());
+
+  // The failed connection is removed, the other one is alive.
+  strategy.ChunkFinished(false, r1);
+  TEST_EQUAL(strategy.NextChunk(s1, r1), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(r1, R1, ());
+  TEST_EQUAL(strategy.NextChunk(sEmpty, rEmpty), ChunksDownloadStrategy::ENoFreeServers, ());
+
+  strategy.ChunkFinished(true, r1);
+  TEST_EQUAL(strategy.GetCompletePrefixSize(), R2.second + 1, ());
+
+  TEST_EQUAL(strategy.NextChunk(s1, r1), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(r1, R3, ());
+  strategy.ChunkFinished(true, r1);
+  TEST_EQUAL(strategy.NextChunk(s1, r1), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(r1, R4, ());
+  strategy.ChunkFinished(true, r1);
+
+  TEST_EQUAL(strategy.GetCompletePrefixSize(), FILE_SIZE, ());
+  TEST_EQUAL(strategy.NextChunk(sEmpty, rEmpty), ChunksDownloadStrategy::EDownloadSucceeded, ());
+}
+
 namespace
 {
   string ReadFileAsString(string const & file)
@@ -589,14 +641,20 @@ UNIT_TEST(DownloadResumeChunks)
     strategy.SaveChunks(FILESIZE, RESUME_FILENAME);
   }
 
-  // 3rd step - check that resume works
+  // 3rd step - check that resume works, chunks are downloaded one by one to check progress,
+  // the hash includes data downloaded before
   {
+    HttpRequest::SetConnectionsLimits(8, 1);
+
     ResumeChecker checker;
     unique_ptr<HttpRequest> const request(HttpRequest::GetFile(urls, FILENAME, FILESIZE,
                                                          bind(&ResumeChecker::OnFinish, &checker, _1),
-                                                         bind(&ResumeChecker::OnProgress, &checker, _1)));
+                                                         bind(&ResumeChecker::OnProgress, &checker, _1),
+                                                         512 * 1024, true, SHA256));
     QCoreApplication::exec();
 
+    HttpRequest::SetConnectionsLimits(8, 2);
+
     TEST_EQUAL(sha2::digest256(ReadFileAsString(FILENAME)), SHA256, ());
 
     FinishDownloadSuccess(FILENAME);
@@ -638,3 +696,107 @@ UNIT_TEST(DownloadResumeChunksWithCancel)
 
   FinishDownloadSuccess(FILENAME);
 }
+
+UNIT_TEST(DownloadChunksWithHash)
+{
+  string const FILENAME = "some_downloader_test_file";
+  string const SHA256 = "49F7BC24B6137C339DFE2D538EE533C7DC6AF89FACBCCE750D7B682C77D61FB1";
+  int64_t const FILESIZE = 47684;
+
+  // remove data from previously failed files
+  DeleteTempDownloadFiles();
+
+  DownloadObserver observer;
+  HttpRequest::CallbackT onFinish = bind(&DownloadObserver::OnDownloadFinish, &observer, _1);
+  HttpRequest::CallbackT onProgress = bind(&DownloadObserver::OnDownloadProgress, &observer, _1);
+
+  vector<string> urls;
+  urls.push_back(TEST_URL_BIG_FILE);
+  urls.push_back(TEST_URL_BIG_FILE);
+
+  {
+    // hash is case insensitive
+    unique_ptr<HttpRequest> const request(HttpRequest::GetFile(
+        urls, FILENAME, FILESIZE, onFinish, onProgress, 2048, true, strings::MakeLowerCase(SHA256)));
+    QCoreApplication::exec();
+
+    observer.TestOk();
+
+    TEST_EQUAL(sha2::digest256(ReadFileAsString(FILENAME)), SHA256, ());
+
+    FinishDownloadSuccess(FILENAME);
+  }
+
+  observer.Reset();
+
+  {
+    string const invalidSha256(SHA256.size(), '0');
+    unique_ptr<HttpRequest> const request(HttpRequest::GetFile(
+        urls, FILENAME, FILESIZE, onFinish, onProgress, 2048, true, invalidSha256));
+    QCoreApplication::exec();
+
+    observer.TestFailed();
+
+    // Corrupted file can't be resumed, so nothing is left.
+    uint64_t size;
+    TEST(!my::GetFileSize(FILENAME, size), ());
+    TEST(!my::GetFileSize(FILENAME + DOWNLOADING_FILE_EXTENSION, size), ());
+    TEST(!my::GetFileSize(FILENAME + RESUME_FILE_EXTENSION, size), ());
+  }
+}
+
+namespace
+{
+  class SeveralFilesObserver
+  {
+    size_t m_filesCount;
+    size_t m_completedCount;
+
+  public:
+    explicit SeveralFilesObserver(size_t filesCount) : m_filesCount(filesCount), m_completedCount(0) {}
+
+    void OnFinish(HttpRequest & request)
+    {
+      TEST_EQUAL(request.Status(), HttpRequest::ECompleted, (request.Data()));
+      if (++m_completedCount == m_filesCount)
+        QCoreApplication::quit();
+    }
+  };
+}
+
+UNIT_TEST(DownloadSeveralFilesWithConnectionsLimit)
+{
+  string const SHA256 = "49F7BC24B6137C339DFE2D538EE533C7DC6AF89FACBCCE750D7B682C77D61FB1";
+  int64_t const FILESIZE = 47684;
+
+  // remove data from previously failed files
+  DeleteTempDownloadFiles();
+
+  vector<string> urls;
+  urls.push_back(TEST_URL_BIG_FILE);
+  urls.push_back(TEST_URL_BIG_FILE);
+
+  // Files share the only connection.
+  HttpRequest::SetConnectionsLimits(1, 2);
+
+  vector<string> const files = {"some_test_file_1", "some_test_file_2", "some_test_file_3"};
+  SeveralFilesObserver observer(files.size());
+  {
+    vector<unique_ptr<HttpRequest>> requests;
+    for (string const & file : files)
+    {
+      requests.emplace_back(HttpRequest::GetFile(
+          urls, file, FILESIZE, bind(&SeveralFilesObserver::OnFinish, &observer, _1),
+          HttpRequest::CallbackT(), 2048, true, SHA256));
+    }
+    QCoreApplication::exec();
+  }
+
+  HttpRequest::SetConnectionsLimits(8, 2);
+
+  for (string const & file : files)
+  {
+    TEST_EQUAL(sha2::digest256(ReadFileAsString(file)), SHA256, ());
+    FinishDownloadSuccess(file);
+  }
+}
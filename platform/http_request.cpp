@@ -10,9 +10,13 @@
 
 #include "coding/internal/file_data.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/sha2.hpp"
 
 #include "base/logging.hpp"
+#include "base/string_utils.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/list.hpp"
 #include "std/unique_ptr.hpp"
 
 
@@ -136,6 +140,64 @@ public:
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
+class FileHttpRequest;
+
+/// Shares chunk connections between all file requests, so several files are downloaded
+/// simultaneously without overloading the network. Requests work on the main thread only,
+/// so there is no synchronization.
+class ConnectionsBudget
+{
+  size_t m_maxConnections;
+  size_t m_connectionsPerServer;
+  size_t m_usedConnections;
+  /// Requests which need more connections.
+  list<FileHttpRequest *> m_waiting;
+
+  ConnectionsBudget() : m_maxConnections(8), m_connectionsPerServer(2), m_usedConnections(0) {}
+
+public:
+  static ConnectionsBudget & Instance()
+  {
+    static ConnectionsBudget budget;
+    return budget;
+  }
+
+  void SetLimits(size_t maxConnections, size_t connectionsPerServer)
+  {
+    ASSERT_GREATER(maxConnections, 0, ());
+    ASSERT_GREATER(connectionsPerServer, 0, ());
+    m_maxConnections = maxConnections;
+    m_connectionsPerServer = connectionsPerServer;
+  }
+
+  size_t GetConnectionsPerServer() const { return m_connectionsPerServer; }
+
+  bool TryAcquire()
+  {
+    if (m_usedConnections >= m_maxConnections)
+      return false;
+    ++m_usedConnections;
+    return true;
+  }
+
+  void Release()
+  {
+    ASSERT_GREATER(m_usedConnections, 0, ());
+    --m_usedConnections;
+  }
+
+  void Wait(FileHttpRequest * request)
+  {
+    if (find(m_waiting.begin(), m_waiting.end(), request) == m_waiting.end())
+      m_waiting.push_back(request);
+  }
+
+  void StopWaiting(FileHttpRequest * request) { m_waiting.remove(request); }
+
+  /// Gives free connections to waiting requests in the order they came.
+  void WakeUp();
+};
+
 class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
 {
   ChunksDownloadStrategy m_strategy;
@@ -149,18 +211,41 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
   size_t m_goodChunksCount;
   bool m_doCleanProgressFiles;
 
+  /// Expected hash (lower case hex) and the hash of the downloaded file beginning.
+  string m_sha256;
+  unique_ptr<sha2::Digest256> m_digest;
+  int64_t m_hashedSize;
+
   ChunksDownloadStrategy::ResultT StartThreads()
   {
+    ConnectionsBudget & budget = ConnectionsBudget::Instance();
     string url;
     pair<int64_t, int64_t> range;
-    ChunksDownloadStrategy::ResultT result;
-    while ((result = m_strategy.NextChunk(url, range)) == ChunksDownloadStrategy::ENextChunk)
+    while (true)
     {
+      if (!budget.TryAcquire())
+      {
+        budget.Wait(this);
+        return ChunksDownloadStrategy::ENoFreeServers;
+      }
+
+      ChunksDownloadStrategy::ResultT const result = m_strategy.NextChunk(url, range);
+      if (result != ChunksDownloadStrategy::ENextChunk)
+      {
+        budget.Release();
+        return result;
+      }
+
       HttpThread * p = CreateNativeHttpThread(url, *this, range.first, range.second, m_progress.second);
       ASSERT ( p, () );
       m_threads.push_back(make_pair(p, range.first));
     }
-    return result;
+  }
+
+  void DeleteThread(HttpThread * p)
+  {
+    DeleteNativeHttpThread(p);
+    ConnectionsBudget::Instance().Release();
   }
 
   class ThreadByPos
@@ -182,7 +267,7 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     {
       HttpThread * p = it->first;
       m_threads.erase(it);
-      DeleteNativeHttpThread(p);
+      DeleteThread(p);
     }
     else
       LOG(LERROR, ("Tried to remove invalid thread for position", begRange));
@@ -208,12 +293,69 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     }
   }
 
-  void SaveResumeChunks()
+  /// Hashes the completely downloaded beginning of the file, so the hash of the file is ready
+  /// right after the last chunk. Chunks are read back because data of failed chunks is written too.
+  void UpdateDigest()
   {
+    int64_t const prefixSize = m_strategy.GetCompletePrefixSize();
+    if (prefixSize <= m_hashedSize)
+      return;
+
     try
     {
-      // Flush writer before saving downloaded chunks.
       m_writer->Flush();
+      my::FileData file(m_filePath + DOWNLOADING_FILE_EXTENSION, my::FileData::OP_READ);
+      vector<char> buffer(static_cast<size_t>(min<int64_t>(prefixSize - m_hashedSize, 64 * 1024)));
+      while (m_hashedSize < prefixSize)
+      {
+        size_t const size = static_cast<size_t>(min<int64_t>(prefixSize - m_hashedSize, buffer.size()));
+        file.Read(m_hashedSize, buffer.data(), size);
+        m_digest->Update(buffer.data(), size);
+        m_hashedSize += size;
+      }
+    }
+    catch (RootException const & e)
+    {
+      // The hash won't be complete, so the download fails.
+      LOG(LWARNING, ("Can't hash downloaded data", e.Msg()));
+    }
+  }
+
+  bool IsHashCorrect()
+  {
+    UpdateDigest();
+    if (m_hashedSize != m_progress.second)
+      return false;
+    string sha256 = m_digest->Finish();
+    strings::AsciiToLower(sha256);
+    if (sha256 != m_sha256)
+    {
+      LOG(LWARNING, (m_filePath, "has hash", sha256, "instead of", m_sha256));
+      return false;
+    }
+    return true;
+  }
+
+  void SyncWriter()
+  {
+    try
+    {
+      m_writer->Sync();
+    }
+    catch (Writer::Exception const & e)
+    {
+      LOG(LWARNING, ("Can't sync file", e.Msg()));
+      m_status = EFailed;
+    }
+  }
+
+  void SaveResumeChunks()
+  {
+    try
+    {
+      // Data must be on the disk before chunks are saved as downloaded, otherwise a crash
+      // leaves holes in the file. Chunks are saved once per several chunks, so it's not slow.
+      m_writer->Sync();
 
       m_strategy.SaveChunks(m_progress.second, m_filePath + RESUME_FILE_EXTENSION);
     }
@@ -240,6 +382,9 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     // report progress
     if (isChunkOk)
     {
+      if (m_digest)
+        UpdateDigest();
+
       m_progress.first += (endRange - begRange) + 1;
       if (m_onProgress)
         m_onProgress(*this);
@@ -248,11 +393,10 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
       LOG(LWARNING, (m_filePath, "HttpRequest error:", httpCode));
 
     ChunksDownloadStrategy::ResultT const result = StartThreads();
+    // Free connections (if any) go to other requests.
+    ConnectionsBudget::Instance().WakeUp();
 
-    if (result == ChunksDownloadStrategy::EDownloadFailed)
-      m_status = EFailed;
-    else if (result == ChunksDownloadStrategy::EDownloadSucceeded)
-      m_status = ECompleted;
+    UpdateStatus(result);
 
     if (isChunkOk)
     {
@@ -263,29 +407,68 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     }
 
     if (m_status != EInProgress)
-    {
-      // 1. Save downloaded chunks if some error occured.
-      if (m_status != ECompleted)
-        SaveResumeChunks();
+      FinishDownload();
+  }
 
-      // 2. Free file handle.
-      CloseWriter();
+  void UpdateStatus(ChunksDownloadStrategy::ResultT result)
+  {
+    if (result == ChunksDownloadStrategy::EDownloadFailed)
+      m_status = EFailed;
+    else if (result == ChunksDownloadStrategy::EDownloadSucceeded)
+      m_status = ECompleted;
+  }
 
-      // 3. Clean up resume file with chunks range on success
-      if (m_status == ECompleted)
-      {
-        (void)my::DeleteFileX(m_filePath + RESUME_FILE_EXTENSION);
+  /// Checks, moves or keeps for resume the downloaded file and calls m_onFinish.
+  /// The request may be deleted by m_onFinish, so it's the last call.
+  void FinishDownload()
+  {
+    ASSERT_NOT_EQUAL(m_status, EInProgress, ());
 
-        // Rename finished file to it's original name.
-        (void)my::DeleteFileX(m_filePath);
-        CHECK(my::RenameFileX(m_filePath + DOWNLOADING_FILE_EXTENSION, m_filePath), ());
+    // The request may be waiting for connections which it doesn't need anymore.
+    ConnectionsBudget::Instance().StopWaiting(this);
 
-        DisableBackupForFile(m_filePath);
+    bool isFileCorrupted = false;
+    if (m_status == ECompleted)
+    {
+      if (m_digest && !IsHashCorrect())
+      {
+        m_status = EFailed;
+        isFileCorrupted = true;
+      }
+      else
+      {
+        // The file must be on the disk before it's renamed.
+        SyncWriter();
       }
+    }
+
+    // 1. Save downloaded chunks if some error occured.
+    if (m_status != ECompleted && !isFileCorrupted)
+      SaveResumeChunks();
+
+    // 2. Free file handle.
+    CloseWriter();
+
+    // 3. Clean up resume file with chunks range on success
+    if (m_status == ECompleted)
+    {
+      (void)my::DeleteFileX(m_filePath + RESUME_FILE_EXTENSION);
+
+      // Rename finished file to it's original name.
+      (void)my::DeleteFileX(m_filePath);
+      CHECK(my::RenameFileX(m_filePath + DOWNLOADING_FILE_EXTENSION, m_filePath), ());
 
-      // 4. Finish downloading.
-      m_onFinish(*this);
+      DisableBackupForFile(m_filePath);
     }
+    else if (isFileCorrupted)
+    {
+      // Nothing can be resumed.
+      (void)my::DeleteFileX(m_filePath + DOWNLOADING_FILE_EXTENSION);
+      (void)my::DeleteFileX(m_filePath + RESUME_FILE_EXTENSION);
+    }
+
+    // 4. Finish downloading.
+    m_onFinish(*this);
   }
 
   void CloseWriter()
@@ -305,10 +488,18 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
 public:
   FileHttpRequest(vector<string> const & urls, string const & filePath, int64_t fileSize,
                   CallbackT const & onFinish, CallbackT const & onProgress,
-                  int64_t chunkSize, bool doCleanProgressFiles)
-    : HttpRequest(onFinish, onProgress), m_strategy(urls), m_filePath(filePath),
-      m_goodChunksCount(0), m_doCleanProgressFiles(doCleanProgressFiles)
+                  int64_t chunkSize, bool doCleanProgressFiles, string const & sha256)
+    : HttpRequest(onFinish, onProgress),
+      m_strategy(urls, ConnectionsBudget::Instance().GetConnectionsPerServer()),
+      m_filePath(filePath), m_goodChunksCount(0), m_doCleanProgressFiles(doCleanProgressFiles),
+      m_sha256(sha256), m_hashedSize(0)
   {
+    if (!m_sha256.empty())
+    {
+      strings::AsciiToLower(m_sha256);
+      m_digest.reset(new sha2::Digest256());
+    }
+
     ASSERT ( !urls.empty(), () );
 
     // Load resume downloading information.
@@ -329,8 +520,10 @@ public:
 
     // Create file and reserve needed size.
     unique_ptr<FileWriter> writer(new FileWriter(filePath + DOWNLOADING_FILE_EXTENSION, openMode));
-    // Reserving disk space is very slow on a device.
-    //writer->Reserve(fileSize);
+    // Reserving disk space by writing is very slow on a device, so it's done
+    // only when the file system can allocate space without writing.
+    if (openMode == FileWriter::OP_WRITE_TRUNCATE)
+      (void)writer->Preallocate(fileSize);
 
     // Assign here, because previous functions can throw an exception.
     m_writer.swap(writer);
@@ -346,12 +539,15 @@ public:
   {
     // Do safe delete with removing from list in case if DeleteNativeHttpThread
     // can produce final notifications to this->OnFinish().
+    ConnectionsBudget & budget = ConnectionsBudget::Instance();
+    budget.StopWaiting(this);
     while (!m_threads.empty())
     {
       HttpThread * p = m_threads.back().first;
       m_threads.pop_back();
-      DeleteNativeHttpThread(p);
+      DeleteThread(p);
     }
+    budget.WakeUp();
 
     if (m_status == EInProgress)
     {
@@ -370,8 +566,31 @@ public:
   {
     return m_filePath;
   }
+
+  /// Called when connections are released. Chunks in progress may have finished while
+  /// the request was waiting, so it may turn out that the download is over.
+  void OnConnectionsAvailable()
+  {
+    if (m_status != EInProgress)
+      return;
+
+    UpdateStatus(StartThreads());
+    if (m_status != EInProgress)
+      FinishDownload();
+  }
 };
 
+void ConnectionsBudget::WakeUp()
+{
+  // A request waits again if it's out of connections, so the loop is finite.
+  while (m_usedConnections < m_maxConnections && !m_waiting.empty())
+  {
+    FileHttpRequest * request = m_waiting.front();
+    m_waiting.pop_front();
+    request->OnConnectionsAvailable();
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 HttpRequest::HttpRequest(CallbackT const & onFinish, CallbackT const & onProgress)
   : m_status(EInProgress), m_progress(make_pair(0, -1)),
@@ -413,11 +632,12 @@ namespace
 HttpRequest * HttpRequest::GetFile(vector<string> const & urls,
                                    string const & filePath, int64_t fileSize,
                                    CallbackT const & onFinish, CallbackT const & onProgress,
-                                   int64_t chunkSize, bool doCleanOnCancel)
+                                   int64_t chunkSize, bool doCleanOnCancel, string const & sha256)
 {
   try
   {
-    return new FileHttpRequest(urls, filePath, fileSize, onFinish, onProgress, chunkSize, doCleanOnCancel);
+    return new FileHttpRequest(urls, filePath, fileSize, onFinish, onProgress, chunkSize,
+                               doCleanOnCancel, sha256);
   }
   catch (FileWriter::Exception const & e)
   {
@@ -432,4 +652,9 @@ HttpRequest * HttpRequest::GetFile(vector<string> const & urls,
   }
 }
 
+void HttpRequest::SetConnectionsLimits(size_t maxConnections, size_t connectionsPerServer)
+{
+  ConnectionsBudget::Instance().SetLimits(maxConnections, connectionsPerServer);
+}
+
 } // namespace downloader
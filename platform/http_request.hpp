@@ -52,12 +52,20 @@ public:
 
   /// Download file to filePath.
   /// @param[in]  fileSize  Correct file size (needed for resuming and reserving).
+  /// @param[in]  sha256    Expected SHA-256 of the file as a hex string or empty string.
+  ///                       The file is hashed while chunks are coming, download fails on mismatch.
   static HttpRequest * GetFile(vector<string> const & urls,
                                string const & filePath, int64_t fileSize,
                                CallbackT const & onFinish,
                                CallbackT const & onProgress = CallbackT(),
                                int64_t chunkSize = 512 * 1024,
-                               bool doCleanOnCancel = true);
+                               bool doCleanOnCancel = true,
+                               string const & sha256 = string());
+
+  /// Limits the number of chunks which are downloaded simultaneously by all file requests
+  /// and by one request from one server. The latter is used by requests created later.
+  /// storage::Storage downloads files of several countries at a time, they share the limits.
+  static void SetConnectionsLimits(size_t maxConnections, size_t connectionsPerServer);
 };
 
 } // namespace downloader
@@ -28,6 +28,7 @@ namespace
 char const kBitsExt[] = ".bftsegbits";
 char const kNodesExt[] = ".bftsegnodes";
 char const kOffsetsExt[] = ".offsets";
+char const kFtSegBackwardExt[] = ".bftsegidx";
 
 size_t const kMaxTimestampLength = 18;
 
@@ -317,7 +318,7 @@ bool CountryIndexes::DeleteFromDisk(LocalCountryFile const & localFile)
   string const directory = IndexesDir(localFile);
   bool ok = true;
 
-  for (auto index : {Index::Bits, Index::Nodes, Index::Offsets})
+  for (auto index : {Index::Bits, Index::Nodes, Index::Offsets, Index::FtSegBackward})
   {
     string const path = GetPath(localFile, index);
     if (Platform::IsFileExistsByFullPath(path) && !my::DeleteFileX(path))
@@ -351,6 +352,9 @@ string CountryIndexes::GetPath(LocalCountryFile const & localFile, Index index)
     case Index::Offsets:
       ext = kOffsetsExt;
       break;
+    case Index::FtSegBackward:
+      ext = kFtSegBackwardExt;
+      break;
   }
   return my::JoinFoldersToPath(IndexesDir(localFile), localFile.GetCountryName() + ext);
 }
@@ -361,13 +365,14 @@ void CountryIndexes::GetIndexesExts(vector<string> & exts)
   exts.push_back(kBitsExt);
   exts.push_back(kNodesExt);
   exts.push_back(kOffsetsExt);
+  exts.push_back(kFtSegBackwardExt);
 }
 
 // static
 bool CountryIndexes::IsIndexFile(string const & file)
 {
   return strings::EndsWith(file, kBitsExt) || strings::EndsWith(file, kNodesExt) ||
-         strings::EndsWith(file, kOffsetsExt);
+         strings::EndsWith(file, kOffsetsExt) || strings::EndsWith(file, kFtSegBackwardExt);
 }
 
 // static
@@ -402,6 +407,8 @@ string DebugPrint(CountryIndexes::Index index)
       return "Nodes";
     case CountryIndexes::Index::Offsets:
       return "Offsets";
+    case CountryIndexes::Index::FtSegBackward:
+      return "FtSegBackward";
   }
 }
 }  // namespace platform
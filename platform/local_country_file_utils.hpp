@@ -69,7 +69,8 @@ public:
   {
     Bits,
     Nodes,
-    Offsets
+    Offsets,
+    FtSegBackward
   };
 
   /// Prepares (if necessary) directory for country indexes. Local file
@@ -24,5 +24,13 @@ UNIT_TEST(CountryFile_Smoke)
   TEST_EQUAL(1, countryFile.GetRemoteSize(MapOptions::Map), ());
   TEST_EQUAL(2, countryFile.GetRemoteSize(MapOptions::CarRouting), ());
   TEST_EQUAL(3, countryFile.GetRemoteSize(MapOptions::MapWithCarRouting), ());
+
+  TEST_EQUAL(string(), countryFile.GetRemoteHash(MapOptions::Map), ());
+  TEST_EQUAL(string(), countryFile.GetRemoteHash(MapOptions::CarRouting), ());
+
+  countryFile.SetRemoteHashes("aa" /* mapSha256 */, "bb" /* routingSha256 */);
+
+  TEST_EQUAL("aa", countryFile.GetRemoteHash(MapOptions::Map), ());
+  TEST_EQUAL("bb", countryFile.GetRemoteHash(MapOptions::CarRouting), ());
 }
 }  // namespace platform
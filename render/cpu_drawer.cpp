@@ -1,7 +1,7 @@
 #include "cpu_drawer.hpp"
 #include "proto_to_styles.hpp"
 
-#include "geometry/tree4d.hpp"
+#include "geometry/packed_rtree.hpp"
 #include "geometry/transformations.hpp"
 
 #include "graphics/text_path.hpp"
@@ -162,7 +162,7 @@ public:
   }
 
 private:
-  m4::Tree<CPUDrawer::OverlayWrapper const *, OverlayWrapperTraits> m_tree;
+  m4::PackedRTree<CPUDrawer::OverlayWrapper const *, OverlayWrapperTraits> m_tree;
 };
 
 CPUDrawer::CPUDrawer(Params const & params)
@@ -58,6 +58,14 @@ public:
                                my::Cancellable const & cancellable = my::Cancellable(),
                                TOnVisitedVertexCallback onVisitedVertexCallback = nullptr) const;
 
+  /// One-to-all mode: finds distances from the start vertex to all vertices which are not
+  /// further than maxDistance. It's Dijkstra's algorithm, the heuristic of the graph isn't used.
+  /// @param distances Distances of reached vertices, the start vertex included.
+  /// @return OK or Cancelled.
+  Result PropagateWave(TGraphType const & graph, TVertexType const & startVertex,
+                       double maxDistance, map<TVertexType, double> & distances,
+                       my::Cancellable const & cancellable = my::Cancellable()) const;
+
 private:
   // Periodicy of checking is cancellable cancelled.
   static uint32_t constexpr kCancelledPollPeriod = 128;
@@ -365,6 +373,52 @@ typename AStarAlgorithm<TGraph>::Result AStarAlgorithm<TGraph>::FindPathBidirect
   return Result::NoPath;
 }
 
+template <typename TGraph>
+typename AStarAlgorithm<TGraph>::Result AStarAlgorithm<TGraph>::PropagateWave(
+    TGraphType const & graph, TVertexType const & startVertex, double maxDistance,
+    map<TVertexType, double> & distances, my::Cancellable const & cancellable) const
+{
+  distances.clear();
+  priority_queue<State, vector<State>, greater<State>> queue;
+
+  distances[startVertex] = 0.0;
+  queue.push(State(startVertex, 0.0));
+
+  vector<TEdgeType> adj;
+
+  uint32_t steps = 0;
+  while (!queue.empty())
+  {
+    ++steps;
+
+    if (steps % kCancelledPollPeriod == 0 && cancellable.IsCancelled())
+      return Result::Cancelled;
+
+    State const stateV = queue.top();
+    queue.pop();
+
+    if (stateV.distance > distances[stateV.vertex])
+      continue;
+
+    graph.GetOutgoingEdgesList(stateV.vertex, adj);
+    for (auto const & edge : adj)
+    {
+      State stateW(edge.GetTarget(), stateV.distance + edge.GetWeight());
+      if (stateV.vertex == stateW.vertex || stateW.distance > maxDistance)
+        continue;
+
+      auto const t = distances.find(stateW.vertex);
+      if (t != distances.end() && stateW.distance >= t->second - kEpsilon)
+        continue;
+
+      distances[stateW.vertex] = stateW.distance;
+      queue.push(stateW);
+    }
+  }
+
+  return Result::OK;
+}
+
 // static
 template <typename TGraph>
 void AStarAlgorithm<TGraph>::ReconstructPath(TVertexType const & v,
@@ -138,7 +138,7 @@ private:
 
   map<CrossNode, vector<CrossWeightedEdge> > m_virtualEdges;
 
-  mutable RoutingIndexManager m_indexManager;
+  RoutingIndexManager & m_indexManager;
 
   // Caching stuff.
   using TCachingKey = pair<TWrittenNodeId, Index::MwmId>;
@@ -6,6 +6,7 @@
 #include "indexer/classificator.hpp"
 #include "indexer/ftypes_matcher.hpp"
 #include "indexer/index.hpp"
+#include "indexer/index_query_cache.hpp"
 #include "indexer/scales.hpp"
 
 #include "geometry/distance_on_sphere.hpp"
@@ -104,10 +105,13 @@ void FeaturesRoadGraph::RoadInfoCache::Clear()
 
 FeaturesRoadGraph::FeaturesRoadGraph(Index & index, unique_ptr<IVehicleModelFactory> && vehicleModelFactory)
     : m_index(index),
+      m_queryCache(new IndexQueryCache(index)),
       m_vehicleModel(move(vehicleModelFactory))
 {
 }
 
+FeaturesRoadGraph::~FeaturesRoadGraph() {}
+
 uint32_t FeaturesRoadGraph::GetStreetReadScale() { return scales::GetUpperScale(); }
 
 class CrossFeaturesLoader
@@ -163,7 +167,7 @@ void FeaturesRoadGraph::ForEachFeatureClosestToCross(m2::PointD const & cross,
 {
   CrossFeaturesLoader featuresLoader(*this, edgesLoader);
   m2::RectD const rect = MercatorBounds::RectByCenterXYAndSizeInMeters(cross, kMwmRoadCrossingRadiusMeters);
-  m_index.ForEachInRect(featuresLoader, rect, GetStreetReadScale());
+  m_queryCache->ForEachInRect(featuresLoader, rect, GetStreetReadScale());
 }
 
 void FeaturesRoadGraph::FindClosestEdges(m2::PointD const & point, uint32_t count,
@@ -187,7 +191,7 @@ void FeaturesRoadGraph::FindClosestEdges(m2::PointD const & point, uint32_t coun
     finder.AddInformationSource(featureId, roadInfo);
   };
 
-  m_index.ForEachInRect(
+  m_queryCache->ForEachInRect(
       f, MercatorBounds::RectByCenterXYAndSizeInMeters(point, kMwmCrossingNodeEqualityRadiusMeters),
       GetStreetReadScale());
 
@@ -210,7 +214,7 @@ void FeaturesRoadGraph::GetJunctionTypes(Junction const & junction, feature::Typ
 
   m2::PointD const & cross = junction.GetPoint();
 
-  auto const f = [&types, &cross](FeatureType const & ft)
+  auto const f = [&types, &cross](FeatureView const & ft)
   {
     if (!types.Empty())
       return;
@@ -227,7 +231,7 @@ void FeaturesRoadGraph::GetJunctionTypes(Junction const & junction, feature::Typ
   };
 
   m2::RectD const rect = MercatorBounds::RectByCenterXYAndSizeInMeters(cross, kMwmRoadCrossingRadiusMeters);
-  m_index.ForEachInRect(f, rect, GetStreetReadScale());
+  m_queryCache->ForEachViewInRect(f, rect, GetStreetReadScale());
 }
 
 void FeaturesRoadGraph::ClearState()
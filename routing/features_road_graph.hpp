@@ -14,6 +14,7 @@
 #include "std/vector.hpp"
 
 class Index;
+class IndexQueryCache;
 class FeatureType;
 
 namespace routing
@@ -57,6 +58,7 @@ private:
 
 public:
   FeaturesRoadGraph(Index & index, unique_ptr<IVehicleModelFactory> && vehicleModelFactory);
+  ~FeaturesRoadGraph() override;
 
   static uint32_t GetStreetReadScale();
 
@@ -90,6 +92,9 @@ private:
   void LockFeatureMwm(FeatureID const & featureId) const;
 
   Index & m_index;
+  // Roads near the same crossings are read many times while a route is built, so
+  // features of index cells are cached between queries and routes.
+  unique_ptr<IndexQueryCache> const m_queryCache;
   mutable RoadInfoCache m_cache;
   mutable CrossCountryVehicleModel m_vehicleModel;
   mutable map<MwmSet::MwmId, MwmSet::MwmHandle> m_mwmLocks;
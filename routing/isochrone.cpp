@@ -0,0 +1,176 @@
+#include "routing/isochrone.hpp"
+
+#include "routing/routing_algorithm.hpp"
+#include "routing/base/astar_algorithm.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "base/assert.hpp"
+#include "base/parallel_for_pool.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+#include "std/cmath.hpp"
+#include "std/map.hpp"
+#include "std/set.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/utility.hpp"
+
+namespace routing
+{
+namespace
+{
+double constexpr KMPH2MPS = 1000.0 / (60 * 60);
+
+using TGridPoint = pair<int64_t, int64_t>;
+
+TGridPoint operator-(TGridPoint const & p1, TGridPoint const & p2)
+{
+  return TGridPoint(p1.first - p2.first, p1.second - p2.second);
+}
+
+// Adds points of the part [0, fraction] of the segment to points, so that every cell of
+// the grid which the part crosses gets a point.
+void AddSegmentPoints(m2::PointD const & p1, m2::PointD const & p2, double fraction,
+                      double cellSize, vector<m2::PointD> & points)
+{
+  m2::PointD const end = p1 + (p2 - p1) * fraction;
+  size_t const count = static_cast<size_t>(ceil(p1.Length(end) / (cellSize / 2)));
+  for (size_t i = 0; i <= count; ++i)
+    points.push_back(count == 0 ? p1 : p1 + (end - p1) * (static_cast<double>(i) / count));
+}
+}  // namespace
+
+bool BuildIsochrone(IRoadGraph & graph, m2::PointD const & origin, IsochroneParams const & params,
+                    Isochrone & isochrone)
+{
+  isochrone = Isochrone();
+
+  vector<pair<Edge, m2::PointD>> vicinity;
+  graph.FindClosestEdges(origin, 1 /* count */, vicinity);
+  if (vicinity.empty())
+    return false;
+
+  Junction const originJunction(origin);
+  graph.ResetFakes();
+  graph.AddFakeEdges(originJunction, vicinity);
+
+  map<Junction, double> times;
+  AStarAlgorithm<RoadGraph>().PropagateWave(RoadGraph(graph), originJunction,
+                                            params.m_maxTimeSec, times);
+
+  double const cellSize =
+      MercatorBounds::RectByCenterXYAndSizeInMeters(origin, params.m_cellSizeM / 2).SizeX();
+  vector<m2::PointD> points;
+  IRoadGraph::TEdgeVector edges;
+  for (auto const & vertex : times)
+  {
+    edges.clear();
+    graph.GetOutgoingEdges(vertex.first, edges);
+    for (Edge const & e : edges)
+    {
+      m2::PointD const & start = e.GetStartJunction().GetPoint();
+      m2::PointD const & end = e.GetEndJunction().GetPoint();
+      double const timeSec =
+          MercatorBounds::DistanceOnEarth(start, end) / (graph.GetSpeedKMPH(e) * KMPH2MPS);
+      double const fraction =
+          timeSec > 0.0 ? min((params.m_maxTimeSec - vertex.second) / timeSec, 1.0) : 1.0;
+      AddSegmentPoints(start, end, fraction, cellSize, points);
+      if (!e.IsFake())
+        isochrone.m_edges.emplace_back(e, vertex.second, vertex.second + timeSec);
+    }
+  }
+  graph.ResetFakes();
+
+  MakeGridPolygons(points, cellSize, isochrone.m_polygons);
+  return true;
+}
+
+size_t BuildIsochrones(TRoadGraphFactory const & graphFactory, vector<m2::PointD> const & origins,
+                       IsochroneParams const & params, size_t threadsCount,
+                       vector<Isochrone> & isochrones)
+{
+  ASSERT_GREATER(threadsCount, 0, ());
+  isochrones.assign(origins.size(), Isochrone());
+
+  // Graphs are made on first use, so threads which don't join the loop make no graphs.
+  vector<unique_ptr<IRoadGraph>> graphs(threadsCount);
+  atomic<size_t> built(0);
+  threads::ParallelForPool::Instance().ParallelFor(origins.size(), [&](size_t i, size_t slot)
+  {
+    if (!graphs[slot])
+      graphs[slot] = graphFactory();
+    if (BuildIsochrone(*graphs[slot], origins[i], params, isochrones[i]))
+      ++built;
+  }, threadsCount);
+  return built;
+}
+
+void MakeGridPolygons(vector<m2::PointD> const & points, double cellSize,
+                      vector<vector<m2::PointD>> & polygons)
+{
+  polygons.clear();
+
+  set<TGridPoint> cells;
+  for (m2::PointD const & p : points)
+  {
+    cells.emplace(static_cast<int64_t>(floor(p.x / cellSize)),
+                  static_cast<int64_t>(floor(p.y / cellSize)));
+  }
+  auto const isCell = [&cells](int64_t x, int64_t y) { return cells.count(TGridPoint(x, y)) != 0; };
+
+  // Sides of cells on the outline, they are directed so that cells are on the left.
+  multimap<TGridPoint, TGridPoint> sides;
+  for (TGridPoint const & c : cells)
+  {
+    int64_t const x = c.first;
+    int64_t const y = c.second;
+    if (!isCell(x, y - 1))
+      sides.emplace(TGridPoint(x, y), TGridPoint(x + 1, y));
+    if (!isCell(x + 1, y))
+      sides.emplace(TGridPoint(x + 1, y), TGridPoint(x + 1, y + 1));
+    if (!isCell(x, y + 1))
+      sides.emplace(TGridPoint(x + 1, y + 1), TGridPoint(x, y + 1));
+    if (!isCell(x - 1, y))
+      sides.emplace(TGridPoint(x, y + 1), TGridPoint(x, y));
+  }
+
+  while (!sides.empty())
+  {
+    TGridPoint const start = sides.begin()->first;
+    TGridPoint prev = start;
+    TGridPoint cur = sides.begin()->second;
+    sides.erase(sides.begin());
+
+    vector<TGridPoint> ring(1, start);
+    while (cur != start)
+    {
+      auto const range = sides.equal_range(cur);
+      ASSERT(range.first != range.second, ());
+      // Two sides go from a corner shared by two diagonal cells only, the left turn keeps
+      // the current cell on the left.
+      TGridPoint const dir = cur - prev;
+      TGridPoint const left(-dir.second, dir.first);
+      auto next = range.first;
+      for (auto it = range.first; it != range.second; ++it)
+      {
+        if (it->second - cur == left)
+          next = it;
+      }
+
+      // Corners on straight lines are skipped.
+      if (next->second - cur != dir)
+        ring.push_back(cur);
+      prev = cur;
+      cur = next->second;
+      sides.erase(next);
+    }
+
+    vector<m2::PointD> polygon;
+    polygon.reserve(ring.size());
+    for (TGridPoint const & p : ring)
+      polygon.emplace_back(p.first * cellSize, p.second * cellSize);
+    polygons.push_back(move(polygon));
+  }
+}
+}  // namespace routing
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "routing/road_graph.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/vector.hpp"
+
+namespace routing
+{
+/// Edge of the road graph reached from the origin of an isochrone.
+struct ReachableEdge
+{
+  ReachableEdge(Edge const & edge, double startTimeSec, double endTimeSec)
+    : m_edge(edge), m_startTimeSec(startTimeSec), m_endTimeSec(endTimeSec)
+  {
+  }
+
+  Edge m_edge;
+  /// Arrival times at the start and at the end junctions of the edge. The edge is reached
+  /// partially if m_endTimeSec is greater than the time budget.
+  double m_startTimeSec;
+  double m_endTimeSec;
+};
+
+struct Isochrone
+{
+  vector<ReachableEdge> m_edges;
+  /// Outlines of the grid cells covering reachable parts of roads in mercator. Outer rings are
+  /// counterclockwise and holes are clockwise.
+  vector<vector<m2::PointD>> m_polygons;
+};
+
+struct IsochroneParams
+{
+  double m_maxTimeSec = 15 * 60;
+  /// Side of cells of the grid which covers reachable parts of roads.
+  double m_cellSizeM = 100.0;
+};
+
+/// Builds the isochrone of the origin: finds all roads reachable within the time budget by
+/// AStarAlgorithm::PropagateWave with travel times of the graph and covers them by polygons.
+/// FeaturesRoadGraph loads roads of all mwms, so isochrones cross mwm borders.
+/// Fake edges of the graph are reset.
+/// @return false if there are no roads near the origin.
+bool BuildIsochrone(IRoadGraph & graph, m2::PointD const & origin, IsochroneParams const & params,
+                    Isochrone & isochrone);
+
+/// Builds isochrones of origins on at most threadsCount threads of the shared ParallelForPool,
+/// every thread has its own graph made by graphFactory. isochrones[i] corresponds to origins[i].
+/// @return Number of built isochrones.
+size_t BuildIsochrones(TRoadGraphFactory const & graphFactory, vector<m2::PointD> const & origins,
+                       IsochroneParams const & params, size_t threadsCount,
+                       vector<Isochrone> & isochrones);
+
+/// Covers points by cells of the square grid with the cell side cellSize and makes outlines of
+/// connected groups of cells, cells touching by corners are not connected.
+void MakeGridPolygons(vector<m2::PointD> const & points, double cellSize,
+                      vector<vector<m2::PointD>> & polygons);
+}  // namespace routing
@@ -0,0 +1,308 @@
+#include "routing/map_matcher.hpp"
+
+#include "routing/base/astar_algorithm.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "base/assert.hpp"
+#include "base/cancellable.hpp"
+#include "base/parallel_for_pool.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+#include "std/cmath.hpp"
+#include "std/limits.hpp"
+#include "std/map.hpp"
+#include "std/unique_ptr.hpp"
+
+namespace routing
+{
+namespace
+{
+double constexpr kImpossibleScore = -numeric_limits<double>::infinity();
+
+inline double DistanceM(m2::PointD const & p1, m2::PointD const & p2)
+{
+  return MercatorBounds::DistanceOnEarth(p1, p2);
+}
+
+/// An edge weighted by its length in meters.
+class LengthEdge
+{
+public:
+  LengthEdge(Junction const & target, double weight) : m_target(target), m_weight(weight) {}
+
+  inline Junction const & GetTarget() const { return m_target; }
+
+  inline double GetWeight() const { return m_weight; }
+
+private:
+  Junction m_target;
+  double m_weight;
+};
+
+/// A wrapper around IRoadGraph, which makes it possible to find shortest routes by length
+/// with astar algorithms.
+class LengthGraph
+{
+public:
+  using TVertexType = Junction;
+  using TEdgeType = LengthEdge;
+
+  explicit LengthGraph(IRoadGraph const & roadGraph) : m_roadGraph(roadGraph) {}
+
+  void GetOutgoingEdgesList(Junction const & v, vector<LengthEdge> & adj) const
+  {
+    IRoadGraph::TEdgeVector edges;
+    m_roadGraph.GetOutgoingEdges(v, edges);
+
+    adj.clear();
+    adj.reserve(edges.size());
+    for (auto const & e : edges)
+    {
+      adj.emplace_back(e.GetEndJunction(),
+                       DistanceM(v.GetPoint(), e.GetEndJunction().GetPoint()));
+    }
+  }
+
+  void GetIngoingEdgesList(Junction const & v, vector<LengthEdge> & adj) const
+  {
+    IRoadGraph::TEdgeVector edges;
+    m_roadGraph.GetIngoingEdges(v, edges);
+
+    adj.clear();
+    adj.reserve(edges.size());
+    for (auto const & e : edges)
+    {
+      adj.emplace_back(e.GetStartJunction(),
+                       DistanceM(e.GetStartJunction().GetPoint(), v.GetPoint()));
+    }
+  }
+
+  double HeuristicCostEstimate(Junction const & v, Junction const & w) const
+  {
+    return DistanceM(v.GetPoint(), w.GetPoint());
+  }
+
+private:
+  IRoadGraph const & m_roadGraph;
+};
+
+using TAlgorithm = AStarAlgorithm<LengthGraph>;
+}  // namespace
+
+MapMatcher::MapMatcher(IRoadGraph const & graph, Params const & params)
+  : m_graph(graph), m_params(params)
+{
+}
+
+size_t MapMatcher::Match(TTrace const & trace, vector<MatchedPoint> & result) const
+{
+  result.assign(trace.size(), MatchedPoint());
+
+  vector<Step> steps(trace.size());
+  // Beginning of the current part of the trace, parts are split by points without candidates
+  // or by points which are unreachable from the previous ones.
+  size_t begin = 0;
+  for (size_t i = 0; i < trace.size(); ++i)
+  {
+    Step & step = steps[i];
+    FindCandidates(trace[i], step.m_candidates);
+    if (step.m_candidates.empty())
+    {
+      Decode(steps, begin, i, result);
+      begin = i + 1;
+      continue;
+    }
+
+    if (i == begin || !MakeTransitions(steps[i - 1], trace[i - 1], trace[i], step))
+    {
+      if (i != begin)
+        Decode(steps, begin, i, result);
+      begin = i;
+      step.m_scores.clear();
+      step.m_parents.assign(step.m_candidates.size(), 0);
+      for (Candidate const & c : step.m_candidates)
+        step.m_scores.push_back(GetEmissionScore(c));
+    }
+  }
+  Decode(steps, begin, trace.size(), result);
+
+  return count_if(result.begin(), result.end(), [](MatchedPoint const & p)
+                  {
+                    return p.IsMatched();
+                  });
+}
+
+void MapMatcher::FindCandidates(m2::PointD const & point, vector<Candidate> & candidates) const
+{
+  vector<pair<Edge, m2::PointD>> vicinities;
+  m_graph.FindClosestEdges(point, m_params.m_candidatesCount, vicinities);
+
+  candidates.clear();
+  for (auto const & v : vicinities)
+  {
+    double const distM = DistanceM(point, v.second);
+    if (distM > m_params.m_maxCandidateDistM)
+      continue;
+    // Closest edges are along features, roads may be passed in both directions.
+    candidates.emplace_back(v.first, v.second, distM);
+    if (m_graph.GetRoadInfo(v.first.GetFeatureId()).m_bidirectional)
+      candidates.emplace_back(v.first.GetReverseEdge(), v.second, distM);
+  }
+}
+
+double MapMatcher::FindRouteDistance(Junction const & from, Junction const & to,
+                                     double maxDistM) const
+{
+  if (from == to)
+    return 0.0;
+  if (DistanceM(from.GetPoint(), to.GetPoint()) > maxDistM)
+    return -1.0;
+
+  // Vertices are settled in ascending order of their distances from the start plus estimations
+  // of distances to the finish. When a settled vertex is out of the ellipse around the start
+  // and the finish, the route is longer than maxDistM.
+  my::Cancellable cancellable;
+  auto const onVisitedVertex = [&](Junction const & v, Junction const & /* target */)
+  {
+    if (DistanceM(from.GetPoint(), v.GetPoint()) + DistanceM(v.GetPoint(), to.GetPoint()) >
+        maxDistM)
+    {
+      cancellable.Cancel();
+    }
+  };
+
+  vector<Junction> path;
+  if (TAlgorithm().FindPath(LengthGraph(m_graph), from, to, path, cancellable, onVisitedVertex) !=
+      TAlgorithm::Result::OK)
+  {
+    return -1.0;
+  }
+
+  double distM = 0.0;
+  for (size_t i = 1; i < path.size(); ++i)
+    distM += DistanceM(path[i - 1].GetPoint(), path[i].GetPoint());
+  return distM <= maxDistM ? distM : -1.0;
+}
+
+bool MapMatcher::MakeTransitions(Step const & prev, m2::PointD const & prevPoint,
+                                 m2::PointD const & point, Step & step) const
+{
+  double const directDistM = DistanceM(prevPoint, point);
+  double const windowM = max(m_params.m_minWindowM, m_params.m_windowFactor * directDistM);
+
+  // Candidates of neighbouring points share junctions, so routes between junctions are cached.
+  map<pair<Junction, Junction>, double> routeDists;
+  auto const getRouteDist = [&](Junction const & from, Junction const & to)
+  {
+    auto const key = make_pair(from, to);
+    auto const it = routeDists.find(key);
+    if (it != routeDists.end())
+      return it->second;
+    double const distM = FindRouteDistance(from, to, windowM);
+    routeDists.emplace(key, distM);
+    return distM;
+  };
+
+  step.m_scores.assign(step.m_candidates.size(), kImpossibleScore);
+  step.m_parents.assign(step.m_candidates.size(), 0);
+  bool reachable = false;
+  for (size_t j = 0; j < step.m_candidates.size(); ++j)
+  {
+    Candidate const & to = step.m_candidates[j];
+    for (size_t i = 0; i < prev.m_candidates.size(); ++i)
+    {
+      if (prev.m_scores[i] == kImpossibleScore)
+        continue;
+
+      Candidate const & from = prev.m_candidates[i];
+      Junction const & fromStart = from.m_edge.GetStartJunction();
+      double routeDistM;
+      if (from.m_edge.SameRoadSegmentAndDirection(to.m_edge) &&
+          DistanceM(fromStart.GetPoint(), to.m_point) >=
+              DistanceM(fromStart.GetPoint(), from.m_point))
+      {
+        routeDistM = DistanceM(from.m_point, to.m_point);
+      }
+      else
+      {
+        Junction const & fromEnd = from.m_edge.GetEndJunction();
+        Junction const & toStart = to.m_edge.GetStartJunction();
+        double const partsDistM = DistanceM(from.m_point, fromEnd.GetPoint()) +
+                                  DistanceM(toStart.GetPoint(), to.m_point);
+        if (partsDistM > windowM)
+          continue;
+        double const betweenDistM = getRouteDist(fromEnd, toStart);
+        if (betweenDistM < 0.0)
+          continue;
+        routeDistM = partsDistM + betweenDistM;
+      }
+      if (routeDistM > windowM)
+        continue;
+
+      double const score = prev.m_scores[i] -
+                           fabs(routeDistM - directDistM) / m_params.m_transitionBetaM;
+      if (score > step.m_scores[j])
+      {
+        step.m_scores[j] = score;
+        step.m_parents[j] = i;
+      }
+    }
+
+    if (step.m_scores[j] != kImpossibleScore)
+    {
+      step.m_scores[j] += GetEmissionScore(to);
+      reachable = true;
+    }
+  }
+  return reachable;
+}
+
+void MapMatcher::Decode(vector<Step> const & steps, size_t begin, size_t end,
+                        vector<MatchedPoint> & result) const
+{
+  if (begin >= end)
+    return;
+
+  vector<double> const & lastScores = steps[end - 1].m_scores;
+  ASSERT(!lastScores.empty(), ());
+  size_t candidate = max_element(lastScores.begin(), lastScores.end()) - lastScores.begin();
+  for (size_t i = end; i > begin; --i)
+  {
+    Step const & step = steps[i - 1];
+    result[i - 1].m_edge = step.m_candidates[candidate].m_edge;
+    result[i - 1].m_point = step.m_candidates[candidate].m_point;
+    candidate = step.m_parents[candidate];
+  }
+}
+
+double MapMatcher::GetEmissionScore(Candidate const & candidate) const
+{
+  double const d = candidate.m_distM / m_params.m_gpsSigmaM;
+  return -0.5 * d * d;
+}
+
+size_t MatchTraces(TRoadGraphFactory const & graphFactory, MapMatcher::Params const & params,
+                   vector<TTrace> const & traces, size_t threadsCount,
+                   vector<vector<MatchedPoint>> & results)
+{
+  ASSERT_GREATER(threadsCount, 0, ());
+  results.assign(traces.size(), vector<MatchedPoint>());
+
+  // Matchers are made on first use, so threads which don't join the loop make no graphs.
+  vector<unique_ptr<IRoadGraph>> graphs(threadsCount);
+  vector<unique_ptr<MapMatcher>> matchers(threadsCount);
+  atomic<size_t> matched(0);
+  threads::ParallelForPool::Instance().ParallelFor(traces.size(), [&](size_t i, size_t slot)
+  {
+    if (!matchers[slot])
+    {
+      graphs[slot] = graphFactory();
+      matchers[slot].reset(new MapMatcher(*graphs[slot], params));
+    }
+    matched += matchers[slot]->Match(traces[i], results[i]);
+  }, threadsCount);
+  return matched;
+}
+}  // namespace routing
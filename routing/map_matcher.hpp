@@ -0,0 +1,112 @@
+#pragma once
+
+#include "routing/road_graph.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace routing
+{
+/// GPS trace in mercator.
+using TTrace = vector<m2::PointD>;
+
+/// Point of a trace snapped to the road network.
+struct MatchedPoint
+{
+  bool IsMatched() const { return !m_edge.IsFake(); }
+
+  /// Fake edge if the point isn't matched.
+  Edge m_edge = Edge::MakeFake(Junction(), Junction());
+  /// Projection of the trace point to m_edge.
+  m2::PointD m_point = m2::PointD::Zero();
+};
+
+/// Offline map matching of whole GPS traces by a hidden Markov model: hidden states are
+/// directed edges near trace points, emission probabilities depend on distances from points to
+/// edges and transition probabilities depend on the difference between the route distance and
+/// the great circle distance of consecutive points. The most probable sequence of edges is
+/// found by Viterbi algorithm. Route distances are found by AStarAlgorithm on the road graph
+/// and the search is bounded by a window around consecutive points. If no transition is
+/// possible the trace is split and parts are matched independently.
+/// Not thread-safe when the graph isn't, use a matcher with its own graph per thread.
+class MapMatcher
+{
+public:
+  struct Params
+  {
+    /// Number of nearest roads which are candidates of every point.
+    uint32_t m_candidatesCount = 4;
+    /// Roads further from a point aren't candidates.
+    double m_maxCandidateDistM = 50.0;
+    /// Standard deviation of GPS errors.
+    double m_gpsSigmaM = 10.0;
+    /// Scale of the exponential distribution of differences between route and great circle
+    /// distances of consecutive points.
+    double m_transitionBetaM = 10.0;
+    /// Route between consecutive points isn't longer than the greater of m_minWindowM and
+    /// m_windowFactor multiplied by the great circle distance between the points.
+    double m_windowFactor = 4.0;
+    double m_minWindowM = 300.0;
+  };
+
+  MapMatcher(IRoadGraph const & graph, Params const & params);
+
+  /// @param result Matched points, result[i] corresponds to trace[i].
+  /// @return Number of matched points.
+  size_t Match(TTrace const & trace, vector<MatchedPoint> & result) const;
+
+private:
+  struct Candidate
+  {
+    Candidate(Edge const & edge, m2::PointD const & point, double distM)
+      : m_edge(edge), m_point(point), m_distM(distM)
+    {
+    }
+
+    Edge m_edge;
+    m2::PointD m_point;
+    /// Distance from the trace point to m_point.
+    double m_distM;
+  };
+
+  struct Step
+  {
+    vector<Candidate> m_candidates;
+    /// Log probabilities of the most probable sequences ending with candidates.
+    vector<double> m_scores;
+    /// Indexes of previous candidates of the most probable sequences.
+    vector<size_t> m_parents;
+  };
+
+  void FindCandidates(m2::PointD const & point, vector<Candidate> & candidates) const;
+
+  /// @return Distance of the shortest route between junctions which is not longer than maxDistM,
+  /// or a negative value if there is no such route.
+  double FindRouteDistance(Junction const & from, Junction const & to, double maxDistM) const;
+
+  /// Fills scores and parents of the step by the previous one.
+  /// @return false if no candidate of the step is reachable.
+  bool MakeTransitions(Step const & prev, m2::PointD const & prevPoint, m2::PointD const & point,
+                       Step & step) const;
+
+  /// Restores the most probable sequence of edges of steps [begin, end).
+  void Decode(vector<Step> const & steps, size_t begin, size_t end,
+              vector<MatchedPoint> & result) const;
+
+  double GetEmissionScore(Candidate const & candidate) const;
+
+  IRoadGraph const & m_graph;
+  Params const m_params;
+};
+
+/// Matches traces on at most threadsCount threads of the shared ParallelForPool, every thread
+/// has its own graph made by graphFactory.
+/// results[i] corresponds to traces[i].
+/// @return Number of matched points of all traces.
+size_t MatchTraces(TRoadGraphFactory const & graphFactory, MapMatcher::Params const & params,
+                   vector<TTrace> const & traces, size_t threadsCount,
+                   vector<vector<MatchedPoint>> & results);
+}  // namespace routing
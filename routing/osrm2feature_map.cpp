@@ -2,9 +2,8 @@
 
 #include "defines.hpp"
 
-#include "indexer/data_header.hpp"
-
 #include "platform/local_country_file_utils.hpp"
+#include "platform/mwm_version.hpp"
 
 #include "coding/file_name_utils.hpp"
 #include "coding/internal/file_data.hpp"
@@ -16,6 +15,7 @@
 #include "base/math.hpp"
 #include "base/scope_guard.hpp"
 
+#include "std/algorithm.hpp"
 #include "std/fstream.hpp"
 #include "std/sstream.hpp"
 #include "std/unordered_map.hpp"
@@ -26,7 +26,14 @@ using platform::CountryIndexes;
 
 namespace
 {
-const routing::TNodesList kEmptyList;
+template <class T>
+void WriteSection(T & t, FilesContainerW & cont, string const & tag)
+{
+  string const fName = cont.GetFileName() + "." + tag;
+  MY_SCOPE_GUARD(deleteFileGuard, bind(&FileWriter::DeleteFileX, cref(fName)));
+  succinct::mapper::freeze(t, fName.c_str());
+  cont.Write(fName, tag);
+}
 }  // namespace
 
 namespace routing
@@ -161,24 +168,63 @@ void OsrmFtSegMapping::Clear()
 {
   m_offsets.clear();
   m_handle.Unmap();
+  succinct::elias_fano().swap(m_starts);
+  m_startsHandle.Unmap();
+  m_backwardIndex.Clear();
 }
 
 void OsrmFtSegMapping::Load(FilesMappingContainer & cont, platform::LocalCountryFile const & localFile)
 {
   Clear();
 
+  if (cont.IsExist(ROUTING_FTSEG_STARTS_FILE_TAG))
   {
-    ReaderSource<FileReader> src(cont.GetReader(ROUTING_NODEIND_TO_FTSEGIND_FILE_TAG));
-    uint32_t const count = ReadVarUint<uint32_t>(src);
-    m_offsets.resize(count);
-    for (uint32_t i = 0; i < count; ++i)
+    m_startsHandle.Assign(cont.Map(ROUTING_FTSEG_STARTS_FILE_TAG));
+    ASSERT(m_startsHandle.IsValid(), ());
+    succinct::mapper::map(m_starts, m_startsHandle.GetData<char>());
+  }
+  else
+  {
+    // Routing files made before the starts section.
+    SegOffsetsT offsets;
     {
-      m_offsets[i].m_nodeId = ReadVarUint<TOsrmNodeId>(src);
-      m_offsets[i].m_offset = ReadVarUint<uint32_t>(src);
+      ReaderSource<FileReader> src(cont.GetReader(ROUTING_NODEIND_TO_FTSEGIND_FILE_TAG));
+      uint32_t const count = ReadVarUint<uint32_t>(src);
+      offsets.resize(count);
+      for (uint32_t i = 0; i < count; ++i)
+      {
+        offsets[i].m_nodeId = ReadVarUint<TOsrmNodeId>(src);
+        offsets[i].m_offset = ReadVarUint<uint32_t>(src);
+      }
     }
+
+    FilesMappingContainer::Handle handle(cont.Map(ROUTING_FTSEG_FILE_TAG));
+    succinct::elias_fano_compressed_list segments;
+    succinct::mapper::map(segments, handle.GetData<char>());
+    MakeStarts(offsets, segments.size(), m_starts);
   }
 
-  m_backwardIndex.Construct(*this, m_offsets.back().m_nodeId, cont, localFile);
+  m_backwardIndex.Construct(*this, cont, localFile);
+}
+
+// static
+void OsrmFtSegMapping::MakeStarts(SegOffsetsT const & offsets, uint64_t segmentsCount,
+                                  succinct::elias_fano & starts)
+{
+  // Every node has one segment at least and every offset adds extra segments of its node.
+  uint64_t const nodesCount = segmentsCount - (offsets.empty() ? 0 : offsets.back().m_offset);
+  // The universe is one more than the segments count for rank of the last segment.
+  succinct::elias_fano::elias_fano_builder builder(segmentsCount + 1, nodesCount + 1);
+  size_t next = 0;
+  uint64_t extra = 0;
+  for (TOsrmNodeId node = 0; node < nodesCount; ++node)
+  {
+    builder.push_back(node + extra);
+    if (next < offsets.size() && offsets[next].m_nodeId == node)
+      extra = offsets[next++].m_offset;
+  }
+  builder.push_back(segmentsCount);
+  succinct::elias_fano(&builder).swap(starts);
 }
 
 void OsrmFtSegMapping::Map(FilesMappingContainer & cont)
@@ -248,9 +294,7 @@ void OsrmFtSegMapping::GetOsrmNodes(TFtSegVec const & segments, OsrmNodesT & res
   {
     OsrmMappingTypes::FtSeg const & seg = *it;
 
-    TNodesList const & nodeIds = m_backwardIndex.GetNodeIdByFid(seg.m_fid);
-
-    for (uint32_t nodeId : nodeIds)
+    m_backwardIndex.ForEachNodeId(seg.m_fid, [&](TOsrmNodeId nodeId)
     {
       auto const & range = GetSegmentsRange(nodeId);
       for (size_t i = range.first; i != range.second; ++i)
@@ -280,7 +324,7 @@ void OsrmFtSegMapping::GetOsrmNodes(TFtSegVec const & segments, OsrmNodesT & res
           }
         }
       }
-    }
+    });
   }
 }
 
@@ -291,6 +335,29 @@ void OsrmFtSegMapping::GetSegmentByIndex(size_t idx, OsrmMappingTypes::FtSeg & s
 }
 
 pair<size_t, size_t> OsrmFtSegMapping::GetSegmentsRange(TOsrmNodeId nodeId) const
+{
+  if (m_starts.num_ones() == 0)
+    return GetSegmentsRangeByOffsets(nodeId);
+
+  if (nodeId + 1 >= m_starts.num_ones())
+  {
+    ASSERT(false, (nodeId, m_starts.num_ones()));
+    return make_pair(m_starts.size() - 1, m_starts.size() - 1);
+  }
+  auto const range = m_starts.select_range(nodeId);
+  return make_pair(static_cast<size_t>(range.first), static_cast<size_t>(range.second));
+}
+
+TOsrmNodeId OsrmFtSegMapping::GetNodeId(uint32_t segInd) const
+{
+  if (m_starts.num_ones() == 0)
+    return GetNodeIdByOffsets(segInd);
+
+  ASSERT_LESS(segInd + 1, m_starts.size(), ());
+  return static_cast<TOsrmNodeId>(m_starts.rank(segInd + 1) - 1);
+}
+
+pair<size_t, size_t> OsrmFtSegMapping::GetSegmentsRangeByOffsets(TOsrmNodeId nodeId) const
 {
   SegOffsetsT::const_iterator it = lower_bound(m_offsets.begin(), m_offsets.end(), OsrmMappingTypes::SegOffset(nodeId, 0),
                                                [] (OsrmMappingTypes::SegOffset const & o, OsrmMappingTypes::SegOffset const & val)
@@ -307,7 +374,7 @@ pair<size_t, size_t> OsrmFtSegMapping::GetSegmentsRange(TOsrmNodeId nodeId) cons
     return make_pair(start, start + 1);
 }
 
-TOsrmNodeId OsrmFtSegMapping::GetNodeId(uint32_t segInd) const
+TOsrmNodeId OsrmFtSegMapping::GetNodeIdByOffsets(uint32_t segInd) const
 {
   SegOffsetsT::const_iterator it = lower_bound(m_offsets.begin(), m_offsets.end(), OsrmMappingTypes::SegOffset(segInd, 0),
                                                [] (OsrmMappingTypes::SegOffset const & o, OsrmMappingTypes::SegOffset const & val)
@@ -360,6 +427,7 @@ void OsrmFtSegMappingBuilder::Append(TOsrmNodeId nodeId, FtSegVectorT const & da
 void OsrmFtSegMappingBuilder::Save(FilesContainerW & cont) const
 {
   {
+    // Old routing files readers need offsets.
     FileWriter writer = cont.GetWriter(ROUTING_NODEIND_TO_FTSEGIND_FILE_TAG);
     uint32_t const count = static_cast<uint32_t>(m_offsets.size());
     WriteVarUint(writer, count);
@@ -373,149 +441,139 @@ void OsrmFtSegMappingBuilder::Save(FilesContainerW & cont) const
     writer.WritePaddingByEnd(4);
   }
 
-  string const fName = cont.GetFileName() + "." ROUTING_FTSEG_FILE_TAG;
-  MY_SCOPE_GUARD(deleteFileGuard, bind(&FileWriter::DeleteFileX, cref(fName)));
-
   succinct::elias_fano_compressed_list compressed(m_buffer);
-  succinct::mapper::freeze(compressed, fName.c_str());
-  cont.Write(fName, ROUTING_FTSEG_FILE_TAG);
-}
+  WriteSection(compressed, cont, ROUTING_FTSEG_FILE_TAG);
 
-void OsrmFtSegBackwardIndex::Save(string const & nodesFileName, string const & bitsFileName)
-{
+  succinct::elias_fano starts;
+  MakeStarts(m_offsets, m_buffer.size(), starts);
+  WriteSection(starts, cont, ROUTING_FTSEG_STARTS_FILE_TAG);
+
+  OsrmFtSegBackwardIndex::TFidNodes fidNodes;
+  fidNodes.reserve(m_buffer.size());
+  for (uint64_t node = 0; node + 1 < starts.num_ones(); ++node)
   {
-    LOG(LINFO, ("Saving routing nodes index to ", nodesFileName));
-    string const nodesFileNameTmp = nodesFileName + EXTENSION_TMP;
-    FileWriter nodesFile(nodesFileNameTmp);
-    WriteVarUint(nodesFile, static_cast<uint32_t>(m_nodeIds.size()));
-    for (auto const bucket : m_nodeIds)
+    auto const range = starts.select_range(node);
+    for (uint64_t i = range.first; i != range.second; ++i)
     {
-      rw::WriteVectorOfPOD(nodesFile, bucket);
+      OsrmMappingTypes::FtSeg const seg(m_buffer[i]);
+      if (seg.IsValid())
+        fidNodes.emplace_back(seg.m_fid, static_cast<TOsrmNodeId>(node));
     }
-    my::RenameFileX(nodesFileNameTmp, nodesFileName);
-  }
-  {
-    LOG(LINFO, ("Saving features routing bits to ", bitsFileName));
-    string const bitsFileNameTmp = bitsFileName + EXTENSION_TMP;
-    succinct::mapper::freeze(m_rankIndex, bitsFileNameTmp.c_str());
-    my::RenameFileX(bitsFileNameTmp, bitsFileName);
   }
+  OsrmFtSegBackwardIndex backwardIndex;
+  backwardIndex.Build(fidNodes);
+  string const fName = cont.GetFileName() + "." ROUTING_FTSEG_BACKWARD_FILE_TAG;
+  MY_SCOPE_GUARD(deleteFileGuard, bind(&FileWriter::DeleteFileX, cref(fName)));
+  backwardIndex.Save(fName);
+  cont.Write(fName, ROUTING_FTSEG_BACKWARD_FILE_TAG);
 }
 
-bool OsrmFtSegBackwardIndex::Load(string const & nodesFileName, string const & bitsFileName)
+void OsrmFtSegBackwardIndex::Build(TFidNodes & fidNodes)
 {
-  Platform & pl = GetPlatform();
-  if (!pl.IsFileExistsByFullPath(nodesFileName) || !pl.IsFileExistsByFullPath(bitsFileName))
-    return false;
+  Clear();
+
+  // Remove duplicate nodes emitted by equal choices on a generation route step.
+  sort(fidNodes.begin(), fidNodes.end());
+  fidNodes.erase(unique(fidNodes.begin(), fidNodes.end()), fidNodes.end());
 
-  m_mappedBits.reset(new MmapReader(bitsFileName));
+  size_t featuresCount = 0;
+  for (size_t i = 0; i < fidNodes.size(); ++i)
+  {
+    if (i == 0 || fidNodes[i].first != fidNodes[i - 1].first)
+      ++featuresCount;
+  }
 
+  vector<bool> features(fidNodes.empty() ? 0 : fidNodes.back().first + 1, false);
+  succinct::elias_fano::elias_fano_builder starts(fidNodes.size(), featuresCount + 1);
+  vector<uint64_t> nodeIds;
+  nodeIds.reserve(fidNodes.size());
+  for (size_t i = 0; i < fidNodes.size(); ++i)
   {
-    FileReader nodesFile(nodesFileName);
-    ReaderSource<FileReader> nodesSource(nodesFile);
-    uint32_t size = ReadVarUint<uint32_t>(nodesSource);
-    m_nodeIds.resize(size);
-    for (uint32_t i = 0; i < size; ++i)
+    uint32_t const fid = fidNodes[i].first;
+    if (i == 0 || fid != fidNodes[i - 1].first)
     {
-      rw::ReadVectorOfPOD(nodesSource, m_nodeIds[i]);
+      features[fid] = true;
+      starts.push_back(i);
     }
+    nodeIds.push_back(fidNodes[i].second);
   }
-  succinct::mapper::map(m_rankIndex, reinterpret_cast<char const *>(m_mappedBits->Data()));
+  starts.push_back(fidNodes.size());
+
+  succinct::rs_bit_vector(features).swap(m_data.m_features);
+  succinct::elias_fano(&starts, false /* with_rank_index */).swap(m_data.m_starts);
+  succinct::elias_fano_compressed_list(nodeIds).swap(m_data.m_nodeIds);
+}
+
+void OsrmFtSegBackwardIndex::Save(string const & fileName)
+{
+  LOG(LINFO, ("Saving routing backward index to", fileName));
+  string const fileNameTmp = fileName + EXTENSION_TMP;
+  succinct::mapper::freeze(m_data, fileNameTmp.c_str());
+  my::RenameFileX(fileNameTmp, fileName);
+}
 
+bool OsrmFtSegBackwardIndex::Load(string const & fileName)
+{
+  if (!GetPlatform().IsFileExistsByFullPath(fileName))
+    return false;
+
+  m_mappedFile.reset(new MmapReader(fileName));
+  succinct::mapper::map(m_data, reinterpret_cast<char const *>(m_mappedFile->Data()));
   return true;
 }
 
-void OsrmFtSegBackwardIndex::Construct(OsrmFtSegMapping & mapping, uint32_t maxNodeId,
+void OsrmFtSegBackwardIndex::Construct(OsrmFtSegMapping & mapping,
                                        FilesMappingContainer & routingFile,
                                        platform::LocalCountryFile const & localFile)
 {
   Clear();
 
-  feature::DataHeader header(localFile.GetPath(MapOptions::Map));
-  m_oldFormat = header.GetFormat() < version::v5;
-  if (m_oldFormat)
-    LOG(LINFO, ("Using old format index for", localFile.GetCountryName()));
+  if (routingFile.IsExist(ROUTING_FTSEG_BACKWARD_FILE_TAG))
+  {
+    m_handle.Assign(routingFile.Map(ROUTING_FTSEG_BACKWARD_FILE_TAG));
+    ASSERT(m_handle.IsValid(), ());
+    succinct::mapper::map(m_data, m_handle.GetData<char>());
+    return;
+  }
 
   CountryIndexes::PreparePlaceOnDisk(localFile);
-  string const bitsFileName = CountryIndexes::GetPath(localFile, CountryIndexes::Index::Bits);
-  string const nodesFileName = CountryIndexes::GetPath(localFile, CountryIndexes::Index::Nodes);
-
-  m_table = feature::FeaturesOffsetsTable::CreateIfNotExistsAndLoad(localFile);
+  string const fileName = CountryIndexes::GetPath(localFile, CountryIndexes::Index::FtSegBackward);
+  if (Load(fileName))
+    return;
 
-  if (Load(bitsFileName, nodesFileName))
+  // Feature ids of maps older than v5 are offsets of features, so they can't index a bit vector.
+  version::MwmVersion version;
+  if (!version::ReadVersion(FilesContainerR(localFile.GetPath(MapOptions::Map)), version) ||
+      version.format < version::v5)
+  {
+    LOG(LWARNING, ("Backward routing index isn't built for the old map format", localFile));
     return;
+  }
 
   LOG(LINFO, ("Backward routing index is absent! Creating new one."));
   mapping.Map(routingFile);
-
-  // Generate temporary index to speedup processing
-  unordered_map<uint32_t, TNodesList> temporaryBackwardIndex;
-  for (uint32_t i = 0; i < maxNodeId; ++i)
+  TFidNodes fidNodes;
+  fidNodes.reserve(mapping.GetSegmentsCount());
+  for (size_t i = 0; i < mapping.GetSegmentsCount(); ++i)
   {
-    auto indexes = mapping.GetSegmentsRange(i);
-    for (; indexes.first != indexes.second; ++indexes.first)
-    {
-      OsrmMappingTypes::FtSeg seg;
-      mapping.GetSegmentByIndex(indexes.first, seg);
-      temporaryBackwardIndex[seg.m_fid].push_back(i);
-    }
+    OsrmMappingTypes::FtSeg seg;
+    mapping.GetSegmentByIndex(i, seg);
+    if (seg.IsValid())
+      fidNodes.emplace_back(seg.m_fid, mapping.GetNodeId(static_cast<uint32_t>(i)));
   }
-
   mapping.Unmap();
-  LOG(LINFO, ("Temporary index constructed"));
 
-  // Create final index
-  vector<bool> inIndex(m_table->size(), false);
-  m_nodeIds.reserve(temporaryBackwardIndex.size());
-
-  size_t removedNodes = 0;
-  for (size_t i = 0; i < m_table->size(); ++i)
-  {
-    uint32_t const fid = m_oldFormat ? m_table->GetFeatureOffset(i) : static_cast<uint32_t>(i);
-    auto it = temporaryBackwardIndex.find(fid);
-    if (it != temporaryBackwardIndex.end())
-    {
-      inIndex[i] = true;
-      m_nodeIds.emplace_back(move(it->second));
-
-      // Remove duplicates nodes emmited by equal choises on a generation route step.
-      TNodesList & nodesList = m_nodeIds.back();
-      size_t const foundNodes = nodesList.size();
-      sort(nodesList.begin(), nodesList.end());
-      nodesList.erase(unique(nodesList.begin(), nodesList.end()), nodesList.end());
-      removedNodes += foundNodes - nodesList.size();
-    }
-  }
-
-  LOG(LDEBUG, ("Backward index constructor removed", removedNodes, "duplicates."));
-
-  // Pack and save index
-  succinct::rs_bit_vector(inIndex).swap(m_rankIndex);
-
-  LOG(LINFO, ("Writing additional indexes to data files", bitsFileName, nodesFileName));
-  Save(bitsFileName, nodesFileName);
-}
-
-TNodesList const & OsrmFtSegBackwardIndex::GetNodeIdByFid(uint32_t fid) const
-{
-  ASSERT(m_table, ());
-
-  size_t const index = m_oldFormat ? m_table->GetFeatureIndexbyOffset(fid) : fid;
-  ASSERT_LESS(index, m_table->size(), ("Can't find feature index in offsets table"));
-  if (!m_rankIndex[index])
-    return kEmptyList;
-
-  size_t nodeIdx = m_rankIndex.rank(index);
-  ASSERT_LESS(nodeIdx, m_nodeIds.size(), ());
-  return m_nodeIds[nodeIdx];
+  Build(fidNodes);
+  Save(fileName);
 }
 
 void OsrmFtSegBackwardIndex::Clear()
 {
-  m_nodeIds.clear();
-  succinct::rs_bit_vector().swap(m_rankIndex);
-  m_table.reset();
-  m_mappedBits.reset();
+  succinct::rs_bit_vector().swap(m_data.m_features);
+  succinct::elias_fano().swap(m_data.m_starts);
+  succinct::elias_fano_compressed_list().swap(m_data.m_nodeIds);
+  m_handle.Unmap();
+  m_mappedFile.reset();
 }
 
 }
@@ -1,7 +1,5 @@
 #pragma once
 
-#include "indexer/features_offsets_table.hpp"
-
 #include "coding/file_container.hpp"
 #include "coding/mmap_reader.hpp"
 
@@ -11,12 +9,14 @@
 
 #include "std/limits.hpp"
 #include "std/string.hpp"
+#include "std/unique_ptr.hpp"
 #include "std/unordered_map.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
 
-#include "3party/succinct/rs_bit_vector.hpp"
+#include "3party/succinct/elias_fano.hpp"
 #include "3party/succinct/elias_fano_compressed_list.hpp"
+#include "3party/succinct/rs_bit_vector.hpp"
 
 #include "defines.hpp"
 
@@ -100,27 +100,56 @@ FtSeg SplitSegment(FtSeg const & segment, FtSeg const & splitter, bool const res
 
 class OsrmFtSegMapping;
 
+/// Index of OSRM nodes of features: a bit for every feature id which has nodes, starts of lists
+/// of nodes of these features and sorted node ids of every feature. The generator writes it to
+/// the ROUTING_FTSEG_BACKWARD_FILE_TAG section. For routing files without the section it's built
+/// at the first load and saved to country indexes.
 class OsrmFtSegBackwardIndex
 {
-  succinct::rs_bit_vector m_rankIndex;
-  vector<TNodesList> m_nodeIds;
-  unique_ptr<feature::FeaturesOffsetsTable> m_table;
-
-  unique_ptr<MmapReader> m_mappedBits;
-
-  bool m_oldFormat;
+public:
+  using TFidNodes = vector<pair<uint32_t, TOsrmNodeId>>;
 
-  void Save(string const & nodesFileName, string const & bitsFileName);
-  bool Load(string const & nodesFileName, string const & bitsFileName);
+  /// @param fidNodes Pairs of feature ids and their nodes in any order, it's sorted.
+  void Build(TFidNodes & fidNodes);
+  void Save(string const & fileName);
 
-public:
-  void Construct(OsrmFtSegMapping & mapping, uint32_t maxNodeId,
-                 FilesMappingContainer & routingFile,
+  void Construct(OsrmFtSegMapping & mapping, FilesMappingContainer & routingFile,
                  platform::LocalCountryFile const & localFile);
 
-  TNodesList const & GetNodeIdByFid(uint32_t fid) const;
+  bool HasNodeIds(uint32_t fid) const
+  {
+    return fid < m_data.m_features.size() && m_data.m_features[fid];
+  }
+
+  template <class ToDo> void ForEachNodeId(uint32_t fid, ToDo && toDo) const
+  {
+    if (!HasNodeIds(fid))
+      return;
+    auto const range = m_data.m_starts.select_range(m_data.m_features.rank(fid));
+    for (uint64_t i = range.first; i != range.second; ++i)
+      toDo(static_cast<TOsrmNodeId>(m_data.m_nodeIds[i]));
+  }
 
   void Clear();
+
+private:
+  struct Data
+  {
+    succinct::rs_bit_vector m_features;
+    succinct::elias_fano m_starts;
+    succinct::elias_fano_compressed_list m_nodeIds;
+
+    template <typename Visitor> void map(Visitor & visit)
+    {
+      visit(m_features, "m_features")(m_starts, "m_starts")(m_nodeIds, "m_nodeIds");
+    }
+  };
+
+  bool Load(string const & fileName);
+
+  Data m_data;
+  FilesMappingContainer::Handle m_handle;
+  unique_ptr<MmapReader> m_mappedFile;
 };
 
 class OsrmFtSegMapping
@@ -151,9 +180,11 @@ public:
   void GetOsrmNodes(TFtSegVec const & segments, OsrmNodesT & res) const;
 
   void GetSegmentByIndex(size_t idx, OsrmMappingTypes::FtSeg & seg) const;
-  TNodesList const & GetNodeIdByFid(uint32_t fid) const
+
+  bool HasNodeIds(uint32_t fid) const { return m_backwardIndex.HasNodeIds(fid); }
+  template <class ToDo> void ForEachNodeIdByFid(uint32_t fid, ToDo && toDo) const
   {
-    return m_backwardIndex.GetNodeIdByFid(fid);
+    m_backwardIndex.ForEachNodeId(fid, forward<ToDo>(toDo));
   }
 
   /// @name For debug purpose only.
@@ -174,11 +205,25 @@ public:
 
 protected:
   typedef vector<OsrmMappingTypes::SegOffset> SegOffsetsT;
+
+  /// Makes starts of segments of nodes by offsets of nodes with several segments.
+  static void MakeStarts(SegOffsetsT const & offsets, uint64_t segmentsCount,
+                         succinct::elias_fano & starts);
+
+  /// Offsets of nodes with several segments. Only the builder uses them for lookups,
+  /// loaded mappings have m_starts.
   SegOffsetsT m_offsets;
 
 private:
+  pair<size_t, size_t> GetSegmentsRangeByOffsets(TOsrmNodeId nodeId) const;
+  TOsrmNodeId GetNodeIdByOffsets(uint32_t segInd) const;
+
   succinct::elias_fano_compressed_list m_segments;
   FilesMappingContainer::Handle m_handle;
+  /// Positions of the first segments of nodes and the segments count, so segments of a node n
+  /// are [select(n), select(n + 1)).
+  succinct::elias_fano m_starts;
+  FilesMappingContainer::Handle m_startsHandle;
   OsrmFtSegBackwardIndex m_backwardIndex;
 };
 
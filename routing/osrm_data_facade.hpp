@@ -9,7 +9,10 @@
 
 #include "base/bits.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/numeric.hpp"
 #include "std/string.hpp"
+#include "std/vector.hpp"
 
 #include "3party/succinct/elias_fano.hpp"
 #include "3party/succinct/elias_fano_compressed_list.hpp"
@@ -39,6 +42,61 @@ protected:
 
   uint32_t m_numberOfNodes = 0;
 
+  /// @name Hot edge cache: adjacency of hot blocks of consecutive nodes decoded into flat arrays.
+  //@{
+  enum : uint32_t
+  {
+    kHotBlockBits = 4,
+    kHotBlockSize = 1 << kHotBlockBits,
+    kNoHotBlock = 0xFFFFFFFF,
+    kEdgeChunkBits = 6
+  };
+
+  struct HotBlock
+  {
+    /// Ids of the first edges of the nodes of the block and the end of the last node edges.
+    EdgeID m_nodeBegins[kHotBlockSize + 1];
+    /// Position of the first edge of the block in the flat arrays.
+    uint32_t m_offset;
+  };
+
+  /// Index of a block in m_hotBlocks or kNoHotBlock for every block of nodes.
+  vector<uint32_t> m_hotBlockIndexes;
+  /// Hot blocks sorted by nodes and therefore by edges.
+  vector<HotBlock> m_hotBlocks;
+  /// Index of the first hot block which ends after the start of every chunk of edges.
+  vector<uint32_t> m_hotEdgeChunks;
+  vector<NodeID> m_hotTargets;
+  vector<EdgeDataT> m_hotEdgeData;
+  size_t m_hotEdgeCacheBytes = 0;
+  /// Touches of every block of nodes, they are counted when it isn't empty.
+  mutable vector<uint32_t> m_touches;
+
+  HotBlock const * GetHotBlockByNode(NodeID n) const
+  {
+    if (m_hotBlocks.empty())
+      return nullptr;
+    uint32_t const index = m_hotBlockIndexes[n >> kHotBlockBits];
+    return index == kNoHotBlock ? nullptr : &m_hotBlocks[index];
+  }
+
+  HotBlock const * GetHotBlockByEdge(EdgeID e) const
+  {
+    if (m_hotBlocks.empty())
+      return nullptr;
+    // There are few blocks in a chunk.
+    size_t i = m_hotEdgeChunks[e >> kEdgeChunkBits];
+    while (i < m_hotBlocks.size() && m_hotBlocks[i].m_nodeBegins[kHotBlockSize] <= e)
+      ++i;
+    if (i == m_hotBlocks.size() || e < m_hotBlocks[i].m_nodeBegins[0])
+      return nullptr;
+    return &m_hotBlocks[i];
+  }
+  //@}
+
+  /// Weights of edges which replace the weights of the routing file when it isn't empty.
+  vector<uint32_t> m_edgeWeights;
+
 public:
   //OsrmRawDataFacade(): m_numberOfNodes(0) {}
 
@@ -62,12 +120,140 @@ public:
 
   void ClearRawData()
   {
+    ClearHotEdgeCache();
+    ClearContainer(m_edgeWeights);
     ClearContainer(m_edgeData);
     ClearContainer(m_edgeId);
     ClearContainer(m_shortcuts);
     ClearContainer(m_matrix);
   }
 
+  /// Starts counting of touches of nodes for BuildHotEdgeCache. Counting isn't thread-safe,
+  /// so run profiling queries from one thread.
+  void StartTouchesCounting()
+  {
+    m_touches.assign((m_numberOfNodes + kHotBlockSize - 1) >> kHotBlockBits, 0);
+  }
+
+  bool IsTouchesCounting() const { return !m_touches.empty(); }
+
+  /// Decodes adjacency of the most touched nodes into flat arrays until the cache takes
+  /// maxBytes, adjacency of other nodes is read from the succinct structures. Nodes are ranked
+  /// in blocks of kHotBlockSize by touches counted since StartTouchesCounting or, when touches
+  /// weren't counted, by edges count, which is high at top levels of the contraction hierarchy.
+  /// The cache is read-only, so the facade may be used from several threads as before.
+  void BuildHotEdgeCache(size_t maxBytes)
+  {
+    ClearHotEdgeCache();
+    vector<uint32_t> touches;
+    touches.swap(m_touches);
+
+    uint32_t const blocksCount = (m_numberOfNodes + kHotBlockSize - 1) >> kHotBlockBits;
+    size_t const chunksCount = (GetNumberOfEdges() >> kEdgeChunkBits) + 1;
+    size_t bytes = (blocksCount + chunksCount) * sizeof(uint32_t);
+    if (blocksCount == 0 || bytes > maxBytes)
+      return;
+
+    // Edges of consecutive nodes are consecutive.
+    vector<EdgeID> blockBegins(blocksCount + 1);
+    for (uint32_t b = 0; b <= blocksCount; ++b)
+      blockBegins[b] = BeginEdges(min(b << kHotBlockBits, m_numberOfNodes));
+
+    auto const getWeight = [&](uint32_t b) -> uint64_t
+    {
+      return touches.empty() ? blockBegins[b + 1] - blockBegins[b] : touches[b];
+    };
+    vector<uint32_t> order(blocksCount);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](uint32_t b1, uint32_t b2)
+    {
+      return getWeight(b1) > getWeight(b2);
+    });
+
+    vector<uint32_t> hot;
+    for (uint32_t b : order)
+    {
+      if (getWeight(b) == 0)
+        break;
+      size_t const blockBytes =
+          sizeof(HotBlock) +
+          (blockBegins[b + 1] - blockBegins[b]) * (sizeof(NodeID) + sizeof(EdgeDataT));
+      // Smaller blocks may still fit.
+      if (bytes + blockBytes > maxBytes)
+        continue;
+      bytes += blockBytes;
+      hot.push_back(b);
+    }
+    sort(hot.begin(), hot.end());
+
+    vector<HotBlock> blocks(hot.size());
+    vector<NodeID> targets;
+    vector<EdgeDataT> edgeData;
+    for (size_t i = 0; i < hot.size(); ++i)
+    {
+      HotBlock & block = blocks[i];
+      block.m_offset = static_cast<uint32_t>(targets.size());
+      for (uint32_t j = 0; j < kHotBlockSize; ++j)
+      {
+        NodeID const node = (hot[i] << kHotBlockBits) + j;
+        if (node >= m_numberOfNodes)
+        {
+          block.m_nodeBegins[j] = blockBegins[hot[i] + 1];
+          continue;
+        }
+        block.m_nodeBegins[j] = BeginEdges(node);
+        EdgeID const end = EndEdges(node);
+        for (EdgeID e = block.m_nodeBegins[j]; e < end; ++e)
+        {
+          targets.push_back(GetTarget(e));
+          edgeData.push_back(GetEdgeData(e, node));
+        }
+      }
+      block.m_nodeBegins[kHotBlockSize] = blockBegins[hot[i] + 1];
+    }
+
+    m_hotBlockIndexes.assign(blocksCount, kNoHotBlock);
+    for (size_t i = 0; i < hot.size(); ++i)
+      m_hotBlockIndexes[hot[i]] = static_cast<uint32_t>(i);
+    m_hotEdgeChunks.resize(chunksCount);
+    for (size_t c = 0, i = 0; c < chunksCount; ++c)
+    {
+      while (i < blocks.size() && blocks[i].m_nodeBegins[kHotBlockSize] <= (c << kEdgeChunkBits))
+        ++i;
+      m_hotEdgeChunks[c] = static_cast<uint32_t>(i);
+    }
+    m_hotBlocks.swap(blocks);
+    m_hotTargets.swap(targets);
+    m_hotEdgeData.swap(edgeData);
+    m_hotEdgeCacheBytes = bytes;
+  }
+
+  void ClearHotEdgeCache()
+  {
+    ClearContainer(m_hotBlockIndexes);
+    ClearContainer(m_hotBlocks);
+    ClearContainer(m_hotEdgeChunks);
+    ClearContainer(m_hotTargets);
+    ClearContainer(m_hotEdgeData);
+    m_hotEdgeCacheBytes = 0;
+  }
+
+  /// @return Memory taken by the hot edge cache, 0 if there is no cache.
+  size_t GetHotEdgeCacheBytes() const { return m_hotEdgeCacheBytes; }
+
+  /// Replaces the weights of the routing file by weights[e] for every edge e, an empty vector
+  /// restores them. Weights of shortcuts have to be sums of weights of their halves, see
+  /// CustomizeEdgeWeights. The hot edge cache is cleared, build it again after this call.
+  void SetEdgeWeights(vector<uint32_t> && weights)
+  {
+    ASSERT(weights.empty() || weights.size() == GetNumberOfEdges(), ());
+    ClearHotEdgeCache();
+    m_edgeWeights.swap(weights);
+    ClearContainer(weights);
+  }
+
+  bool HasCustomEdgeWeights() const { return !m_edgeWeights.empty(); }
+
   unsigned GetNumberOfNodes() const override
   {
     return m_numberOfNodes;
@@ -85,18 +271,28 @@ public:
 
   NodeID GetTarget(const EdgeID e) const override
   {
+    if (HotBlock const * block = GetHotBlockByEdge(e))
+      return m_hotTargets[block->m_offset + e - block->m_nodeBegins[0]];
     return (m_matrix.select(e) / 2) % GetNumberOfNodes();
   }
 
   EdgeDataT GetEdgeData(const EdgeID e, NodeID node) const override
   {
+    if (HotBlock const * block = GetHotBlockByNode(node))
+    {
+      EdgeID const * begins = block->m_nodeBegins + (node & (kHotBlockSize - 1));
+      // Shortcut ids depend on the node, so only edges of the node are taken from the cache.
+      if (e >= begins[0] && e < begins[1])
+        return m_hotEdgeData[block->m_offset + e - block->m_nodeBegins[0]];
+    }
+
     EdgeDataT res;
 
     res.shortcut = m_shortcuts[e];
     res.id = res.shortcut ? (node - static_cast<NodeID>(bits::ZigZagDecode(m_edgeId[static_cast<size_t>(m_shortcuts.rank(e))]))) : 0;
     res.backward = (m_matrix.select(e) % 2 == 1);
     res.forward = !res.backward;
-    res.distance = static_cast<int>(m_edgeData[e]);
+    res.distance = static_cast<int>(m_edgeWeights.empty() ? m_edgeData[e] : m_edgeWeights[e]);
 
     return res;
   }
@@ -116,18 +312,24 @@ public:
 
   EdgeID BeginEdges(const NodeID n) const override
   {
+    if (HotBlock const * block = GetHotBlockByNode(n))
+      return block->m_nodeBegins[n & (kHotBlockSize - 1)];
     uint64_t idx = 2 * n * (uint64_t)GetNumberOfNodes();
     return n == 0 ? 0 : static_cast<EdgeID>(m_matrix.rank(min(idx, m_matrix.size())));
   }
 
   EdgeID EndEdges(const NodeID n) const override
   {
+    if (HotBlock const * block = GetHotBlockByNode(n))
+      return block->m_nodeBegins[(n & (kHotBlockSize - 1)) + 1];
     uint64_t const idx = 2 * (n + 1) * (uint64_t)GetNumberOfNodes();
     return static_cast<EdgeID>(m_matrix.rank(min(idx, m_matrix.size())));
   }
 
   EdgeRange GetAdjacentEdgeRange(const NodeID node) const override
   {
+    if (!m_touches.empty())
+      ++m_touches[node >> kHotBlockBits];
     return osrm::irange(BeginEdges(node), EndEdges(node));
   }
 
@@ -4,13 +4,307 @@
 #include "base/logging.hpp"
 #include "base/timer.hpp"
 
+#include "std/algorithm.hpp"
+#include "std/unordered_set.hpp"
+#include "std/utility.hpp"
+
 #include "3party/osrm/osrm-backend/data_structures/internal_route_result.hpp"
 #include "3party/osrm/osrm-backend/data_structures/search_engine_data.hpp"
 #include "3party/osrm/osrm-backend/routing_algorithms/n_to_m_many_to_many.hpp"
+#include "3party/osrm/osrm-backend/routing_algorithms/routing_base.hpp"
 #include "3party/osrm/osrm-backend/routing_algorithms/shortest_path.hpp"
 
 namespace routing
 {
+namespace
+{
+bool HasNodes(PhantomNode const & node)
+{
+  return node.forward_node_id != INVALID_NODE_ID || node.reverse_node_id != INVALID_NODE_ID;
+}
+
+void FillRoutingResult(FeatureGraphNode const & source, FeatureGraphNode const & target,
+                       int length, vector<PathData> const & path, RawRoutingResult & result)
+{
+  result.sourceEdge = source;
+  result.targetEdge = target;
+  result.shortestPathLength = length;
+  vector<RawPathData> data;
+  data.reserve(path.size());
+  for (auto const & element : path)
+    data.emplace_back(element.node, element.segment_duration);
+  result.unpackedPathSegments.emplace_back(move(data));
+}
+
+/// Via-node alternatives finder. Unlike OSRM AlternativeRouting it finds several alternatives
+/// and doesn't need FindEdgeInEitherDirection which OsrmRawDataFacade doesn't support: all
+/// the checks are made on fully unpacked paths.
+class AlternativeRoutesFinder
+    : private BasicRoutingInterface<TRawDataFacade, AlternativeRoutesFinder>
+{
+  using TBase = BasicRoutingInterface<TRawDataFacade, AlternativeRoutesFinder>;
+  using TQueryHeap = SearchEngineData::QueryHeap;
+
+public:
+  AlternativeRoutesFinder(TRawDataFacade & facade, AlternativeRoutesParams const & params)
+    : TBase(&facade), m_facade(facade), m_params(params)
+  {
+  }
+
+  bool Find(FeatureGraphNode const & source, FeatureGraphNode const & target,
+            vector<RawRoutingResult> & results)
+  {
+    results.clear();
+    PhantomNodes nodes;
+    nodes.source_phantom = source.node;
+    nodes.target_phantom = target.node;
+    if (!HasNodes(nodes.source_phantom) || !HasNodes(nodes.target_phantom) ||
+        m_params.m_maxRoutesCount == 0)
+    {
+      return false;
+    }
+
+    unsigned const nodesCount = m_facade.GetNumberOfNodes();
+    m_engineData.InitializeOrClearFirstThreadLocalStorage(nodesCount);
+    TQueryHeap & forwardHeap = *m_engineData.forward_heap_1;
+    TQueryHeap & reverseHeap = *m_engineData.reverse_heap_1;
+
+    PhantomNode const & s = nodes.source_phantom;
+    PhantomNode const & t = nodes.target_phantom;
+    if (s.forward_node_id != INVALID_NODE_ID)
+      forwardHeap.Insert(s.forward_node_id, -s.GetForwardWeightPlusOffset(), s.forward_node_id);
+    if (s.reverse_node_id != INVALID_NODE_ID)
+      forwardHeap.Insert(s.reverse_node_id, -s.GetReverseWeightPlusOffset(), s.reverse_node_id);
+    if (t.forward_node_id != INVALID_NODE_ID)
+      reverseHeap.Insert(t.forward_node_id, t.GetForwardWeightPlusOffset(), t.forward_node_id);
+    if (t.reverse_node_id != INVALID_NODE_ID)
+      reverseHeap.Insert(t.reverse_node_id, t.GetReverseWeightPlusOffset(), t.reverse_node_id);
+    m_edgeOffset = min(0, min(-s.GetForwardWeightPlusOffset(), -s.GetReverseWeightPlusOffset()));
+
+    // Both searches go on until (1 + m_maxStretch) * L to collect via nodes.
+    NodeID middle = SPECIAL_NODEID;
+    int shortestLength = INVALID_EDGE_WEIGHT;
+    vector<NodeID> viaNodes;
+    while (!forwardHeap.Empty() || !reverseHeap.Empty())
+    {
+      if (!forwardHeap.Empty())
+        SearchStep(forwardHeap, reverseHeap, true /* forward */, middle, shortestLength, viaNodes);
+      if (!reverseHeap.Empty())
+        SearchStep(reverseHeap, forwardHeap, false /* forward */, middle, shortestLength, viaNodes);
+    }
+    if (middle == SPECIAL_NODEID)
+      return false;
+
+    vector<NodeID> packedPath;
+    TBase::RetrievePackedPathFromHeap(forwardHeap, reverseHeap, middle, packedPath);
+    vector<PathData> path;
+    TBase::UnpackPath(packedPath, nodes, path);
+    AddRoute(source, target, shortestLength, path, results);
+
+    double const maxLength = shortestLength * (1.0 + m_params.m_maxStretch);
+    vector<pair<int, NodeID>> candidates;
+    sort(viaNodes.begin(), viaNodes.end());
+    viaNodes.erase(unique(viaNodes.begin(), viaNodes.end()), viaNodes.end());
+    for (NodeID const node : viaNodes)
+    {
+      int const length = forwardHeap.GetKey(node) + reverseHeap.GetKey(node);
+      if (length <= maxLength)
+        candidates.emplace_back(length, node);
+    }
+    sort(candidates.begin(), candidates.end());
+
+    size_t checked = 0;
+    for (auto const & candidate : candidates)
+    {
+      if (results.size() >= m_params.m_maxRoutesCount || checked >= m_params.m_maxViaNodesCount)
+        break;
+      NodeID const via = candidate.second;
+      // Paths through nodes of found routes mostly repeat them.
+      if (m_routesNodes.count(via) != 0)
+        continue;
+      ++checked;
+
+      int length = 0;
+      if (!FindViaPath(via, forwardHeap, reverseHeap, packedPath, length) || length > maxLength)
+        continue;
+      path.clear();
+      TBase::UnpackPath(packedPath, nodes, path);
+      if (IsAdmissible(path, via, shortestLength))
+        AddRoute(source, target, length, path, results);
+    }
+    return true;
+  }
+
+private:
+  /// Step of the search which doesn't stop at the shortest path and collects via nodes.
+  void SearchStep(TQueryHeap & heap, TQueryHeap & otherHeap, bool forward, NodeID & middle,
+                  int & upperBound, vector<NodeID> & viaNodes) const
+  {
+    NodeID const node = heap.DeleteMin();
+    int const distance = heap.GetKey(node);
+    if (upperBound != INVALID_EDGE_WEIGHT &&
+        distance + m_edgeOffset > upperBound * (1.0 + m_params.m_maxStretch))
+    {
+      heap.DeleteAll();
+      return;
+    }
+
+    if (otherHeap.WasInserted(node))
+    {
+      viaNodes.push_back(node);
+      int const length = distance + otherHeap.GetKey(node);
+      if (length >= 0 && length < upperBound)
+      {
+        middle = node;
+        upperBound = length;
+      }
+    }
+
+    for (auto const edge : m_facade.GetAdjacentEdgeRange(node))
+    {
+      QueryEdge::EdgeData const data = m_facade.GetEdgeData(edge, node);
+      if (!(forward ? data.forward : data.backward))
+        continue;
+      NodeID const to = m_facade.GetTarget(edge);
+      int const toDistance = distance + data.distance;
+      if (!heap.WasInserted(to))
+      {
+        heap.Insert(to, toDistance, node);
+      }
+      else if (toDistance < heap.GetKey(to))
+      {
+        heap.GetData(to).parent = node;
+        heap.DecreaseKey(to, toDistance);
+      }
+    }
+  }
+
+  /// Finds the packed path through the via node by searches from it which meet the search
+  /// spaces of the source and of the target.
+  bool FindViaPath(NodeID via, TQueryHeap & forwardHeap, TQueryHeap & reverseHeap,
+                   vector<NodeID> & packedPath, int & length)
+  {
+    m_engineData.InitializeOrClearSecondThreadLocalStorage(m_facade.GetNumberOfNodes());
+    TQueryHeap & fromViaHeap = *m_engineData.forward_heap_2;
+    TQueryHeap & toViaHeap = *m_engineData.reverse_heap_2;
+
+    NodeID toViaMiddle = SPECIAL_NODEID;
+    int toViaLength = INVALID_EDGE_WEIGHT;
+    toViaHeap.Insert(via, 0, via);
+    while (!toViaHeap.Empty())
+    {
+      TBase::RoutingStep(toViaHeap, forwardHeap, &toViaMiddle, &toViaLength, m_edgeOffset,
+                         false /* forward */);
+    }
+    if (toViaMiddle == SPECIAL_NODEID)
+      return false;
+
+    NodeID fromViaMiddle = SPECIAL_NODEID;
+    int fromViaLength = INVALID_EDGE_WEIGHT;
+    fromViaHeap.Insert(via, 0, via);
+    while (!fromViaHeap.Empty())
+    {
+      TBase::RoutingStep(fromViaHeap, reverseHeap, &fromViaMiddle, &fromViaLength, m_edgeOffset,
+                         true /* forward */);
+    }
+    if (fromViaMiddle == SPECIAL_NODEID)
+      return false;
+
+    packedPath.clear();
+    TBase::RetrievePackedPathFromHeap(forwardHeap, toViaHeap, toViaMiddle, packedPath);
+    // The via node starts the second half.
+    packedPath.pop_back();
+    vector<NodeID> fromViaPath;
+    TBase::RetrievePackedPathFromHeap(fromViaHeap, reverseHeap, fromViaMiddle, fromViaPath);
+    packedPath.insert(packedPath.end(), fromViaPath.begin(), fromViaPath.end());
+    length = toViaLength + fromViaLength;
+    return true;
+  }
+
+  /// @return Length of the shortest path between nodes or INVALID_EDGE_WEIGHT.
+  int FindDistance(NodeID from, NodeID to)
+  {
+    if (from == to)
+      return 0;
+    m_engineData.InitializeOrClearThirdThreadLocalStorage(m_facade.GetNumberOfNodes());
+    TQueryHeap & forwardHeap = *m_engineData.forward_heap_3;
+    TQueryHeap & reverseHeap = *m_engineData.reverse_heap_3;
+    forwardHeap.Insert(from, 0, from);
+    reverseHeap.Insert(to, 0, to);
+    NodeID middle = SPECIAL_NODEID;
+    int distance = INVALID_EDGE_WEIGHT;
+    while (!forwardHeap.Empty() || !reverseHeap.Empty())
+    {
+      if (!forwardHeap.Empty())
+        TBase::RoutingStep(forwardHeap, reverseHeap, &middle, &distance, 0, true /* forward */);
+      if (!reverseHeap.Empty())
+        TBase::RoutingStep(reverseHeap, forwardHeap, &middle, &distance, 0, false /* forward */);
+    }
+    return distance;
+  }
+
+  /// Checks that the unpacked path has no cycles, has limited sharing with found routes and
+  /// is locally optimal around the via node (the T-test).
+  bool IsAdmissible(vector<PathData> const & path, NodeID via, int shortestLength)
+  {
+    // lengths[i] is the length of the path till path[i].
+    vector<int> lengths(path.size(), 0);
+    unordered_set<NodeID> pathNodes;
+    size_t viaIndex = path.size();
+    int sharing = 0;
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+      NodeID const node = path[i].node;
+      if (!pathNodes.insert(node).second)
+        return false;
+      if (node == via)
+        viaIndex = i;
+      if (i == 0)
+        continue;
+      lengths[i] = lengths[i - 1] + path[i].segment_duration;
+      if (m_routesEdges.count(MakeEdgeKey(path[i - 1].node, node)) != 0)
+        sharing += path[i].segment_duration;
+    }
+    if (viaIndex == path.size() || sharing > shortestLength * m_params.m_maxSharing)
+      return false;
+
+    double const localLength = shortestLength * m_params.m_localOptimality;
+    size_t begin = viaIndex;
+    while (begin > 0 && lengths[viaIndex] - lengths[begin] < localLength)
+      --begin;
+    size_t end = viaIndex;
+    while (end + 1 < path.size() && lengths[end] - lengths[viaIndex] < localLength)
+      ++end;
+    return FindDistance(path[begin].node, path[end].node) >= lengths[end] - lengths[begin];
+  }
+
+  void AddRoute(FeatureGraphNode const & source, FeatureGraphNode const & target, int length,
+                vector<PathData> const & path, vector<RawRoutingResult> & results)
+  {
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+      m_routesNodes.insert(path[i].node);
+      if (i > 0)
+        m_routesEdges.insert(MakeEdgeKey(path[i - 1].node, path[i].node));
+    }
+    results.emplace_back();
+    FillRoutingResult(source, target, length, path, results.back());
+  }
+
+  static uint64_t MakeEdgeKey(NodeID from, NodeID to)
+  {
+    return (static_cast<uint64_t>(from) << 32) | to;
+  }
+
+  TRawDataFacade & m_facade;
+  AlternativeRoutesParams const m_params;
+  SearchEngineData m_engineData;
+  int m_edgeOffset = 0;
+  unordered_set<NodeID> m_routesNodes;
+  unordered_set<uint64_t> m_routesEdges;
+};
+}  // namespace
+
 bool IsRouteExist(InternalRouteResult const & r)
 {
   return !(INVALID_EDGE_WEIGHT == r.shortest_path_length || r.segment_end_coordinates.empty() ||
@@ -90,6 +384,16 @@ bool FindSingleRoute(FeatureGraphNode const & source, FeatureGraphNode const & t
   return false;
 }
 
+bool FindAlternativeRoutes(FeatureGraphNode const & source, FeatureGraphNode const & target,
+                           TRawDataFacade & facade, AlternativeRoutesParams const & params,
+                           vector<RawRoutingResult> & results)
+{
+  my::HighResTimer timer(true);
+  bool const found = AlternativeRoutesFinder(facade, params).Find(source, target, results);
+  LOG(LINFO, ("Found", results.size(), "alternative routes in", timer.ElapsedNano(), "ns"));
+  return found;
+}
+
 FeatureGraphNode::FeatureGraphNode(NodeID const nodeId, bool const isStartNode,
                                    Index::MwmId const & id)
     : segmentPoint(m2::PointD::Zero()), mwmId(id)
@@ -98,4 +98,34 @@ void FindWeightsMatrix(TRoutingNodes const & sources, TRoutingNodes const & targ
 bool FindSingleRoute(FeatureGraphNode const & source, FeatureGraphNode const & target,
                      TRawDataFacade & facade, RawRoutingResult & rawRoutingResult);
 
+/// Parameters of alternative routes, lengths are relative to the length L of the shortest path.
+struct AlternativeRoutesParams
+{
+  /// Maximal number of routes including the shortest one.
+  size_t m_maxRoutesCount = 3;
+  /// Routes are not longer than (1 + m_maxStretch) * L.
+  double m_maxStretch = 0.25;
+  /// A route shares at most m_maxSharing * L with the routes found before it.
+  double m_maxSharing = 0.75;
+  /// Parts of a route of length m_localOptimality * L around its via node are shortest paths.
+  double m_localOptimality = 0.1;
+  /// Maximal number of via nodes to check.
+  size_t m_maxViaNodesCount = 64;
+};
+
+/*! Find the shortest path and its alternatives in a single MWM between 2 OSRM nodes by the
+   * via-node method. Via nodes are the nodes met by both the forward and the backward searches
+   * which go on until (1 + m_maxStretch) * L, the alternative through a via node is made of
+   * the paths to and from it found by the same search spaces.
+   * \param source Source OSRM graph node to make paths.
+   * \param target Target OSRM graph node to make paths.
+   * \param facade OSRM routing data facade to recover graph information.
+   * \param params Limits of alternative routes.
+   * \param results Routing results, the shortest path is the first one.
+   * \return true when a path exists, false otherwise.
+   */
+bool FindAlternativeRoutes(FeatureGraphNode const & source, FeatureGraphNode const & target,
+                           TRawDataFacade & facade, AlternativeRoutesParams const & params,
+                           vector<RawRoutingResult> & results);
+
 }  // namespace routing
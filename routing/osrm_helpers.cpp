@@ -44,7 +44,7 @@ void Point2PhantomNode::operator()(FeatureType const & ft)
 
   FindNearestSegment(ft, m_point, res);
 
-  if (res.m_fid != kInvalidFid && !m_routingMapping.m_segMapping.GetNodeIdByFid(res.m_fid).empty())
+  if (res.m_fid != kInvalidFid && m_routingMapping.m_segMapping.HasNodeIds(res.m_fid))
     m_candidates.push_back(res);
 }
 
@@ -284,8 +284,10 @@ void Point2Node::operator()(FeatureType const & ft)
   if (!CarModel::Instance().IsRoad(ft))
     return;
   uint32_t const featureId = ft.GetID().m_index;
-  for (auto const & n : m_routingMapping.m_segMapping.GetNodeIdByFid(featureId))
-    m_nodeIds.push_back(n);
+  m_routingMapping.m_segMapping.ForEachNodeIdByFid(featureId, [this](TOsrmNodeId nodeId)
+  {
+    m_nodeIds.push_back(nodeId);
+  });
 }
 }  // namespace helpers
 }  // namespace routing
@@ -48,6 +48,9 @@ public:
   // Functor, for getting features from a index foreach method.
   void operator()(FeatureType const & ft);
 
+  // Adds a candidate found without reading features, e.g. by a SegmentIndex.
+  void AddCandidate(Candidate const & candidate) { m_candidates.push_back(candidate); }
+
   /// Makes OSRM tasks result vector.
   void MakeResult(vector<FeatureGraphNode> & res, size_t maxCount);
 
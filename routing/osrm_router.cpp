@@ -3,6 +3,8 @@
 #include "osrm2feature_map.hpp"
 #include "osrm_helpers.hpp"
 #include "osrm_router.hpp"
+#include "segment_index.hpp"
+#include "speed_profiles.hpp"
 #include "turns_generator.hpp"
 
 #include "platform/country_file.hpp"
@@ -66,10 +68,16 @@ bool OsrmRouter::CheckRoutingAbility(m2::PointD const & startPoint, m2::PointD c
 }
 
 OsrmRouter::OsrmRouter(Index * index, TCountryFileFn const & countryFileFn)
-    : m_pIndex(index), m_indexManager(countryFileFn, *index)
+    : m_pIndex(index), m_indexManager(make_shared<RoutingIndexManager>(countryFileFn, *index))
 {
 }
 
+OsrmRouter::OsrmRouter(Index * index, shared_ptr<RoutingIndexManager> const & indexManager)
+    : m_pIndex(index), m_indexManager(indexManager)
+{
+  ASSERT(m_indexManager, ());
+}
+
 string OsrmRouter::GetName() const
 {
   return "vehicle";
@@ -79,7 +87,8 @@ void OsrmRouter::ClearState()
 {
   m_cachedTargets.clear();
   m_cachedTargetPoint = m2::PointD::Zero();
-  m_indexManager.Clear();
+  if (!m_indexManager->IsShared())
+    m_indexManager->Clear();
 }
 
 bool OsrmRouter::FindRouteFromCases(TFeatureGraphNodeVec const & source,
@@ -94,6 +103,19 @@ bool OsrmRouter::FindRouteFromCases(TFeatureGraphNodeVec const & source,
   return false;
 }
 
+bool OsrmRouter::FindAlternativeRoutesFromCases(TFeatureGraphNodeVec const & source,
+                                                TFeatureGraphNodeVec const & target,
+                                                TDataFacade & facade,
+                                                AlternativeRoutesParams const & params,
+                                                vector<RawRoutingResult> & results)
+{
+  for (auto const & targetEdge : target)
+    for (auto const & sourceEdge : source)
+      if (FindAlternativeRoutes(sourceEdge, targetEdge, facade, params, results))
+        return true;
+  return false;
+}
+
 void FindGraphNodeOffsets(uint32_t const nodeId, m2::PointD const & point,
                           Index const * pIndex, TRoutingMappingPtr & mapping,
                           FeatureGraphNode & graphNode)
@@ -165,7 +187,7 @@ OsrmRouter::ResultCode OsrmRouter::MakeRouteFromCrossesPath(TCheckedPath const &
   {
     ASSERT_EQUAL(cross.startNode.mwmId, cross.finalNode.mwmId, ());
     RawRoutingResult routingResult;
-    TRoutingMappingPtr mwmMapping = m_indexManager.GetMappingById(cross.startNode.mwmId);
+    TRoutingMappingPtr mwmMapping = m_indexManager->GetMappingById(cross.startNode.mwmId);
     ASSERT(mwmMapping->IsValid(), ());
     MappingGuard mwmMappingGuard(mwmMapping);
     UNUSED_VALUE(mwmMappingGuard);
@@ -221,11 +243,32 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
                                                   m2::PointD const & finalPoint,
                                                   RouterDelegate const & delegate, Route & route)
 {
+  vector<Route> alternatives;
+  return CalculateRouteWithAlternatives(startPoint, startDirection, finalPoint,
+                                        0 /* maxAlternativesCount */, delegate, route,
+                                        alternatives);
+}
+
+OsrmRouter::ResultCode OsrmRouter::CalculateRouteWithAlternatives(
+    m2::PointD const & startPoint, m2::PointD const & startDirection,
+    m2::PointD const & finalPoint, size_t maxAlternativesCount, RouterDelegate const & delegate,
+    Route & route, vector<Route> & alternatives)
+{
+  alternatives.clear();
   my::HighResTimer timer(true);
-  m_indexManager.Clear();  // TODO (Dragunov) make proper index manager cleaning
+  // Mappings of a shared manager are used by other routers.
+  if (!m_indexManager->IsShared())
+    m_indexManager->Clear();  // TODO (Dragunov) make proper index manager cleaning
+
+  uint32_t const departureTime = delegate.GetDepartureWeekTime();
+  SpeedProfilesBucketGuard bucketGuard(m_indexManager->GetSpeedProfilesBucketLock(),
+                                       departureTime == RouterDelegate::kNoDepartureTime
+                                           ? SpeedProfilesBucketLock::kAnyBucket
+                                           : SpeedProfiles::GetBucket(departureTime));
+  UNUSED_VALUE(bucketGuard);
 
-  TRoutingMappingPtr startMapping = m_indexManager.GetMappingByPoint(startPoint);
-  TRoutingMappingPtr targetMapping = m_indexManager.GetMappingByPoint(finalPoint);
+  TRoutingMappingPtr startMapping = m_indexManager->GetMappingByPoint(startPoint);
+  TRoutingMappingPtr targetMapping = m_indexManager->GetMappingByPoint(finalPoint);
 
   if (!startMapping->IsValid())
   {
@@ -290,14 +333,28 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
   if (startMapping->GetMwmId() == targetMapping->GetMwmId())
   {
     LOG(LINFO, ("Single mwm routing case"));
-    m_indexManager.ForEachMapping([](pair<string, TRoutingMappingPtr> const & indexPair)
-                                  {
-                                    indexPair.second->FreeCrossContext();
-                                  });
-    if (!FindRouteFromCases(startTask, m_cachedTargets, startMapping->m_dataFacade,
-                            routingResult))
+    FreeCrossContexts();
+    vector<RawRoutingResult> alternativeResults;
+    if (maxAlternativesCount == 0)
     {
-      return RouteNotFound;
+      if (!FindRouteFromCases(startTask, m_cachedTargets, startMapping->m_dataFacade,
+                              routingResult))
+      {
+        return RouteNotFound;
+      }
+    }
+    else
+    {
+      AlternativeRoutesParams params;
+      params.m_maxRoutesCount = maxAlternativesCount + 1;
+      // The search for alternatives finds the shortest route too, it's the first result.
+      if (!FindAlternativeRoutesFromCases(startTask, m_cachedTargets, startMapping->m_dataFacade,
+                                          params, alternativeResults))
+      {
+        return RouteNotFound;
+      }
+      routingResult = move(alternativeResults.front());
+      alternativeResults.erase(alternativeResults.begin());
     }
     INTERRUPT_WHEN_CANCELLED(delegate);
     delegate.OnProgress(kPathFoundProgress);
@@ -314,13 +371,28 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
     route.SetTurnInstructions(turnsDir);
     route.SetSectionTimes(times);
 
+    for (auto const & alternativeResult : alternativeResults)
+    {
+      turnsDir.clear();
+      times.clear();
+      points.clear();
+      MakeTurnAnnotation(alternativeResult, startMapping, delegate, points, turnsDir, times);
+      INTERRUPT_WHEN_CANCELLED(delegate);
+
+      alternatives.emplace_back(GetName());
+      Route & alternative = alternatives.back();
+      alternative.SetGeometry(points.begin(), points.end());
+      alternative.SetTurnInstructions(turnsDir);
+      alternative.SetSectionTimes(times);
+    }
+
     return NoError;
   }
   else //4.2 Multiple mwm case
   {
     LOG(LINFO, ("Multiple mwm routing case"));
     TCheckedPath finalPath;
-    ResultCode code = CalculateCrossMwmPath(startTask, m_cachedTargets, m_indexManager, delegate,
+    ResultCode code = CalculateCrossMwmPath(startTask, m_cachedTargets, *m_indexManager, delegate,
                                             finalPath);
     timer.Reset();
     INTERRUPT_WHEN_CANCELLED(delegate);
@@ -331,10 +403,7 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
     {
       auto code = MakeRouteFromCrossesPath(finalPath, delegate, route);
       // Manually free all cross context allocations before geometry unpacking.
-      m_indexManager.ForEachMapping([](pair<string, TRoutingMappingPtr> const & indexPair)
-                                    {
-                                      indexPair.second->FreeCrossContext();
-                                    });
+      FreeCrossContexts();
       LOG(LINFO, ("Make final route", timer.ElapsedNano()));
       timer.Reset();
       return code;
@@ -343,6 +412,17 @@ OsrmRouter::ResultCode OsrmRouter::CalculateRoute(m2::PointD const & startPoint,
   }
 }
 
+void OsrmRouter::FreeCrossContexts()
+{
+  // Cross contexts of a shared manager may be used by other routers at the moment.
+  if (m_indexManager->IsShared())
+    return;
+  m_indexManager->ForEachMapping([](pair<string, TRoutingMappingPtr> const & indexPair)
+                                 {
+                                   indexPair.second->FreeCrossContext();
+                                 });
+}
+
 IRouter::ResultCode OsrmRouter::FindPhantomNodes(m2::PointD const & point,
                                                  m2::PointD const & direction,
                                                  TFeatureGraphNodeVec & res, size_t maxCount,
@@ -352,9 +432,30 @@ IRouter::ResultCode OsrmRouter::FindPhantomNodes(m2::PointD const & point,
   helpers::Point2PhantomNode getter(*mapping, *m_pIndex, direction);
   getter.SetPoint(point);
 
-  m_pIndex->ForEachInRectForMWM(getter, MercatorBounds::RectByCenterXYAndSizeInMeters(
-                                            point, kFeatureFindingRectSideRadiusMeters),
-                                scales::GetUpperScale(), mapping->GetMwmId());
+  m2::RectD const rect =
+      MercatorBounds::RectByCenterXYAndSizeInMeters(point, kFeatureFindingRectSideRadiusMeters);
+  SegmentIndex const * segmentIndex =
+      m_indexManager->UseSegmentIndex() ? mapping->LoadSegmentIndex(*m_pIndex) : nullptr;
+  if (segmentIndex)
+  {
+    // The nearest segment of every feature within the circle inscribed in the rect.
+    vector<SegmentIndex::Result> nearest;
+    segmentIndex->FindNearest(point, maxCount, min(rect.SizeX(), rect.SizeY()) / 2,
+                              true /* distinctFeatures */, nearest);
+    for (SegmentIndex::Result const & r : nearest)
+    {
+      helpers::Point2PhantomNode::Candidate candidate;
+      candidate.m_dist = r.m_squareDist;
+      candidate.m_segIdx = r.m_segIdx;
+      candidate.m_fid = r.m_fid;
+      candidate.m_point = r.m_point;
+      getter.AddCandidate(candidate);
+    }
+  }
+  else
+  {
+    m_pIndex->ForEachInRectForMWM(getter, rect, scales::GetUpperScale(), mapping->GetMwmId());
+  }
 
   if (!getter.HasCandidates())
     return RouteNotFound;
@@ -391,24 +492,13 @@ OsrmRouter::ResultCode OsrmRouter::MakeTurnAnnotation(
     // Get all computed route coordinates.
     size_t const numSegments = pathSegments.size();
 
-    // Construct loaded segments.
+    // Construct loaded segments and make primary decisions about turns.
     vector<turns::LoadedPathSegment> loadedSegments;
-    loadedSegments.reserve(numSegments);
-    for (size_t segmentIndex = 0; segmentIndex < numSegments; ++segmentIndex)
-    {
-      bool isStartNode = (segmentIndex == 0);
-      bool isEndNode = (segmentIndex == numSegments - 1);
-      if (isStartNode || isEndNode)
-      {
-        loadedSegments.emplace_back(*mapping, *m_pIndex, pathSegments[segmentIndex],
-                                    routingResult.sourceEdge, routingResult.targetEdge, isStartNode,
-                                    isEndNode);
-      }
-      else
-      {
-        loadedSegments.emplace_back(*mapping, *m_pIndex, pathSegments[segmentIndex]);
-      }
-    }
+    vector<turns::TurnItem> loadedTurns;
+    turns::LoadPathSegmentsAndTurns(*m_pIndex, *mapping, pathSegments, routingResult.sourceEdge,
+                                    routingResult.targetEdge, GetPlatform().CpuCores(),
+                                    loadedSegments, loadedTurns);
+    INTERRUPT_WHEN_CANCELLED(delegate);
 
     // Annotate turns.
     size_t skipTurnSegments = 0;
@@ -423,14 +513,11 @@ OsrmRouter::ResultCode OsrmRouter::MakeTurnAnnotation(
       if (segmentIndex > 0 && !points.empty() && skipTurnSegments == 0)
       {
         turns::TurnItem turnItem;
-        turnItem.m_index = static_cast<uint32_t>(points.size() - 1);
-
         skipTurnSegments = CheckUTurnOnRoute(loadedSegments, segmentIndex, turnItem);
 
-        turns::TurnInfo turnInfo(loadedSegments[segmentIndex - 1], loadedSegments[segmentIndex]);
-
         if (turnItem.m_turn == turns::TurnDirection::NoTurn)
-          turns::GetTurnDirection(*m_pIndex, *mapping, turnInfo, turnItem);
+          turnItem = move(loadedTurns[segmentIndex]);
+        turnItem.m_index = static_cast<uint32_t>(points.size() - 1);
 
 #ifdef DEBUG
         double distMeters = 0.0;
@@ -446,7 +533,7 @@ OsrmRouter::ResultCode OsrmRouter::MakeTurnAnnotation(
         //  Lane information.
         if (turnItem.m_turn != turns::TurnDirection::NoTurn)
         {
-          turnItem.m_lanes = turnInfo.m_ingoing.m_lanes;
+          turnItem.m_lanes = loadedSegments[segmentIndex - 1].m_lanes;
           turnsDir.push_back(move(turnItem));
         }
       }
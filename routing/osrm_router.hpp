@@ -6,6 +6,8 @@
 #include "routing/router.hpp"
 #include "routing/routing_mapping.hpp"
 
+#include "std/shared_ptr.hpp"
+
 
 namespace feature { class TypesHolder; }
 
@@ -28,6 +30,9 @@ public:
   typedef vector<double> GeomTurnCandidateT;
 
   OsrmRouter(Index * index, TCountryFileFn const & countryFileFn);
+  /// Router using the routing indexes of the manager, a shared manager may be used by
+  /// routers of several threads at once.
+  OsrmRouter(Index * index, shared_ptr<RoutingIndexManager> const & indexManager);
 
   virtual string GetName() const override;
 
@@ -35,6 +40,15 @@ public:
                             m2::PointD const & finalPoint, RouterDelegate const & delegate,
                             Route & route) override;
 
+  /// Alternatives are found by FindAlternativeRoutes in the single mwm case only, a cross mwm
+  /// route has no alternatives.
+  ResultCode CalculateRouteWithAlternatives(m2::PointD const & startPoint,
+                                            m2::PointD const & startDirection,
+                                            m2::PointD const & finalPoint,
+                                            size_t maxAlternativesCount,
+                                            RouterDelegate const & delegate, Route & route,
+                                            vector<Route> & alternatives) override;
+
   virtual void ClearState() override;
 
   /*! Find single shortest path in a single MWM between 2 sets of edges
@@ -48,6 +62,15 @@ public:
                                  TFeatureGraphNodeVec const & target, TDataFacade & facade,
                                  RawRoutingResult & rawRoutingResult);
 
+  /// Finds the shortest route and its alternatives by FindAlternativeRoutes between the first
+  /// pair of source and target edges which are connected, as FindRouteFromCases does.
+  /// \return true when a path exists, false otherwise.
+  static bool FindAlternativeRoutesFromCases(TFeatureGraphNodeVec const & source,
+                                             TFeatureGraphNodeVec const & target,
+                                             TDataFacade & facade,
+                                             AlternativeRoutesParams const & params,
+                                             vector<RawRoutingResult> & results);
+
   /*! Fast checking ability of route construction
    *  @param startPoint starting road point
    *  @param finalPoint final road point
@@ -100,11 +123,14 @@ private:
   ResultCode MakeRouteFromCrossesPath(TCheckedPath const & path, RouterDelegate const & delegate,
                                       Route & route);
 
+  /// Frees cross contexts of all mappings unless the index manager is shared.
+  void FreeCrossContexts();
+
   Index const * m_pIndex;
 
   TFeatureGraphNodeVec m_cachedTargets;
   m2::PointD m_cachedTargetPoint;
 
-  RoutingIndexManager m_indexManager;
+  shared_ptr<RoutingIndexManager> m_indexManager;
 };
 }  // namespace routing
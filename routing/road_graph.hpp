@@ -6,8 +6,10 @@
 
 #include "indexer/feature_data.hpp"
 
+#include "std/function.hpp"
 #include "std/initializer_list.hpp"
 #include "std/map.hpp"
+#include "std/unique_ptr.hpp"
 #include "std/vector.hpp"
 
 namespace routing
@@ -172,4 +174,7 @@ private:
   map<Junction, TEdgeVector> m_outgoingEdges;
 };
 
+/// Makes a road graph, e.g. for a worker thread when graphs are not thread-safe.
+using TRoadGraphFactory = function<unique_ptr<IRoadGraph>()>;
+
 }  // namespace routing
@@ -207,6 +207,71 @@ void Route::GetCurrentDirectionPoint(m2::PointD & pt) const
     m_poly.GetCurrentDirectionPoint(pt, kOnEndToleranceM);
 }
 
+bool Route::GetPointAhead(double distanceMeters, size_t & segIdx, m2::PointD & point) const
+{
+  if (!m_poly.IsValid())
+    return false;
+
+  auto const & points = m_poly.GetPolyline().GetPoints();
+  auto const current = m_poly.GetCurrentIter();
+  m2::PointD segBegin = current.m_pt;
+  for (size_t i = current.m_ind; i + 1 < points.size(); ++i)
+  {
+    double const segLengthMeters = MercatorBounds::DistanceOnEarth(segBegin, points[i + 1]);
+    if (distanceMeters < segLengthMeters)
+    {
+      segIdx = i;
+      point = segBegin + (points[i + 1] - segBegin) * (distanceMeters / segLengthMeters);
+      return true;
+    }
+    distanceMeters -= segLengthMeters;
+    segBegin = points[i + 1];
+  }
+  return false;
+}
+
+void Route::AppendTail(Route const & route, size_t segIdx)
+{
+  auto const & tailPoints = route.m_poly.GetPolyline().GetPoints();
+  ASSERT_LESS(segIdx + 1, tailPoints.size(), ());
+
+  vector<m2::PointD> points = m_poly.GetPolyline().GetPoints();
+  ASSERT(!points.empty(), ());
+  double const jointTimeSec = route.GetTimeToPointSec(segIdx, points.back());
+  double const timeSec = m_times.empty() ? 0.0 : m_times.back().second;
+
+  // The point segIdx + 1 of route follows the last point of this route.
+  size_t const shift = points.size();
+  auto const shiftIndex = [shift, segIdx](uint32_t index)
+  {
+    return static_cast<uint32_t>(index + shift - segIdx - 1);
+  };
+
+  points.insert(points.end(), tailPoints.begin() + segIdx + 1, tailPoints.end());
+
+  if (!m_turns.empty() && m_turns.back().m_turn == turns::TurnDirection::ReachedYourDestination)
+    m_turns.pop_back();
+  for (auto const & turn : route.m_turns)
+  {
+    if (turn.m_index <= segIdx)
+      continue;
+    m_turns.push_back(turn);
+    m_turns.back().m_index = shiftIndex(turn.m_index);
+  }
+
+  for (auto const & time : route.m_times)
+  {
+    if (time.first <= segIdx)
+      continue;
+    m_times.emplace_back(shiftIndex(time.first), time.second - jointTimeSec + timeSec);
+  }
+
+  m_absentCountries.insert(route.m_absentCountries.begin(), route.m_absentCountries.end());
+
+  FollowedPolyline(points.begin(), points.end()).Swap(m_poly);
+  Update();
+}
+
 bool Route::MoveIterator(location::GpsInfo const & info) const
 {
   double predictDistance = -1.0;
@@ -249,6 +314,32 @@ double Route::GetPolySegAngle(size_t ind) const
   return (i == polySz) ? 0 : my::RadToDeg(ang::AngleTo(p1, p2));
 }
 
+double Route::GetTimeToPointSec(size_t segIdx, m2::PointD const & point) const
+{
+  if (m_times.empty())
+    return 0.0;
+
+  auto const it = upper_bound(m_times.begin(), m_times.end(), segIdx,
+                              [](size_t v, Route::TTimeItem const & item)
+                              {
+                                return v < item.first;
+                              });
+  if (it == m_times.end())
+    return m_times.back().second;
+
+  size_t const sectionBegin = (it == m_times.begin() ? 0 : (it - 1)->first);
+  double const sectionBeginTimeSec = (it == m_times.begin() ? 0.0 : (it - 1)->second);
+  auto const sectionBeginIter = m_poly.GetIterToIndex(sectionBegin);
+  double const sectionMeters =
+      m_poly.GetDistanceM(sectionBeginIter, m_poly.GetIterToIndex(it->first));
+  if (my::AlmostEqualULPs(sectionMeters, 0.))
+    return sectionBeginTimeSec;
+
+  double const passedMeters =
+      m_poly.GetDistanceM(sectionBeginIter, FollowedPolyline::Iter(point, segIdx));
+  return sectionBeginTimeSec + (it->second - sectionBeginTimeSec) * (passedMeters / sectionMeters);
+}
+
 void Route::MatchLocationToRoute(location::GpsInfo & location, location::RouteMatchingInfo & routeMatchingInfo) const
 {
   if (m_poly.IsValid())
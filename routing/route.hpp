@@ -91,6 +91,18 @@ public:
 
   void GetCurrentDirectionPoint(m2::PointD & pt) const;
 
+  /// \brief GetPointAhead finds the point of the route in distanceMeters from the current
+  /// position along the route.
+  /// \param segIdx is the index of the polyline segment which contains the point.
+  /// @return false if the rest of the route is shorter than distanceMeters.
+  bool GetPointAhead(double distanceMeters, size_t & segIdx, m2::PointD & point) const;
+
+  /// \brief AppendTail appends the part of route after the end of this route to this route.
+  /// The end of this route should lie on the segment segIdx of route. The destination turn
+  /// of this route is replaced by turns of route, times of route are shifted so that
+  /// they continue times of this route.
+  void AppendTail(Route const & route, size_t segIdx);
+
   /// @return true  If position was updated successfully (projection within gps error radius).
   bool MoveIterator(location::GpsInfo const & info) const;
 
@@ -114,6 +126,8 @@ private:
   /// Call this fucnction when geometry have changed.
   void Update();
   double GetPolySegAngle(size_t ind) const;
+  /// @return Time from the beginning of the route to the point on the segment segIdx.
+  double GetTimeToPointSec(size_t segIdx, m2::PointD const & point) const;
   TTurns::const_iterator GetCurrentTurn() const;
 
 private:
@@ -1,5 +1,7 @@
 #include "router.hpp"
 
+#include "route.hpp"
+
 namespace routing
 {
 
@@ -14,4 +16,13 @@ string ToString(RouterType type)
   return "Error";
 }
 
+IRouter::ResultCode IRouter::CalculateRouteWithAlternatives(
+    m2::PointD const & startPoint, m2::PointD const & startDirection,
+    m2::PointD const & finalPoint, size_t /* maxAlternativesCount */,
+    RouterDelegate const & delegate, Route & route, vector<Route> & alternatives)
+{
+  alternatives.clear();
+  return CalculateRoute(startPoint, startDirection, finalPoint, delegate, route);
+}
+
 } //  namespace routing
@@ -8,6 +8,7 @@
 
 #include "std/function.hpp"
 #include "std/string.hpp"
+#include "std/vector.hpp"
 
 namespace routing
 {
@@ -70,6 +71,17 @@ public:
                                     m2::PointD const & startDirection,
                                     m2::PointD const & finalPoint, RouterDelegate const & delegate,
                                     Route & route) = 0;
+
+  /// Calculates the route as CalculateRoute does and up to maxAlternativesCount alternative
+  /// routes. Routers which can't find alternatives calculate the route only.
+  /// @param alternatives result alternative routes, they may be fewer than requested or absent
+  /// @return ResultCode error code or NoError if route was initialised
+  virtual ResultCode CalculateRouteWithAlternatives(m2::PointD const & startPoint,
+                                                    m2::PointD const & startDirection,
+                                                    m2::PointD const & finalPoint,
+                                                    size_t maxAlternativesCount,
+                                                    RouterDelegate const & delegate, Route & route,
+                                                    vector<Route> & alternatives);
 };
 
 }  // namespace routing
@@ -8,6 +8,9 @@ void DefaultProgressFn(float /* progress */) {}
 void DefaultPointFn(m2::PointD const & /* point */) {}
 } //  namespace
 
+// static
+uint32_t constexpr RouterDelegate::kNoDepartureTime;
+
 RouterDelegate::RouterDelegate()
 {
   m_progressCallback = DefaultProgressFn;
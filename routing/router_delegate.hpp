@@ -5,7 +5,9 @@
 #include "base/cancellable.hpp"
 #include "base/timer.hpp"
 
+#include "std/cstdint.hpp"
 #include "std/function.hpp"
+#include "std/limits.hpp"
 #include "std/mutex.hpp"
 
 namespace routing
@@ -33,6 +35,8 @@ public:
   using TProgressCallback = function<void(float)>;
   using TPointCheckCallback = function<void(m2::PointD const &)>;
 
+  static uint32_t constexpr kNoDepartureTime = numeric_limits<uint32_t>::max();
+
   RouterDelegate();
 
   /// Set routing progress. Waits current progress status from 0 to 100.
@@ -42,12 +46,19 @@ public:
   void SetProgressCallback(TProgressCallback const & progressCallback);
   void SetPointCheckCallback(TPointCheckCallback const & pointCallback);
 
+  /// Sets the departure time in seconds since Monday 00:00 of the local time. Routers which
+  /// support speed profiles calculate routes for this time, see SpeedProfiles.
+  void SetDepartureWeekTime(uint32_t weekTimeSec) { m_departureWeekTimeSec = weekTimeSec; }
+  /// @return kNoDepartureTime if the time isn't set.
+  uint32_t GetDepartureWeekTime() const { return m_departureWeekTimeSec; }
+
   void Reset() override;
 
 private:
   mutable mutex m_guard;
   TProgressCallback m_progressCallback;
   TPointCheckCallback m_pointCallback;
+  uint32_t m_departureWeekTimeSec = kNoDepartureTime;
 };
 
 }  //  nomespace routing
@@ -20,6 +20,8 @@ SOURCES += \
     cross_mwm_router.cpp \
     cross_routing_context.cpp \
     features_road_graph.cpp \
+    isochrone.cpp \
+    map_matcher.cpp \
     nearest_edge_finder.cpp \
     online_absent_fetcher.cpp \
     online_cross_fetcher.cpp \
@@ -36,8 +38,11 @@ SOURCES += \
     router_delegate.cpp \
     routing_algorithm.cpp \
     routing_mapping.cpp \
+    routing_service.cpp \
     routing_session.cpp \
+    segment_index.cpp \
     speed_camera.cpp \
+    speed_profiles.cpp \
     turns.cpp \
     turns_generator.cpp \
     turns_notification_manager.cpp \
@@ -55,6 +60,8 @@ HEADERS += \
     cross_routing_context.hpp \
     directions_engine.hpp \
     features_road_graph.hpp \
+    isochrone.hpp \
+    map_matcher.hpp \
     nearest_edge_finder.hpp \
     online_absent_fetcher.hpp \
     online_cross_fetcher.hpp \
@@ -72,9 +79,12 @@ HEADERS += \
     router_delegate.hpp \
     routing_algorithm.hpp \
     routing_mapping.hpp \
+    routing_service.hpp \
     routing_session.hpp \
     routing_settings.hpp \
+    segment_index.hpp \
     speed_camera.hpp \
+    speed_profiles.hpp \
     turns.hpp \
     turns_generator.hpp \
     turns_notification_manager.hpp \
@@ -22,91 +22,64 @@ inline double TimeBetweenSec(Junction const & j1, Junction const & j2, double sp
   return MercatorBounds::DistanceOnEarth(j1.GetPoint(), j2.GetPoint()) / speedMPS;
 }
 
-/// A class which represents an weighted edge used by RoadGraph.
-class WeightedEdge
-{
-public:
-  WeightedEdge(Junction const & target, double weight) : target(target), weight(weight) {}
-
-  inline Junction const & GetTarget() const { return target; }
-
-  inline double GetWeight() const { return weight; }
-
-private:
-  Junction const target;
-  double const weight;
-};
+typedef AStarAlgorithm<RoadGraph> TAlgorithmImpl;
 
-/// A wrapper around IRoadGraph, which makes it possible to use IRoadGraph with astar algorithms.
-class RoadGraph
+IRoutingAlgorithm::Result Convert(TAlgorithmImpl::Result value)
 {
-public:
-  using TVertexType = Junction;
-  using TEdgeType = WeightedEdge;
-
-  RoadGraph(IRoadGraph const & roadGraph)
-    : m_roadGraph(roadGraph)
-    , m_maxSpeedMPS(roadGraph.GetMaxSpeedKMPH() * KMPH2MPS)
-  {}
-
-  void GetOutgoingEdgesList(Junction const & v, vector<WeightedEdge> & adj) const
+  switch (value)
   {
-    IRoadGraph::TEdgeVector edges;
-    m_roadGraph.GetOutgoingEdges(v, edges);
+  case TAlgorithmImpl::Result::OK: return IRoutingAlgorithm::Result::OK;
+  case TAlgorithmImpl::Result::NoPath: return IRoutingAlgorithm::Result::NoPath;
+  case TAlgorithmImpl::Result::Cancelled: return IRoutingAlgorithm::Result::Cancelled;
+  }
+  ASSERT(false, ("Unexpected TAlgorithmImpl::Result value:", value));
+  return IRoutingAlgorithm::Result::NoPath;
+}
+}  // namespace
 
-    adj.clear();
-    adj.reserve(edges.size());
+RoadGraph::RoadGraph(IRoadGraph const & roadGraph)
+  : m_roadGraph(roadGraph), m_maxSpeedMPS(roadGraph.GetMaxSpeedKMPH() * KMPH2MPS)
+{
+}
 
-    for (auto const & e : edges)
-    {
-      ASSERT_EQUAL(v, e.GetStartJunction(), ());
+void RoadGraph::GetOutgoingEdgesList(Junction const & v, vector<WeightedEdge> & adj) const
+{
+  IRoadGraph::TEdgeVector edges;
+  m_roadGraph.GetOutgoingEdges(v, edges);
 
-      double const speedMPS = m_roadGraph.GetSpeedKMPH(e) * KMPH2MPS;
-      adj.emplace_back(e.GetEndJunction(), TimeBetweenSec(e.GetStartJunction(), e.GetEndJunction(), speedMPS));
-    }
-  }
+  adj.clear();
+  adj.reserve(edges.size());
 
-  void GetIngoingEdgesList(Junction const & v, vector<WeightedEdge> & adj) const
+  for (auto const & e : edges)
   {
-    IRoadGraph::TEdgeVector edges;
-    m_roadGraph.GetIngoingEdges(v, edges);
+    ASSERT_EQUAL(v, e.GetStartJunction(), ());
 
-    adj.clear();
-    adj.reserve(edges.size());
+    double const speedMPS = m_roadGraph.GetSpeedKMPH(e) * KMPH2MPS;
+    adj.emplace_back(e.GetEndJunction(), TimeBetweenSec(e.GetStartJunction(), e.GetEndJunction(), speedMPS));
+  }
+}
 
-    for (auto const & e : edges)
-    {
-      ASSERT_EQUAL(v, e.GetEndJunction(), ());
+void RoadGraph::GetIngoingEdgesList(Junction const & v, vector<WeightedEdge> & adj) const
+{
+  IRoadGraph::TEdgeVector edges;
+  m_roadGraph.GetIngoingEdges(v, edges);
 
-      double const speedMPS = m_roadGraph.GetSpeedKMPH(e) * KMPH2MPS;
-      adj.emplace_back(e.GetStartJunction(), TimeBetweenSec(e.GetStartJunction(), e.GetEndJunction(), speedMPS));
-    }
-  }
+  adj.clear();
+  adj.reserve(edges.size());
 
-  double HeuristicCostEstimate(Junction const & v, Junction const & w) const
+  for (auto const & e : edges)
   {
-    return TimeBetweenSec(v, w, m_maxSpeedMPS);
-  }
-
-private:
-  IRoadGraph const & m_roadGraph;
-  double const m_maxSpeedMPS;
-};
+    ASSERT_EQUAL(v, e.GetEndJunction(), ());
 
-typedef AStarAlgorithm<RoadGraph> TAlgorithmImpl;
+    double const speedMPS = m_roadGraph.GetSpeedKMPH(e) * KMPH2MPS;
+    adj.emplace_back(e.GetStartJunction(), TimeBetweenSec(e.GetStartJunction(), e.GetEndJunction(), speedMPS));
+  }
+}
 
-IRoutingAlgorithm::Result Convert(TAlgorithmImpl::Result value)
+double RoadGraph::HeuristicCostEstimate(Junction const & v, Junction const & w) const
 {
-  switch (value)
-  {
-  case TAlgorithmImpl::Result::OK: return IRoutingAlgorithm::Result::OK;
-  case TAlgorithmImpl::Result::NoPath: return IRoutingAlgorithm::Result::NoPath;
-  case TAlgorithmImpl::Result::Cancelled: return IRoutingAlgorithm::Result::Cancelled;
-  }
-  ASSERT(false, ("Unexpected TAlgorithmImpl::Result value:", value));
-  return IRoutingAlgorithm::Result::NoPath;
+  return TimeBetweenSec(v, w, m_maxSpeedMPS);
 }
-}  // namespace
 
 string DebugPrint(IRoutingAlgorithm::Result const & value)
 {
@@ -12,6 +12,42 @@
 namespace routing
 {
 
+/// A class which represents an weighted edge used by RoadGraph.
+class WeightedEdge
+{
+public:
+  WeightedEdge(Junction const & target, double weight) : target(target), weight(weight) {}
+
+  inline Junction const & GetTarget() const { return target; }
+
+  inline double GetWeight() const { return weight; }
+
+private:
+  Junction const target;
+  double const weight;
+};
+
+/// A wrapper around IRoadGraph, which makes it possible to use IRoadGraph with astar algorithms.
+/// Weights of edges are travel times in seconds.
+class RoadGraph
+{
+public:
+  using TVertexType = Junction;
+  using TEdgeType = WeightedEdge;
+
+  RoadGraph(IRoadGraph const & roadGraph);
+
+  void GetOutgoingEdgesList(Junction const & v, vector<WeightedEdge> & adj) const;
+
+  void GetIngoingEdgesList(Junction const & v, vector<WeightedEdge> & adj) const;
+
+  double HeuristicCostEstimate(Junction const & v, Junction const & w) const;
+
+private:
+  IRoadGraph const & m_roadGraph;
+  double const m_maxSpeedMPS;
+};
+
 // IRoutingAlgorithm is an abstract interface of a routing algorithm,
 // which searches the optimal way between two junctions on the graph
 class IRoutingAlgorithm
@@ -0,0 +1,140 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_mapping.hpp"
+
+#include "platform/local_country_file.hpp"
+#include "platform/local_country_file_utils.hpp"
+
+#include "coding/file_container.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include "std/functional.hpp"
+#include "std/limits.hpp"
+#include "std/queue.hpp"
+#include "std/random.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+
+namespace
+{
+size_t constexpr kHotEdgeCacheBytes = 16 * 1024 * 1024;
+size_t constexpr kMaxSettledNodes = 5000;
+
+// Runs forward searches of the contraction hierarchy limited by settled nodes.
+// @return Number of relaxed edges.
+uint64_t RunSearches(TDataFacade const & facade, vector<NodeID> const & sources,
+                     uint64_t & checksum)
+{
+  using TQueueItem = pair<EdgeWeight, NodeID>;
+  vector<EdgeWeight> weights(facade.GetNumberOfNodes(), INVALID_EDGE_WEIGHT);
+  vector<NodeID> reached;
+  uint64_t relaxations = 0;
+  for (NodeID source : sources)
+  {
+    for (NodeID node : reached)
+      weights[node] = INVALID_EDGE_WEIGHT;
+    reached.assign(1, source);
+    weights[source] = 0;
+
+    priority_queue<TQueueItem, vector<TQueueItem>, greater<TQueueItem>> queue;
+    queue.emplace(0, source);
+    size_t settled = 0;
+    while (!queue.empty() && settled < kMaxSettledNodes)
+    {
+      TQueueItem const top = queue.top();
+      queue.pop();
+      if (top.first > weights[top.second])
+        continue;
+      ++settled;
+
+      for (EdgeID e : facade.GetAdjacentEdgeRange(top.second))
+      {
+        auto const data = facade.GetEdgeData(e, top.second);
+        if (!data.forward)
+          continue;
+        ++relaxations;
+        NodeID const target = facade.GetTarget(e);
+        EdgeWeight const weight = top.first + data.distance;
+        if (weight < weights[target])
+        {
+          if (weights[target] == INVALID_EDGE_WEIGHT)
+            reached.push_back(target);
+          weights[target] = weight;
+          queue.emplace(weight, target);
+        }
+      }
+    }
+    checksum += settled + reached.size();
+  }
+  return relaxations;
+}
+
+vector<NodeID> GetRandomNodes(uint32_t nodesCount, size_t count, uint32_t seed)
+{
+  mt19937 rng(seed);
+  uniform_int_distribution<NodeID> dist(0, nodesCount - 1);
+  vector<NodeID> nodes(count);
+  for (auto & node : nodes)
+    node = dist(rng);
+  return nodes;
+}
+
+double MeasureRelaxationsPerSec(TDataFacade const & facade, vector<NodeID> const & sources,
+                                uint64_t & checksum)
+{
+  my::Timer timer;
+  uint64_t const relaxations = RunSearches(facade, sources, checksum);
+  return relaxations / max(timer.ElapsedSeconds(), 1e-9);
+}
+}  // namespace
+
+// Relaxations per second of the facade without the hot edge cache, with the cache of nodes
+// with many edges and with the cache of nodes touched by other searches.
+UNIT_TEST(HotEdgeCache_RelaxationsPerSecond)
+{
+  vector<platform::LocalCountryFile> localFiles;
+  platform::FindAllLocalMapsAndCleanup(numeric_limits<int64_t>::max() /* latestVersion */,
+                                       localFiles);
+
+  for (auto & file : localFiles)
+  {
+    file.SyncWithDisk();
+    if (file.GetFiles() != MapOptions::MapWithCarRouting)
+      continue;
+
+    FilesMappingContainer container(file.GetPath(MapOptions::CarRouting));
+    TDataFacade facade;
+    facade.Load(container);
+    uint32_t const nodesCount = facade.GetNumberOfNodes();
+    if (nodesCount == 0)
+      continue;
+    vector<NodeID> const sources = GetRandomNodes(nodesCount, 200, 0 /* seed */);
+
+    uint64_t expected = 0;
+    RunSearches(facade, sources, expected);  // Warms up the page cache.
+    expected = 0;
+    double const plain = MeasureRelaxationsPerSec(facade, sources, expected);
+
+    facade.BuildHotEdgeCache(kHotEdgeCacheBytes);
+    uint64_t checksum = 0;
+    double const byEdges = MeasureRelaxationsPerSec(facade, sources, checksum);
+    TEST_EQUAL(checksum, expected, (file.GetCountryName()));
+
+    facade.StartTouchesCounting();
+    uint64_t unused = 0;
+    RunSearches(facade, GetRandomNodes(nodesCount, 200, 1 /* seed */), unused);
+    facade.BuildHotEdgeCache(kHotEdgeCacheBytes);
+    checksum = 0;
+    double const byTouches = MeasureRelaxationsPerSec(facade, sources, checksum);
+    TEST_EQUAL(checksum, expected, (file.GetCountryName()));
+
+    LOG(LINFO, (file.GetCountryName(), "nodes:", nodesCount, "cache bytes:",
+                facade.GetHotEdgeCacheBytes(), "relaxations per second without cache:", plain,
+                "by edges:", byEdges, "by touches:", byTouches));
+    facade.Clear();
+  }
+}
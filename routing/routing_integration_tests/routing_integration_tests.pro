@@ -24,11 +24,13 @@ QT *= core
 SOURCES += \
   ../../testing/testingmain.cpp \
   cross_section_tests.cpp \
+  hot_edge_cache_test.cpp \
   online_cross_tests.cpp \
   osrm_route_test.cpp \
   osrm_turn_test.cpp \
   pedestrian_route_test.cpp \
   routing_test_tools.cpp \
+  turns_generator_test.cpp \
 
 HEADERS += \
   routing_test_tools.hpp \
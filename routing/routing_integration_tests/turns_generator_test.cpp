@@ -0,0 +1,115 @@
+#include "testing/testing.hpp"
+
+#include "routing/osrm_engine.hpp"
+#include "routing/routing_mapping.hpp"
+#include "routing/turns_generator.hpp"
+
+#include "indexer/index.hpp"
+
+#include "platform/local_country_file.hpp"
+#include "platform/local_country_file_utils.hpp"
+
+#include "base/logging.hpp"
+#include "base/macros.hpp"
+
+#include "std/limits.hpp"
+#include "std/random.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+using namespace routing::turns;
+
+namespace
+{
+// Paths are loaded by ranges of 64 segments, so a path covers several ranges.
+size_t constexpr kMinPathSegmentsCount = 300;
+size_t constexpr kMaxAttemptsCount = 100;
+size_t constexpr kMaxCheckedMapsCount = 3;
+
+// Finds a route between random nodes of the mapping with at least kMinPathSegmentsCount segments.
+bool FindLongRoute(RoutingMapping & mapping, RawRoutingResult & result)
+{
+  uint32_t const nodesCount = mapping.m_dataFacade.GetNumberOfNodes();
+  if (nodesCount == 0)
+    return false;
+
+  mt19937 rng(0);
+  uniform_int_distribution<NodeID> dist(0, nodesCount - 1);
+  for (size_t i = 0; i < kMaxAttemptsCount; ++i)
+  {
+    FeatureGraphNode const source(dist(rng), true /* isStartNode */, mapping.GetMwmId());
+    FeatureGraphNode const target(dist(rng), false /* isStartNode */, mapping.GetMwmId());
+    if (FindSingleRoute(source, target, mapping.m_dataFacade, result) &&
+        result.unpackedPathSegments.size() == 1 &&
+        result.unpackedPathSegments.front().size() >= kMinPathSegmentsCount)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TestSegmentsEqual(LoadedPathSegment const & lhs, LoadedPathSegment const & rhs, size_t i)
+{
+  TEST_EQUAL(lhs.m_path, rhs.m_path, (i));
+  TEST(lhs.m_highwayClass == rhs.m_highwayClass, (i));
+  TEST_EQUAL(lhs.m_onRoundabout, rhs.m_onRoundabout, (i));
+  TEST_EQUAL(lhs.m_isLink, rhs.m_isLink, (i));
+  TEST_EQUAL(lhs.m_weight, rhs.m_weight, (i));
+  TEST_EQUAL(lhs.m_name, rhs.m_name, (i));
+  TEST_EQUAL(lhs.m_nodeId, rhs.m_nodeId, (i));
+  TEST_EQUAL(lhs.m_lanes, rhs.m_lanes, (i));
+}
+}  // namespace
+
+// Segments and turns loaded on several threads are the same as loaded on one thread.
+UNIT_TEST(LoadPathSegmentsAndTurns_ParallelLoadingIsEqualToSerial)
+{
+  vector<platform::LocalCountryFile> localFiles;
+  platform::FindAllLocalMapsAndCleanup(numeric_limits<int64_t>::max() /* latestVersion */,
+                                       localFiles);
+
+  size_t checkedCount = 0;
+  for (auto & file : localFiles)
+  {
+    if (checkedCount == kMaxCheckedMapsCount)
+      break;
+    file.SyncWithDisk();
+    if (file.GetFiles() != MapOptions::MapWithCarRouting)
+      continue;
+
+    Index index;
+    if (!index.RegisterMap(file).first.IsAlive())
+      continue;
+
+    auto mapping = make_shared<RoutingMapping>(file.GetCountryName(), index);
+    if (!mapping->IsValid())
+      continue;
+    MappingGuard guard(mapping);
+    UNUSED_VALUE(guard);
+
+    RawRoutingResult result;
+    if (!FindLongRoute(*mapping, result))
+      continue;
+    vector<RawPathData> const & path = result.unpackedPathSegments.front();
+
+    vector<LoadedPathSegment> serialSegments, parallelSegments;
+    vector<TurnItem> serialTurns, parallelTurns;
+    LoadPathSegmentsAndTurns(index, *mapping, path, result.sourceEdge, result.targetEdge,
+                             1 /* maxThreadsCount */, serialSegments, serialTurns);
+    LoadPathSegmentsAndTurns(index, *mapping, path, result.sourceEdge, result.targetEdge,
+                             4 /* maxThreadsCount */, parallelSegments, parallelTurns);
+
+    TEST_EQUAL(serialSegments.size(), path.size(), (file.GetCountryName()));
+    TEST_EQUAL(parallelSegments.size(), path.size(), (file.GetCountryName()));
+    for (size_t i = 0; i < path.size(); ++i)
+      TestSegmentsEqual(serialSegments[i], parallelSegments[i], i);
+    TEST_EQUAL(serialTurns, parallelTurns, (file.GetCountryName()));
+
+    LOG(LINFO, (file.GetCountryName(), "path segments:", path.size()));
+    ++checkedCount;
+  }
+  TEST_GREATER(checkedCount, 0, ("No routing file has a route of", kMinPathSegmentsCount,
+                                 "segments."));
+}
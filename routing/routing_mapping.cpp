@@ -1,8 +1,13 @@
 #include "routing_mapping.hpp"
 
+#include "routing/car_model.hpp"
 #include "routing/cross_routing_context.hpp"
 #include "routing/osrm2feature_map.hpp"
 #include "routing/osrm_data_facade.hpp"
+#include "routing/segment_index.hpp"
+#include "routing/speed_profiles.hpp"
+
+#include "indexer/scales.hpp"
 
 #include "platform/country_file.hpp"
 #include "platform/local_country_file.hpp"
@@ -12,6 +17,7 @@
 #include "coding/reader_wrapper.hpp"
 
 #include "base/logging.hpp"
+#include "base/timer.hpp"
 
 
 using platform::CountryFile;
@@ -42,11 +48,22 @@ bool CheckMwmConsistency(LocalCountryFile const & localFile)
 
   return version1.timestamp == version2.timestamp;
 }
+
+/// \return true if features of the map are indexed by their numbers rather than by offsets,
+/// which routing sections rely on.
+bool HasFeatureIndexes(LocalCountryFile const & localFile)
+{
+  version::MwmVersion version;
+  return version::ReadVersion(FilesContainerR(localFile.GetPath(MapOptions::Map)), version) &&
+         version.format >= version::v5;
+}
 } //  namespace
 
 namespace routing
 {
 
+RoutingMapping::RoutingMapping() : m_pIndex(nullptr) {}
+
 RoutingMapping::RoutingMapping(string const & countryFile, MwmSet & index)
     : m_mapCounter(0),
       m_facadeCounter(0),
@@ -76,6 +93,15 @@ RoutingMapping::RoutingMapping(string const & countryFile, MwmSet & index)
     return;
   }
 
+  if (!HasFeatureIndexes(localFile))
+  {
+    LOG(LWARNING, ("Routing isn't supported for the old map format", localFile));
+    m_error = IRouter::ResultCode::FileTooOld;
+    m_container.Close();
+    m_handle = MwmSet::MwmHandle();
+    return;
+  }
+
   m_mwmId = m_handle.GetId();
   m_error = IRouter::ResultCode::NoError;
 }
@@ -91,6 +117,12 @@ void RoutingMapping::LoadFileIfNeeded()
 }
 
 void RoutingMapping::FreeFileIfPossible()
+{
+  lock_guard<mutex> lock(m_mutex);
+  FreeFileIfPossibleImpl();
+}
+
+void RoutingMapping::FreeFileIfPossibleImpl()
 {
   if (m_mapCounter == 0 && m_facadeCounter == 0 && m_handle.IsAlive())
   {
@@ -109,6 +141,7 @@ RoutingMapping::~RoutingMapping()
 
 void RoutingMapping::Map()
 {
+  lock_guard<mutex> lock(m_mutex);
   LoadFileIfNeeded();
   if (!m_handle.IsAlive())
     return;
@@ -122,14 +155,16 @@ void RoutingMapping::Map()
 
 void RoutingMapping::Unmap()
 {
+  lock_guard<mutex> lock(m_mutex);
   --m_mapCounter;
   if (m_mapCounter < 1 && m_segMapping.IsMapped())
     m_segMapping.Unmap();
-  FreeFileIfPossible();
+  FreeFileIfPossibleImpl();
 }
 
 void RoutingMapping::LoadFacade()
 {
+  lock_guard<mutex> lock(m_mutex);
   if (!m_facadeCounter)
   {
     LoadFileIfNeeded();
@@ -142,16 +177,18 @@ void RoutingMapping::LoadFacade()
 
 void RoutingMapping::FreeFacade()
 {
+  lock_guard<mutex> lock(m_mutex);
   --m_facadeCounter;
   if (!m_facadeCounter)
   {
-    FreeFileIfPossible();
+    FreeFileIfPossibleImpl();
     m_dataFacade.Clear();
   }
 }
 
 void RoutingMapping::LoadCrossContext()
 {
+  lock_guard<mutex> lock(m_mutex);
   if (m_crossContextLoaded)
     return;
 
@@ -169,9 +206,66 @@ void RoutingMapping::LoadCrossContext()
 
 void RoutingMapping::FreeCrossContext()
 {
+  lock_guard<mutex> lock(m_mutex);
   m_crossContextLoaded = false;
   m_crossContext = CrossRoutingContextReader();
-  FreeFileIfPossible();
+  FreeFileIfPossibleImpl();
+}
+
+SegmentIndex const * RoutingMapping::LoadSegmentIndex(Index const & index)
+{
+  lock_guard<mutex> lock(m_mutex);
+  if (m_segmentIndex)
+    return m_segmentIndex.get();
+
+  if (!m_segMapping.IsMapped() || !m_mwmId.IsAlive())
+    return nullptr;
+
+  my::Timer timer;
+  vector<SegmentIndex::Segment> segments;
+  auto collector = [this, &segments](FeatureType const & ft)
+  {
+    if (!CarModel::Instance().IsRoad(ft))
+      return;
+    uint32_t const fid = ft.GetID().m_index;
+    if (!m_segMapping.HasNodeIds(fid))
+      return;
+
+    ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+    for (size_t i = 1; i < ft.GetPointsCount(); ++i)
+    {
+      segments.emplace_back(fid, static_cast<uint32_t>(i - 1), ft.GetPoint(i - 1),
+                            ft.GetPoint(i));
+    }
+  };
+  index.ForEachInRectForMWM(collector, m_mwmId.GetInfo()->m_limitRect, scales::GetUpperScale(),
+                            m_mwmId);
+
+  m_segmentIndex.reset(new SegmentIndex(segments));
+  LOG(LINFO, ("Segment index of", m_countryFile, "is built, segments:", segments.size(),
+              "bytes:", m_segmentIndex->GetMemoryBytes(), "seconds:", timer.ElapsedSeconds()));
+  return m_segmentIndex.get();
+}
+
+bool RoutingMapping::CustomizeWeights(uint32_t bucket)
+{
+  lock_guard<mutex> lock(m_mutex);
+  m_dataFacade.SetEdgeWeights(vector<uint32_t>());
+  if (!m_handle.IsAlive() || !m_segMapping.IsMapped() || m_facadeCounter == 0)
+    return false;
+
+  my::Timer timer;
+  SpeedProfiles profiles;
+  if (!profiles.Load(m_container))
+    return false;
+  vector<double> factors;
+  MakeNodeSpeedFactors(m_segMapping, profiles, bucket, m_dataFacade.GetNumberOfNodes(), factors);
+  vector<uint32_t> weights;
+  CustomizeEdgeWeights(m_dataFacade, factors, weights);
+  m_dataFacade.SetEdgeWeights(move(weights));
+  LOG(LINFO, ("Weights of", m_countryFile, "are customized for bucket", bucket, "profiles:",
+              profiles.GetProfilesCount(), "seconds:", timer.ElapsedSeconds()));
+  return true;
 }
 
 TRoutingMappingPtr RoutingIndexManager::GetMappingByPoint(m2::PointD const & point)
@@ -185,15 +279,72 @@ TRoutingMappingPtr RoutingIndexManager::GetMappingByPoint(m2::PointD const & poi
 
 TRoutingMappingPtr RoutingIndexManager::GetMappingByName(string const & mapName)
 {
+  auto const findMapping = [this, &mapName]()
+  {
+    lock_guard<mutex> lock(m_mutex);
+    auto const mapIter = m_mapping.find(mapName);
+    return mapIter != m_mapping.end() ? mapIter->second : TRoutingMappingPtr();
+  };
+
   // Check if we have already loaded this file.
-  auto mapIter = m_mapping.find(mapName);
-  if (mapIter != m_mapping.end())
-    return mapIter->second;
-
-  // Or load and check file.
-  TRoutingMappingPtr newMapping(new RoutingMapping(mapName, m_index));
-  m_mapping[mapName] = newMapping;
-  return newMapping;
+  TRoutingMappingPtr mapping = findMapping();
+  if (mapping)
+    return mapping;
+
+  // Or load and check file, another router might have loaded it meanwhile.
+  lock_guard<mutex> loadLock(m_loadMutex);
+  mapping = findMapping();
+  if (mapping)
+    return mapping;
+
+  mapping.reset(new RoutingMapping(mapName, m_index));
+  unique_ptr<MappingGuard> guard;
+  if (m_shared && mapping->IsValid())
+  {
+    guard.reset(new MappingGuard(mapping));
+    PrepareFacade(*mapping);
+  }
+
+  lock_guard<mutex> lock(m_mutex);
+  m_mapping[mapName] = mapping;
+  if (guard)
+    m_pinned.push_back(move(guard));
+  return mapping;
+}
+
+void RoutingIndexManager::PrepareFacade(RoutingMapping & mapping)
+{
+  if (m_useSpeedProfiles)
+    mapping.CustomizeWeights(m_speedProfilesBucket);
+  if (m_hotEdgeCacheBytes != 0)
+    mapping.m_dataFacade.BuildHotEdgeCache(m_hotEdgeCacheBytes);
+}
+
+void RoutingIndexManager::CustomizePinnedMappings(uint32_t bucket)
+{
+  lock_guard<mutex> loadLock(m_loadMutex);
+  m_useSpeedProfiles = true;
+  m_speedProfilesBucket = bucket;
+
+  vector<TRoutingMappingPtr> pinned;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    for (auto const & mapping : m_mapping)
+    {
+      if (m_shared && mapping.second->IsValid())
+        pinned.push_back(mapping.second);
+    }
+  }
+  for (auto const & mapping : pinned)
+    PrepareFacade(*mapping);
+}
+
+void RoutingIndexManager::Clear()
+{
+  lock_guard<mutex> loadLock(m_loadMutex);
+  lock_guard<mutex> lock(m_mutex);
+  m_pinned.clear();
+  m_mapping.clear();
 }
 
 TRoutingMappingPtr RoutingIndexManager::GetMappingById(Index::MwmId const & id)
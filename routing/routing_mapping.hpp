@@ -3,20 +3,27 @@
 #include "osrm2feature_map.hpp"
 #include "osrm_data_facade.hpp"
 #include "router.hpp"
+#include "speed_profiles.hpp"
 
 #include "indexer/index.hpp"
 
 #include "3party/osrm/osrm-backend/data_structures/query_edge.hpp"
 
 #include "std/algorithm.hpp"
+#include "std/mutex.hpp"
+#include "std/unique_ptr.hpp"
 #include "std/unordered_map.hpp"
+#include "std/vector.hpp"
 
 
 namespace routing
 {
+class SegmentIndex;
+
 using TDataFacade = OsrmDataFacade<QueryEdge::EdgeData>;
 
-/// Datamapping and facade for single MWM and MWM.routing file
+/// Datamapping and facade for single MWM and MWM.routing file.
+/// Loading and freeing of sections are thread-safe, loaded sections are read-only.
 struct RoutingMapping
 {
   TDataFacade m_dataFacade;
@@ -25,7 +32,7 @@ struct RoutingMapping
 
   /// Default constructor to create invalid instance for existing client code.
   /// @postcondition IsValid() == false.
-  RoutingMapping() : m_pIndex(nullptr) {}
+  RoutingMapping();
   /// @param countryFile Country file name without extension.
   RoutingMapping(string const & countryFile, MwmSet & index);
   ~RoutingMapping();
@@ -39,6 +46,19 @@ struct RoutingMapping
   void LoadCrossContext();
   void FreeCrossContext();
 
+  /// Builds the index of segments of roads of the mwm which have OSRM nodes, if it isn't
+  /// built yet. The index is kept till the mapping is destroyed.
+  /// @precondition The mapping is mapped.
+  /// @return nullptr if the index can't be built.
+  SegmentIndex const * LoadSegmentIndex(Index const & index);
+
+  /// Customizes weights of the facade by speed profiles of the routing file for the week time
+  /// bucket, see CustomizeEdgeWeights. The hot edge cache of the facade is cleared.
+  /// Not thread-safe with routing on the facade.
+  /// @precondition The mapping is mapped and the facade is loaded.
+  /// @return false if there are no speed profiles, weights of the routing file are used then.
+  bool CustomizeWeights(uint32_t bucket);
+
   bool IsValid() const { return m_error == IRouter::ResultCode::NoError && m_mwmId.IsAlive(); }
 
   IRouter::ResultCode GetError() const { return m_error; }
@@ -57,12 +77,15 @@ struct RoutingMapping
 
 private:
   void LoadFileIfNeeded();
+  void FreeFileIfPossibleImpl();
 
+  mutex m_mutex;
   size_t m_mapCounter;
   size_t m_facadeCounter;
   bool m_crossContextLoaded;
   string m_countryFile;
   FilesMappingContainer m_container;
+  unique_ptr<SegmentIndex> m_segmentIndex;
   IRouter::ResultCode m_error;
   MwmSet::MwmHandle m_handle;
   // We save a mwmId for possibility to unlock a mwm file by rewriting m_handle.
@@ -93,15 +116,44 @@ public:
 
 /*! Manager for loading, cashing and building routing indexes.
  * Builds and shares special routing contexts.
+ * A shared manager is used by routers of several threads at once: its mappings are loaded
+ * once, pinned and are never freed by routers, so every routing file is mapped once.
 */
 class RoutingIndexManager
 {
 public:
-  RoutingIndexManager(TCountryFileFn const & countryFileFn, MwmSet & index)
-      : m_countryFileFn(countryFileFn), m_index(index)
+  RoutingIndexManager(TCountryFileFn const & countryFileFn, MwmSet & index, bool shared = false)
+      : m_countryFileFn(countryFileFn), m_index(index), m_shared(shared),
+        m_bucketLock([this](uint32_t bucket) { CustomizePinnedMappings(bucket); })
+  {
+  }
+
+  ~RoutingIndexManager() { Clear(); }
+
+  bool IsShared() const { return m_shared; }
+
+  /// Sets memory budget of hot edge caches of facades of pinned mappings created afterwards,
+  /// see OsrmRawDataFacade::BuildHotEdgeCache. 0 means no cache.
+  void SetHotEdgeCacheBytes(size_t maxBytes) { m_hotEdgeCacheBytes = maxBytes; }
+
+  /// Makes routers look for start and finish roads in segment indexes of mappings instead of
+  /// reading features around points, see RoutingMapping::LoadSegmentIndex. Indexes are built on
+  /// the first use and take memory, so it makes sense for shared managers only.
+  void SetUseSegmentIndex(bool use) { m_useSegmentIndex = use; }
+  bool UseSegmentIndex() const { return m_useSegmentIndex; }
+
+  /// Makes facades of pinned mappings use weights customized by speed profiles for the week
+  /// time bucket, see RoutingMapping::CustomizeWeights. Waits till routers holding the bucket
+  /// lock finish their routes.
+  void SetSpeedProfilesBucket(uint32_t bucket)
   {
+    SpeedProfilesBucketGuard guard(m_bucketLock, bucket);
   }
 
+  /// Routers hold the lock while they use facades of pinned mappings, so the facades are
+  /// customized for the bucket of their routes.
+  SpeedProfilesBucketLock & GetSpeedProfilesBucketLock() { return m_bucketLock; }
+
   TRoutingMappingPtr GetMappingByPoint(m2::PointD const & point);
 
   TRoutingMappingPtr GetMappingByName(string const & mapName);
@@ -111,16 +163,36 @@ public:
   template <class TFunctor>
   void ForEachMapping(TFunctor toDo)
   {
+    lock_guard<mutex> lock(m_mutex);
     for_each(m_mapping.begin(), m_mapping.end(), toDo);
   }
 
-  void Clear() { m_mapping.clear(); }
+  void Clear();
 
 private:
+  // Customizes facades of a new pinned mapping for the current bucket and builds its hot edge
+  // cache.
+  void PrepareFacade(RoutingMapping & mapping);
+  void CustomizePinnedMappings(uint32_t bucket);
+
   TCountryFileFn m_countryFileFn;
+  // Guards m_mapping and m_pinned. Mappings are loaded and customized under m_loadMutex only,
+  // so getting of loaded mappings doesn't wait for it.
+  mutex m_mutex;
   // TODO (ldragunov) Rewrite to mwmId.
   unordered_map<string, TRoutingMappingPtr> m_mapping;
+  // Guards of pinned mappings of a shared manager.
+  vector<unique_ptr<MappingGuard>> m_pinned;
   MwmSet & m_index;
+  bool const m_shared;
+  size_t m_hotEdgeCacheBytes = 0;
+  bool m_useSegmentIndex = false;
+
+  // Serializes loading of mappings and customization of pinned ones, guards the bucket.
+  mutex m_loadMutex;
+  bool m_useSpeedProfiles = false;
+  uint32_t m_speedProfilesBucket = 0;
+  SpeedProfilesBucketLock m_bucketLock;
 };
 
 }  // namespace routing
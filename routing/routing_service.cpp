@@ -0,0 +1,233 @@
+#include "routing/routing_service.hpp"
+
+#include "routing/osrm_router.hpp"
+#include "routing/routing_mapping.hpp"
+
+#include "indexer/index.hpp"
+#include "indexer/mercator.hpp"
+
+#include "base/exception.hpp"
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/sstream.hpp"
+
+namespace routing
+{
+namespace
+{
+// Returns the nearest-rank percentile of sorted values.
+double GetPercentile(vector<double> const & sorted, double percent)
+{
+  if (sorted.empty())
+    return 0.0;
+  size_t const rank = static_cast<size_t>(ceil(percent / 100.0 * sorted.size()));
+  return sorted[min(max(rank, static_cast<size_t>(1)), sorted.size()) - 1];
+}
+}  // namespace
+
+// static
+size_t constexpr RoutingService::kMaxLatenciesCount;
+
+bool LoadQueryLog(istream & s, vector<RoutingQuery> & queries)
+{
+  string line;
+  while (getline(s, line))
+  {
+    strings::Trim(line);
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    istringstream ls(line);
+    double startLat, startLon, finalLat, finalLon;
+    if (!(ls >> startLat >> startLon >> finalLat >> finalLon))
+    {
+      LOG(LWARNING, ("Malformed line of query log:", line));
+      return false;
+    }
+    queries.emplace_back(MercatorBounds::FromLatLon(startLat, startLon),
+                         MercatorBounds::FromLatLon(finalLat, finalLon));
+    uint32_t weekTimeSec;
+    if (ls >> weekTimeSec)
+      queries.back().m_departureWeekTimeSec = weekTimeSec;
+  }
+  return true;
+}
+
+RoutingService::RoutingService(TRouterFactory const & routerFactory, size_t workersCount,
+                               size_t maxQueueSize, uint32_t timeoutSec)
+  : m_maxQueueSize(maxQueueSize), m_timeoutSec(timeoutSec)
+{
+  ASSERT_GREATER(workersCount, 0, ());
+  for (size_t i = 0; i < workersCount; ++i)
+    m_routers.push_back(routerFactory());
+  for (size_t i = 0; i < workersCount; ++i)
+    m_workers.emplace_back(&RoutingService::ThreadFunc, this, i);
+}
+
+RoutingService::~RoutingService()
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_exit = true;
+  }
+  m_queueCv.notify_all();
+  for (auto & worker : m_workers)
+    worker.join();
+
+  // Workers are stopped, so the queue isn't guarded anymore.
+  for (Task & task : m_queue)
+  {
+    if (!task.m_callback)
+      continue;
+    Route route(m_routers.front()->GetName());
+    task.m_callback(route, IRouter::Cancelled);
+  }
+}
+
+bool RoutingService::Submit(RoutingQuery const & query, TReadyCallback const & callback)
+{
+  {
+    unique_lock<mutex> lock(m_mutex);
+    if (m_queue.size() >= m_maxQueueSize)
+    {
+      ++m_rejected;
+      return false;
+    }
+    if (m_firstSubmitSec < 0.0)
+      m_firstSubmitSec = m_timer.ElapsedSeconds();
+    m_queue.push_back({query, callback, m_timer.ElapsedSeconds()});
+  }
+  m_queueCv.notify_one();
+  return true;
+}
+
+void RoutingService::Replay(vector<RoutingQuery> const & queries)
+{
+  for (RoutingQuery const & query : queries)
+    Enqueue(query, TReadyCallback());
+  WaitAll();
+}
+
+void RoutingService::Enqueue(RoutingQuery const & query, TReadyCallback const & callback)
+{
+  {
+    unique_lock<mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this]() { return m_queue.size() < m_maxQueueSize; });
+    if (m_firstSubmitSec < 0.0)
+      m_firstSubmitSec = m_timer.ElapsedSeconds();
+    m_queue.push_back({query, callback, m_timer.ElapsedSeconds()});
+  }
+  m_queueCv.notify_one();
+}
+
+void RoutingService::WaitAll()
+{
+  unique_lock<mutex> lock(m_mutex);
+  m_doneCv.wait(lock, [this]() { return m_queue.empty() && m_running == 0; });
+}
+
+RoutingService::Stats RoutingService::GetStats() const
+{
+  vector<double> latencies;
+  Stats stats;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    latencies = m_latencies;
+    stats.m_completed = m_completed;
+    stats.m_rejected = m_rejected;
+    stats.m_failed = m_failed;
+    if (m_completed != 0 && m_lastDoneSec > m_firstSubmitSec)
+      stats.m_queriesPerSec = m_completed / (m_lastDoneSec - m_firstSubmitSec);
+  }
+
+  sort(latencies.begin(), latencies.end());
+  stats.m_p50LatencySec = GetPercentile(latencies, 50.0);
+  stats.m_p99LatencySec = GetPercentile(latencies, 99.0);
+  return stats;
+}
+
+void RoutingService::ResetStats()
+{
+  lock_guard<mutex> lock(m_mutex);
+  m_firstSubmitSec = -1.0;
+  m_lastDoneSec = 0.0;
+  m_completed = 0;
+  m_rejected = 0;
+  m_failed = 0;
+  m_latencies.clear();
+}
+
+void RoutingService::ThreadFunc(size_t worker)
+{
+  IRouter & router = *m_routers[worker];
+  while (true)
+  {
+    Task task;
+    {
+      unique_lock<mutex> lock(m_mutex);
+      m_queueCv.wait(lock, [this]() { return m_exit || !m_queue.empty(); });
+      if (m_exit)
+        break;
+      task = move(m_queue.front());
+      m_queue.pop_front();
+      ++m_running;
+    }
+    m_doneCv.notify_all();
+
+    RouterDelegate delegate;
+    delegate.Reset();
+    delegate.SetTimeout(m_timeoutSec);
+    delegate.SetDepartureWeekTime(task.m_query.m_departureWeekTimeSec);
+
+    RoutingQuery const & query = task.m_query;
+    Route route(router.GetName());
+    IRouter::ResultCode code;
+    try
+    {
+      code = router.CalculateRoute(query.m_startPoint, query.m_startDirection, query.m_finalPoint,
+                                   delegate, route);
+    }
+    catch (RootException const & e)
+    {
+      LOG(LERROR, ("Exception happened while calculating route:", e.Msg()));
+      code = IRouter::InternalError;
+    }
+
+    if (task.m_callback)
+      task.m_callback(route, code);
+
+    {
+      lock_guard<mutex> lock(m_mutex);
+      --m_running;
+      m_lastDoneSec = m_timer.ElapsedSeconds();
+      double const latency = m_lastDoneSec - task.m_submitSec;
+      if (m_latencies.size() < kMaxLatenciesCount)
+        m_latencies.push_back(latency);
+      else
+        m_latencies[m_completed % kMaxLatenciesCount] = latency;
+      ++m_completed;
+      if (code != IRouter::NoError)
+        ++m_failed;
+    }
+    m_doneCv.notify_all();
+  }
+}
+
+RoutingService::TRouterFactory MakeSharedOsrmRouterFactory(Index & index,
+                                                           TCountryFileFn const & countryFileFn,
+                                                           size_t hotEdgeCacheBytes,
+                                                           bool useSegmentIndex)
+{
+  auto const manager = make_shared<RoutingIndexManager>(countryFileFn, index, true /* shared */);
+  manager->SetHotEdgeCacheBytes(hotEdgeCacheBytes);
+  manager->SetUseSegmentIndex(useSegmentIndex);
+  return [&index, manager]()
+  {
+    return unique_ptr<IRouter>(new OsrmRouter(&index, manager));
+  };
+}
+}  // namespace routing
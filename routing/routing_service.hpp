@@ -0,0 +1,148 @@
+#pragma once
+
+#include "routing/route.hpp"
+#include "routing/router.hpp"
+#include "routing/router_delegate.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/thread.hpp"
+#include "base/timer.hpp"
+
+#include "std/condition_variable.hpp"
+#include "std/cstdint.hpp"
+#include "std/deque.hpp"
+#include "std/function.hpp"
+#include "std/iostream.hpp"
+#include "std/mutex.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+class Index;
+
+namespace routing
+{
+/// Single routing query in mercator coordinates.
+struct RoutingQuery
+{
+  RoutingQuery() = default;
+  RoutingQuery(m2::PointD const & startPoint, m2::PointD const & finalPoint)
+    : m_startPoint(startPoint), m_finalPoint(finalPoint)
+  {
+  }
+
+  m2::PointD m_startPoint;
+  m2::PointD m_startDirection = m2::PointD::Zero();
+  m2::PointD m_finalPoint;
+  /// See RouterDelegate::SetDepartureWeekTime.
+  uint32_t m_departureWeekTimeSec = RouterDelegate::kNoDepartureTime;
+};
+
+/// Reads a query log: a query per line as "startLat startLon finalLat finalLon [weekTimeSec]",
+/// where weekTimeSec is an optional departure time in seconds since Monday 00:00,
+/// empty lines and lines starting with '#' are skipped.
+/// @return false if there is a malformed line.
+bool LoadQueryLog(istream & s, vector<RoutingQuery> & queries);
+
+/// Calculates routes of many queries at once for server-side use. Every worker thread has its
+/// own router, so search heaps are per worker, while routers may share read-only routing data
+/// (see MakeSharedOsrmRouterFactory). The queue of pending queries is limited: queries above
+/// the limit are rejected instead of increasing latency of all queries.
+/// Shared routing data is customized for one speed profiles bucket at a time, so queries with
+/// departure times of different buckets are calculated by turns, see SpeedProfilesBucketLock.
+class RoutingService final
+{
+public:
+  /// Callback takes ownership of passed route, it's called on a worker thread.
+  using TReadyCallback = function<void(Route &, IRouter::ResultCode)>;
+  /// Creates a router for a worker, it's called once per worker in the constructor.
+  using TRouterFactory = function<unique_ptr<IRouter>()>;
+
+  struct Stats
+  {
+    uint64_t m_completed = 0;
+    uint64_t m_rejected = 0;
+    uint64_t m_failed = 0;
+    /// Latencies are from a query submission till its callback, including the time in queue.
+    /// They are percentiles of the last kMaxLatenciesCount completed queries.
+    double m_p50LatencySec = 0.0;
+    double m_p99LatencySec = 0.0;
+    /// Completed queries per second from the first submitted query till the last completed one.
+    double m_queriesPerSec = 0.0;
+  };
+
+  /// Number of latest latencies which are kept for percentiles.
+  static size_t constexpr kMaxLatenciesCount = 1 << 16;
+
+  /// @param workersCount Number of worker threads.
+  /// @param maxQueueSize Maximum number of submitted but not started queries.
+  /// @param timeoutSec Timeout of a single route calculation. 0 is infinity.
+  RoutingService(TRouterFactory const & routerFactory, size_t workersCount, size_t maxQueueSize,
+                 uint32_t timeoutSec);
+  /// Waits for running queries, callbacks of queued queries are called with Cancelled code.
+  ~RoutingService();
+
+  /// Enqueues a query. Callback may be empty.
+  /// @return false if the queue is full, the query is rejected and callback isn't called.
+  bool Submit(RoutingQuery const & query, TReadyCallback const & callback);
+
+  /// Submits all queries waiting for a free place in the queue instead of rejecting them,
+  /// and waits until all of them are processed.
+  void Replay(vector<RoutingQuery> const & queries);
+
+  /// Waits until all submitted queries are processed.
+  void WaitAll();
+
+  Stats GetStats() const;
+  void ResetStats();
+
+  size_t GetWorkersCount() const { return m_workers.size(); }
+
+private:
+  struct Task
+  {
+    RoutingQuery m_query;
+    TReadyCallback m_callback;
+    double m_submitSec;
+  };
+
+  void ThreadFunc(size_t worker);
+  void Enqueue(RoutingQuery const & query, TReadyCallback const & callback);
+
+  size_t const m_maxQueueSize;
+  uint32_t const m_timeoutSec;
+
+  vector<unique_ptr<IRouter>> m_routers;
+  vector<threads::SimpleThread> m_workers;
+
+  mutable mutex m_mutex;
+  /// Is notified when a query is submitted or the service is stopped.
+  condition_variable m_queueCv;
+  /// Is notified when a query is taken from the queue or is processed.
+  condition_variable m_doneCv;
+  deque<Task> m_queue;
+  size_t m_running = 0;
+  bool m_exit = false;
+
+  /// @name Statistics, guarded by m_mutex.
+  //@{
+  my::Timer m_timer;
+  double m_firstSubmitSec = -1.0;
+  double m_lastDoneSec = 0.0;
+  uint64_t m_completed = 0;
+  uint64_t m_rejected = 0;
+  uint64_t m_failed = 0;
+  /// Ring of latest latencies, m_completed % kMaxLatenciesCount is the next one to overwrite.
+  vector<double> m_latencies;
+  //@}
+};
+
+/// Makes factory of OsrmRouters which share one RoutingIndexManager: every routing file is
+/// mapped once for all workers.
+/// @param hotEdgeCacheBytes Budget of the hot edge cache of every routing file, 0 means no cache.
+/// @param useSegmentIndex Snap start and finish points by segment indexes of routing files.
+RoutingService::TRouterFactory MakeSharedOsrmRouterFactory(Index & index,
+                                                           TCountryFileFn const & countryFileFn,
+                                                           size_t hotEdgeCacheBytes = 0,
+                                                           bool useSegmentIndex = false);
+}  // namespace routing
@@ -36,6 +36,12 @@ double constexpr kKmHToMps = 1000. / 3600.;
 
 double constexpr kInvalidSpeedCameraDistance = -1;
 
+// Distance along the left route from the last matched position to the point where a detour
+// rejoins the route.
+double constexpr kRejoinDistanceMeters = 2000.;
+// Maximal distance between the end of a detour and the rejoin point.
+double constexpr kRejoinToleranceMeters = 20.;
+
 // It limits depth of a speed camera point lookup along the route to avoid freezing.
 size_t constexpr kSpeedCameraLookAheadCount = 50;
 }  // namespace
@@ -50,6 +56,7 @@ RoutingSession::RoutingSession()
       m_lastWarnedSpeedCameraIndex(0),
       m_lastCheckedSpeedCameraIndex(0),
       m_speedWarningSignal(false),
+      m_routingSettings(GetCarRoutingSettings()),
       m_passedDistanceOnRouteMeters(0.0)
 {
 }
@@ -70,6 +77,8 @@ void RoutingSession::BuildRoute(m2::PointD const & startPoint, m2::PointD const
   m_lastGoodPosition = startPoint;
   m_endPoint = endPoint;
   m_router->ClearState();
+  // The current route leads to another end point, so it can't be rejoined.
+  RemoveRoute();
   RebuildRoute(startPoint, readyCallback, progressCallback, timeoutSec);
 }
 
@@ -79,6 +88,42 @@ void RoutingSession::RebuildRoute(m2::PointD const & startPoint,
 {
   ASSERT(m_router != nullptr, ());
   ASSERT_NOT_EQUAL(m_endPoint, m2::PointD::Zero(), ("End point was not set"));
+
+  shared_ptr<Route> leftRoute;
+  size_t rejoinSegIdx = 0;
+  m2::PointD rejoinPoint;
+  {
+    threads::MutexGuard guard(m_routeSessionMutex);
+    UNUSED_VALUE(guard);
+
+    if (m_routingSettings.m_incrementalRebuild && m_state == RouteNeedRebuild &&
+        m_route.GetPointAhead(kRejoinDistanceMeters, rejoinSegIdx, rejoinPoint))
+    {
+      leftRoute = make_shared<Route>(string());
+      leftRoute->Swap(m_route);
+    }
+  }
+
+  if (!leftRoute)
+  {
+    BuildFullRoute(startPoint, readyCallback, progressCallback, timeoutSec);
+    return;
+  }
+
+  RemoveRoute();
+  m_state = RouteBuilding;
+  m_router->CalculateRoute(startPoint, startPoint - m_lastGoodPosition, rejoinPoint,
+                           DoRejoinCallback(*this, leftRoute, rejoinSegIdx, rejoinPoint,
+                                            startPoint, readyCallback, progressCallback,
+                                            timeoutSec, m_routeSessionMutex),
+                           progressCallback, timeoutSec);
+}
+
+void RoutingSession::BuildFullRoute(m2::PointD const & startPoint,
+                                    TReadyCallback const & readyCallback,
+                                    TProgressCallback const & progressCallback,
+                                    uint32_t timeoutSec)
+{
   RemoveRoute();
   m_state = RouteBuilding;
 
@@ -89,6 +134,58 @@ void RoutingSession::RebuildRoute(m2::PointD const & startPoint,
                            progressCallback, timeoutSec);
 }
 
+void RoutingSession::DoRejoinCallback::operator()(Route & route, IRouter::ResultCode e)
+{
+  threads::MutexGuard guard(m_routeSessionMutexInner);
+  UNUSED_VALUE(guard);
+
+  if (e == IRouter::NeedMoreMaps)
+  {
+    for (string const & country : route.GetAbsentCountries())
+      m_rs.m_route.AddAbsentCountry(country);
+    m_callback(m_rs.m_route, e);
+    return;
+  }
+
+  if (e == IRouter::NoError && IsRejoined(route))
+  {
+    route.AppendTail(*m_leftRoute, m_rejoinSegIdx);
+    m_rs.AssignRoute(route, e);
+    m_callback(m_rs.m_route, e);
+    return;
+  }
+
+  if (e == IRouter::Cancelled)
+  {
+    m_rs.AssignRoute(route, e);
+    m_callback(m_rs.m_route, e);
+    return;
+  }
+
+  LOG(LINFO, ("Detour to the route is not found:", e, "Rebuilding the full route."));
+  // The session is still building the route, so the full route is requested directly.
+  m_rs.m_router->CalculateRoute(m_startPoint, m_startPoint - m_rs.m_lastGoodPosition,
+                                m_rs.m_endPoint,
+                                DoReadyCallback(m_rs, m_callback, m_routeSessionMutexInner),
+                                m_progressCallback, m_timeoutSec);
+}
+
+bool RoutingSession::DoRejoinCallback::IsRejoined(Route const & detour) const
+{
+  if (!detour.IsValid())
+    return false;
+
+  auto const & points = detour.GetPoly().GetPoints();
+  if (MercatorBounds::DistanceOnEarth(points.back(), m_rejoinPoint) > kRejoinToleranceMeters)
+    return false;
+
+  // The detour should go in the direction of the left route, not against it.
+  auto const & leftPoints = m_leftRoute->GetPoly().GetPoints();
+  m2::PointD const detourDir = points.back() - points[points.size() - 2];
+  m2::PointD const leftDir = leftPoints[m_rejoinSegIdx + 1] - leftPoints[m_rejoinSegIdx];
+  return m2::DotProduct(detourDir, leftDir) > 0.0;
+}
+
 void RoutingSession::DoReadyCallback::operator()(Route & route, IRouter::ResultCode e)
 {
   threads::MutexGuard guard(m_routeSessionMutexInner);
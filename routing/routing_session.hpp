@@ -16,6 +16,7 @@
 
 #include "std/atomic.hpp"
 #include "std/limits.hpp"
+#include "std/shared_ptr.hpp"
 #include "std/unique_ptr.hpp"
 
 namespace location
@@ -79,6 +80,9 @@ public:
   void BuildRoute(m2::PointD const & startPoint, m2::PointD const & endPoint,
                   TReadyCallback const & readyCallback,
                   TProgressCallback const & progressCallback, uint32_t timeoutSec);
+  /// Builds the route from startPoint to the end point of the current route. If the user has
+  /// left the route and RoutingSettings::m_incrementalRebuild is set, only a detour to a point of
+  /// the rest of the route is built and the rest of the route is kept.
   void RebuildRoute(m2::PointD const & startPoint, TReadyCallback const & readyCallback,
                     TProgressCallback const & progressCallback, uint32_t timeoutSec);
 
@@ -132,8 +136,42 @@ private:
     void operator()(Route & route, IRouter::ResultCode e);
   };
 
+  /// Appends the rest of the left route to the detour or rebuilds the full route if the detour
+  /// doesn't rejoin the left route.
+  struct DoRejoinCallback
+  {
+    RoutingSession & m_rs;
+    shared_ptr<Route> m_leftRoute;
+    size_t m_rejoinSegIdx;
+    m2::PointD m_rejoinPoint;
+    m2::PointD m_startPoint;
+    TReadyCallback m_callback;
+    TProgressCallback m_progressCallback;
+    uint32_t m_timeoutSec;
+    threads::Mutex & m_routeSessionMutexInner;
+
+    DoRejoinCallback(RoutingSession & rs, shared_ptr<Route> const & leftRoute, size_t rejoinSegIdx,
+                     m2::PointD const & rejoinPoint, m2::PointD const & startPoint,
+                     TReadyCallback const & cb, TProgressCallback const & progressCallback,
+                     uint32_t timeoutSec, threads::Mutex & routeSessionMutex)
+        : m_rs(rs), m_leftRoute(leftRoute), m_rejoinSegIdx(rejoinSegIdx),
+          m_rejoinPoint(rejoinPoint), m_startPoint(startPoint), m_callback(cb),
+          m_progressCallback(progressCallback), m_timeoutSec(timeoutSec),
+          m_routeSessionMutexInner(routeSessionMutex)
+    {
+    }
+
+    void operator()(Route & route, IRouter::ResultCode e);
+
+  private:
+    bool IsRejoined(Route const & detour) const;
+  };
+
   void AssignRoute(Route & route, IRouter::ResultCode e);
 
+  void BuildFullRoute(m2::PointD const & startPoint, TReadyCallback const & readyCallback,
+                      TProgressCallback const & progressCallback, uint32_t timeoutSec);
+
   /// Returns a nearest speed camera record on your way and distance to it.
   /// Returns kInvalidSpeedCameraDistance if there is no cameras on your way.
   double GetDistanceToCurrentCamM(SpeedCameraRestriction & camera, Index const & index);
@@ -35,19 +35,26 @@ struct RoutingSettings
 
   /// \brief m_speedCameraWarning is a flag for enabling user notifications about speed cameras.
   bool m_speedCameraWarning;
+
+  /// \brief if m_incrementalRebuild is equal to true a route is rebuilt after leaving it
+  /// as a detour to a point of the rest of the route ahead, which is shorter to find than
+  /// the full route. The full route is rebuilt if the detour is not found.
+  bool m_incrementalRebuild;
 };
 
 inline RoutingSettings GetPedestrianRoutingSettings()
 {
   return RoutingSettings({ false /* m_matchRoute */, false /* m_soundDirection */,
                            20. /* m_matchingThresholdM */, true /* m_keepPedestrianInfo */,
-                           false /* m_showTurnAfterNext */, false /* m_speedCameraWarning*/});
+                           false /* m_showTurnAfterNext */, false /* m_speedCameraWarning*/,
+                           false /* m_incrementalRebuild */});
 }
 
 inline RoutingSettings GetCarRoutingSettings()
 {
   return RoutingSettings({ true /* m_matchRoute */, true /* m_soundDirection */,
                            50. /* m_matchingThresholdM */, false /* m_keepPedestrianInfo */,
-                           true /* m_showTurnAfterNext */, true /* m_speedCameraWarning*/});
+                           true /* m_showTurnAfterNext */, true /* m_speedCameraWarning*/,
+                           true /* m_incrementalRebuild */});
 }
 }  // namespace routing
@@ -88,4 +88,25 @@ UNIT_TEST(AStarAlgorithm_Sample)
   TestAStar(graph, expectedRoute);
 }
 
+UNIT_TEST(AStarAlgorithm_PropagateWave)
+{
+  UndirectedGraph graph;
+
+  graph.AddEdge(0, 1, 10);
+  graph.AddEdge(1, 2, 5);
+  graph.AddEdge(2, 3, 5);
+  graph.AddEdge(2, 4, 10);
+  graph.AddEdge(3, 4, 3);
+  graph.AddEdge(4, 5, 1);
+
+  using TAlgorithm = AStarAlgorithm<UndirectedGraph>;
+  map<unsigned, double> distances;
+  TEST_EQUAL(TAlgorithm::Result::OK, TAlgorithm().PropagateWave(graph, 0u, 23.0, distances), ());
+  map<unsigned, double> const expected = {{0, 0.0}, {1, 10.0}, {2, 15.0}, {3, 20.0}, {4, 23.0}};
+  TEST_EQUAL(expected, distances, ());
+
+  TEST_EQUAL(TAlgorithm::Result::OK, TAlgorithm().PropagateWave(graph, 5u, 0.0, distances), ());
+  TEST_EQUAL(distances.size(), 1, ());
+}
+
 }  // namespace routing_test
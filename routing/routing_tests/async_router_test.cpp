@@ -128,4 +128,18 @@ UNIT_TEST(StandartAsyncFogTest)
   TEST_EQUAL(resultCallback.m_absent.size(), 1, ());
   TEST(resultCallback.m_absent[0].empty(), ());
 }
+
+UNIT_TEST(RouterWithoutAlternativesTest)
+{
+  DummyRouter router(ResultCode::NoError, {});
+  RouterDelegate delegate;
+  Route route("");
+  vector<Route> alternatives(1, Route("stale"));
+  TEST_EQUAL(router.CalculateRouteWithAlternatives({1, 2}, {3, 4}, {5, 6},
+                                                   2 /* maxAlternativesCount */, delegate, route,
+                                                   alternatives),
+             ResultCode::NoError, ());
+  TEST_EQUAL(route.GetRouterId(), "dummy", ());
+  TEST(alternatives.empty(), ());
+}
 }  //  namespace
@@ -0,0 +1,176 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/road_graph_builder.hpp"
+
+#include "routing/isochrone.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include "base/math.hpp"
+
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+using namespace routing_test;
+
+namespace
+{
+double constexpr kStep = 0.001;
+// Max speed of RoadGraphMockSource.
+double constexpr kSpeedKMPH = 5.0;
+m2::PointD const kOrigin(10.0, 10.0);
+
+m2::PointD GetGridPoint(double col, double row)
+{
+  return m2::PointD(kOrigin.x + col * kStep, kOrigin.y + row * kStep);
+}
+
+// Grid of bidirectional roads: road i is the row i and road size + i is the column i.
+unique_ptr<IRoadGraph> MakeGridGraph(uint32_t size)
+{
+  RoadGraphMockSource * graph = new RoadGraphMockSource();
+  unique_ptr<IRoadGraph> result(graph);
+  for (bool rows : {true, false})
+  {
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      IRoadGraph::RoadInfo ri;
+      ri.m_bidirectional = true;
+      ri.m_speedKMPH = kSpeedKMPH;
+      for (uint32_t j = 0; j < size; ++j)
+        ri.m_points.push_back(rows ? GetGridPoint(j, i) : GetGridPoint(i, j));
+      graph->AddRoad(move(ri));
+    }
+  }
+  return result;
+}
+
+double GetSignedArea(vector<m2::PointD> const & polygon)
+{
+  double area = 0.0;
+  for (size_t i = 0; i < polygon.size(); ++i)
+  {
+    m2::PointD const & p1 = polygon[i];
+    m2::PointD const & p2 = polygon[(i + 1) % polygon.size()];
+    area += p1.x * p2.y - p2.x * p1.y;
+  }
+  return area / 2;
+}
+}  // namespace
+
+UNIT_TEST(Isochrone_StraightRoad)
+{
+  RoadGraphMockSource graph;
+  IRoadGraph::RoadInfo ri;
+  ri.m_bidirectional = true;
+  ri.m_speedKMPH = kSpeedKMPH;
+  for (uint32_t i = 0; i < 20; ++i)
+    ri.m_points.push_back(GetGridPoint(i, 0));
+  graph.AddRoad(move(ri));
+
+  IsochroneParams params;
+  params.m_maxTimeSec = 300.0;
+  params.m_cellSizeM = 50.0;
+  m2::PointD const origin = GetGridPoint(10.5, 0.1);
+  Isochrone isochrone;
+  TEST(BuildIsochrone(graph, origin, params, isochrone), ());
+
+  double const speedMPS = kSpeedKMPH * 1000.0 / 3600.0;
+  m2::PointD const projection = GetGridPoint(10.5, 0.0);
+  // The way from the origin to its projection to the road is a part of the time budget.
+  double const reachM =
+      params.m_maxTimeSec * speedMPS - MercatorBounds::DistanceOnEarth(origin, projection);
+  TEST(!isochrone.m_edges.empty(), ());
+  for (ReachableEdge const & e : isochrone.m_edges)
+  {
+    TEST(!e.m_edge.IsFake(), ());
+    TEST_LESS(e.m_startTimeSec, e.m_endTimeSec, ());
+    TEST_LESS_OR_EQUAL(e.m_startTimeSec, params.m_maxTimeSec, ());
+    double const distM = MercatorBounds::DistanceOnEarth(origin, projection) +
+                         MercatorBounds::DistanceOnEarth(
+                             projection, e.m_edge.GetStartJunction().GetPoint());
+    TEST(my::AlmostEqualAbs(e.m_startTimeSec, distM / speedMPS, 1.0), (e.m_startTimeSec, distM));
+  }
+
+  TEST_EQUAL(isochrone.m_polygons.size(), 1, ());
+  vector<m2::PointD> const & polygon = isochrone.m_polygons.front();
+  TEST_EQUAL(polygon.size(), 4, ());
+  TEST_GREATER(GetSignedArea(polygon), 0.0, ());
+
+  m2::RectD rect;
+  for (m2::PointD const & p : polygon)
+    rect.Add(p);
+  for (m2::PointD const & side : {rect.LeftBottom(), rect.RightTop()})
+  {
+    double const distM =
+        MercatorBounds::DistanceOnEarth(projection, m2::PointD(side.x, projection.y));
+    TEST_GREATER_OR_EQUAL(distM, reachM - 1.0, ());
+    TEST_LESS_OR_EQUAL(distM, reachM + params.m_cellSizeM + 1.0, ());
+  }
+}
+
+UNIT_TEST(Isochrone_MakeGridPolygons)
+{
+  vector<vector<m2::PointD>> polygons;
+  MakeGridPolygons({}, 1.0, polygons);
+  TEST(polygons.empty(), ());
+
+  // Ring of 8 cells around the hole.
+  vector<m2::PointD> points;
+  for (int x = 0; x < 3; ++x)
+  {
+    for (int y = 0; y < 3; ++y)
+    {
+      if (x != 1 || y != 1)
+        points.emplace_back(x + 0.5, y + 0.5);
+    }
+  }
+  MakeGridPolygons(points, 1.0, polygons);
+  TEST_EQUAL(polygons.size(), 2, ());
+  double area = 0.0;
+  for (auto const & polygon : polygons)
+  {
+    TEST_EQUAL(polygon.size(), 4, ());
+    area += GetSignedArea(polygon);
+  }
+  TEST(my::AlmostEqualAbs(area, 8.0, 1e-9), (area));
+
+  // Cells touching by corners aren't connected.
+  MakeGridPolygons({m2::PointD(0.5, 0.5), m2::PointD(1.5, 1.5), m2::PointD(1.2, 1.7)}, 1.0,
+                   polygons);
+  TEST_EQUAL(polygons.size(), 2, ());
+  for (auto const & polygon : polygons)
+  {
+    TEST_EQUAL(polygon.size(), 4, ());
+    TEST(my::AlmostEqualAbs(GetSignedArea(polygon), 1.0, 1e-9), ());
+  }
+}
+
+UNIT_TEST(Isochrone_BuildIsochrones)
+{
+  uint32_t const size = 8;
+  vector<m2::PointD> origins;
+  for (uint32_t i = 0; i < 10; ++i)
+    origins.push_back(GetGridPoint(0.3 + i % 5, 0.6 + i % 7));
+
+  IsochroneParams params;
+  params.m_maxTimeSec = 200.0;
+  auto const graphFactory = [size]() { return MakeGridGraph(size); };
+  vector<Isochrone> expected;
+  TEST_EQUAL(BuildIsochrones(graphFactory, origins, params, 1 /* threadsCount */, expected),
+             origins.size(), ());
+  vector<Isochrone> isochrones;
+  TEST_EQUAL(BuildIsochrones(graphFactory, origins, params, 3 /* threadsCount */, isochrones),
+             origins.size(), ());
+
+  TEST_EQUAL(isochrones.size(), expected.size(), ());
+  for (size_t i = 0; i < isochrones.size(); ++i)
+  {
+    TEST(!isochrones[i].m_polygons.empty(), (i));
+    TEST_EQUAL(isochrones[i].m_polygons, expected[i].m_polygons, (i));
+    TEST_EQUAL(isochrones[i].m_edges.size(), expected[i].m_edges.size(), (i));
+  }
+}
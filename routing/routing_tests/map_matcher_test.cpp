@@ -0,0 +1,156 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/road_graph_builder.hpp"
+
+#include "routing/map_matcher.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include "std/random.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+using namespace routing_test;
+
+namespace
+{
+double constexpr kStep = 0.001;
+m2::PointD const kOrigin(10.0, 10.0);
+
+m2::PointD GetGridPoint(double col, double row)
+{
+  return m2::PointD(kOrigin.x + col * kStep, kOrigin.y + row * kStep);
+}
+
+// Grid of bidirectional roads: road i is the row i and road size + i is the column i.
+unique_ptr<IRoadGraph> MakeGridGraph(uint32_t size)
+{
+  RoadGraphMockSource * graph = new RoadGraphMockSource();
+  unique_ptr<IRoadGraph> result(graph);
+  for (bool rows : {true, false})
+  {
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      IRoadGraph::RoadInfo ri;
+      ri.m_bidirectional = true;
+      ri.m_speedKMPH = 60.0;
+      for (uint32_t j = 0; j < size; ++j)
+        ri.m_points.push_back(rows ? GetGridPoint(j, i) : GetGridPoint(i, j));
+      graph->AddRoad(move(ri));
+    }
+  }
+  return result;
+}
+
+// Trace along the row from the column 0 to the column turnCol and along the column turnCol
+// from the row to the row finalRow, points are shifted by noise.
+TTrace MakeTrace(uint32_t row, uint32_t turnCol, uint32_t finalRow, mt19937 & rng)
+{
+  uniform_real_distribution<double> noise(-kStep * 0.05, kStep * 0.05);
+  TTrace trace;
+  for (double col = 0.1; col < turnCol; col += 0.3)
+    trace.push_back(GetGridPoint(col, row) + m2::PointD(noise(rng), noise(rng)));
+  for (double r = row + 0.2; r < finalRow; r += 0.3)
+    trace.push_back(GetGridPoint(turnCol, r) + m2::PointD(noise(rng), noise(rng)));
+  return trace;
+}
+
+// Returns the index of the road which is expected for the point of the trace made by MakeTrace
+// or -1 if the point is near the turn.
+int GetExpectedRoad(m2::PointD const & p, uint32_t size, uint32_t row, uint32_t turnCol)
+{
+  m2::PointD const turn = GetGridPoint(turnCol, row);
+  if (MercatorBounds::DistanceOnEarth(p, turn) < 30.0)
+    return -1;
+  return p.x < turn.x - kStep * 0.2 ? static_cast<int>(row) : static_cast<int>(size + turnCol);
+}
+}  // namespace
+
+UNIT_TEST(MapMatcher_Turn)
+{
+  uint32_t const size = 10;
+  unique_ptr<IRoadGraph> const graph = MakeGridGraph(size);
+  MapMatcher const matcher(*graph, MapMatcher::Params());
+
+  mt19937 rng(0);
+  TTrace const trace = MakeTrace(3 /* row */, 5 /* turnCol */, 8 /* finalRow */, rng);
+  vector<MatchedPoint> result;
+  TEST_EQUAL(matcher.Match(trace, result), trace.size(), ());
+  TEST_EQUAL(result.size(), trace.size(), ());
+
+  for (size_t i = 0; i < trace.size(); ++i)
+  {
+    TEST(result[i].IsMatched(), (i));
+    TEST_LESS(MercatorBounds::DistanceOnEarth(trace[i], result[i].m_point), 15.0, (i));
+    int const road = GetExpectedRoad(trace[i], size, 3, 5);
+    if (road < 0)
+      continue;
+    TEST_EQUAL(result[i].m_edge.GetFeatureId(), MakeTestFeatureID(road), (i));
+    // Vehicle moves along roads.
+    TEST(result[i].m_edge.IsForward(), (i));
+  }
+}
+
+UNIT_TEST(MapMatcher_PointsWithoutRoads)
+{
+  unique_ptr<IRoadGraph> const graph = MakeGridGraph(10);
+  MapMatcher const matcher(*graph, MapMatcher::Params());
+
+  mt19937 rng(0);
+  TTrace trace = MakeTrace(3 /* row */, 5 /* turnCol */, 8 /* finalRow */, rng);
+  // A point far from all roads splits the trace into two matched parts.
+  trace.insert(trace.begin() + 4, GetGridPoint(2.5, 3.5));
+  vector<MatchedPoint> result;
+  TEST_EQUAL(matcher.Match(trace, result), trace.size() - 1, ());
+  TEST(!result[4].IsMatched(), ());
+  TEST(result[3].IsMatched(), ());
+  TEST(result[5].IsMatched(), ());
+
+  TEST_EQUAL(matcher.Match(TTrace(), result), 0, ());
+  TEST(result.empty(), ());
+}
+
+UNIT_TEST(MapMatcher_MatchTraces)
+{
+  uint32_t const size = 12;
+  mt19937 rng(1);
+  vector<TTrace> traces;
+  for (uint32_t i = 0; i < 40; ++i)
+  {
+    traces.push_back(
+        MakeTrace(1 + i % 5 /* row */, 3 + i % 7 /* turnCol */, 11 /* finalRow */, rng));
+  }
+  size_t pointsCount = 0;
+  for (auto const & trace : traces)
+    pointsCount += trace.size();
+
+  auto const graphFactory = [size]() { return MakeGridGraph(size); };
+  vector<vector<MatchedPoint>> expected;
+  my::Timer timer;
+  TEST_EQUAL(MatchTraces(graphFactory, MapMatcher::Params(), traces, 1 /* threadsCount */,
+                         expected),
+             pointsCount, ());
+  double const oneThreadSec = timer.ElapsedSeconds();
+
+  vector<vector<MatchedPoint>> results;
+  timer.Reset();
+  TEST_EQUAL(MatchTraces(graphFactory, MapMatcher::Params(), traces, 4 /* threadsCount */,
+                         results),
+             pointsCount, ());
+  double const fourThreadsSec = timer.ElapsedSeconds();
+
+  TEST_EQUAL(results.size(), expected.size(), ());
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    TEST_EQUAL(results[i].size(), expected[i].size(), (i));
+    for (size_t j = 0; j < results[i].size(); ++j)
+      TEST_EQUAL(results[i][j].m_edge, expected[i][j].m_edge, (i, j));
+  }
+
+  LOG(LINFO, ("Points per second, one thread:", pointsCount / oneThreadSec, "four threads:",
+              pointsCount / fourThreadsSec));
+}
@@ -0,0 +1,103 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/osrm_test_facade.hpp"
+
+#include "routing/osrm_data_facade.hpp"
+
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+using namespace routing_test;
+
+namespace
+{
+vector<vector<TestEdge>> MakeRandomGraph(uint32_t nodesCount)
+{
+  mt19937 rng(0);
+  uniform_int_distribution<uint32_t> nodeDist(0, nodesCount - 1);
+  uniform_int_distribution<uint32_t> degreeDist(0, 6);
+  uniform_int_distribution<int> distanceDist(1, 10000);
+  vector<vector<TestEdge>> graph(nodesCount);
+  for (uint32_t node = 0; node < nodesCount; ++node)
+  {
+    // Some nodes have many edges like top levels of a contraction hierarchy.
+    uint32_t const degree = node % 97 == 0 ? 60 : degreeDist(rng);
+    vector<NodeID> targets;
+    for (uint32_t i = 0; i < degree; ++i)
+      targets.push_back(nodeDist(rng));
+    sort(targets.begin(), targets.end());
+    targets.erase(unique(targets.begin(), targets.end()), targets.end());
+
+    for (NodeID target : targets)
+    {
+      TestEdge edge;
+      edge.m_target = target;
+      edge.m_data.distance = distanceDist(rng);
+      edge.m_data.shortcut = rng() % 3 == 0;
+      edge.m_data.id = edge.m_data.shortcut ? nodeDist(rng) : 0;
+      edge.m_data.backward = rng() % 2 == 0;
+      edge.m_data.forward = !edge.m_data.backward;
+      graph[node].push_back(edge);
+    }
+  }
+  return graph;
+}
+
+void TestSameAsGraph(TFacade const & facade, vector<vector<TestEdge>> const & graph)
+{
+  TEST_EQUAL(facade.GetNumberOfNodes(), graph.size(), ());
+  for (NodeID node = 0; node < graph.size(); ++node)
+  {
+    auto const & expected = graph[node];
+    TEST_EQUAL(facade.GetOutDegree(node), expected.size(), (node));
+    size_t i = 0;
+    for (EdgeID e : facade.GetAdjacentEdgeRange(node))
+    {
+      TEST_EQUAL(facade.GetTarget(e), expected[i].m_target, (node, e));
+      TEdgeData const data = facade.GetEdgeData(e, node);
+      TEST_EQUAL(data.distance, expected[i].m_data.distance, (node, e));
+      TEST_EQUAL(data.shortcut, expected[i].m_data.shortcut, (node, e));
+      TEST_EQUAL(data.forward, expected[i].m_data.forward, (node, e));
+      TEST_EQUAL(data.backward, expected[i].m_data.backward, (node, e));
+      if (data.shortcut)
+        TEST_EQUAL(data.id, expected[i].m_data.id, (node, e));
+      ++i;
+    }
+  }
+}
+}  // namespace
+
+UNIT_TEST(OsrmDataFacade_HotEdgeCache)
+{
+  vector<vector<TestEdge>> const graph = MakeRandomGraph(5000);
+  TestFacade testFacade(graph);
+  TFacade & facade = testFacade.Get();
+  TestSameAsGraph(facade, graph);
+
+  // Budget is too small even for the blocks table.
+  facade.BuildHotEdgeCache(10);
+  TEST_EQUAL(facade.GetHotEdgeCacheBytes(), 0, ());
+  TestSameAsGraph(facade, graph);
+
+  for (size_t maxBytes : {5000, 20000, 100000, 100000000})
+  {
+    facade.BuildHotEdgeCache(maxBytes);
+    TEST_GREATER(facade.GetHotEdgeCacheBytes(), 0, (maxBytes));
+    TEST_LESS_OR_EQUAL(facade.GetHotEdgeCacheBytes(), maxBytes, ());
+    TestSameAsGraph(facade, graph);
+  }
+
+  // Only touched nodes are cached.
+  facade.StartTouchesCounting();
+  for (NodeID node = 100; node < 200; ++node)
+    facade.GetAdjacentEdgeRange(node);
+  facade.BuildHotEdgeCache(100000000);
+  TEST_GREATER(facade.GetHotEdgeCacheBytes(), 0, ());
+  TEST_LESS(facade.GetHotEdgeCacheBytes(), 20000, ());
+  TestSameAsGraph(facade, graph);
+
+  facade.ClearHotEdgeCache();
+  TEST_EQUAL(facade.GetHotEdgeCacheBytes(), 0, ());
+  TestSameAsGraph(facade, graph);
+}
@@ -0,0 +1,140 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/osrm_test_facade.hpp"
+
+#include "routing/osrm_engine.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+using namespace routing_test;
+
+namespace
+{
+NodeID constexpr kSource = 0;
+NodeID constexpr kTarget = 10;
+uint32_t constexpr kNodesCount = 12;
+
+// Graph without shortcuts, a search on it is a plain bidirectional Dijkstra.
+class GraphBuilder
+{
+public:
+  GraphBuilder() : m_graph(kNodesCount) {}
+
+  void AddEdge(NodeID from, NodeID to, int distance)
+  {
+    m_graph[from].push_back(MakeEdge(to, distance, false /* backward */));
+    m_graph[to].push_back(MakeEdge(from, distance, true /* backward */));
+  }
+
+  void AddPath(vector<NodeID> const & nodes, vector<int> const & distances)
+  {
+    for (size_t i = 0; i < distances.size(); ++i)
+      AddEdge(nodes[i], nodes[i + 1], distances[i]);
+  }
+
+  vector<vector<TestEdge>> Build()
+  {
+    for (auto & edges : m_graph)
+    {
+      sort(edges.begin(), edges.end(), [](TestEdge const & e1, TestEdge const & e2)
+      {
+        if (e1.m_target != e2.m_target)
+          return e1.m_target < e2.m_target;
+        return e1.m_data.backward < e2.m_data.backward;
+      });
+    }
+    return m_graph;
+  }
+
+private:
+  static TestEdge MakeEdge(NodeID target, int distance, bool backward)
+  {
+    TestEdge edge;
+    edge.m_target = target;
+    edge.m_data.distance = distance;
+    edge.m_data.shortcut = false;
+    edge.m_data.id = 0;
+    edge.m_data.backward = backward;
+    edge.m_data.forward = !backward;
+    return edge;
+  }
+
+  vector<vector<TestEdge>> m_graph;
+};
+
+vector<NodeID> GetNodes(RawRoutingResult const & result)
+{
+  TEST_EQUAL(result.unpackedPathSegments.size(), 1, ());
+  vector<NodeID> nodes;
+  for (RawPathData const & data : result.unpackedPathSegments.front())
+    nodes.push_back(data.node);
+  return nodes;
+}
+
+bool FindRoutes(TFacade & facade, NodeID target, AlternativeRoutesParams const & params,
+                vector<RawRoutingResult> & results)
+{
+  return FindAlternativeRoutes(FeatureGraphNode(kSource, true /* isStartNode */, Index::MwmId()),
+                               FeatureGraphNode(target, false /* isStartNode */, Index::MwmId()),
+                               facade, params, results);
+}
+}  // namespace
+
+UNIT_TEST(OsrmEngine_AlternativeRoutes)
+{
+  GraphBuilder builder;
+  builder.AddPath({kSource, 1, 2, kTarget}, {40, 20, 40});
+  // Detour of the shortest path which shares too much with it.
+  builder.AddPath({1, 9, 2}, {12, 12});
+  builder.AddPath({kSource, 3, 4, kTarget}, {30, 50, 30});
+  builder.AddPath({kSource, 5, 6, kTarget}, {40, 40, 40});
+  // Too long path.
+  builder.AddPath({kSource, 7, 8, kTarget}, {100, 50, 50});
+  TestFacade testFacade(builder.Build());
+
+  AlternativeRoutesParams params;
+  vector<RawRoutingResult> results;
+  TEST(FindRoutes(testFacade.Get(), kTarget, params, results), ());
+  TEST_EQUAL(results.size(), 3, ());
+  TEST_EQUAL(results[0].shortestPathLength, 100, ());
+  TEST_EQUAL(GetNodes(results[0]), vector<NodeID>({kSource, 1, 2, kTarget}), ());
+  TEST_EQUAL(results[1].shortestPathLength, 110, ());
+  TEST_EQUAL(GetNodes(results[1]), vector<NodeID>({kSource, 3, 4, kTarget}), ());
+  TEST_EQUAL(results[2].shortestPathLength, 120, ());
+  TEST_EQUAL(GetNodes(results[2]), vector<NodeID>({kSource, 5, 6, kTarget}), ());
+
+  params.m_maxRoutesCount = 2;
+  TEST(FindRoutes(testFacade.Get(), kTarget, params, results), ());
+  TEST_EQUAL(results.size(), 2, ());
+  TEST_EQUAL(results[1].shortestPathLength, 110, ());
+
+  // The isolated node isn't reachable.
+  TEST(!FindRoutes(testFacade.Get(), kNodesCount - 1, params, results), ());
+  TEST(results.empty(), ());
+}
+
+UNIT_TEST(OsrmEngine_AlternativeRoutesLocalOptimality)
+{
+  GraphBuilder builder;
+  builder.AddPath({kSource, 1, kTarget}, {50, 50});
+  builder.AddPath({kSource, 2, 3, kTarget}, {45, 20, 45});
+  // Path through the node 4 isn't locally optimal: the way from 2 to 3 is shorter.
+  builder.AddPath({2, 4, 3}, {30, 1});
+  TestFacade testFacade(builder.Build());
+
+  AlternativeRoutesParams params;
+  params.m_maxStretch = 0.5;
+  params.m_maxSharing = 1.0;
+  vector<RawRoutingResult> results;
+  TEST(FindRoutes(testFacade.Get(), kTarget, params, results), ());
+  TEST_EQUAL(results.size(), 2, ());
+  TEST_EQUAL(GetNodes(results[0]), vector<NodeID>({kSource, 1, kTarget}), ());
+  TEST_EQUAL(GetNodes(results[1]), vector<NodeID>({kSource, 2, 3, kTarget}), ());
+
+  params.m_localOptimality = 0.0;
+  TEST(FindRoutes(testFacade.Get(), kTarget, params, results), ());
+  TEST_EQUAL(results.size(), 3, ());
+  TEST_EQUAL(GetNodes(results[2]), vector<NodeID>({kSource, 2, 4, 3, kTarget}), ());
+}
@@ -1,8 +1,8 @@
+#include "testing/benchmark.hpp"
 #include "testing/testing.hpp"
 
 #include "routing/osrm_router.hpp"
 
-#include "indexer/features_offsets_table.hpp"
 #include "indexer/mercator.hpp"
 
 #include "platform/country_file.hpp"
@@ -16,10 +16,12 @@
 
 #include "defines.hpp"
 
+#include "base/macros.hpp"
 #include "base/scope_guard.hpp"
 
+#include "std/algorithm.hpp"
 #include "std/bind.hpp"
-#include "std/unique_ptr.hpp"
+#include "std/map.hpp"
 #include "std/vector.hpp"
 
 using namespace routing;
@@ -52,6 +54,62 @@ void TestSegmentRange(OsrmFtSegMapping const & mapping, RangeDataT const & test)
   }
 }
 
+void TestBackwardIndex(OsrmFtSegMapping const & mapping, InputDataT const & data)
+{
+  map<uint32_t, vector<TOsrmNodeId>> expected;
+  for (TOsrmNodeId nodeId = 0; nodeId < data.size(); ++nodeId)
+  {
+    for (auto const & seg : data[nodeId])
+      expected[seg.m_fid].push_back(nodeId);
+  }
+
+  for (auto & fidNodes : expected)
+  {
+    vector<TOsrmNodeId> & nodes = fidNodes.second;
+    nodes.erase(unique(nodes.begin(), nodes.end()), nodes.end());
+
+    vector<TOsrmNodeId> found;
+    mapping.ForEachNodeIdByFid(fidNodes.first, [&found](TOsrmNodeId nodeId)
+    {
+      found.push_back(nodeId);
+    });
+    TEST(mapping.HasNodeIds(fidNodes.first), (fidNodes.first));
+    TEST_EQUAL(found, nodes, (fidNodes.first));
+  }
+
+  uint32_t const absentFid = expected.rbegin()->first + 1;
+  TEST(!mapping.HasNodeIds(absentFid), ());
+  mapping.ForEachNodeIdByFid(absentFid, [](TOsrmNodeId)
+  {
+    TEST(false, ());
+  });
+}
+
+void TestLoadedMapping(string const & ftSegsPath, platform::LocalCountryFile const & localFile,
+                       InputDataT const & data, NodeIdDataT const & nodeIds,
+                       RangeDataT const & ranges)
+{
+  FilesMappingContainer cont(ftSegsPath);
+  OsrmFtSegMapping mapping;
+  mapping.Load(cont, localFile);
+  mapping.Map(cont);
+
+  TestNodeId(mapping, nodeIds);
+  TestSegmentRange(mapping, ranges);
+  TestBackwardIndex(mapping, data);
+
+  for (size_t i = 0; i < mapping.GetSegmentsCount(); ++i)
+  {
+    TOsrmNodeId const node = mapping.GetNodeId(i);
+    size_t count = 0;
+    mapping.ForEachFtSeg(node, [&] (OsrmMappingTypes::FtSeg const & s)
+    {
+      TEST_EQUAL(s, data[node][count++], ());
+    });
+    TEST_EQUAL(count, data[node].size(), ());
+  }
+}
+
 void TestMapping(InputDataT const & data,
                  NodeIdDataT const & nodeIds,
                  RangeDataT const & ranges)
@@ -63,36 +121,9 @@ void TestMapping(InputDataT const & data,
       localFile.GetCountryFile().GetNameWithExt(MapOptions::Map));
   static char const ftSegsPath[] = "test1.tmp";
 
-  platform::CountryIndexes::PreparePlaceOnDisk(localFile);
-  string const & featuresOffsetsTablePath =
-    CountryIndexes::GetPath(localFile, CountryIndexes::Index::Offsets);
   MY_SCOPE_GUARD(ftSegsFileDeleter, bind(FileWriter::DeleteFileX, ftSegsPath));
-  MY_SCOPE_GUARD(featuresOffsetsTableFileDeleter,
-                 bind(FileWriter::DeleteFileX, featuresOffsetsTablePath));
   MY_SCOPE_GUARD(indexesDeleter, bind(&CountryIndexes::DeleteFromDisk, localFile));
 
-  {
-    // Prepare fake features offsets table for input data, because
-    // OsrmFtSegMapping::Load() loads routing index and creates
-    // additional helper indexes and some of them require
-    // FeatureOffsetsTable existence.
-    //
-    // As instantiation of FeatureOffsetsTable requires complete MWM
-    // file with features or at least already searialized
-    // FeatureOffsetsTable, the purpose of this code is to prepare a
-    // file with serialized FeatureOffsetsTable and feed it to
-    // OsrmFtSegMapping.
-    feature::FeaturesOffsetsTable::Builder tableBuilder;
-    for (auto const & segVector : data)
-    {
-      for (auto const & seg : segVector)
-        tableBuilder.PushOffset(seg.m_fid);
-    }
-    unique_ptr<feature::FeaturesOffsetsTable> table =
-        feature::FeaturesOffsetsTable::Build(tableBuilder);
-    table->Save(featuresOffsetsTablePath);
-  }
-
   OsrmFtSegMappingBuilder builder;
   for (TOsrmNodeId nodeId = 0; nodeId < data.size(); ++nodeId)
     builder.Append(nodeId, data[nodeId]);
@@ -105,28 +136,62 @@ void TestMapping(InputDataT const & data,
     builder.Save(w);
   }
 
+  TestLoadedMapping(ftSegsPath, localFile, data, nodeIds, ranges);
+
   {
-    FilesMappingContainer cont(ftSegsPath);
-    OsrmFtSegMapping mapping;
-    mapping.Load(cont, localFile);
-    mapping.Map(cont);
+    // Routing files made before the starts and the backward index sections.
+    FilesContainerW w(ftSegsPath, FileWriter::OP_WRITE_EXISTING);
+    w.DeleteSection(ROUTING_FTSEG_STARTS_FILE_TAG);
+    w.DeleteSection(ROUTING_FTSEG_BACKWARD_FILE_TAG);
+  }
+  // The first load builds the backward index and saves it to country indexes,
+  // the second one reads it.
+  TestLoadedMapping(ftSegsPath, localFile, data, nodeIds, ranges);
+  TestLoadedMapping(ftSegsPath, localFile, data, nodeIds, ranges);
+}
 
-    TestNodeId(mapping, nodeIds);
-    TestSegmentRange(mapping, ranges);
+#ifndef DEBUG
+uint32_t constexpr kBenchmarkNodesCount = 1000000;
+// The builder doesn't know its segments count, see OsrmFtSegMapping::GetSegmentsCount().
+uint32_t g_benchmarkSegmentsCount = 0;
 
-    for (size_t i = 0; i < mapping.GetSegmentsCount(); ++i)
+OsrmFtSegMappingBuilder const & GetBenchmarkBuilder()
+{
+  static OsrmFtSegMappingBuilder builder;
+  if (g_benchmarkSegmentsCount == 0)
+  {
+    // Most of nodes have one segment, some of them have several ones.
+    OsrmFtSegMappingBuilder::FtSegVectorT segments;
+    for (TOsrmNodeId nodeId = 0; nodeId < kBenchmarkNodesCount; ++nodeId)
     {
-      TOsrmNodeId const node = mapping.GetNodeId(i);
-      size_t count = 0;
-      mapping.ForEachFtSeg(node, [&] (OsrmMappingTypes::FtSeg const & s)
-      {
-        TEST_EQUAL(s, data[node][count++], ());
-      });
-      TEST_EQUAL(count, data[node].size(), ());
+      segments.clear();
+      size_t const count = (nodeId % 7 == 0) ? nodeId % 5 + 2 : 1;
+      for (size_t i = 0; i < count; ++i)
+        segments.emplace_back(nodeId / 2, i, i + 1);
+      builder.Append(nodeId, segments);
+      g_benchmarkSegmentsCount += segments.size();
     }
   }
+  return builder;
 }
 
+void RunTranslationBenchmark(OsrmFtSegMapping const & mapping)
+{
+  BENCHMARK_N_TIMES(10, 10.0)
+  {
+    uint64_t sum = 0;
+    for (TOsrmNodeId nodeId = 0; nodeId < kBenchmarkNodesCount; ++nodeId)
+    {
+      auto const range = mapping.GetSegmentsRange(nodeId);
+      sum += range.second - range.first;
+    }
+    for (uint32_t i = 0; i < g_benchmarkSegmentsCount; i += 3)
+      sum += mapping.GetNodeId(i);
+    FORCE_USE_VALUE(sum);
+  }
+}
+#endif
+
 bool TestFtSeg(SegT const & s)
 {
   return (SegT(s.Store()) == s);
@@ -134,6 +199,31 @@ bool TestFtSeg(SegT const & s)
 
 }
 
+#ifndef DEBUG
+BENCHMARK_TEST(OsrmFtSegMapping_TranslationByOffsets)
+{
+  // The builder looks up nodes by sorted offsets of nodes with several segments.
+  RunTranslationBenchmark(GetBenchmarkBuilder());
+}
+
+BENCHMARK_TEST(OsrmFtSegMapping_TranslationByStarts)
+{
+  static char const ftSegsPath[] = "benchmark_ftsegs.tmp";
+  MY_SCOPE_GUARD(ftSegsFileDeleter, bind(FileWriter::DeleteFileX, ftSegsPath));
+  {
+    FilesContainerW w(ftSegsPath);
+    GetBenchmarkBuilder().Save(w);
+  }
+
+  FilesMappingContainer cont(ftSegsPath);
+  OsrmFtSegMapping mapping;
+  // The routing file has all the sections, so the local file isn't used.
+  mapping.Load(cont, platform::LocalCountryFile());
+  mapping.Map(cont);
+  RunTranslationBenchmark(mapping);
+}
+#endif
+
 UNIT_TEST(FtSeg_Smoke)
 {
   SegT arr[] = {
@@ -257,3 +347,43 @@ UNIT_TEST(OsrmFtSegMappingBuilder_Smoke)
     TestMapping(data, nodeIds, ranges);
   }
 }
+
+UNIT_TEST(OsrmFtSegMapping_NoBackwardIndexForOldMaps)
+{
+  platform::CountryFile country("TestCountry");
+  platform::LocalCountryFile localFile(GetPlatform().WritableDir(), country, 0 /* version */);
+  string const mapFile = localFile.GetCountryFile().GetNameWithExt(MapOptions::Map);
+  MY_SCOPE_GUARD(mapFileDeleter,
+                 bind(FileWriter::DeleteFileX, GetPlatform().WritablePathForFile(mapFile)));
+  {
+    // Maps older than v5 have no prolog in the version section.
+    FilesContainerW w(GetPlatform().WritablePathForFile(mapFile));
+    FileWriter versionWriter = w.GetWriter(VERSION_FILE_TAG);
+    versionWriter.Write("OLD", 4);
+  }
+  localFile.SyncWithDisk();
+
+  static char const ftSegsPath[] = "test_old.tmp";
+  MY_SCOPE_GUARD(ftSegsFileDeleter, bind(FileWriter::DeleteFileX, ftSegsPath));
+  MY_SCOPE_GUARD(indexesDeleter, bind(&CountryIndexes::DeleteFromDisk, localFile));
+
+  // Feature ids of old maps are offsets, so the backward index isn't built for them.
+  uint32_t const offset = 1000000;
+  OsrmFtSegMappingBuilder builder;
+  builder.Append(0, {{offset, 0, 1}});
+  {
+    FilesContainerW w(ftSegsPath);
+    builder.Save(w);
+  }
+  {
+    FilesContainerW w(ftSegsPath, FileWriter::OP_WRITE_EXISTING);
+    w.DeleteSection(ROUTING_FTSEG_BACKWARD_FILE_TAG);
+  }
+
+  FilesMappingContainer cont(ftSegsPath);
+  OsrmFtSegMapping mapping;
+  mapping.Load(cont, localFile);
+  mapping.Map(cont);
+  TEST(!mapping.HasNodeIds(offset), ());
+  TEST_EQUAL(mapping.GetSegmentsCount(), 1, ());
+}
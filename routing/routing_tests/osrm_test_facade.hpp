@@ -0,0 +1,90 @@
+#pragma once
+
+#include "routing/osrm_data_facade.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/matrix_traversal.hpp"
+
+#include "base/bits.hpp"
+#include "base/scope_guard.hpp"
+
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+#include "3party/osrm/osrm-backend/data_structures/query_edge.hpp"
+
+namespace routing_test
+{
+using TEdgeData = QueryEdge::EdgeData;
+using TFacade = routing::OsrmRawDataFacade<TEdgeData>;
+
+struct TestEdge
+{
+  NodeID m_target;
+  TEdgeData m_data;
+};
+
+// Facade with the data packed as the routing generator does.
+class TestFacade
+{
+public:
+  explicit TestFacade(vector<vector<TestEdge>> const & graph)
+  {
+    uint32_t const nodesCount = static_cast<uint32_t>(graph.size());
+    vector<uint64_t> edges;
+    vector<uint32_t> edgeData;
+    vector<bool> shortcuts;
+    vector<uint64_t> edgeIds;
+    for (uint32_t node = 0; node < nodesCount; ++node)
+    {
+      for (TestEdge const & edge : graph[node])
+      {
+        edges.push_back(TraverseMatrixInRowOrder<uint64_t>(nodesCount, node, edge.m_target,
+                                                           edge.m_data.backward));
+        edgeData.push_back(edge.m_data.distance);
+        shortcuts.push_back(edge.m_data.shortcut);
+        if (edge.m_data.shortcut)
+          edgeIds.push_back(bits::ZigZagEncode(int64_t(node) - int64_t(edge.m_data.id)));
+      }
+    }
+
+    succinct::elias_fano::elias_fano_builder builder(edges.back(), edges.size());
+    for (uint64_t e : edges)
+      builder.push_back(e);
+    succinct::elias_fano matrix(&builder);
+    m_matrix.assign(reinterpret_cast<char const *>(&nodesCount), sizeof(nodesCount));
+    m_matrix += Freeze(matrix);
+
+    succinct::elias_fano_compressed_list edgeDataList(edgeData);
+    m_edgeData = Freeze(edgeDataList);
+    succinct::elias_fano_compressed_list edgeIdsList(edgeIds);
+    m_edgeIds = Freeze(edgeIdsList);
+    succinct::rs_bit_vector shortcutsVector(shortcuts);
+    m_shortcuts = Freeze(shortcutsVector);
+
+    m_facade.LoadRawData(m_edgeData.data(), m_edgeIds.data(), m_shortcuts.data(),
+                         m_matrix.data());
+  }
+
+  TFacade & Get() { return m_facade; }
+
+private:
+  template <class T>
+  static string Freeze(T & t)
+  {
+    string const fileName = "osrm_data_facade_test.tmp";
+    MY_SCOPE_GUARD(deleteFile, bind(&FileWriter::DeleteFileX, fileName));
+    succinct::mapper::freeze(t, fileName.c_str());
+    string data;
+    FileReader(fileName).ReadAsString(data);
+    return data;
+  }
+
+  string m_matrix;
+  string m_edgeData;
+  string m_edgeIds;
+  string m_shortcuts;
+  TFacade m_facade;
+};
+}  // namespace routing_test
@@ -1,5 +1,7 @@
 #include "road_graph_builder.hpp"
 
+#include "routing/nearest_edge_finder.hpp"
+
 #include "indexer/mwm_set.hpp"
 
 #include "base/macros.hpp"
@@ -93,9 +95,10 @@ void RoadGraphMockSource::ForEachFeatureClosestToCross(m2::PointD const & /* cro
 void RoadGraphMockSource::FindClosestEdges(m2::PointD const & point, uint32_t count,
                                            vector<pair<Edge, m2::PointD>> & vicinities) const
 {
-  UNUSED_VALUE(point);
-  UNUSED_VALUE(count);
-  UNUSED_VALUE(vicinities);
+  NearestEdgeFinder finder(point);
+  for (size_t roadId = 0; roadId < m_roads.size(); ++roadId)
+    finder.AddInformationSource(MakeTestFeatureID(roadId), m_roads[roadId]);
+  finder.MakeResult(vicinities, count);
 }
 
 void RoadGraphMockSource::GetFeatureTypes(FeatureID const & featureId, feature::TypesHolder & types) const
@@ -157,3 +157,58 @@ UNIT_TEST(NextTurnsTest)
     TEST_EQUAL(turnsDist.size(), 1, ());
   }
 }
+
+UNIT_TEST(PointAheadTest)
+{
+  Route route("TestRouter");
+  route.SetGeometry(kTestGeometry.begin(), kTestGeometry.end());
+  double const firstSegLenM = MercatorBounds::DistanceOnEarth(kTestGeometry[0], kTestGeometry[1]);
+  double const secondSegLenM = MercatorBounds::DistanceOnEarth(kTestGeometry[1], kTestGeometry[2]);
+
+  size_t segIdx = 0;
+  m2::PointD point;
+  TEST(route.GetPointAhead(firstSegLenM + secondSegLenM / 2, segIdx, point), ());
+  TEST_EQUAL(segIdx, 1, ());
+  TEST(point.EqualDxDy(m2::PointD(0.5, 1), 1e-9), (point));
+
+  route.MoveIterator(GetGps(0, 0.5));
+  TEST(route.GetPointAhead(firstSegLenM / 4, segIdx, point), ());
+  TEST_EQUAL(segIdx, 0, ());
+  TEST(point.EqualDxDy(m2::PointD(0, 0.75), 1e-3), (point));
+
+  TEST(!route.GetPointAhead(route.GetTotalDistanceMeters(), segIdx, point), ());
+}
+
+UNIT_TEST(AppendTailTest)
+{
+  Route route("TestRouter");
+  route.SetGeometry(kTestGeometry.begin(), kTestGeometry.end());
+  vector<turns::TurnItem> turns(kTestTurns);
+  route.SetTurnInstructions(turns);
+  Route::TTimes times({{1, 10.}, {2, 20.}, {4, 40.}});
+  route.SetSectionTimes(times);
+
+  // The detour ends at the middle of the segment 2 of the route.
+  vector<m2::PointD> const detourGeometry({{2, 0}, {2, 1.5}, {1, 1.5}});
+  Route detour("TestRouter");
+  detour.SetGeometry(detourGeometry.begin(), detourGeometry.end());
+  vector<turns::TurnItem> detourTurns(
+      {turns::TurnItem(1, turns::TurnDirection::TurnLeft),
+       turns::TurnItem(2, turns::TurnDirection::ReachedYourDestination)});
+  detour.SetTurnInstructions(detourTurns);
+  Route::TTimes detourTimes({{2, 5.}});
+  detour.SetSectionTimes(detourTimes);
+
+  detour.AppendTail(route, 2 /* segIdx */);
+
+  vector<m2::PointD> const expectedGeometry({{2, 0}, {2, 1.5}, {1, 1.5}, {1, 2}, {1, 3}});
+  TEST_EQUAL(detour.GetPoly().GetPoints(), expectedGeometry, ());
+  vector<turns::TurnItem> const expectedTurns(
+      {turns::TurnItem(1, turns::TurnDirection::TurnLeft),
+       turns::TurnItem(4, turns::TurnDirection::ReachedYourDestination)});
+  TEST_EQUAL(detour.GetTurns(), expectedTurns, ());
+  // A quarter of the last section of the route is passed by the detour, so the time is about
+  // 20 seconds and it's truncated by GetTotalTimeSec.
+  uint32_t const totalTimeSec = detour.GetTotalTimeSec();
+  TEST(totalTimeSec == 19 || totalTimeSec == 20, (totalTimeSec));
+}
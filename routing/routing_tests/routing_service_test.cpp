@@ -0,0 +1,206 @@
+#include "testing/testing.hpp"
+
+#include "routing/route.hpp"
+#include "routing/router.hpp"
+#include "routing/routing_service.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "base/thread.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/atomic.hpp"
+#include "std/condition_variable.hpp"
+#include "std/mutex.hpp"
+#include "std/sstream.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+
+namespace
+{
+// Shared state of all DummyRouters of a service.
+struct DummyState
+{
+  atomic<uint32_t> m_running{0};
+  atomic<uint32_t> m_maxRunning{0};
+
+  // Routers wait until the gate is open.
+  mutex m_mutex;
+  condition_variable m_cv;
+  bool m_open = true;
+
+  void SetOpen(bool open)
+  {
+    {
+      lock_guard<mutex> lock(m_mutex);
+      m_open = open;
+    }
+    m_cv.notify_all();
+  }
+};
+
+class DummyRouter : public IRouter
+{
+  DummyState & m_state;
+
+public:
+  explicit DummyRouter(DummyState & state) : m_state(state) {}
+
+  // IRouter overrides:
+  string GetName() const override { return "Dummy"; }
+  ResultCode CalculateRoute(m2::PointD const & startPoint, m2::PointD const & startDirection,
+                            m2::PointD const & finalPoint, RouterDelegate const & delegate,
+                            Route & route) override
+  {
+    uint32_t const running = ++m_state.m_running;
+    uint32_t maxRunning = m_state.m_maxRunning;
+    while (running > maxRunning && !m_state.m_maxRunning.compare_exchange_weak(maxRunning, running))
+    {
+    }
+
+    {
+      unique_lock<mutex> lock(m_state.m_mutex);
+      m_state.m_cv.wait(lock, [this]() { return m_state.m_open; });
+    }
+    threads::Sleep(5);
+    --m_state.m_running;
+
+    if (startPoint == finalPoint)
+      return RouteNotFound;
+    vector<m2::PointD> points({startPoint, finalPoint});
+    route = Route("dummy", points.begin(), points.end());
+    return NoError;
+  }
+};
+
+RoutingService::TRouterFactory MakeDummyFactory(DummyState & state)
+{
+  return [&state]() { return unique_ptr<IRouter>(new DummyRouter(state)); };
+}
+}  // namespace
+
+UNIT_TEST(RoutingService_Parallel)
+{
+  DummyState state;
+  RoutingService service(MakeDummyFactory(state), 4 /* workersCount */, 100 /* maxQueueSize */,
+                         0 /* timeoutSec */);
+  TEST_EQUAL(service.GetWorkersCount(), 4, ());
+
+  mutex resultsMutex;
+  vector<uint32_t> routed;
+  uint32_t notFound = 0;
+  for (uint32_t i = 0; i < 40; ++i)
+  {
+    m2::PointD const start(i, i);
+    m2::PointD const finish = (i % 10 == 0 ? start : m2::PointD(i, i + 1));
+    TEST(service.Submit(RoutingQuery(start, finish), [&, i](Route & route, IRouter::ResultCode code)
+    {
+      lock_guard<mutex> lock(resultsMutex);
+      if (code == IRouter::NoError)
+      {
+        TEST_EQUAL(route.GetPoly().Front(), m2::PointD(i, i), ());
+        routed.push_back(i);
+      }
+      else
+      {
+        TEST_EQUAL(code, IRouter::RouteNotFound, ());
+        ++notFound;
+      }
+    }), (i));
+  }
+  service.WaitAll();
+
+  TEST_EQUAL(routed.size(), 36, ());
+  TEST_EQUAL(notFound, 4, ());
+  TEST_GREATER(state.m_maxRunning.load(), 1, ("Queries are calculated in parallel."));
+  TEST_LESS_OR_EQUAL(state.m_maxRunning.load(), 4, ());
+
+  RoutingService::Stats const stats = service.GetStats();
+  TEST_EQUAL(stats.m_completed, 40, ());
+  TEST_EQUAL(stats.m_failed, 4, ());
+  TEST_EQUAL(stats.m_rejected, 0, ());
+  TEST_GREATER(stats.m_p50LatencySec, 0.0, ());
+  TEST_LESS_OR_EQUAL(stats.m_p50LatencySec, stats.m_p99LatencySec, ());
+  TEST_GREATER(stats.m_queriesPerSec, 0.0, ());
+}
+
+UNIT_TEST(RoutingService_AdmissionControl)
+{
+  DummyState state;
+  state.SetOpen(false);
+  RoutingService service(MakeDummyFactory(state), 2 /* workersCount */, 3 /* maxQueueSize */,
+                         0 /* timeoutSec */);
+
+  // Both workers are blocked on the first two queries, next three are queued.
+  uint32_t accepted = 0;
+  for (uint32_t i = 0; i < 2; ++i)
+    accepted += service.Submit(RoutingQuery(m2::PointD(0, 0), m2::PointD(1, 1)), nullptr) ? 1 : 0;
+  while (state.m_running.load() != 2)
+    threads::Sleep(1);
+  for (uint32_t i = 0; i < 10; ++i)
+    accepted += service.Submit(RoutingQuery(m2::PointD(0, 0), m2::PointD(1, 1)), nullptr) ? 1 : 0;
+  TEST_EQUAL(accepted, 5, ());
+  TEST_EQUAL(service.GetStats().m_rejected, 7, ());
+
+  state.SetOpen(true);
+  service.WaitAll();
+  TEST_EQUAL(service.GetStats().m_completed, 5, ());
+
+  // Replay waits for a place in the queue instead of rejecting queries.
+  service.ResetStats();
+  service.Replay(vector<RoutingQuery>(20, RoutingQuery(m2::PointD(0, 0), m2::PointD(1, 1))));
+  RoutingService::Stats const stats = service.GetStats();
+  TEST_EQUAL(stats.m_completed, 20, ());
+  TEST_EQUAL(stats.m_rejected, 0, ());
+}
+
+UNIT_TEST(RoutingService_CancelQueuedOnDestruction)
+{
+  DummyState state;
+  state.SetOpen(false);
+  unique_ptr<RoutingService> service(new RoutingService(
+      MakeDummyFactory(state), 1 /* workersCount */, 10 /* maxQueueSize */, 0 /* timeoutSec */));
+
+  mutex resultsMutex;
+  vector<IRouter::ResultCode> codes;
+  auto const callback = [&](Route &, IRouter::ResultCode code)
+  {
+    lock_guard<mutex> lock(resultsMutex);
+    codes.push_back(code);
+  };
+  TEST(service->Submit(RoutingQuery(m2::PointD(0, 0), m2::PointD(1, 1)), callback), ());
+  while (state.m_running.load() != 1)
+    threads::Sleep(1);
+  for (uint32_t i = 0; i < 3; ++i)
+    TEST(service->Submit(RoutingQuery(m2::PointD(0, 0), m2::PointD(1, 1)), callback), ());
+
+  // The worker finishes the running query after the service is told to stop.
+  threads::SimpleThread destroyer([&service]() { service.reset(); });
+  threads::Sleep(50);
+  state.SetOpen(true);
+  destroyer.join();
+
+  TEST_EQUAL(codes.size(), 4, ());
+  TEST_EQUAL(codes[0], IRouter::NoError, ());
+  TEST_EQUAL(count(codes.begin(), codes.end(), IRouter::Cancelled), 3, ());
+}
+
+UNIT_TEST(RoutingService_LoadQueryLog)
+{
+  istringstream log("# startLat startLon finalLat finalLon\n"
+                    "55.75 37.61 55.80 37.50\n"
+                    "\n"
+                    "  53.90 27.56 53.85 27.60 30600 \n");
+  vector<RoutingQuery> queries;
+  TEST(LoadQueryLog(log, queries), ());
+  TEST_EQUAL(queries.size(), 2, ());
+  TEST_EQUAL(queries[0].m_departureWeekTimeSec, RouterDelegate::kNoDepartureTime, ());
+  TEST_EQUAL(queries[1].m_departureWeekTimeSec, 30600, ());
+  TEST(queries[0].m_startPoint.EqualDxDy(MercatorBounds::FromLatLon(55.75, 37.61), 1e-9), ());
+  TEST(queries[1].m_finalPoint.EqualDxDy(MercatorBounds::FromLatLon(53.85, 27.60), 1e-9), ());
+
+  istringstream malformed("55.75 37.61 55.80\n");
+  TEST(!LoadQueryLog(malformed, queries), ());
+}
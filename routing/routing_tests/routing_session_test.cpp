@@ -9,6 +9,7 @@
 #include "base/logging.hpp"
 
 #include "std/chrono.hpp"
+#include "std/cmath.hpp"
 #include "std/mutex.hpp"
 #include "std/string.hpp"
 #include "std/vector.hpp"
@@ -41,6 +42,51 @@ public:
   }
 };
 
+// Router which returns the straight route from the start point to the final point. If
+// detourFails is true, it finds only routes to endPoint.
+class StraightRouter : public IRouter
+{
+private:
+  m2::PointD const m_endPoint;
+  bool const m_detourFails;
+  vector<m2::PointD> & m_finalPoints;
+
+public:
+  StraightRouter(m2::PointD const & endPoint, bool detourFails, vector<m2::PointD> & finalPoints)
+    : m_endPoint(endPoint), m_detourFails(detourFails), m_finalPoints(finalPoints)
+  {
+  }
+  string GetName() const override { return "straight"; }
+  void ClearState() override {}
+  ResultCode CalculateRoute(m2::PointD const & startPoint,
+                            m2::PointD const & /* startDirection */,
+                            m2::PointD const & finalPoint,
+                            RouterDelegate const & /* delegate */, Route & route) override
+  {
+    m_finalPoints.push_back(finalPoint);
+    if (m_detourFails && finalPoint != m_endPoint)
+      return RouteNotFound;
+
+    // Points are in about 1 km from each other and a minute is spent between them.
+    size_t const segCount = static_cast<size_t>(ceil(startPoint.Length(finalPoint) / 0.01));
+    vector<m2::PointD> points;
+    Route::TTimes times;
+    for (size_t i = 0; i <= segCount; ++i)
+    {
+      double const fraction = static_cast<double>(i) / segCount;
+      points.push_back(startPoint + (finalPoint - startPoint) * fraction);
+      if (i != 0)
+        times.emplace_back(i, 60. * i);
+    }
+    vector<turns::TurnItem> turns(
+        {turns::TurnItem(segCount, turns::TurnDirection::ReachedYourDestination)});
+    route.SetGeometry(points.begin(), points.end());
+    route.SetTurnInstructions(turns);
+    route.SetSectionTimes(times);
+    return NoError;
+  }
+};
+
 static vector<m2::PointD> kTestRoute = {{0., 1.}, {0., 2.}, {0., 3.}, {0., 4.}};
 static auto kRouteBuildingMaxDuration = seconds(30);
 
@@ -153,4 +199,94 @@ UNIT_TEST(TestRouteRebuilding)
   }
   TEST_EQUAL(code, RoutingSession::State::RouteNeedRebuild, ());
 }
+
+// Goes along the route built by StraightRouter, leaves it and rebuilds it.
+void RebuildLeftRoute(bool detourFails, vector<m2::PointD> & finalPoints, Route & rebuiltRoute)
+{
+  Index index;
+  RoutingSession session;
+  session.Init(nullptr, nullptr);
+  m2::PointD const startPoint(0., 0.);
+  m2::PointD const endPoint(0., 0.2);
+  session.SetRouter(make_unique<StraightRouter>(endPoint, detourFails, finalPoints), nullptr);
+
+  TimedSignal buildTimedSignal;
+  session.BuildRoute(startPoint, endPoint,
+                     [&buildTimedSignal](Route const &, IRouter::ResultCode)
+                     {
+                       buildTimedSignal.Signal();
+                     },
+                     nullptr, 0);
+  TEST(buildTimedSignal.WaitUntil(steady_clock::now() + kRouteBuildingMaxDuration),
+       ("Route was not built."));
+
+  location::GpsInfo info;
+  info.m_horizontalAccuracy = 0.01;
+  info.m_verticalAccuracy = 0.01;
+  m2::PointD position = startPoint;
+  RoutingSession::State code = RoutingSession::State::RoutingNotActive;
+  for (; position.y < 0.05; position.y += 0.001)
+  {
+    info.m_longitude = MercatorBounds::XToLon(position.x);
+    info.m_latitude = MercatorBounds::YToLat(position.y);
+    code = session.OnLocationPositionChanged(position, info, index);
+    TEST_EQUAL(code, RoutingSession::State::OnRoute, ());
+  }
+  while (code != RoutingSession::State::RouteNeedRebuild)
+  {
+    TEST_LESS(position.x, 0.1, ("The left route is not detected."));
+    position.x += 0.001;
+    info.m_longitude = MercatorBounds::XToLon(position.x);
+    code = session.OnLocationPositionChanged(position, info, index);
+  }
+
+  TimedSignal rebuildTimedSignal;
+  session.RebuildRoute(position,
+                       [&rebuildTimedSignal, &rebuiltRoute](Route const & route,
+                                                            IRouter::ResultCode code)
+                       {
+                         TEST_EQUAL(code, IRouter::NoError, ());
+                         rebuiltRoute = route;
+                         rebuildTimedSignal.Signal();
+                       },
+                       nullptr, 0);
+  TEST(rebuildTimedSignal.WaitUntil(steady_clock::now() + kRouteBuildingMaxDuration),
+       ("Route was not rebuilt."));
+  TEST(rebuiltRoute.GetPoly().Front().EqualDxDy(position, 1e-9), ());
+  TEST(rebuiltRoute.GetPoly().Back().EqualDxDy(endPoint, 1e-9), ());
+}
+
+UNIT_TEST(TestIncrementalRouteRebuilding)
+{
+  vector<m2::PointD> finalPoints;
+  Route route("straight");
+  RebuildLeftRoute(false /* detourFails */, finalPoints, route);
+
+  // Only the detour to the left route is found.
+  TEST_EQUAL(finalPoints.size(), 2, ());
+  TEST_NOT_EQUAL(finalPoints[1], finalPoints[0], ());
+  TEST(my::AlmostEqualAbs(finalPoints[1].x, 0., 1e-9), ());
+  TEST_GREATER(finalPoints[1].y, 0.05, ());
+  TEST_LESS(finalPoints[1].y, 0.1, ());
+  TEST(find(route.GetPoly().GetPoints().begin(), route.GetPoly().GetPoints().end(),
+            finalPoints[1]) != route.GetPoly().GetPoints().end(), ());
+  TEST_EQUAL(route.GetTurns().size(), 1, ());
+  TEST_EQUAL(route.GetTurns().back().m_turn, turns::TurnDirection::ReachedYourDestination, ());
+  TEST_EQUAL(route.GetTurns().back().m_index, route.GetPoly().GetSize() - 1, ());
+  // The route is shorter than 20 km which takes 20 minutes but longer than the rest of it.
+  TEST_LESS(route.GetTotalTimeSec(), 20 * 60, ());
+  TEST_GREATER(route.GetTotalTimeSec(), 14 * 60, ());
+}
+
+UNIT_TEST(TestIncrementalRouteRebuildingFallback)
+{
+  vector<m2::PointD> finalPoints;
+  Route route("straight");
+  RebuildLeftRoute(true /* detourFails */, finalPoints, route);
+
+  // The full route is rebuilt after the failed detour.
+  TEST_EQUAL(finalPoints.size(), 3, ());
+  TEST_NOT_EQUAL(finalPoints[1], finalPoints[0], ());
+  TEST_EQUAL(finalPoints[2], finalPoints[0], ());
+}
 }  // namespace routing
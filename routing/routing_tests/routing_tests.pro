@@ -27,18 +27,26 @@ SOURCES += \
   async_router_test.cpp \
   cross_routing_tests.cpp \
   followed_polyline_test.cpp \
+  isochrone_test.cpp \
+  map_matcher_test.cpp \
   nearest_edge_finder_tests.cpp \
   online_cross_fetcher_test.cpp \
+  osrm_data_facade_test.cpp \
+  osrm_engine_test.cpp \
   osrm_router_test.cpp \
   road_graph_builder.cpp \
   road_graph_nearest_edges_test.cpp \
   route_tests.cpp \
   routing_mapping_test.cpp \
+  routing_service_test.cpp \
   routing_session_test.cpp \
+  segment_index_test.cpp \
+  speed_profiles_test.cpp \
   turns_generator_test.cpp \
   turns_sound_test.cpp \
   turns_tts_text_tests.cpp \
   vehicle_model_test.cpp \
 
 HEADERS += \
+  osrm_test_facade.hpp \
   road_graph_builder.hpp \
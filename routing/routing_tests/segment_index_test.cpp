@@ -0,0 +1,148 @@
+#include "testing/testing.hpp"
+
+#include "routing/segment_index.hpp"
+
+#include "geometry/distance.hpp"
+
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+#include "std/random.hpp"
+#include "std/vector.hpp"
+
+using namespace routing;
+
+namespace
+{
+// Coordinates of segments are quantised by the index.
+double constexpr kEps = 1e-6;
+
+// Polylines of features with random directions, every feature has several segments.
+vector<SegmentIndex::Segment> MakeRandomSegments(uint32_t featuresCount)
+{
+  mt19937 rng(0);
+  uniform_real_distribution<double> coordDist(-10.0, 10.0);
+  uniform_real_distribution<double> stepDist(-0.05, 0.05);
+  uniform_int_distribution<uint32_t> countDist(1, 8);
+  vector<SegmentIndex::Segment> segments;
+  for (uint32_t fid = 0; fid < featuresCount; ++fid)
+  {
+    m2::PointD p(coordDist(rng), coordDist(rng));
+    uint32_t const count = countDist(rng);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      m2::PointD const next(p.x + stepDist(rng), p.y + stepDist(rng));
+      segments.emplace_back(fid, i, p, next);
+      p = next;
+    }
+  }
+  return segments;
+}
+
+// Returns square distances to k nearest segments found by brute force.
+vector<double> FindNearestDists(vector<SegmentIndex::Segment> const & segments,
+                                m2::PointD const & point, size_t k, bool distinctFeatures)
+{
+  vector<pair<double, uint32_t>> dists;
+  for (auto const & s : segments)
+  {
+    m2::ProjectionToSection<m2::PointD> segProj;
+    segProj.SetBounds(s.m_p0, s.m_p1);
+    dists.emplace_back(point.SquareLength(segProj(point)), s.m_fid);
+  }
+  sort(dists.begin(), dists.end());
+
+  vector<double> res;
+  vector<uint32_t> fids;
+  for (auto const & d : dists)
+  {
+    if (res.size() == k)
+      break;
+    if (distinctFeatures && find(fids.begin(), fids.end(), d.second) != fids.end())
+      continue;
+    fids.push_back(d.second);
+    res.push_back(d.first);
+  }
+  return res;
+}
+
+void TestSameDists(vector<SegmentIndex::Result> const & results, vector<double> const & expected)
+{
+  TEST_EQUAL(results.size(), expected.size(), ());
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    TEST(my::AlmostEqualAbs(sqrt(results[i].m_squareDist), sqrt(expected[i]), 1e-6),
+         (i, results[i].m_squareDist, expected[i]));
+  }
+}
+}  // namespace
+
+UNIT_TEST(SegmentIndex_Empty)
+{
+  SegmentIndex index(vector<SegmentIndex::Segment>{});
+  TEST_EQUAL(index.GetSegmentsCount(), 0, ());
+  vector<SegmentIndex::Result> res;
+  index.FindNearest(m2::PointD(0, 0), 10, 100.0, false /* distinctFeatures */, res);
+  TEST(res.empty(), ());
+}
+
+UNIT_TEST(SegmentIndex_Projection)
+{
+  SegmentIndex index({SegmentIndex::Segment(7, 0, m2::PointD(0, 0), m2::PointD(2, 0)),
+                      SegmentIndex::Segment(7, 1, m2::PointD(2, 0), m2::PointD(2, 2)),
+                      SegmentIndex::Segment(8, 0, m2::PointD(5, 5), m2::PointD(6, 6))});
+  TEST_EQUAL(index.GetSegmentsCount(), 3, ());
+
+  vector<SegmentIndex::Result> res;
+  index.FindNearest(m2::PointD(1, 1), 10, 100.0, false /* distinctFeatures */, res);
+  TEST_EQUAL(res.size(), 3, ());
+  TEST_EQUAL(res[0].m_fid, 7, ());
+  TEST(res[0].m_point.EqualDxDy(m2::PointD(1, 0), kEps) ||
+           res[0].m_point.EqualDxDy(m2::PointD(2, 1), kEps),
+       (res[0].m_point));
+  TEST_EQUAL(res[2].m_fid, 8, ());
+  TEST_EQUAL(res[2].m_segIdx, 0, ());
+  TEST(res[2].m_point.EqualDxDy(m2::PointD(5, 5), kEps), (res[2].m_point));
+
+  index.FindNearest(m2::PointD(1, 1), 10, 100.0, true /* distinctFeatures */, res);
+  TEST_EQUAL(res.size(), 2, ());
+  TEST_EQUAL(res[0].m_fid, 7, ());
+  TEST_EQUAL(res[1].m_fid, 8, ());
+
+  // Segments of the feature 8 are too far.
+  index.FindNearest(m2::PointD(1, 1), 10, 2.0, true /* distinctFeatures */, res);
+  TEST_EQUAL(res.size(), 1, ());
+  TEST_EQUAL(res[0].m_fid, 7, ());
+}
+
+UNIT_TEST(SegmentIndex_SameAsBruteForce)
+{
+  vector<SegmentIndex::Segment> const segments = MakeRandomSegments(3000);
+  SegmentIndex index(segments);
+  TEST_EQUAL(index.GetSegmentsCount(), segments.size(), ());
+
+  mt19937 rng(1);
+  uniform_real_distribution<double> coordDist(-11.0, 11.0);
+  vector<m2::PointD> points;
+  for (size_t i = 0; i < 200; ++i)
+    points.emplace_back(coordDist(rng), coordDist(rng));
+
+  for (bool distinctFeatures : {false, true})
+  {
+    vector<vector<SegmentIndex::Result>> batch;
+    index.FindNearest(points, 10, 100.0, distinctFeatures, batch);
+    TEST_EQUAL(batch.size(), points.size(), ());
+
+    vector<SegmentIndex::Result> res;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      vector<double> const expected = FindNearestDists(segments, points[i], 10, distinctFeatures);
+      index.FindNearest(points[i], 10, 100.0, distinctFeatures, res);
+      TestSameDists(res, expected);
+      TestSameDists(batch[i], expected);
+      for (auto const & r : res)
+        TEST(my::AlmostEqualAbs(points[i].SquareLength(r.m_point), r.m_squareDist, 1e-9), ());
+    }
+  }
+}
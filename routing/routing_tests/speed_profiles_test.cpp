@@ -0,0 +1,191 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/osrm_test_facade.hpp"
+
+#include "routing/speed_profiles.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/math.hpp"
+#include "base/scope_guard.hpp"
+#include "base/thread.hpp"
+
+#include "std/atomic.hpp"
+#include "std/vector.hpp"
+
+#include "defines.hpp"
+
+using namespace routing;
+using namespace routing_test;
+
+namespace
+{
+SpeedProfiles::TProfile MakeProfile(uint8_t speed, uint32_t slowBucket, uint8_t slowSpeed)
+{
+  SpeedProfiles::TProfile profile;
+  profile.fill(speed);
+  profile[slowBucket] = slowSpeed;
+  return profile;
+}
+
+TestEdge MakeEdge(NodeID target, int distance, bool backward, NodeID middle)
+{
+  TestEdge edge;
+  edge.m_target = target;
+  edge.m_data.distance = distance;
+  edge.m_data.shortcut = middle != SPECIAL_NODEID;
+  edge.m_data.id = edge.m_data.shortcut ? middle : 0;
+  edge.m_data.backward = backward;
+  edge.m_data.forward = !backward;
+  return edge;
+}
+
+vector<int> GetWeights(TFacade const & facade)
+{
+  vector<int> weights;
+  for (NodeID node = 0; node < facade.GetNumberOfNodes(); ++node)
+  {
+    for (EdgeID e : facade.GetAdjacentEdgeRange(node))
+      weights.push_back(facade.GetEdgeData(e, node).distance);
+  }
+  return weights;
+}
+}  // namespace
+
+UNIT_TEST(SpeedProfiles_GetBucket)
+{
+  TEST_EQUAL(SpeedProfiles::GetBucket(0), 0, ());
+  TEST_EQUAL(SpeedProfiles::GetBucket(SpeedProfiles::kBucketSec - 1), 0, ());
+  TEST_EQUAL(SpeedProfiles::GetBucket(SpeedProfiles::kBucketSec), 1, ());
+  TEST_EQUAL(SpeedProfiles::GetBucket(SpeedProfiles::kWeekSec - 1),
+             SpeedProfiles::kBucketsCount - 1, ());
+  TEST_EQUAL(SpeedProfiles::GetBucket(SpeedProfiles::kWeekSec + SpeedProfiles::kBucketSec), 1,
+             ());
+}
+
+UNIT_TEST(SpeedProfiles_Serialization)
+{
+  string const fileName = "speed_profiles_test.tmp";
+  MY_SCOPE_GUARD(deleteFile, bind(&FileWriter::DeleteFileX, fileName));
+
+  SpeedProfilesBuilder builder;
+  builder.SetProfile(7, MakeProfile(100, 40, 50));
+  builder.SetProfile(3, MakeProfile(80, 0, 0));
+  builder.SetProfile(12, MakeProfile(100, 40, 50));
+  {
+    FilesContainerW container(fileName);
+    FileWriter writer = container.GetWriter(ROUTING_SPEED_PROFILES_FILE_TAG);
+    builder.Serialize(writer);
+  }
+
+  FilesMappingContainer container(fileName);
+  SpeedProfiles profiles;
+  TEST(profiles.Load(container), ());
+  TEST(profiles.IsLoaded(), ());
+  TEST_EQUAL(profiles.GetFeaturesCount(), 3, ());
+  // Equal profiles are stored once.
+  TEST_EQUAL(profiles.GetProfilesCount(), 2, ());
+
+  for (uint32_t fid : {7, 12})
+  {
+    TEST(my::AlmostEqualAbs(profiles.GetSpeedFactor(fid, 39), 1.0, 1e-9), (fid));
+    TEST(my::AlmostEqualAbs(profiles.GetSpeedFactor(fid, 40), 0.5, 1e-9), (fid));
+  }
+  TEST(my::AlmostEqualAbs(profiles.GetSpeedFactor(3, 1), 0.8, 1e-9), ());
+  // Closed roads are very slow.
+  TEST(my::AlmostEqualAbs(profiles.GetSpeedFactor(3, 0), 0.01, 1e-9), ());
+  // Features without profiles keep the free flow speed.
+  TEST(my::AlmostEqualAbs(profiles.GetSpeedFactor(5, 40), 1.0, 1e-9), ());
+
+  profiles.Clear();
+  TEST(!profiles.IsLoaded(), ());
+  TEST(my::AlmostEqualAbs(profiles.GetSpeedFactor(7, 40), 1.0, 1e-9), ());
+}
+
+UNIT_TEST(SpeedProfiles_CustomizeEdgeWeights)
+{
+  // Edges 0 -> 1 and 1 -> 2 and the shortcut 0 -> 2 through 1.
+  vector<vector<TestEdge>> graph(3);
+  graph[0].push_back(MakeEdge(1, 10, false /* backward */, SPECIAL_NODEID));
+  graph[0].push_back(MakeEdge(2, 30, false /* backward */, 1));
+  graph[2].push_back(MakeEdge(1, 20, true /* backward */, SPECIAL_NODEID));
+  TestFacade testFacade(graph);
+  TFacade & facade = testFacade.Get();
+  TEST_EQUAL(GetWeights(facade), vector<int>({10, 30, 20}), ());
+
+  vector<uint32_t> weights;
+  CustomizeEdgeWeights(facade, {0.5, 2.0, 1.0}, weights);
+  TEST_EQUAL(weights, vector<uint32_t>({20, 30, 10}), ());
+  CustomizeEdgeWeights(facade, {1.0, 0.25, 1.0}, weights);
+  TEST_EQUAL(weights, vector<uint32_t>({10, 90, 80}), ());
+
+  facade.BuildHotEdgeCache(100000);
+  TEST_GREATER(facade.GetHotEdgeCacheBytes(), 0, ());
+  facade.SetEdgeWeights(move(weights));
+  TEST(facade.HasCustomEdgeWeights(), ());
+  TEST_EQUAL(facade.GetHotEdgeCacheBytes(), 0, ());
+  TEST_EQUAL(GetWeights(facade), vector<int>({10, 90, 80}), ());
+
+  facade.SetEdgeWeights(vector<uint32_t>());
+  TEST(!facade.HasCustomEdgeWeights(), ());
+  TEST_EQUAL(GetWeights(facade), vector<int>({10, 30, 20}), ());
+}
+
+UNIT_TEST(SpeedProfiles_BucketLock)
+{
+  vector<uint32_t> customized;
+  SpeedProfilesBucketLock lock([&customized](uint32_t bucket) { customized.push_back(bucket); });
+  TEST_EQUAL(lock.GetBucket(), SpeedProfilesBucketLock::kAnyBucket, ());
+  {
+    SpeedProfilesBucketGuard guard(lock, SpeedProfilesBucketLock::kAnyBucket);
+    TEST(customized.empty(), ());
+  }
+  {
+    SpeedProfilesBucketGuard guard(lock, 5);
+    SpeedProfilesBucketGuard guard5(lock, 5);
+    SpeedProfilesBucketGuard guardAny(lock, SpeedProfilesBucketLock::kAnyBucket);
+  }
+  {
+    SpeedProfilesBucketGuard guard(lock, 5);
+  }
+  TEST_EQUAL(customized, vector<uint32_t>({5}), ());
+  TEST_EQUAL(lock.GetBucket(), 5, ());
+}
+
+UNIT_TEST(SpeedProfiles_BucketLockThreads)
+{
+  atomic<uint32_t> holders(0);
+  atomic<uint32_t> errors(0);
+  atomic<uint32_t> customizations(0);
+  SpeedProfilesBucketLock lock([&](uint32_t /* bucket */)
+  {
+    if (holders.load() != 0)
+      ++errors;
+    ++customizations;
+    threads::Sleep(1);
+  });
+
+  vector<threads::SimpleThread> threads;
+  for (uint32_t i = 0; i < 8; ++i)
+  {
+    threads.emplace_back([&, i]()
+    {
+      for (uint32_t j = 0; j < 50; ++j)
+      {
+        uint32_t const bucket =
+            (i + j) % 4 == 0 ? SpeedProfilesBucketLock::kAnyBucket : (i + j) % 4;
+        SpeedProfilesBucketGuard guard(lock, bucket);
+        ++holders;
+        if (bucket != SpeedProfilesBucketLock::kAnyBucket && lock.GetBucket() != bucket)
+          ++errors;
+        --holders;
+      }
+    });
+  }
+  for (auto & thread : threads)
+    thread.join();
+
+  TEST_EQUAL(errors.load(), 0, ());
+  TEST_GREATER(customizations.load(), 0, ());
+}
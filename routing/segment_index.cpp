@@ -0,0 +1,202 @@
+#include "routing/segment_index.hpp"
+
+#include "indexer/point_to_int64.hpp"
+
+#include "geometry/distance.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/numeric.hpp"
+
+namespace routing
+{
+namespace
+{
+// Returns the position of the quantised point on the Hilbert curve.
+uint64_t GetHilbertKey(m2::PointU const & p)
+{
+  uint32_t x = p.x;
+  uint32_t y = p.y;
+  uint64_t key = 0;
+  for (uint64_t s = 1ULL << (POINT_COORD_BITS - 1); s > 0; s >>= 1)
+  {
+    uint32_t const rx = (x & s) != 0 ? 1 : 0;
+    uint32_t const ry = (y & s) != 0 ? 1 : 0;
+    key += s * s * ((3 * rx) ^ ry);
+    if (ry == 0)
+    {
+      if (rx == 1)
+      {
+        x = ~x;
+        y = ~y;
+      }
+      swap(x, y);
+    }
+  }
+  return key;
+}
+
+double GetSquareDistToRect(m2::PointD const & p, m2::RectD const & r)
+{
+  double const dx = max(max(r.minX() - p.x, p.x - r.maxX()), 0.0);
+  double const dy = max(max(r.minY() - p.y, p.y - r.maxY()), 0.0);
+  return dx * dx + dy * dy;
+}
+}  // namespace
+
+SegmentIndex::SegmentIndex(vector<Segment> const & segments)
+{
+  m_leaves.reserve(segments.size());
+  vector<uint64_t> keys;
+  keys.reserve(segments.size());
+  for (Segment const & s : segments)
+  {
+    Leaf const leaf = {PointD2PointU(s.m_p0, POINT_COORD_BITS),
+                       PointD2PointU(s.m_p1, POINT_COORD_BITS), s.m_fid, s.m_segIdx};
+    m_leaves.push_back(leaf);
+    keys.push_back(GetHilbertKey(m2::PointU(leaf.m_p0.x / 2 + leaf.m_p1.x / 2,
+                                            leaf.m_p0.y / 2 + leaf.m_p1.y / 2)));
+  }
+
+  vector<uint32_t> order(m_leaves.size());
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(), [&keys](uint32_t l, uint32_t r) { return keys[l] < keys[r]; });
+  vector<Leaf> sorted;
+  sorted.reserve(m_leaves.size());
+  for (uint32_t i : order)
+    sorted.push_back(m_leaves[i]);
+  m_leaves.swap(sorted);
+
+  if (m_leaves.empty())
+    return;
+
+  vector<m2::RectD> level;
+  for (size_t i = 0; i < m_leaves.size(); i += kFanout)
+  {
+    m2::RectD rect;
+    for (size_t j = i; j < min(i + kFanout, m_leaves.size()); ++j)
+    {
+      rect.Add(PointU2PointD(m_leaves[j].m_p0, POINT_COORD_BITS));
+      rect.Add(PointU2PointD(m_leaves[j].m_p1, POINT_COORD_BITS));
+    }
+    level.push_back(rect);
+  }
+  m_levels.push_back(move(level));
+
+  while (m_levels.back().size() > 1)
+  {
+    vector<m2::RectD> const & children = m_levels.back();
+    vector<m2::RectD> parents;
+    for (size_t i = 0; i < children.size(); i += kFanout)
+    {
+      m2::RectD rect;
+      for (size_t j = i; j < min(i + kFanout, children.size()); ++j)
+        rect.Add(children[j]);
+      parents.push_back(rect);
+    }
+    m_levels.push_back(move(parents));
+  }
+}
+
+void SegmentIndex::FindNearest(m2::PointD const & point, size_t k, double maxDist,
+                               bool distinctFeatures, vector<Result> & res) const
+{
+  vector<QueueItem> queue;
+  FindNearest(point, k, maxDist, distinctFeatures, queue, res);
+}
+
+void SegmentIndex::FindNearest(vector<m2::PointD> const & points, size_t k, double maxDist,
+                               bool distinctFeatures, vector<vector<Result>> & res) const
+{
+  vector<uint64_t> keys;
+  keys.reserve(points.size());
+  for (m2::PointD const & p : points)
+    keys.push_back(GetHilbertKey(PointD2PointU(p, POINT_COORD_BITS)));
+  vector<uint32_t> order(points.size());
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(), [&keys](uint32_t l, uint32_t r) { return keys[l] < keys[r]; });
+
+  res.assign(points.size(), vector<Result>());
+  vector<QueueItem> queue;
+  for (uint32_t i : order)
+    FindNearest(points[i], k, maxDist, distinctFeatures, queue, res[i]);
+}
+
+void SegmentIndex::FindNearest(m2::PointD const & point, size_t k, double maxDist,
+                               bool distinctFeatures, vector<QueueItem> & queue,
+                               vector<Result> & res) const
+{
+  res.clear();
+  if (m_levels.empty() || k == 0)
+    return;
+
+  double const maxSquareDist = maxDist * maxDist;
+  auto const push = [&](QueueItem const & item)
+  {
+    if (item.m_squareDist > maxSquareDist)
+      return;
+    queue.push_back(item);
+    push_heap(queue.begin(), queue.end());
+  };
+
+  auto const project = [&point](Leaf const & leaf)
+  {
+    m2::ProjectionToSection<m2::PointD> segProj;
+    segProj.SetBounds(PointU2PointD(leaf.m_p0, POINT_COORD_BITS),
+                      PointU2PointD(leaf.m_p1, POINT_COORD_BITS));
+    return segProj(point);
+  };
+
+  queue.clear();
+  uint32_t const rootLevel = static_cast<uint32_t>(m_levels.size() - 1);
+  push({GetSquareDistToRect(point, m_levels[rootLevel][0]), rootLevel, 0});
+
+  // Items are popped in ascending order of distances, and a distance of a node is not greater
+  // than distances of its leaves, so leaves are popped in ascending order of distances.
+  while (!queue.empty() && res.size() < k)
+  {
+    pop_heap(queue.begin(), queue.end());
+    QueueItem const item = queue.back();
+    queue.pop_back();
+
+    if (item.m_level == kLeafLevel)
+    {
+      Leaf const & leaf = m_leaves[item.m_index];
+      if (distinctFeatures && any_of(res.begin(), res.end(), [&leaf](Result const & r)
+                                     {
+                                       return r.m_fid == leaf.m_fid;
+                                     }))
+      {
+        continue;
+      }
+      res.push_back({leaf.m_fid, leaf.m_segIdx, project(leaf), item.m_squareDist});
+      continue;
+    }
+
+    size_t const childrenCount = item.m_level == 0 ? m_leaves.size()
+                                                   : m_levels[item.m_level - 1].size();
+    size_t const end = min((item.m_index + 1) * kFanout, childrenCount);
+    for (size_t i = item.m_index * kFanout; i < end; ++i)
+    {
+      uint32_t const index = static_cast<uint32_t>(i);
+      if (item.m_level == 0)
+      {
+        push({point.SquareLength(project(m_leaves[i])), kLeafLevel, index});
+      }
+      else
+      {
+        push({GetSquareDistToRect(point, m_levels[item.m_level - 1][i]), item.m_level - 1, index});
+      }
+    }
+  }
+}
+
+size_t SegmentIndex::GetMemoryBytes() const
+{
+  size_t bytes = m_leaves.capacity() * sizeof(Leaf);
+  for (auto const & level : m_levels)
+    bytes += level.capacity() * sizeof(m2::RectD);
+  return bytes;
+}
+}  // namespace routing
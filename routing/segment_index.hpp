@@ -0,0 +1,93 @@
+#pragma once
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace routing
+{
+/// Static spatial index of road segments of one mwm for fast snapping of points to roads.
+/// It's a packed R-tree: segments are sorted along the Hilbert curve by their middle points
+/// and every kFanout consecutive segments (nodes) are grouped into a parent node. Leaves keep
+/// quantised coordinates of segments, so no feature is read while searching.
+/// The index is read-only after construction and may be used by several threads at once.
+class SegmentIndex
+{
+public:
+  static size_t constexpr kFanout = 16;
+
+  struct Segment
+  {
+    Segment() = default;
+    Segment(uint32_t fid, uint32_t segIdx, m2::PointD const & p0, m2::PointD const & p1)
+      : m_fid(fid), m_segIdx(segIdx), m_p0(p0), m_p1(p1)
+    {
+    }
+
+    uint32_t m_fid = 0;
+    /// Segment is between points m_segIdx and m_segIdx + 1 of the feature.
+    uint32_t m_segIdx = 0;
+    m2::PointD m_p0;
+    m2::PointD m_p1;
+  };
+
+  struct Result
+  {
+    uint32_t m_fid;
+    uint32_t m_segIdx;
+    /// Projection of the query point to the segment.
+    m2::PointD m_point;
+    /// Square distance from the query point to m_point in mercator.
+    double m_squareDist;
+  };
+
+  explicit SegmentIndex(vector<Segment> const & segments);
+
+  /// Finds at most k segments nearest to the point, sorted by distance.
+  /// @param maxDist Segments further than maxDist in mercator are skipped.
+  /// @param distinctFeatures If true, only the nearest segment of every feature is found.
+  void FindNearest(m2::PointD const & point, size_t k, double maxDist, bool distinctFeatures,
+                   vector<Result> & res) const;
+
+  /// Batched version of FindNearest: points are processed along the Hilbert curve, so
+  /// neighbouring queries reuse hot nodes of the tree. res[i] are results of points[i].
+  void FindNearest(vector<m2::PointD> const & points, size_t k, double maxDist,
+                   bool distinctFeatures, vector<vector<Result>> & res) const;
+
+  size_t GetSegmentsCount() const { return m_leaves.size(); }
+
+  size_t GetMemoryBytes() const;
+
+private:
+  struct Leaf
+  {
+    m2::PointU m_p0;
+    m2::PointU m_p1;
+    uint32_t m_fid;
+    uint32_t m_segIdx;
+  };
+
+  /// Item of the best-first search queue: a node of a level or a leaf if m_level == kLeafLevel.
+  struct QueueItem
+  {
+    double m_squareDist;
+    uint32_t m_level;
+    uint32_t m_index;
+
+    bool operator<(QueueItem const & rhs) const { return m_squareDist > rhs.m_squareDist; }
+  };
+
+  static uint32_t constexpr kLeafLevel = static_cast<uint32_t>(-1);
+
+  void FindNearest(m2::PointD const & point, size_t k, double maxDist, bool distinctFeatures,
+                   vector<QueueItem> & queue, vector<Result> & res) const;
+
+  vector<Leaf> m_leaves;
+  /// m_levels[0] are boxes of groups of leaves, m_levels.back() is the root.
+  /// Node i of a level covers children [i * kFanout, (i + 1) * kFanout) of the level below.
+  vector<vector<m2::RectD>> m_levels;
+};
+}  // namespace routing
@@ -24,7 +24,7 @@ namespace routing
 {
 uint8_t const kNoSpeedCamera = numeric_limits<uint8_t>::max();
 
-uint8_t ReadCameraRestriction(FeatureType & ft)
+uint8_t ReadCameraRestriction(FeatureType const & ft)
 {
   using feature::Metadata;
   ft.ParseMetadata();
@@ -42,7 +42,8 @@ uint8_t CheckCameraInPoint(m2::PointD const & point, Index const & index)
 {
   uint32_t speedLimit = kNoSpeedCamera;
 
-  auto const f = [&point, &speedLimit](FeatureType & ft)
+  // Cameras are rare, so only types and centers of points are decoded for most features.
+  auto const f = [&point, &speedLimit](FeatureView const & ft)
   {
     if (ft.GetFeatureType() != feature::GEOM_POINT)
       return;
@@ -53,13 +54,13 @@ uint8_t CheckCameraInPoint(m2::PointD const & point, Index const & index)
 
     if (my::AlmostEqualAbs(ft.GetCenter().x, point.x, kCoordinateEqualityDelta) &&
         my::AlmostEqualAbs(ft.GetCenter().y, point.y, kCoordinateEqualityDelta))
-      speedLimit = ReadCameraRestriction(ft);
+      speedLimit = ReadCameraRestriction(ft.GetFeature());
   };
 
-  index.ForEachInRect(f,
-                      MercatorBounds::RectByCenterXYAndSizeInMeters(point,
-                                                                    kCameraCheckRadiusMeters),
-                      scales::GetUpperScale());
+  index.ForEachViewInRect(f,
+                          MercatorBounds::RectByCenterXYAndSizeInMeters(point,
+                                                                        kCameraCheckRadiusMeters),
+                          scales::GetUpperScale());
   return speedLimit;
 }
 }  // namespace routing
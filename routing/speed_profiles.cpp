@@ -0,0 +1,284 @@
+#include "routing/speed_profiles.hpp"
+
+#include "routing/osrm2feature_map.hpp"
+
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstring.hpp"
+#include "std/limits.hpp"
+
+#include "defines.hpp"
+
+namespace routing
+{
+namespace
+{
+// Weights have to be positive, so closed roads are very slow.
+uint8_t constexpr kMinSpeedPercent = 1;
+
+class WeightsCustomizer
+{
+public:
+  WeightsCustomizer(TRawDataFacade const & facade, vector<double> const & nodeFactors,
+                    vector<uint32_t> & weights)
+    : m_facade(facade), m_nodeFactors(nodeFactors), m_weights(weights)
+  {
+  }
+
+  void Customize()
+  {
+    m_weights.assign(m_facade.GetNumberOfEdges(), 0);
+    for (NodeID node = 0; node < m_facade.GetNumberOfNodes(); ++node)
+    {
+      for (auto const e : m_facade.GetAdjacentEdgeRange(node))
+        GetWeight(e, node);
+    }
+  }
+
+private:
+  uint32_t GetWeight(EdgeID e, NodeID node)
+  {
+    if (m_weights[e] != 0)
+      return m_weights[e];
+
+    QueryEdge::EdgeData const data = m_facade.GetEdgeData(e, node);
+    NodeID const target = m_facade.GetTarget(e);
+    NodeID const from = data.forward ? node : target;
+    NodeID const to = data.forward ? target : node;
+    uint32_t weight = 0;
+    if (data.shortcut)
+    {
+      weight = GetHalfWeight(from, data.id) + GetHalfWeight(data.id, to);
+    }
+    else
+    {
+      ASSERT_LESS(from, m_nodeFactors.size(), ());
+      weight = max(static_cast<uint32_t>(data.distance / m_nodeFactors[from] + 0.5), 1u);
+    }
+    m_weights[e] = weight;
+    return weight;
+  }
+
+  /// @return Weight of the edge from -> to which BasicRoutingInterface::UnpackEdge chooses.
+  uint32_t GetHalfWeight(NodeID from, NodeID to)
+  {
+    uint32_t weight = numeric_limits<uint32_t>::max();
+    for (auto const e : m_facade.GetAdjacentEdgeRange(from))
+    {
+      if (m_facade.GetTarget(e) == to && m_facade.GetEdgeData(e, from).forward)
+        weight = min(weight, GetWeight(e, from));
+    }
+    if (weight != numeric_limits<uint32_t>::max())
+      return weight;
+
+    for (auto const e : m_facade.GetAdjacentEdgeRange(to))
+    {
+      if (m_facade.GetTarget(e) == from && m_facade.GetEdgeData(e, to).backward)
+        weight = min(weight, GetWeight(e, to));
+    }
+    ASSERT_NOT_EQUAL(weight, numeric_limits<uint32_t>::max(), (from, to));
+    return weight;
+  }
+
+  TRawDataFacade const & m_facade;
+  vector<double> const & m_nodeFactors;
+  vector<uint32_t> & m_weights;
+};
+}  // namespace
+
+// static
+uint32_t constexpr SpeedProfiles::kVersion;
+uint32_t constexpr SpeedProfiles::kBucketsCount;
+uint32_t constexpr SpeedProfiles::kWeekSec;
+uint32_t constexpr SpeedProfiles::kBucketSec;
+
+bool SpeedProfiles::Load(FilesMappingContainer const & container)
+{
+  Clear();
+  if (!container.IsExist(ROUTING_SPEED_PROFILES_FILE_TAG))
+    return false;
+
+  FilesMappingContainer::Handle handle(container.Map(ROUTING_SPEED_PROFILES_FILE_TAG));
+  if (!handle.IsValid() || handle.GetSize() < sizeof(Header))
+    return false;
+
+  char const * data = handle.GetData<char>();
+  Header header;
+  memcpy(&header, data, sizeof(header));
+  if (header.m_version != kVersion || header.m_bucketsCount != kBucketsCount)
+  {
+    LOG(LWARNING, ("Unsupported speed profiles, version:", header.m_version, "buckets:",
+                   header.m_bucketsCount));
+    return false;
+  }
+
+  uint64_t const profilesBytes = static_cast<uint64_t>(header.m_profilesCount) * kBucketsCount;
+  uint64_t const size = sizeof(Header) + profilesBytes +
+                        static_cast<uint64_t>(header.m_featuresCount) *
+                            (sizeof(uint32_t) + sizeof(uint16_t));
+  if (handle.GetSize() != size)
+  {
+    LOG(LWARNING, ("Wrong size of speed profiles:", handle.GetSize(), "expected:", size));
+    return false;
+  }
+
+  data += sizeof(Header);
+  m_profiles = reinterpret_cast<uint8_t const *>(data);
+  m_featureIds = reinterpret_cast<uint32_t const *>(data + profilesBytes);
+  m_profileIndexes = reinterpret_cast<uint16_t const *>(m_featureIds + header.m_featuresCount);
+  m_header = header;
+  m_handle.Assign(move(handle));
+  return true;
+}
+
+void SpeedProfiles::Clear()
+{
+  m_handle.Unmap();
+  m_header = {kVersion, kBucketsCount, 0, 0};
+  m_profiles = nullptr;
+  m_featureIds = nullptr;
+  m_profileIndexes = nullptr;
+}
+
+double SpeedProfiles::GetSpeedFactor(uint32_t featureId, uint32_t bucket) const
+{
+  ASSERT_LESS(bucket, kBucketsCount, ());
+  uint32_t const * end = m_featureIds + m_header.m_featuresCount;
+  uint32_t const * it = lower_bound(m_featureIds, end, featureId);
+  if (it == end || *it != featureId)
+    return 1.0;
+
+  uint16_t const profile = m_profileIndexes[it - m_featureIds];
+  ASSERT_LESS(profile, m_header.m_profilesCount, ());
+  uint8_t const speed = m_profiles[static_cast<size_t>(profile) * kBucketsCount + bucket];
+  return max(speed, kMinSpeedPercent) / 100.0;
+}
+
+void SpeedProfilesBuilder::SetProfile(uint32_t featureId, SpeedProfiles::TProfile const & profile)
+{
+  m_profiles[featureId] = profile;
+}
+
+void SpeedProfilesBuilder::Serialize(Writer & writer) const
+{
+  map<SpeedProfiles::TProfile, uint16_t> indexes;
+  vector<SpeedProfiles::TProfile const *> profiles;
+  vector<uint16_t> featureProfiles;
+  featureProfiles.reserve(m_profiles.size());
+  for (auto const & p : m_profiles)
+  {
+    auto it = indexes.find(p.second);
+    if (it == indexes.end())
+    {
+      CHECK_LESS_OR_EQUAL(profiles.size(), numeric_limits<uint16_t>::max(),
+                          ("Too many different speed profiles."));
+      it = indexes.emplace(p.second, static_cast<uint16_t>(profiles.size())).first;
+      profiles.push_back(&p.second);
+    }
+    featureProfiles.push_back(it->second);
+  }
+
+  WriteToSink(writer, SpeedProfiles::kVersion);
+  WriteToSink(writer, SpeedProfiles::kBucketsCount);
+  WriteToSink(writer, static_cast<uint32_t>(profiles.size()));
+  WriteToSink(writer, static_cast<uint32_t>(m_profiles.size()));
+  for (auto const * profile : profiles)
+    writer.Write(profile->data(), profile->size());
+  for (auto const & p : m_profiles)
+    WriteToSink(writer, p.first);
+  for (uint16_t const index : featureProfiles)
+    WriteToSink(writer, index);
+}
+
+void MakeNodeSpeedFactors(OsrmFtSegMapping const & mapping, SpeedProfiles const & profiles,
+                          uint32_t bucket, uint32_t nodesCount, vector<double> & factors)
+{
+  factors.assign(nodesCount, 1.0);
+  for (TOsrmNodeId node = 0; node < nodesCount; ++node)
+  {
+    double sum = 0.0;
+    size_t count = 0;
+    mapping.ForEachFtSeg(node, [&](OsrmMappingTypes::FtSeg const & seg)
+    {
+      sum += profiles.GetSpeedFactor(seg.m_fid, bucket);
+      ++count;
+    });
+    if (count != 0)
+      factors[node] = sum / count;
+  }
+}
+
+void CustomizeEdgeWeights(TRawDataFacade const & facade, vector<double> const & nodeFactors,
+                          vector<uint32_t> & weights)
+{
+  ASSERT(!facade.HasCustomEdgeWeights(), ());
+  WeightsCustomizer(facade, nodeFactors, weights).Customize();
+}
+// static
+uint32_t constexpr SpeedProfilesBucketLock::kAnyBucket;
+
+SpeedProfilesBucketLock::SpeedProfilesBucketLock(TCustomizeFn const & customizeFn)
+  : m_customizeFn(customizeFn)
+{
+}
+
+void SpeedProfilesBucketLock::Acquire(uint32_t bucket)
+{
+  unique_lock<mutex> lock(m_mutex);
+  bool waiting = false;
+  while (true)
+  {
+    bool const current = bucket == kAnyBucket || bucket == m_bucket;
+    if (!m_customizing)
+    {
+      if (current && (waiting || m_waitingCount == 0))
+        break;
+      if (!current && m_holdersCount == 0)
+      {
+        m_customizing = true;
+        lock.unlock();
+        m_customizeFn(bucket);
+        lock.lock();
+        m_customizing = false;
+        m_bucket = bucket;
+        m_cv.notify_all();
+        break;
+      }
+    }
+    if (!current && !waiting)
+    {
+      waiting = true;
+      ++m_waitingCount;
+    }
+    m_cv.wait(lock);
+  }
+
+  if (waiting)
+  {
+    --m_waitingCount;
+    if (m_waitingCount == 0)
+      m_cv.notify_all();
+  }
+  ++m_holdersCount;
+}
+
+void SpeedProfilesBucketLock::Release()
+{
+  lock_guard<mutex> lock(m_mutex);
+  ASSERT_GREATER(m_holdersCount, 0, ());
+  --m_holdersCount;
+  if (m_holdersCount == 0)
+    m_cv.notify_all();
+}
+
+uint32_t SpeedProfilesBucketLock::GetBucket() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_bucket;
+}
+}  // namespace routing
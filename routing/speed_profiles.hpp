@@ -0,0 +1,140 @@
+#pragma once
+
+#include "routing/osrm_engine.hpp"
+
+#include "coding/file_container.hpp"
+
+#include "std/array.hpp"
+#include "std/condition_variable.hpp"
+#include "std/cstdint.hpp"
+#include "std/function.hpp"
+#include "std/limits.hpp"
+#include "std/map.hpp"
+#include "std/mutex.hpp"
+#include "std/vector.hpp"
+
+class Writer;
+
+namespace routing
+{
+class OsrmFtSegMapping;
+
+/// Weekly speed profiles of roads mapped from the ROUTING_SPEED_PROFILES_FILE_TAG section of
+/// a routing file. A profile has kBucketsCount buckets of equal duration starting on Monday
+/// 00:00 of the local time, a bucket keeps the speed in percents of the free flow speed which
+/// OSRM weights are made for. Equal profiles are stored once.
+/// Section layout: header, profiles by kBucketsCount bytes, sorted ids of features with profiles
+/// and uint16_t indexes of their profiles.
+class SpeedProfiles
+{
+public:
+  static uint32_t constexpr kVersion = 0;
+  static uint32_t constexpr kBucketsCount = 96;
+  static uint32_t constexpr kWeekSec = 7 * 24 * 60 * 60;
+  static uint32_t constexpr kBucketSec = kWeekSec / kBucketsCount;
+
+  using TProfile = array<uint8_t, kBucketsCount>;
+
+  struct Header
+  {
+    uint32_t m_version;
+    uint32_t m_bucketsCount;
+    uint32_t m_profilesCount;
+    uint32_t m_featuresCount;
+  };
+
+  /// @param weekTimeSec Seconds since Monday 00:00.
+  static uint32_t GetBucket(uint32_t weekTimeSec) { return weekTimeSec % kWeekSec / kBucketSec; }
+
+  /// @return false if the container has no valid section.
+  bool Load(FilesMappingContainer const & container);
+  void Clear();
+
+  bool IsLoaded() const { return m_handle.IsValid(); }
+  uint32_t GetProfilesCount() const { return m_header.m_profilesCount; }
+  uint32_t GetFeaturesCount() const { return m_header.m_featuresCount; }
+
+  /// @return Ratio of the speed of the feature in the bucket to the free flow speed, 1.0 if
+  /// the feature has no profile.
+  double GetSpeedFactor(uint32_t featureId, uint32_t bucket) const;
+
+private:
+  FilesMappingContainer::Handle m_handle;
+  Header m_header = {kVersion, kBucketsCount, 0, 0};
+  uint8_t const * m_profiles = nullptr;
+  uint32_t const * m_featureIds = nullptr;
+  uint16_t const * m_profileIndexes = nullptr;
+};
+
+class SpeedProfilesBuilder
+{
+public:
+  void SetProfile(uint32_t featureId, SpeedProfiles::TProfile const & profile);
+
+  /// Writes the section, see SpeedProfiles.
+  void Serialize(Writer & writer) const;
+
+private:
+  map<uint32_t, SpeedProfiles::TProfile> m_profiles;
+};
+
+/// Makes speed factors of OSRM nodes for the bucket, a factor of a node is the mean of factors
+/// of its feature segments.
+void MakeNodeSpeedFactors(OsrmFtSegMapping const & mapping, SpeedProfiles const & profiles,
+                          uint32_t bucket, uint32_t nodesCount, vector<double> & factors);
+
+/// Customizes weights of the contraction hierarchy of the facade for speed factors of nodes
+/// without rebuilding it: a weight of an edge is divided by the factor of its source node and
+/// a weight of a shortcut is the sum of weights of its halves. Shortcuts which weren't needed
+/// for original weights aren't added, so routes may be a bit longer than the shortest ones.
+/// Weights are taken from the facade, so it must have no custom weights.
+/// @param weights Weights of edges for OsrmRawDataFacade::SetEdgeWeights.
+void CustomizeEdgeWeights(TRawDataFacade const & facade, vector<double> const & nodeFactors,
+                          vector<uint32_t> & weights);
+
+/// Lets routers share facades customized for one bucket at a time. The bucket is changed when
+/// no router holds the lock, routers of other buckets wait meanwhile. Routers of the current
+/// bucket wait too while there are routers of other buckets, so no bucket starves.
+/// A holder must not acquire the lock for another bucket, it would wait for itself.
+class SpeedProfilesBucketLock
+{
+public:
+  /// Any bucket may be acquired, the current one is used then.
+  static uint32_t constexpr kAnyBucket = numeric_limits<uint32_t>::max();
+
+  /// Customizes facades for a bucket, it's called without other holders of the lock.
+  using TCustomizeFn = function<void(uint32_t bucket)>;
+
+  explicit SpeedProfilesBucketLock(TCustomizeFn const & customizeFn);
+
+  void Acquire(uint32_t bucket);
+  void Release();
+
+  /// @return kAnyBucket if facades weren't customized yet.
+  uint32_t GetBucket() const;
+
+private:
+  TCustomizeFn const m_customizeFn;
+
+  mutable mutex m_mutex;
+  condition_variable m_cv;
+  uint32_t m_bucket = kAnyBucket;
+  uint32_t m_holdersCount = 0;
+  // Number of routers waiting for other buckets than the current one.
+  uint32_t m_waitingCount = 0;
+  bool m_customizing = false;
+};
+
+class SpeedProfilesBucketGuard
+{
+public:
+  SpeedProfilesBucketGuard(SpeedProfilesBucketLock & lock, uint32_t bucket) : m_lock(lock)
+  {
+    m_lock.Acquire(bucket);
+  }
+  ~SpeedProfilesBucketGuard() { m_lock.Release(); }
+
+private:
+  SpeedProfilesBucketLock & m_lock;
+};
+}  // namespace routing
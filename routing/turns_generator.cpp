@@ -10,11 +10,14 @@
 #include "geometry/angles.hpp"
 
 #include "base/macros.hpp"
+#include "base/parallel_for_pool.hpp"
+#include "base/stl_add.hpp"
 
 #include "3party/osrm/osrm-backend/data_structures/internal_route_result.hpp"
 
 #include "std/numeric.hpp"
 #include "std/string.hpp"
+#include "std/unique_ptr.hpp"
 
 
 using namespace routing;
@@ -27,6 +30,9 @@ size_t constexpr kMaxPointsCount = 5;
 double constexpr kMinDistMeters = 200.;
 size_t constexpr kNotSoCloseMaxPointsCount = 3;
 double constexpr kNotSoCloseMinDistMeters = 30.;
+// Ranges of segments are small enough to balance postprocessing threads and big enough
+// to let a thread find features of adjacent segments in its cache.
+size_t constexpr kPostprocessingRangeSize = 64;
 
 typedef vector<double> TGeomTurnCandidate;
 
@@ -113,17 +119,14 @@ OsrmMappingTypes::FtSeg GetSegment(NodeID node, RoutingMapping const & routingMa
 
 ftypes::HighwayClass GetOutgoingHighwayClass(NodeID outgoingNode,
                                              RoutingMapping const & routingMapping,
-                                             Index const & index)
+                                             FeaturesCache & cache)
 {
   OsrmMappingTypes::FtSeg const seg =
       GetSegment(outgoingNode, routingMapping, GetFirstSegmentPointIndex);
   if (!seg.IsValid())
     return ftypes::HighwayClass::Error;
 
-  Index::FeaturesLoaderGuard loader(index, routingMapping.GetMwmId());
-  FeatureType ft;
-  loader.GetFeatureByIndex(seg.m_fid, ft);
-  return ftypes::GetHighwayClass(ft);
+  return cache.GetRoad(seg.m_fid).m_highwayClass;
 }
 
 /*!
@@ -133,8 +136,8 @@ ftypes::HighwayClass GetOutgoingHighwayClass(NodeID outgoingNode,
  * - and the turn is GoStraight or TurnSlight*.
  */
 bool KeepTurnByHighwayClass(TurnDirection turn, TTurnCandidates const & possibleTurns,
-                            TurnInfo const & turnInfo, Index const & index,
-                            RoutingMapping & mapping)
+                            TurnInfo const & turnInfo, RoutingMapping & mapping,
+                            FeaturesCache & cache)
 {
   if (!IsGoStraightOrSlightTurn(turn))
     return true;  // The road significantly changes its direction here. So this turn shall be kept.
@@ -148,7 +151,7 @@ bool KeepTurnByHighwayClass(TurnDirection turn, TTurnCandidates const & possible
   {
     if (t.node == turnInfo.m_outgoing.m_nodeId)
       continue;
-    ftypes::HighwayClass const highwayClass = GetOutgoingHighwayClass(t.node, mapping, index);
+    ftypes::HighwayClass const highwayClass = GetOutgoingHighwayClass(t.node, mapping, cache);
     if (static_cast<int>(highwayClass) > static_cast<int>(maxClassForPossibleTurns))
       maxClassForPossibleTurns = highwayClass;
   }
@@ -359,7 +362,7 @@ m2::PointD GetPointForTurn(vector<m2::PointD> const & path, m2::PointD const & j
 // So, to determine we must read the nearest geometry and check its adjacency by OSRM road graph.
 void GetPossibleTurns(Index const & index, NodeID node, m2::PointD const & ingoingPoint,
                       m2::PointD const & junctionPoint, RoutingMapping & routingMapping,
-                      TTurnCandidates & candidates)
+                      FeaturesCache & cache, TTurnCandidates & candidates)
 {
   double const kReadCrossEpsilon = 1.0E-4;
 
@@ -410,14 +413,10 @@ void GetPossibleTurns(Index const & index, NodeID node, m2::PointD const & ingoi
     if (!seg.IsValid())
       continue;
 
-    FeatureType ft;
-    Index::FeaturesLoaderGuard loader(index, routingMapping.GetMwmId());
-    loader.GetFeatureByIndex(seg.m_fid, ft);
-    ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
-
-    m2::PointD const outgoingPoint = ft.GetPoint(
-        seg.m_pointStart < seg.m_pointEnd ? seg.m_pointStart + 1 : seg.m_pointStart - 1);
-    ASSERT_LESS(MercatorBounds::DistanceOnEarth(junctionPoint, ft.GetPoint(seg.m_pointStart)),
+    vector<m2::PointD> const & points = cache.GetRoad(seg.m_fid).m_points;
+    m2::PointD const outgoingPoint =
+        points[seg.m_pointStart < seg.m_pointEnd ? seg.m_pointStart + 1 : seg.m_pointStart - 1];
+    ASSERT_LESS(MercatorBounds::DistanceOnEarth(junctionPoint, points[seg.m_pointStart]),
                 kFeaturesNearTurnMeters, ());
 
     double const a = my::RadToDeg(PiMinusTwoVectorsAngle(junctionPoint, ingoingPoint, outgoingPoint));
@@ -447,7 +446,60 @@ namespace turns
 {
 using TSeg = OsrmMappingTypes::FtSeg;
 
-LoadedPathSegment::LoadedPathSegment(RoutingMapping & mapping, Index const & index,
+FeaturesCache::FeaturesCache(Index const & index, MwmSet::MwmId const & mwmId)
+  : m_loader(index, mwmId)
+{
+}
+
+FeaturesCache::Road const & FeaturesCache::GetRoad(uint32_t featureId)
+{
+  auto const it = m_roads.find(featureId);
+  if (it != m_roads.end())
+    return it->second;
+
+  FeatureType ft;
+  m_loader.GetFeatureByIndex(featureId, ft);
+  ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+
+  Road & road = m_roads[featureId];
+  size_t const count = ft.GetPointsCount();
+  road.m_points.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    road.m_points.push_back(ft.GetPoint(i));
+  road.m_highwayClass = ftypes::GetHighwayClass(ft);
+  road.m_isRoundabout = ftypes::IsRoundAboutChecker::Instance()(ft);
+  road.m_isLink = ftypes::IsLinkChecker::Instance()(ft);
+  ft.GetName(FeatureType::DEFAULT_LANG, road.m_name);
+  return road;
+}
+
+string FeaturesCache::GetLanes(uint32_t featureId, bool isForward)
+{
+  using feature::Metadata;
+
+  FeatureType ft;
+  m_loader.GetFeatureByIndex(featureId, ft);
+  ft.ParseMetadata();
+
+  auto directionType = Metadata::FMD_TURN_LANES;
+  if (!ftypes::IsOneWayChecker::Instance()(ft))
+  {
+    directionType =
+        isForward ? Metadata::FMD_TURN_LANES_FORWARD : Metadata::FMD_TURN_LANES_BACKWARD;
+  }
+  return ft.GetMetadata().Get(directionType);
+}
+
+LoadedPathSegment::LoadedPathSegment()
+  : m_highwayClass(ftypes::HighwayClass::Undefined)
+  , m_onRoundabout(false)
+  , m_isLink(false)
+  , m_weight(0)
+  , m_nodeId(SPECIAL_NODEID)
+{
+}
+
+LoadedPathSegment::LoadedPathSegment(FeaturesCache & cache, TFtSegs const & segments,
                                      RawPathData const & osrmPathSegment)
   : m_highwayClass(ftypes::HighwayClass::Undefined)
   , m_onRoundabout(false)
@@ -455,14 +507,12 @@ LoadedPathSegment::LoadedPathSegment(RoutingMapping & mapping, Index const & ind
   , m_weight(osrmPathSegment.segmentWeight)
   , m_nodeId(osrmPathSegment.node)
 {
-  buffer_vector<TSeg, 8> buffer;
-  mapping.m_segMapping.ForEachFtSeg(osrmPathSegment.node, MakeBackInsertFunctor(buffer));
-  LoadPathGeometry(buffer, 0, buffer.size(), index, mapping, FeatureGraphNode(), FeatureGraphNode(),
+  LoadPathGeometry(segments, 0, segments.size(), cache, FeatureGraphNode(), FeatureGraphNode(),
                    false /* isStartNode */, false /*isEndNode*/);
 }
 
-void LoadedPathSegment::LoadPathGeometry(buffer_vector<TSeg, 8> const & buffer, size_t startIndex,
-                                         size_t endIndex, Index const & index, RoutingMapping & mapping,
+void LoadedPathSegment::LoadPathGeometry(TFtSegs const & buffer, size_t startIndex,
+                                         size_t endIndex, FeaturesCache & cache,
                                          FeatureGraphNode const & startGraphNode,
                                          FeatureGraphNode const & endGraphNode, bool isStartNode,
                                          bool isEndNode)
@@ -478,11 +528,8 @@ void LoadedPathSegment::LoadPathGeometry(buffer_vector<TSeg, 8> const & buffer,
       m_path.clear();
       return;
     }
-    // Load data from drive.
-    FeatureType ft;
-    Index::FeaturesLoaderGuard loader(index, mapping.GetMwmId());
-    loader.GetFeatureByIndex(segment.m_fid, ft);
-    ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+    // Load data from drive or from the cache.
+    FeaturesCache::Road const & road = cache.GetRoad(segment.m_fid);
 
     // Get points in proper direction.
     auto startIdx = segment.m_pointStart;
@@ -496,43 +543,28 @@ void LoadedPathSegment::LoadPathGeometry(buffer_vector<TSeg, 8> const & buffer,
     if (startIdx < endIdx)
     {
       for (auto idx = startIdx; idx <= endIdx; ++idx)
-        m_path.push_back(ft.GetPoint(idx));
+        m_path.push_back(road.m_points[idx]);
     }
     else
     {
       // I use big signed type because endIdx can be 0.
       for (int64_t idx = startIdx; idx >= static_cast<int64_t>(endIdx); --idx)
-        m_path.push_back(ft.GetPoint(idx));
+        m_path.push_back(road.m_points[idx]);
     }
 
     // Load lanes if it is a last segment before junction.
     if (buffer.back() == segment)
-    {
-      using feature::Metadata;
-      ft.ParseMetadata();
-      Metadata const & md = ft.GetMetadata();
-
-      auto directionType = Metadata::FMD_TURN_LANES;
-
-      if (!ftypes::IsOneWayChecker::Instance()(ft))
-      {
-        directionType = (startIdx < endIdx) ? Metadata::FMD_TURN_LANES_FORWARD
-                                            : Metadata::FMD_TURN_LANES_BACKWARD;
-      }
-      ParseLanes(md.Get(directionType), m_lanes);
-    }
+      ParseLanes(cache.GetLanes(segment.m_fid, startIdx < endIdx), m_lanes);
     // Calculate node flags.
-    m_onRoundabout |= ftypes::IsRoundAboutChecker::Instance()(ft);
-    m_isLink |= ftypes::IsLinkChecker::Instance()(ft);
-    m_highwayClass = ftypes::GetHighwayClass(ft);
-    string name;
-    ft.GetName(FeatureType::DEFAULT_LANG, name);
-    if (!name.empty())
-      m_name = name;
+    m_onRoundabout |= road.m_isRoundabout;
+    m_isLink |= road.m_isLink;
+    m_highwayClass = road.m_highwayClass;
+    if (!road.m_name.empty())
+      m_name = road.m_name;
   }
 }
 
-LoadedPathSegment::LoadedPathSegment(RoutingMapping & mapping, Index const & index,
+LoadedPathSegment::LoadedPathSegment(FeaturesCache & cache, TFtSegs const & segments,
                                      RawPathData const & osrmPathSegment,
                                      FeatureGraphNode const & startGraphNode,
                                      FeatureGraphNode const & endGraphNode, bool isStartNode,
@@ -546,8 +578,7 @@ LoadedPathSegment::LoadedPathSegment(RoutingMapping & mapping, Index const & ind
   ASSERT(isStartNode || isEndNode, ("This function process only corner cases."));
   if (!startGraphNode.segment.IsValid() || !endGraphNode.segment.IsValid())
     return;
-  buffer_vector<TSeg, 8> buffer;
-  mapping.m_segMapping.ForEachFtSeg(osrmPathSegment.node, MakeBackInsertFunctor(buffer));
+  TFtSegs const & buffer = segments;
 
   auto findIntersectingSeg = [&buffer](TSeg const & seg) -> size_t
   {
@@ -593,7 +624,7 @@ LoadedPathSegment::LoadedPathSegment(RoutingMapping & mapping, Index const & ind
 
   size_t startIndex = isStartNode ? findIntersectingSeg(startGraphNode.segment) : 0;
   size_t endIndex = isEndNode ? findIntersectingSeg(endGraphNode.segment) + 1 : buffer.size();
-  LoadPathGeometry(buffer, startIndex, endIndex, index, mapping, startGraphNode, endGraphNode, isStartNode,
+  LoadPathGeometry(buffer, startIndex, endIndex, cache, startGraphNode, endGraphNode, isStartNode,
                    isEndNode);
 }
 
@@ -805,8 +836,8 @@ TurnDirection IntermediateDirection(const double angle)
   return FindDirectionByAngle(kLowerBounds, angle);
 }
 
-void GetTurnDirection(Index const & index, RoutingMapping & mapping, TurnInfo & turnInfo,
-                      TurnItem & turn)
+void GetTurnDirection(Index const & index, RoutingMapping & mapping, FeaturesCache & cache,
+                      TurnInfo & turnInfo, TurnItem & turn)
 {
   if (!turnInfo.IsSegmentsValid())
     return;
@@ -838,7 +869,7 @@ void GetTurnDirection(Index const & index, RoutingMapping & mapping, TurnInfo &
   m2::PointD const ingoingPointOneSegment = turnInfo.m_ingoing.m_path[turnInfo.m_ingoing.m_path.size() - 2];
   TTurnCandidates nodes;
   GetPossibleTurns(index, turnInfo.m_ingoing.m_nodeId, ingoingPointOneSegment, junctionPoint,
-                   mapping, nodes);
+                   mapping, cache, nodes);
 
   size_t const numNodes = nodes.size();
   bool const hasMultiTurns = numNodes > 1;
@@ -860,7 +891,7 @@ void GetTurnDirection(Index const & index, RoutingMapping & mapping, TurnInfo &
       turn.m_turn = intermediateDirection;
   }
 
-  bool const keepTurnByHighwayClass =  KeepTurnByHighwayClass(turn.m_turn, nodes, turnInfo, index, mapping);
+  bool const keepTurnByHighwayClass =  KeepTurnByHighwayClass(turn.m_turn, nodes, turnInfo, mapping, cache);
   if (turnInfo.m_ingoing.m_onRoundabout || turnInfo.m_outgoing.m_onRoundabout)
   {
     turn.m_turn = GetRoundaboutDirection(turnInfo.m_ingoing.m_onRoundabout,
@@ -894,6 +925,66 @@ void GetTurnDirection(Index const & index, RoutingMapping & mapping, TurnInfo &
   }
 }
 
+void LoadPathSegmentsAndTurns(Index const & index, RoutingMapping & mapping,
+                              vector<RawPathData> const & path,
+                              FeatureGraphNode const & sourceEdge,
+                              FeatureGraphNode const & targetEdge, size_t maxThreadsCount,
+                              vector<LoadedPathSegment> & segments, vector<TurnItem> & turns)
+{
+  size_t const numSegments = path.size();
+  vector<TFtSegs> ftSegs(numSegments);
+  for (size_t i = 0; i < numSegments; ++i)
+    mapping.m_segMapping.ForEachFtSeg(path[i].node, MakeBackInsertFunctor(ftSegs[i]));
+
+  segments.assign(numSegments, LoadedPathSegment());
+  turns.assign(numSegments, TurnItem());
+
+  size_t const rangesCount =
+      (numSegments + kPostprocessingRangeSize - 1) / kPostprocessingRangeSize;
+  size_t threadsCount = min(maxThreadsCount, rangesCount);
+  // Touches of the facade are counted by one thread only.
+  if (threadsCount == 0 || mapping.m_dataFacade.IsTouchesCounting())
+    threadsCount = 1;
+
+  vector<unique_ptr<FeaturesCache>> caches(threadsCount);
+  for (auto & cache : caches)
+    cache = make_unique<FeaturesCache>(index, mapping.GetMwmId());
+
+  auto const classifyTurn = [&](size_t i, FeaturesCache & cache)
+  {
+    TurnInfo turnInfo(segments[i - 1], segments[i]);
+    GetTurnDirection(index, mapping, cache, turnInfo, turns[i]);
+  };
+
+  threads::ParallelForPool::Instance().ParallelFor(rangesCount, [&](size_t range, size_t slot)
+  {
+    size_t const begin = range * kPostprocessingRangeSize;
+    size_t const end = min(begin + kPostprocessingRangeSize, numSegments);
+    FeaturesCache & cache = *caches[slot];
+    for (size_t i = begin; i < end; ++i)
+    {
+      bool const isStartNode = (i == 0);
+      bool const isEndNode = (i == numSegments - 1);
+      if (isStartNode || isEndNode)
+      {
+        segments[i] = LoadedPathSegment(cache, ftSegs[i], path[i], sourceEdge, targetEdge,
+                                        isStartNode, isEndNode);
+      }
+      else
+      {
+        segments[i] = LoadedPathSegment(cache, ftSegs[i], path[i]);
+      }
+    }
+    // Features of junctions inside the range are in the cache of the thread already.
+    for (size_t i = begin + 1; i < end; ++i)
+      classifyTurn(i, cache);
+  }, threadsCount);
+
+  // Junctions between ranges need segments loaded by different threads.
+  for (size_t i = kPostprocessingRangeSize; i < numSegments; i += kPostprocessingRangeSize)
+    classifyTurn(i, *caches.front());
+}
+
 size_t CheckUTurnOnRoute(vector<LoadedPathSegment> const & segments, size_t currentSegment, TurnItem & turn)
 {
   size_t constexpr kUTurnLookAhead = 3;
@@ -5,12 +5,17 @@
 #include "routing/route.hpp"
 #include "routing/turns.hpp"
 
+#include "indexer/index.hpp"
+
+#include "base/buffer_vector.hpp"
+
 #include "std/function.hpp"
+#include "std/string.hpp"
+#include "std/unordered_map.hpp"
 #include "std/utility.hpp"
 #include "std/vector.hpp"
 
 struct PathData;
-class Index;
 
 namespace ftypes
 {
@@ -28,6 +33,38 @@ namespace turns
  */
 using TGetIndexFunction = function<size_t(pair<size_t, size_t>)>;
 
+using TFtSegs = buffer_vector<OsrmMappingTypes::FtSeg, 8>;
+
+/*!
+ * \brief The FeaturesCache class keeps road attributes of features read by the route
+ * postprocessing, so path geometry loading and turn classification read every feature once.
+ * Features are parsed completely before caching because a FeatureType refers to the state
+ * of its loader. The cache isn't thread-safe, every postprocessing thread has its own one.
+ */
+class FeaturesCache
+{
+public:
+  struct Road
+  {
+    vector<m2::PointD> m_points;
+    ftypes::HighwayClass m_highwayClass;
+    bool m_isRoundabout;
+    bool m_isLink;
+    string m_name;
+  };
+
+  FeaturesCache(Index const & index, MwmSet::MwmId const & mwmId);
+
+  Road const & GetRoad(uint32_t featureId);
+  /// Lanes are needed for last segments before junctions only, so they aren't cached.
+  /// \param isForward is true if the route goes along the feature points order.
+  string GetLanes(uint32_t featureId, bool isForward);
+
+private:
+  Index::FeaturesLoaderGuard m_loader;
+  unordered_map<uint32_t, Road> m_roads;
+};
+
 /*!
  * \brief The LoadedPathSegment struct is a representation of a single osrm node path.
  * It unpacks and stores information about path and road type flags.
@@ -44,20 +81,20 @@ struct LoadedPathSegment
   NodeID m_nodeId;
   vector<SingleLaneInfo> m_lanes;
 
-  // General constructor.
-  LoadedPathSegment(RoutingMapping & mapping, Index const & index,
+  LoadedPathSegment();
+  // General constructor. segments are FtSegs of the node of osrmPathSegment.
+  LoadedPathSegment(FeaturesCache & cache, TFtSegs const & segments,
                     RawPathData const & osrmPathSegment);
   // Special constructor for side nodes. Splits OSRM node by information from the FeatureGraphNode.
-  LoadedPathSegment(RoutingMapping & mapping, Index const & index,
+  LoadedPathSegment(FeaturesCache & cache, TFtSegs const & segments,
                     RawPathData const & osrmPathSegment, FeatureGraphNode const & startGraphNode,
                     FeatureGraphNode const & endGraphNode, bool isStartNode, bool isEndNode);
 
 private:
   // Load information about road, that described as the sequence of FtSegs and start/end indexes in
   // in it. For the side case, it has information about start/end graph nodes.
-  void LoadPathGeometry(buffer_vector<OsrmMappingTypes::FtSeg, 8> const & buffer, size_t startIndex,
-                        size_t endIndex, Index const & index, RoutingMapping & mapping,
-                        FeatureGraphNode const & startGraphNode,
+  void LoadPathGeometry(TFtSegs const & buffer, size_t startIndex, size_t endIndex,
+                        FeaturesCache & cache, FeatureGraphNode const & startGraphNode,
                         FeatureGraphNode const & endGraphNode, bool isStartNode, bool isEndNode);
 };
 
@@ -141,8 +178,22 @@ TurnDirection GetRoundaboutDirection(bool isIngoingEdgeRoundabout, bool isOutgoi
  * \param turnInfo is used for cashing some information while turn calculation.
  * \param turn is used for keeping the result of turn calculation.
  */
-void GetTurnDirection(Index const & index, RoutingMapping & mapping, turns::TurnInfo & turnInfo,
-                      TurnItem & turn);
+void GetTurnDirection(Index const & index, RoutingMapping & mapping, FeaturesCache & cache,
+                      turns::TurnInfo & turnInfo, TurnItem & turn);
+
+/*!
+ * \brief LoadPathSegmentsAndTurns loads all the segments of an unpacked OSRM path and makes
+ * primary decisions about turns at junctions between them. FtSegs of all the nodes are
+ * prefetched in one pass. Then ranges of segments are loaded and turns inside them are classified
+ * on up to maxThreadsCount threads, every thread reads features through its own FeaturesCache.
+ * \param turns Turns made by GetTurnDirection for the junctions before every segment except
+ * the first one. They are valid unless CheckUTurnOnRoute finds an UTurn there.
+ */
+void LoadPathSegmentsAndTurns(Index const & index, RoutingMapping & mapping,
+                              vector<RawPathData> const & path,
+                              FeatureGraphNode const & sourceEdge,
+                              FeatureGraphNode const & targetEdge, size_t maxThreadsCount,
+                              vector<LoadedPathSegment> & segments, vector<TurnItem> & turns);
 
 /*!
  * \brief Finds an UTurn that starts from current segment and returns how many segments it lasts.
@@ -1,4 +1,5 @@
 #pragma once
+#include "search/louds_trie_match.hpp"
 #include "search/search_common.hpp"
 #include "search/search_query.hpp"
 #include "search/search_query_params.hpp"
@@ -394,6 +395,14 @@ template <typename TFilter, typename ToDo>
 void MatchFeaturesInTrie(SearchQueryParams const & params, trie::DefaultIterator const & trieRoot,
                          TFilter const & filter, ToDo && toDo)
 {
+  // LOUDS tries are walked by node ids without iterators.
+  if (auto const * loudsRoot = dynamic_cast<TSearchLoudsIterator const *>(&trieRoot))
+  {
+    MatchFeaturesInLoudsTrie(params, loudsRoot->GetTrie(), loudsRoot->GetNode(), filter,
+                             forward<ToDo>(toDo));
+    return;
+  }
+
   TrieValuesHolder<TFilter> categoriesHolder(filter);
   CHECK(MatchCategoriesInTrie(params, trieRoot, categoriesHolder), ("Can't find categories."));
 
@@ -0,0 +1,56 @@
+#include "search/louds_trie_match.hpp"
+
+namespace search
+{
+namespace impl
+{
+QueryTrie::QueryTrie(SearchQueryParams const & params) : m_nodes(1)
+{
+  size_t const prefixIndex = params.m_tokens.size();
+  CHECK_LESS(prefixIndex, 64, ("Too many tokens for masks."));
+
+  for (size_t i = 0; i < params.m_tokens.size(); ++i)
+  {
+    for (auto const & syn : params.m_tokens[i])
+    {
+      uint32_t const node = Add(syn);
+      m_nodes[node].m_namesMask |= static_cast<uint64_t>(1) << i;
+      m_nodes[node].m_categoriesMask |= static_cast<uint64_t>(1) << i;
+    }
+  }
+
+  for (auto const & syn : params.m_prefixTokens)
+  {
+    uint32_t const node = Add(syn);
+    m_nodes[node].m_isPrefix = true;
+    m_nodes[node].m_categoriesMask |= static_cast<uint64_t>(1) << prefixIndex;
+  }
+}
+
+uint32_t QueryTrie::Add(strings::UniString const & s)
+{
+  ASSERT(!s.empty(), ());
+  uint32_t cur = GetRoot();
+  for (strings::UniChar const c : s)
+  {
+    auto const & children = m_nodes[cur].m_children;
+    auto const it = find_if(children.begin(), children.end(),
+                            [c](pair<strings::UniChar, uint32_t> const & child)
+                            {
+                              return child.first == c;
+                            });
+    if (it != children.end())
+    {
+      cur = it->second;
+      continue;
+    }
+
+    uint32_t const next = static_cast<uint32_t>(m_nodes.size());
+    m_nodes[cur].m_children.push_back(make_pair(c, next));
+    m_nodes.push_back(Node());
+    cur = next;
+  }
+  return cur;
+}
+}  // namespace impl
+}  // namespace search
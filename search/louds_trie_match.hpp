@@ -0,0 +1,253 @@
+#pragma once
+
+#include "search/search_query_params.hpp"
+
+#include "indexer/search_trie.hpp"
+
+#include "coding/louds_trie.hpp"
+
+#include "base/assert.hpp"
+#include "base/buffer_vector.hpp"
+#include "base/string_utils.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cstdint.hpp"
+#include "std/utility.hpp"
+#include "std/vector.hpp"
+
+namespace search
+{
+using TSearchLoudsTrie = trie::LoudsTrie<trie::ValueReader>;
+using TSearchLoudsIterator = trie::LoudsTrieIterator<trie::ValueReader, trie::TEdgeValueReader>;
+
+namespace impl
+{
+// Trie of all query tokens and their synonyms. A node knows which tokens end in it,
+// so all tokens are looked up in the search trie in one traversal.
+class QueryTrie
+{
+public:
+  struct Node
+  {
+    Node() : m_namesMask(0), m_categoriesMask(0), m_isPrefix(false) {}
+
+    buffer_vector<pair<strings::UniChar, uint32_t>, 4> m_children;
+    // Bit i is set when the token i ends in the node. The prefix token has the index
+    // equal to the number of tokens, it's a complete token for categories.
+    uint64_t m_namesMask;
+    uint64_t m_categoriesMask;
+    // True when the prefix token ends in the node.
+    bool m_isPrefix;
+  };
+
+  explicit QueryTrie(SearchQueryParams const & params);
+
+  static uint32_t GetRoot() { return 0; }
+  Node const & GetNode(uint32_t index) const { return m_nodes[index]; }
+
+private:
+  uint32_t Add(strings::UniString const & s);
+
+  vector<Node> m_nodes;
+};
+
+template <typename TValue>
+void SortUniqueById(vector<TValue> & values)
+{
+  sort(values.begin(), values.end(), [](TValue const & lhs, TValue const & rhs)
+  {
+    return lhs.m_featureId < rhs.m_featureId;
+  });
+  values.erase(unique(values.begin(), values.end(), [](TValue const & lhs, TValue const & rhs)
+  {
+    return lhs.m_featureId == rhs.m_featureId;
+  }), values.end());
+}
+
+// Leaves in |values| only features which are in |rhs|. Both vectors must be sorted by ids
+// and must not contain duplicates.
+template <typename TValue>
+void IntersectById(vector<TValue> & values, vector<TValue> const & rhs)
+{
+  size_t count = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < values.size() && j < rhs.size(); ++i)
+  {
+    while (j < rhs.size() && rhs[j].m_featureId < values[i].m_featureId)
+      ++j;
+    if (j < rhs.size() && rhs[j].m_featureId == values[i].m_featureId)
+      values[count++] = values[i];
+  }
+  values.resize(count);
+}
+
+// Set of ids of sorted features for fast lookups. Feature ids in the search index are
+// indexes of features, so the bitmap from the first id to the last one is small.
+class IdsBitmap
+{
+public:
+  template <typename TValue>
+  explicit IdsBitmap(vector<TValue> const & values)
+    : m_first(values.empty() ? 0 : values.front().m_featureId)
+  {
+    if (values.empty())
+      return;
+    m_bits.resize((values.back().m_featureId - m_first) / 64 + 1);
+    for (TValue const & value : values)
+    {
+      uint32_t const bit = value.m_featureId - m_first;
+      m_bits[bit / 64] |= static_cast<uint64_t>(1) << (bit % 64);
+    }
+  }
+
+  bool Has(uint32_t featureId) const
+  {
+    if (featureId < m_first)
+      return false;
+    uint32_t const bit = featureId - m_first;
+    return bit / 64 < m_bits.size() && ((m_bits[bit / 64] >> (bit % 64)) & 1) != 0;
+  }
+
+private:
+  uint32_t m_first;
+  vector<uint64_t> m_bits;
+};
+}  // namespace impl
+
+// Does the same as MatchFeaturesInTrie, but the search trie is walked once for all tokens,
+// synonyms and languages: nodes of the search trie and of the query trie are traversed
+// together with an explicit stack of node pairs, so branches which don't lead to any token
+// are never visited. Subtrees of the prefix token, usually the most expensive part, are
+// enumerated only when every complete token has matched something, and only features
+// which are matched by all complete tokens are collected from them.
+// Each feature is passed to |toDo| only once, in increasing order of ids.
+template <typename TFilter, typename ToDo>
+void MatchFeaturesInLoudsTrie(SearchQueryParams const & params, TSearchLoudsTrie const & trie,
+                              TSearchLoudsTrie::TNode root, TFilter const & filter, ToDo && toDo)
+{
+  using TValue = TSearchLoudsTrie::TValue;
+  using TNode = TSearchLoudsTrie::TNode;
+
+  struct Item
+  {
+    TNode m_node;
+    uint32_t m_queryNode;
+    bool m_isCategories;
+  };
+
+  impl::QueryTrie const queryTrie(params);
+  size_t const tokensCount = params.m_tokens.size();
+  bool const hasPrefix = !params.m_prefixTokens.empty();
+
+  // One slot per token, the last one is for the prefix token.
+  vector<vector<TValue>> slots(tokensCount + (hasPrefix ? 1 : 0));
+  buffer_vector<Item, 64> stack;
+  buffer_vector<TNode, 8> prefixRoots;
+
+  TNode const categoriesRoot = trie.GoToChar(root, search::kCategoriesLang);
+  CHECK_NOT_EQUAL(categoriesRoot, TSearchLoudsTrie::kInvalidNode, ("Can't find categories."));
+  stack.push_back({categoriesRoot, impl::QueryTrie::GetRoot(), true /* isCategories */});
+  for (int8_t const lang : params.m_langs)
+  {
+    if (lang < 0)
+      continue;
+    TNode const langRoot = trie.GoToChar(root, static_cast<trie::TrieChar>(lang));
+    if (langRoot != TSearchLoudsTrie::kInvalidNode)
+      stack.push_back({langRoot, impl::QueryTrie::GetRoot(), false /* isCategories */});
+  }
+
+  while (!stack.empty())
+  {
+    Item const item = stack.back();
+    stack.pop_back();
+
+    impl::QueryTrie::Node const & queryNode = queryTrie.GetNode(item.m_queryNode);
+    uint64_t const mask = item.m_isCategories ? queryNode.m_categoriesMask : queryNode.m_namesMask;
+    if (mask != 0)
+    {
+      trie.ForEachValue(item.m_node, [&](TValue const & value)
+      {
+        if (!filter(value.m_featureId))
+          return;
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+          if (mask & (static_cast<uint64_t>(1) << i))
+            slots[i].push_back(value);
+        }
+      });
+    }
+    if (queryNode.m_isPrefix && !item.m_isCategories)
+      prefixRoots.push_back(item.m_node);
+
+    for (auto const & child : queryNode.m_children)
+    {
+      TNode const next = trie.GoToChar(item.m_node, child.first);
+      if (next != TSearchLoudsTrie::kInvalidNode)
+        stack.push_back({next, child.second, item.m_isCategories});
+    }
+  }
+
+  // Complete tokens are intersected starting from the most selective one.
+  vector<size_t> order(tokensCount);
+  for (size_t i = 0; i < tokensCount; ++i)
+    order[i] = i;
+  sort(order.begin(), order.end(), [&slots](size_t lhs, size_t rhs)
+  {
+    return slots[lhs].size() < slots[rhs].size();
+  });
+
+  // Only the smallest slot is sorted as a whole, others are filtered by the result
+  // before sorting.
+  vector<TValue> result;
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    vector<TValue> & slot = slots[order[i]];
+    if (i != 0)
+    {
+      impl::IdsBitmap const candidates(result);
+      slot.erase(remove_if(slot.begin(), slot.end(), [&candidates](TValue const & value)
+                           {
+                             return !candidates.Has(value.m_featureId);
+                           }),
+                 slot.end());
+    }
+    impl::SortUniqueById(slot);
+    result.swap(slot);
+    if (result.empty())
+      return;
+  }
+
+  if (hasPrefix)
+  {
+    vector<TValue> & prefixSlot = slots.back();
+    impl::IdsBitmap const candidates(result);
+    buffer_vector<TNode, 64> subtree(prefixRoots.begin(), prefixRoots.end());
+    while (!subtree.empty())
+    {
+      TNode const node = subtree.back();
+      subtree.pop_back();
+      trie.ForEachValue(node, [&](TValue const & value)
+      {
+        if (filter(value.m_featureId) &&
+            (tokensCount == 0 || candidates.Has(value.m_featureId)))
+        {
+          prefixSlot.push_back(value);
+        }
+      });
+      trie.ForEachChild(node, [&subtree](trie::TrieChar, TNode child)
+      {
+        subtree.push_back(child);
+      });
+    }
+
+    impl::SortUniqueById(prefixSlot);
+    if (tokensCount == 0)
+      result.swap(prefixSlot);
+    else
+      impl::IntersectById(result, prefixSlot);
+  }
+
+  for (TValue const & value : result)
+    toDo(value);
+}
+}  // namespace search
@@ -7,7 +7,6 @@
 #include "indexer/index.hpp"
 #include "indexer/search_trie.hpp"
 
-#include "coding/reader_wrapper.hpp"
 
 #include "base/logging.hpp"
 
@@ -35,11 +34,7 @@ void RetrieveAddressFeatures(MwmSet::MwmHandle const & handle, SearchQueryParams
 {
   auto * value = handle.GetValue<MwmValue>();
   ASSERT(value, ());
-  serial::CodingParams codingParams(trie::GetCodingParams(value->GetHeader().GetDefCodingParams()));
-  ModelReaderPtr searchReader = value->m_cont.GetReader(SEARCH_INDEX_FILE_TAG);
-  unique_ptr<trie::DefaultIterator> const trieRoot(
-      trie::ReadTrie(SubReaderWrapper<Reader>(searchReader.GetPtr()),
-                     trie::ValueReader(codingParams), trie::TEdgeValueReader()));
+  unique_ptr<trie::DefaultIterator> const trieRoot = value->GetSearchTrie().GetRoot();
 
   auto collector = [&](trie::ValueReader::ValueType const & value)
   {
@@ -20,6 +20,7 @@ HEADERS += \
     keyword_matcher.hpp \
     latlon_match.hpp \
     locality_finder.hpp \
+    louds_trie_match.hpp \
     params.hpp \
     query_saver.hpp \
     result.hpp \
@@ -41,6 +42,7 @@ SOURCES += \
     keyword_matcher.cpp \
     latlon_match.cpp \
     locality_finder.cpp \
+    louds_trie_match.cpp \
     params.cpp \
     query_saver.cpp \
     result.cpp \
@@ -20,12 +20,13 @@
 #include "indexer/search_delimiters.hpp"
 #include "indexer/search_string_utils.hpp"
 
+#include "platform/platform.hpp"
 #include "platform/preferred_languages.hpp"
 
 #include "coding/multilang_utf8_string.hpp"
-#include "coding/reader_wrapper.hpp"
 
 #include "base/logging.hpp"
+#include "base/parallel_for_pool.hpp"
 #include "base/stl_add.hpp"
 #include "base/string_utils.hpp"
 
@@ -1760,13 +1761,7 @@ void Query::SearchLocality(MwmValue const * pMwm, impl::Locality & res1, impl::R
   SearchQueryParams params;
   InitParams(true /* localitySearch */, params);
 
-  serial::CodingParams cp(trie::GetCodingParams(pMwm->GetHeader().GetDefCodingParams()));
-
-  ModelReaderPtr searchReader = pMwm->m_cont.GetReader(SEARCH_INDEX_FILE_TAG);
-
-  unique_ptr<trie::DefaultIterator> const trieRoot(
-      trie::ReadTrie(SubReaderWrapper<Reader>(searchReader.GetPtr()), trie::ValueReader(cp),
-                     trie::TEdgeValueReader()));
+  unique_ptr<trie::DefaultIterator> const trieRoot = pMwm->GetSearchTrie().GetRoot();
 
   ForEachLangPrefix(params, *trieRoot, [&](TrieRootPrefix & langRoot, int8_t lang)
   {
@@ -1849,16 +1844,40 @@ namespace
 void Query::SearchFeatures(SearchQueryParams const & params, TMWMVector const & mwmsInfo,
                            ViewportID vID)
 {
+  vector<Index::MwmHandle> handles;
   for (shared_ptr<MwmInfo> const & info : mwmsInfo)
   {
     // Search only mwms that intersect with viewport (world always does).
     if (m_viewport[vID].IsIntersect(info->m_limitRect))
-      SearchInMWM(m_index.GetMwmHandleById(info), params, vID);
+      handles.push_back(m_index.GetMwmHandleById(info));
+  }
+
+  // Mwms are matched in parallel, but results are added in the same order as before
+  // because AddResultFromTrie changes the query.
+  vector<vector<TTrieValue>> values(handles.size());
+  threads::ParallelForPool::Instance().ParallelFor(handles.size(), [&](size_t i, size_t /* slot */)
+  {
+    MatchFeaturesInMWM(handles[i], params, vID, values[i]);
+  }, GetPlatform().CpuCores());
+
+  for (size_t i = 0; i < handles.size(); ++i)
+  {
+    for (TTrieValue const & value : values[i])
+      AddResultFromTrie(value, handles[i].GetId(), vID);
   }
 }
 
 void Query::SearchInMWM(Index::MwmHandle const & mwmHandle, SearchQueryParams const & params,
                         ViewportID viewportId /*= DEFAULT_V*/)
+{
+  vector<TTrieValue> values;
+  MatchFeaturesInMWM(mwmHandle, params, viewportId, values);
+  for (TTrieValue const & value : values)
+    AddResultFromTrie(value, mwmHandle.GetId(), viewportId);
+}
+
+void Query::MatchFeaturesInMWM(Index::MwmHandle const & mwmHandle, SearchQueryParams const & params,
+                               ViewportID viewportId, vector<TTrieValue> & values) const
 {
   MwmValue const * const value = mwmHandle.GetValue<MwmValue>();
   if (!value || !value->m_cont.IsExist(SEARCH_INDEX_FILE_TAG))
@@ -1870,18 +1889,22 @@ void Query::SearchInMWM(Index::MwmHandle const & mwmHandle, SearchQueryParams co
   if (isWorld && !m_worldSearch)
     return;
 
-  serial::CodingParams cp(trie::GetCodingParams(header.GetDefCodingParams()));
-  ModelReaderPtr searchReader = value->m_cont.GetReader(SEARCH_INDEX_FILE_TAG);
-  unique_ptr<trie::DefaultIterator> const trieRoot(
-      trie::ReadTrie(SubReaderWrapper<Reader>(searchReader.GetPtr()), trie::ValueReader(cp),
-                     trie::TEdgeValueReader()));
+  vector<uint32_t> const * offsets = nullptr;
+  if (viewportId != DEFAULT_V && !isWorld)
+  {
+    // Nothing is in the viewport when there are no offsets for the mwm.
+    static vector<uint32_t> const kNoOffsets;
+    TOffsetsVector const & viewportOffsets = m_offsetsInViewport[viewportId];
+    auto const it = viewportOffsets.find(mwmHandle.GetId());
+    offsets = (it == viewportOffsets.end() ? &kNoOffsets : &it->second);
+  }
+
+  unique_ptr<trie::DefaultIterator> const trieRoot = value->GetSearchTrie().GetRoot();
 
-  MwmSet::MwmId const mwmId = mwmHandle.GetId();
-  FeaturesFilter filter(viewportId == DEFAULT_V || isWorld ?
-                          0 : &m_offsetsInViewport[viewportId][mwmId], *this);
-  MatchFeaturesInTrie(params, *trieRoot, filter, [&](TTrieValue const & value)
+  FeaturesFilter filter(offsets, *this);
+  MatchFeaturesInTrie(params, *trieRoot, filter, [&values](TTrieValue const & value)
   {
-    AddResultFromTrie(value, mwmId, viewportId);
+    values.push_back(value);
   });
 }
 
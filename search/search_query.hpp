@@ -166,6 +166,10 @@ private:
   /// Do search in particular map (mwmHandle).
   void SearchInMWM(Index::MwmHandle const & mwmHandle, SearchQueryParams const & params,
                    ViewportID viewportId = DEFAULT_V);
+  /// Collects features of the map matched to params. Doesn't change the query,
+  /// so it's called for several maps in parallel.
+  void MatchFeaturesInMWM(Index::MwmHandle const & mwmHandle, SearchQueryParams const & params,
+                          ViewportID viewportId, vector<TTrieValue> & values) const;
   //@}
 
   void SuggestStrings(Results & res);
@@ -0,0 +1,235 @@
+#include "testing/testing.hpp"
+#include "testing/benchmark.hpp"
+
+#include "search/feature_offset_match.hpp"
+#include "search/louds_trie_match.hpp"
+#include "search/search_query_params.hpp"
+
+#include "indexer/search_trie.hpp"
+#include "indexer/string_file.hpp"
+#include "indexer/string_file_values.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/louds_trie_builder.hpp"
+#include "coding/reader.hpp"
+#include "coding/trie_builder.hpp"
+#include "coding/trie_reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/string_utils.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/random.hpp"
+#include "std/shared_ptr.hpp"
+#include "std/unique_ptr.hpp"
+#include "std/vector.hpp"
+
+using namespace search;
+
+namespace
+{
+using TString = StringsFile<SerializedFeatureInfoValue>::TString;
+using TValue = trie::ValueReader::ValueType;
+
+int8_t const kLangs[] = {0, 1};
+
+struct IdsFilter
+{
+  // Rejects a part of features, like the viewport filter does.
+  bool operator()(uint32_t featureId) const { return featureId % 7 != 0; }
+};
+
+strings::UniString GetRandomWord(mt19937 & rng)
+{
+  // Letters are taken with geometric distribution, so words have many common prefixes.
+  geometric_distribution<uint32_t> letterDist(0.25);
+  uniform_int_distribution<size_t> lengthDist(2, 8);
+  strings::UniString word(lengthDist(rng));
+  for (auto & c : word)
+    c = 'a' + letterDist(rng) % 26;
+  return word;
+}
+
+// Synthetic search index: every feature has a few words in both languages and
+// some features have categories.
+class Dictionary
+{
+public:
+  Dictionary(size_t featuresCount, size_t wordsCount)
+    : m_cp(trie::GetCodingParams(serial::CodingParams()))
+  {
+    mt19937 rng(0);
+    for (size_t i = 0; i < wordsCount; ++i)
+      m_words.push_back(GetRandomWord(rng));
+    for (size_t i = 0; i < 10; ++i)
+      m_categories.push_back(GetRandomWord(rng));
+
+    // Word frequencies are skewed like in real names.
+    geometric_distribution<size_t> wordDist(0.02);
+    uniform_int_distribution<size_t> countDist(1, 4);
+    uniform_int_distribution<size_t> categoryDist(0, 2 * m_categories.size());
+    for (uint32_t id = 0; id < featuresCount; ++id)
+    {
+      TValue value;
+      value.m_pt = m2::PointD(id % 100, id / 100);
+      value.m_featureId = id;
+      value.m_rank = static_cast<uint8_t>(id % 256);
+
+      SerializedFeatureInfoValue serialized;
+      PushBackByteSink<SerializedFeatureInfoValue::ValueT> sink(serialized.m_value);
+      trie::ValueReader(m_cp).Save(sink, value);
+
+      for (int8_t const lang : kLangs)
+      {
+        for (size_t i = countDist(rng); i > 0; --i)
+          m_strings.emplace_back(m_words[wordDist(rng) % m_words.size()], lang, serialized);
+      }
+      size_t const category = categoryDist(rng);
+      if (category < m_categories.size())
+      {
+        m_strings.emplace_back(m_categories[category], static_cast<int8_t>(kCategoriesLang),
+                               serialized);
+      }
+    }
+    sort(m_strings.begin(), m_strings.end());
+    m_strings.erase(unique(m_strings.begin(), m_strings.end()), m_strings.end());
+  }
+
+  unique_ptr<trie::DefaultIterator> BuildTrie()
+  {
+    PushBackByteSink<vector<uint8_t>> sink(m_trie);
+    trie::Build<PushBackByteSink<vector<uint8_t>>, vector<TString>::iterator,
+                trie::EmptyEdgeBuilder, ValueList<SerializedFeatureInfoValue>>(
+        sink, m_strings.begin(), m_strings.end(), trie::EmptyEdgeBuilder());
+    reverse(m_trie.begin(), m_trie.end());
+    return unique_ptr<trie::DefaultIterator>(trie::ReadTrie(
+        MemReader(m_trie.data(), m_trie.size()), trie::ValueReader(m_cp), trie::TEdgeValueReader()));
+  }
+
+  unique_ptr<trie::DefaultIterator> BuildLoudsTrie()
+  {
+    MemWriter<vector<uint8_t>> writer(m_louds);
+    trie::BuildLoudsTrie<MemWriter<vector<uint8_t>>, vector<TString>::iterator,
+                         ValueList<SerializedFeatureInfoValue>>(writer, m_strings.begin(),
+                                                                m_strings.end());
+    auto const louds = make_shared<TSearchLoudsTrie>(reinterpret_cast<char const *>(m_louds.data()),
+                                                     m_louds.size(), trie::ValueReader(m_cp));
+    return make_unique<TSearchLoudsIterator>(louds, louds->GetRoot());
+  }
+
+  // Returns queries like users type: a few words, some with synonyms, the last one
+  // is often incomplete, some words aren't in the index at all.
+  vector<SearchQueryParams> GetQueries(size_t count) const
+  {
+    mt19937 rng(1);
+    geometric_distribution<size_t> wordDist(0.02);
+    uniform_int_distribution<size_t> tokensDist(0, 3);
+    uniform_int_distribution<size_t> percentDist(0, 99);
+
+    auto const getWord = [&]() -> strings::UniString
+    {
+      size_t const percent = percentDist(rng);
+      if (percent < 5)
+        return GetRandomWord(rng);
+      if (percent < 15)
+        return m_categories[percent % m_categories.size()];
+      return m_words[wordDist(rng) % m_words.size()];
+    };
+
+    vector<SearchQueryParams> queries(count);
+    for (SearchQueryParams & params : queries)
+    {
+      params.m_langs.insert(kLangs[0]);
+      if (percentDist(rng) < 50)
+        params.m_langs.insert(kLangs[1]);
+
+      params.m_tokens.resize(tokensDist(rng));
+      for (auto & token : params.m_tokens)
+      {
+        token.push_back(getWord());
+        if (percentDist(rng) < 20)
+          token.push_back(getWord());
+      }
+
+      if (percentDist(rng) < 70)
+      {
+        strings::UniString word = getWord();
+        word.resize(1 + percentDist(rng) % word.size());
+        params.m_prefixTokens.push_back(word);
+      }
+    }
+    return queries;
+  }
+
+private:
+  serial::CodingParams m_cp;
+  vector<strings::UniString> m_words;
+  vector<strings::UniString> m_categories;
+  vector<TString> m_strings;
+  vector<uint8_t> m_trie;
+  vector<uint8_t> m_louds;
+};
+
+vector<uint32_t> Match(SearchQueryParams const & params, trie::DefaultIterator const & root)
+{
+  vector<uint32_t> ids;
+  MatchFeaturesInTrie(params, root, IdsFilter(), [&ids](TValue const & value)
+  {
+    ids.push_back(value.m_featureId);
+  });
+  sort(ids.begin(), ids.end());
+  return ids;
+}
+}  // namespace
+
+UNIT_TEST(LoudsTrieMatch_CompareWithTrie)
+{
+  Dictionary dictionary(2000, 300);
+  unique_ptr<trie::DefaultIterator> const root = dictionary.BuildTrie();
+  unique_ptr<trie::DefaultIterator> const loudsRoot = dictionary.BuildLoudsTrie();
+
+  size_t nonEmpty = 0;
+  for (SearchQueryParams const & params : dictionary.GetQueries(500))
+  {
+    vector<uint32_t> const expected = Match(params, *root);
+    vector<uint32_t> const actual = Match(params, *loudsRoot);
+    TEST_EQUAL(expected, actual, (DebugPrint(params)));
+    TEST(is_sorted(actual.begin(), actual.end()) &&
+             adjacent_find(actual.begin(), actual.end()) == actual.end(),
+         (DebugPrint(params)));
+    if (!actual.empty())
+      ++nonEmpty;
+  }
+  // Queries must check something.
+  TEST_GREATER(nonEmpty, 100, ());
+}
+
+#ifndef DEBUG
+BENCHMARK_TEST(Trie_MatchFeatures)
+{
+  Dictionary dictionary(50000, 5000);
+  unique_ptr<trie::DefaultIterator> const root = dictionary.BuildTrie();
+  vector<SearchQueryParams> const queries = dictionary.GetQueries(200);
+  BENCHMARK_N_TIMES(5, 10.0)
+  {
+    size_t count = 0;
+    for (SearchQueryParams const & params : queries)
+      count += Match(params, *root).size();
+    FORCE_USE_VALUE(count);
+  }
+}
+
+BENCHMARK_TEST(LoudsTrie_MatchFeatures)
+{
+  Dictionary dictionary(50000, 5000);
+  unique_ptr<trie::DefaultIterator> const root = dictionary.BuildLoudsTrie();
+  vector<SearchQueryParams> const queries = dictionary.GetQueries(200);
+  BENCHMARK_N_TIMES(5, 10.0)
+  {
+    size_t count = 0;
+    for (SearchQueryParams const & params : queries)
+      count += Match(params, *root).size();
+    FORCE_USE_VALUE(count);
+  }
+}
+#endif
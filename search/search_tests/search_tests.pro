@@ -22,6 +22,7 @@ SOURCES += \
     keyword_matcher_test.cpp \
     latlon_match_test.cpp \
     locality_finder_test.cpp \
+    louds_trie_match_test.cpp \
     query_saver_tests.cpp \
     string_intersection_test.cpp \
     string_match_test.cpp \
@@ -1,5 +0,0 @@
-#include "search/search_trie.hpp"
-#include "search"
-#include "coding/writer.hpp"
-
-void Build(FeaturesVector const & featuresVector, Writer & writer);
@@ -6,8 +6,11 @@
 
 #include <random>
 
+using std::bernoulli_distribution;
+using std::geometric_distribution;
 using std::mt19937;
 using std::uniform_int_distribution;
+using std::uniform_real_distribution;
 
 #ifdef DEBUG_NEW
 #define new DEBUG_NEW
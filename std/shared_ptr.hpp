@@ -7,6 +7,8 @@
 #include <memory>
 using std::shared_ptr;
 using std::make_shared;
+using std::atomic_load;
+using std::atomic_store;
 
 #ifdef DEBUG_NEW
 #define new DEBUG_NEW
@@ -40,10 +40,26 @@ void LoadGroupImpl(int depth, json_t * group, ToDo & toDo)
       file = name;
 
     char const * flag = json_string_value(json_object_get(j, "c"));
+
+    // Diffs are optional, each one is {"v": version of the map to update, "s": size}.
+    TMapDiffs diffs;
+    json_t * jDiffs = json_object_get(j, "d");
+    for (size_t k = 0; k < json_array_size(jDiffs); ++k)
+    {
+      json_t * jDiff = json_array_get(jDiffs, k);
+      diffs.emplace_back(json_integer_value(json_object_get(jDiff, "v")),
+                         static_cast<uint32_t>(json_integer_value(json_object_get(jDiff, "s"))));
+    }
+
+    // Hashes of files are optional.
+    char const * mapSha256 = json_string_value(json_object_get(j, "sh"));
+    char const * routingSha256 = json_string_value(json_object_get(j, "rsh"));
+
     toDo(name, file, flag ? flag : "",
          // We expect what mwm and routing files should be less 2Gb
          static_cast<uint32_t>(json_integer_value(json_object_get(j, "s"))),
-         static_cast<uint32_t>(json_integer_value(json_object_get(j, "rs"))), depth);
+         static_cast<uint32_t>(json_integer_value(json_object_get(j, "rs"))),
+         mapSha256 ? mapSha256 : "", routingSha256 ? routingSha256 : "", diffs, depth);
 
     json_t * children = json_object_get(j, "g");
     if (children)
@@ -80,14 +96,17 @@ public:
   DoStoreCountries(CountriesContainerT & cont) : m_cont(cont) {}
 
   void operator()(string const & name, string const & file, string const & flag, uint32_t mapSize,
-                  uint32_t routingSize, int depth)
+                  uint32_t routingSize, string const & mapSha256, string const & routingSha256,
+                  TMapDiffs const & diffs, int depth)
   {
     Country country(name, flag);
     if (mapSize)
     {
       CountryFile countryFile(file);
       countryFile.SetRemoteSizes(mapSize, routingSize);
+      countryFile.SetRemoteHashes(mapSha256, routingSha256);
       country.AddFile(countryFile);
+      country.SetDiffs(diffs);
     }
     m_cont.AddAtDepth(depth, country);
   }
@@ -101,7 +120,8 @@ class DoStoreFile2Info
 public:
   DoStoreFile2Info(map<string, CountryInfo> & file2info) : m_file2info(file2info) {}
 
-  void operator()(string name, string file, string const & flag, uint32_t mapSize, uint32_t, int)
+  void operator()(string name, string file, string const & flag, uint32_t mapSize, uint32_t,
+                  string const &, string const &, TMapDiffs const &, int)
   {
     if (!flag.empty())
       m_lastFlag = flag;
@@ -142,7 +162,8 @@ class DoStoreCode2File
 public:
   DoStoreCode2File(multimap<string, string> & code2file) : m_code2file(code2file) {}
 
-  void operator()(string const &, string const & file, string const & flag, uint32_t, uint32_t, int)
+  void operator()(string const &, string const & file, string const & flag, uint32_t, uint32_t,
+                  string const &, string const &, TMapDiffs const &, int)
   {
     m_code2file.insert(make_pair(flag, file));
   }
@@ -214,6 +235,28 @@ void SaveImpl(T const & v, json_t * jParent)
       json_object_set_new(jCountry.get(), "s", json_integer(file.GetRemoteSize(MapOptions::Map)));
       json_object_set_new(jCountry.get(), "rs",
                           json_integer(file.GetRemoteSize(MapOptions::CarRouting)));
+      string const mapSha256 = file.GetRemoteHash(MapOptions::Map);
+      if (!mapSha256.empty())
+        json_object_set_new(jCountry.get(), "sh", json_string(mapSha256.c_str()));
+      string const routingSha256 = file.GetRemoteHash(MapOptions::CarRouting);
+      if (!routingSha256.empty())
+        json_object_set_new(jCountry.get(), "rsh", json_string(routingSha256.c_str()));
+
+      TMapDiffs const & diffs = v[i].Value().GetDiffs();
+      if (!diffs.empty())
+      {
+        my::JsonHandle jDiffs;
+        jDiffs.AttachNew(json_array());
+        for (MapDiff const & diff : diffs)
+        {
+          my::JsonHandle jDiff;
+          jDiff.AttachNew(json_object());
+          json_object_set_new(jDiff.get(), "v", json_integer(diff.m_fromVersion));
+          json_object_set_new(jDiff.get(), "s", json_integer(diff.m_size));
+          json_array_append(jDiffs.get(), jDiff.get());
+        }
+        json_object_set(jCountry.get(), "d", jDiffs.get());
+      }
     }
 
     if (v[i].SiblingsCount())
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "storage/country_decl.hpp"
+#include "storage/map_diffs.hpp"
 #include "storage/simple_tree.hpp"
 #include "storage/storage_defines.hpp"
 
@@ -34,6 +35,8 @@ class Country
   string m_flag;
   /// stores squares with world pieces which are part of the country
   buffer_vector<platform::CountryFile, 1> m_files;
+  /// diffs which update old versions of the map file to the current one
+  TMapDiffs m_diffs;
 
 public:
   Country() {}
@@ -53,6 +56,9 @@ public:
     return m_files.front();
   }
 
+  void SetDiffs(TMapDiffs const & diffs) { m_diffs = diffs; }
+  TMapDiffs const & GetDiffs() const { return m_diffs; }
+
   string const & Name() const { return m_name; }
   string const & Flag() const { return m_flag; }
 
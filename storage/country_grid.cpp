@@ -0,0 +1,164 @@
+#include "storage/country_grid.hpp"
+
+#include "indexer/mercator.hpp"
+
+#include "geometry/rect_intersect.hpp"
+
+#include "base/math.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/cmath.hpp"
+
+namespace storage
+{
+namespace
+{
+// Borders are extended by this value to be sure that cells which are marked as covered
+// by a country aren't touched by its borders even after rounding of coordinates.
+double const kBorderEps = 1.0E-5;
+
+double GetCellSize(uint32_t cellsPerSide)
+{
+  return (MercatorBounds::maxX - MercatorBounds::minX) / cellsPerSide;
+}
+
+// Returns index of a cell column (row) which contains |coord|.
+uint32_t GetCellCoord(double coord, double minCoord, double cellSize, uint32_t cellsPerSide)
+{
+  double const c = floor((coord - minCoord) / cellSize);
+  return static_cast<uint32_t>(my::clamp(c, 0.0, static_cast<double>(cellsPerSide - 1)));
+}
+
+// Returns the first column (row) whose center is not less than |coord|.
+int GetFirstCenterAfter(double coord, double minCoord, double cellSize)
+{
+  return static_cast<int>(ceil((coord - minCoord) / cellSize - 0.5));
+}
+}  // namespace
+
+CountryGrid::Builder::Builder(uint32_t cellsPerSide)
+  : m_cellsPerSide(cellsPerSide)
+  , m_countriesCount(0)
+  , m_cells(cellsPerSide * cellsPerSide)
+{
+  ASSERT_GREATER(cellsPerSide, 0, ());
+}
+
+void CountryGrid::Builder::AddCountry(vector<m2::RegionD> const & regions)
+{
+  uint32_t const id = m_countriesCount++;
+  double const cellSize = GetCellSize(m_cellsPerSide);
+  int const cellsPerSide = static_cast<int>(m_cellsPerSide);
+
+  // Cells crossed by the borders.
+  vector<uint32_t> borderCells;
+  // Cells whose centers are inside the borders, they're covered by the country when
+  // they aren't crossed by the borders.
+  vector<uint32_t> innerCells;
+
+  for (m2::RegionD const & region : regions)
+  {
+    vector<m2::PointD> const points = region.Data();
+    if (points.size() < 3)
+      continue;
+
+    m2::RectD const rect = region.GetRect();
+    int const firstRow = max(GetFirstCenterAfter(rect.minY(), MercatorBounds::minY, cellSize), 0);
+    int const lastRow = min(GetFirstCenterAfter(rect.maxY(), MercatorBounds::minY, cellSize), cellsPerSide);
+    vector<vector<double>> rowCrossings(max(lastRow - firstRow, 0));
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      m2::PointD const & p1 = points[i];
+      m2::PointD const & p2 = points[(i + 1) % points.size()];
+
+      m2::RectD edgeRect(p1, p2);
+      edgeRect.Inflate(kBorderEps, kBorderEps);
+      uint32_t const minX = GetCellCoord(edgeRect.minX(), MercatorBounds::minX, cellSize, m_cellsPerSide);
+      uint32_t const maxX = GetCellCoord(edgeRect.maxX(), MercatorBounds::minX, cellSize, m_cellsPerSide);
+      uint32_t const minY = GetCellCoord(edgeRect.minY(), MercatorBounds::minY, cellSize, m_cellsPerSide);
+      uint32_t const maxY = GetCellCoord(edgeRect.maxY(), MercatorBounds::minY, cellSize, m_cellsPerSide);
+      for (uint32_t y = minY; y <= maxY; ++y)
+      {
+        for (uint32_t x = minX; x <= maxX; ++x)
+        {
+          m2::RectD cellRect(MercatorBounds::minX + x * cellSize, MercatorBounds::minY + y * cellSize,
+                             MercatorBounds::minX + (x + 1) * cellSize, MercatorBounds::minY + (y + 1) * cellSize);
+          cellRect.Inflate(kBorderEps, kBorderEps);
+          m2::PointD c1 = p1;
+          m2::PointD c2 = p2;
+          if (m2::Intersect(cellRect, c1, c2))
+            borderCells.push_back(y * m_cellsPerSide + x);
+        }
+      }
+
+      // Crossings of the edge with horizontal lines through centers of rows,
+      // the upper end of the edge is excluded to count every vertex once.
+      double const yLow = min(p1.y, p2.y);
+      double const yHigh = max(p1.y, p2.y);
+      int const beginRow = max(GetFirstCenterAfter(yLow, MercatorBounds::minY, cellSize), firstRow);
+      int const endRow = min(GetFirstCenterAfter(yHigh, MercatorBounds::minY, cellSize), lastRow);
+      for (int row = beginRow; row < endRow; ++row)
+      {
+        double const y = MercatorBounds::minY + (row + 0.5) * cellSize;
+        double const x = p1.x + (y - p1.y) * (p2.x - p1.x) / (p2.y - p1.y);
+        rowCrossings[row - firstRow].push_back(x);
+      }
+    }
+
+    for (int row = firstRow; row < lastRow; ++row)
+    {
+      vector<double> & crossings = rowCrossings[row - firstRow];
+      sort(crossings.begin(), crossings.end());
+      for (size_t i = 0; i + 1 < crossings.size(); i += 2)
+      {
+        int const beginCol = max(GetFirstCenterAfter(crossings[i], MercatorBounds::minX, cellSize), 0);
+        int const endCol = min(GetFirstCenterAfter(crossings[i + 1], MercatorBounds::minX, cellSize), cellsPerSide);
+        for (int col = beginCol; col < endCol; ++col)
+          innerCells.push_back(row * m_cellsPerSide + col);
+      }
+    }
+  }
+
+  sort(borderCells.begin(), borderCells.end());
+  borderCells.erase(unique(borderCells.begin(), borderCells.end()), borderCells.end());
+  sort(innerCells.begin(), innerCells.end());
+  innerCells.erase(unique(innerCells.begin(), innerCells.end()), innerCells.end());
+
+  for (uint32_t cell : borderCells)
+    m_cells[cell].push_back(id << 1);
+
+  for (uint32_t cell : innerCells)
+  {
+    if (!binary_search(borderCells.begin(), borderCells.end(), cell))
+      m_cells[cell].push_back((id << 1) | 1);
+  }
+}
+
+void CountryGrid::Builder::Finish(CountryGrid & grid)
+{
+  grid.m_cellsPerSide = m_cellsPerSide;
+  grid.m_offsets.assign(1, 0);
+  grid.m_entries.clear();
+  // Countries are added in order of ids, so entries of every cell are already sorted.
+  for (vector<uint32_t> const & entries : m_cells)
+  {
+    grid.m_entries.insert(grid.m_entries.end(), entries.begin(), entries.end());
+    grid.m_offsets.push_back(static_cast<uint32_t>(grid.m_entries.size()));
+  }
+}
+
+// static
+m2::RectD CountryGrid::GetFullRect()
+{
+  return MercatorBounds::FullRect();
+}
+
+uint32_t CountryGrid::GetCellIndex(m2::PointD const & pt) const
+{
+  double const cellSize = GetCellSize(m_cellsPerSide);
+  uint32_t const x = GetCellCoord(pt.x, MercatorBounds::minX, cellSize, m_cellsPerSide);
+  uint32_t const y = GetCellCoord(pt.y, MercatorBounds::minY, cellSize, m_cellsPerSide);
+  return y * m_cellsPerSide + x;
+}
+}  // namespace storage
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+#include "geometry/region2d.hpp"
+
+#include "coding/varint.hpp"
+
+#include "base/assert.hpp"
+
+#include "std/cstdint.hpp"
+#include "std/vector.hpp"
+
+namespace storage
+{
+// Uniform grid over the whole mercator plane which accelerates point-in-country lookups.
+// Every cell keeps ids of countries which intersect it in increasing order. A country is
+// marked as covering a cell when the cell is entirely inside the country borders, so
+// polygons have to be tested only for cells crossed by the borders.
+//
+// *NOTE* The grid is immutable after building or reading, so it's safe to use it from
+// different threads without synchronization.
+class CountryGrid
+{
+public:
+  static uint32_t const kDefaultCellsPerSide = 512;
+
+  class Builder
+  {
+  public:
+    explicit Builder(uint32_t cellsPerSide = kDefaultCellsPerSide);
+
+    // Countries must be added in order of their ids, i.e. the first added country gets id 0.
+    void AddCountry(vector<m2::RegionD> const & regions);
+
+    void Finish(CountryGrid & grid);
+
+  private:
+    uint32_t const m_cellsPerSide;
+    uint32_t m_countriesCount;
+    // Entries of every cell, see CountryGrid::m_entries.
+    vector<vector<uint32_t>> m_cells;
+  };
+
+  CountryGrid() : m_cellsPerSide(0) {}
+
+  bool IsEmpty() const { return m_offsets.empty(); }
+
+  // Calls |toDo(id, covers)| for countries which intersect a cell of |pt| in increasing order
+  // of ids until |toDo| returns true. |covers| is true when the whole cell is inside the country.
+  // Returns false when |pt| is out of the grid, the caller should check all countries then.
+  template <typename ToDo>
+  bool ForEachCountryInCell(m2::PointD const & pt, ToDo && toDo) const
+  {
+    if (IsEmpty() || !GetFullRect().IsPointInside(pt))
+      return false;
+
+    uint32_t const cell = GetCellIndex(pt);
+    for (uint32_t i = m_offsets[cell]; i < m_offsets[cell + 1]; ++i)
+    {
+      if (toDo(static_cast<size_t>(m_entries[i] >> 1), (m_entries[i] & 1) != 0))
+        break;
+    }
+    return true;
+  }
+
+  template <typename TSink>
+  void Write(TSink & sink) const
+  {
+    WriteVarUint(sink, m_cellsPerSide);
+    uint32_t const cellsCount = m_cellsPerSide * m_cellsPerSide;
+    for (uint32_t cell = 0; cell < cellsCount; ++cell)
+      WriteVarUint(sink, m_offsets[cell + 1] - m_offsets[cell]);
+
+    // Ids in a cell increase, so they're stored as deltas.
+    for (uint32_t cell = 0; cell < cellsCount; ++cell)
+    {
+      uint32_t prevId = 0;
+      for (uint32_t i = m_offsets[cell]; i < m_offsets[cell + 1]; ++i)
+      {
+        uint32_t const id = m_entries[i] >> 1;
+        WriteVarUint(sink, ((id - prevId) << 1) | (m_entries[i] & 1));
+        prevId = id;
+      }
+    }
+  }
+
+  template <typename TSource>
+  void Read(TSource & src)
+  {
+    m_cellsPerSide = ReadVarUint<uint32_t>(src);
+    uint32_t const cellsCount = m_cellsPerSide * m_cellsPerSide;
+
+    m_offsets.resize(cellsCount + 1);
+    m_offsets[0] = 0;
+    for (uint32_t cell = 0; cell < cellsCount; ++cell)
+      m_offsets[cell + 1] = m_offsets[cell] + ReadVarUint<uint32_t>(src);
+
+    m_entries.resize(m_offsets[cellsCount]);
+    for (uint32_t cell = 0; cell < cellsCount; ++cell)
+    {
+      uint32_t id = 0;
+      for (uint32_t i = m_offsets[cell]; i < m_offsets[cell + 1]; ++i)
+      {
+        uint32_t const delta = ReadVarUint<uint32_t>(src);
+        id += delta >> 1;
+        m_entries[i] = (id << 1) | (delta & 1);
+      }
+    }
+  }
+
+private:
+  static m2::RectD GetFullRect();
+
+  uint32_t GetCellIndex(m2::PointD const & pt) const;
+
+  uint32_t m_cellsPerSide;
+  // Entries of the cell i are in [m_offsets[i], m_offsets[i + 1]).
+  vector<uint32_t> m_offsets;
+  // Entry is (country id << 1) | covers.
+  vector<uint32_t> m_entries;
+};
+}  // namespace storage
@@ -13,6 +13,7 @@
 #include "std/bind.hpp"
 #include "std/function.hpp"
 #include "std/limits.hpp"
+#include "std/map.hpp"
 
 namespace storage
 {
@@ -20,11 +21,6 @@ namespace
 {
 size_t const kInvalidId = numeric_limits<size_t>::max();
 
-struct DoFreeCacheMemory
-{
-  void operator()(vector<m2::RegionD> & v) const { vector<m2::RegionD>().swap(v); }
-};
-
 class DoCalcUSA
 {
 public:
@@ -45,11 +41,21 @@ private:
 };
 }  // namespace
 
+// static
+size_t constexpr CountryInfoGetter::kMaxLoadedRegions;
+
 CountryInfoGetter::CountryInfoGetter(ModelReaderPtr polyR, ModelReaderPtr countryR)
-  : m_reader(polyR), m_cache(3)
+  : m_reader(polyR)
 {
   ReaderSource<ModelReaderPtr> src(m_reader.GetReader(PACKED_POLYGONS_INFO_TAG));
   rw::Read(src, m_countries);
+  m_regions.resize(m_countries.size());
+
+  if (m_reader.IsExist(PACKED_POLYGONS_GRID_TAG))
+  {
+    ReaderSource<ModelReaderPtr> gridSrc(m_reader.GetReader(PACKED_POLYGONS_GRID_TAG));
+    m_grid.Read(gridSrc);
+  }
 
   string buffer;
   countryR.ReadAsString(buffer);
@@ -69,6 +75,30 @@ void CountryInfoGetter::GetRegionInfo(m2::PointD const & pt, CountryInfo & info)
     GetRegionInfo(m_countries[id].m_name, info);
 }
 
+void CountryInfoGetter::GetRegionInfo(vector<m2::PointD> const & pts,
+                                      vector<CountryInfo> & infos) const
+{
+  infos.assign(pts.size(), CountryInfo());
+
+  map<IdType, size_t> id2index;
+  for (size_t i = 0; i < pts.size(); ++i)
+  {
+    IdType const id = FindFirstCountry(pts[i]);
+    if (id == kInvalidId)
+      continue;
+
+    auto const it = id2index.find(id);
+    if (it != id2index.end())
+    {
+      infos[i] = infos[it->second];
+      continue;
+    }
+
+    GetRegionInfo(m_countries[id].m_name, infos[i]);
+    id2index.insert(make_pair(id, i));
+  }
+}
+
 void CountryInfoGetter::GetRegionInfo(string const & id, CountryInfo & info) const
 {
   auto const it = m_id2info.find(id);
@@ -132,35 +162,61 @@ bool CountryInfoGetter::IsBelongToRegions(string const & fileName, IdSet const &
 
 void CountryInfoGetter::ClearCaches() const
 {
-  lock_guard<mutex> lock(m_cacheMutex);
+  lock_guard<mutex> lock(m_readerMutex);
 
-  m_cache.ForEachValue(DoFreeCacheMemory());
-  m_cache.Reset();
+  // Regions which are used by other threads now are freed by the last user.
+  for (IdType id : m_loadedIds)
+    atomic_store(&m_regions[id], RegionsPtr());
+  m_loadedIds.clear();
 }
 
-bool CountryInfoGetter::IsBelongToRegion(size_t id, m2::PointD const & pt) const
+size_t CountryInfoGetter::GetLoadedRegionsCount() const
 {
-  lock_guard<mutex> lock(m_cacheMutex);
+  lock_guard<mutex> lock(m_readerMutex);
+  return m_loadedIds.size();
+}
 
-  bool isFound = false;
-  vector<m2::RegionD> & rgns = m_cache.Find(static_cast<uint32_t>(id), isFound);
+CountryInfoGetter::RegionsPtr CountryInfoGetter::GetRegions(IdType id) const
+{
+  RegionsPtr regions = atomic_load(&m_regions[id]);
+  if (regions)
+    return regions;
+
+  lock_guard<mutex> lock(m_readerMutex);
+
+  // Regions may be loaded by another thread while we were waiting for the lock.
+  regions = atomic_load(&m_regions[id]);
+  if (regions)
+    return regions;
 
-  if (!isFound)
+  auto rgns = make_shared<vector<m2::RegionD>>();
+  // Load regions from file.
+  ReaderSource<ModelReaderPtr> src(m_reader.GetReader(strings::to_string(id)));
+
+  uint32_t const count = ReadVarUint<uint32_t>(src);
+  for (size_t i = 0; i < count; ++i)
   {
-    rgns.clear();
-    // Load regions from file.
-    ReaderSource<ModelReaderPtr> src(m_reader.GetReader(strings::to_string(id)));
+    vector<m2::PointD> points;
+    serial::LoadOuterPath(src, serial::CodingParams(), points);
+    rgns->emplace_back(move(points));
+  }
 
-    uint32_t const count = ReadVarUint<uint32_t>(src);
-    for (size_t i = 0; i < count; ++i)
-    {
-      vector<m2::PointD> points;
-      serial::LoadOuterPath(src, serial::CodingParams(), points);
-      rgns.emplace_back(move(points));
-    }
+  regions = rgns;
+  atomic_store(&m_regions[id], regions);
+
+  m_loadedIds.push_back(id);
+  if (m_loadedIds.size() > kMaxLoadedRegions)
+  {
+    atomic_store(&m_regions[m_loadedIds.front()], RegionsPtr());
+    m_loadedIds.pop_front();
   }
+  return regions;
+}
 
-  for (auto const & rgn : rgns)
+bool CountryInfoGetter::IsBelongToRegion(size_t id, m2::PointD const & pt) const
+{
+  RegionsPtr const regions = GetRegions(id);
+  for (auto const & rgn : *regions)
   {
     if (rgn.Contains(pt))
       return true;
@@ -170,6 +226,19 @@ bool CountryInfoGetter::IsBelongToRegion(size_t id, m2::PointD const & pt) const
 
 CountryInfoGetter::IdType CountryInfoGetter::FindFirstCountry(m2::PointD const & pt) const
 {
+  IdType res = kInvalidId;
+  bool const inGrid = m_grid.ForEachCountryInCell(pt, [&](IdType id, bool covers)
+  {
+    if (covers || (m_countries[id].m_rect.IsPointInside(pt) && IsBelongToRegion(id, pt)))
+    {
+      res = id;
+      return true;
+    }
+    return false;
+  });
+  if (inGrid)
+    return res;
+
   for (size_t id = 0; id < m_countries.size(); ++id)
   {
     if (m_countries[id].m_rect.IsPointInside(pt) && IsBelongToRegion(id, pt))
@@ -1,14 +1,15 @@
 #pragma once
 
 #include "storage/country_decl.hpp"
+#include "storage/country_grid.hpp"
 
 #include "geometry/region2d.hpp"
 
 #include "coding/file_container.hpp"
 
-#include "base/cache.hpp"
-
+#include "std/deque.hpp"
 #include "std/mutex.hpp"
+#include "std/shared_ptr.hpp"
 
 namespace storage
 {
@@ -33,6 +34,11 @@ public:
   // Returns info for a region |pt| belongs to.
   void GetRegionInfo(m2::PointD const & pt, CountryInfo & info) const;
 
+  // Returns infos for regions |pts| belong to, |infos| are in the same
+  // order as |pts|. It's faster than calls for every point, because
+  // infos of a country are filled once.
+  void GetRegionInfo(vector<m2::PointD> const & pts, vector<CountryInfo> & infos) const;
+
   // Returns info for a country by file name without an extension.
   void GetRegionInfo(string const & id, CountryInfo & info) const;
 
@@ -57,10 +63,21 @@ public:
   // |fileName|.
   bool IsBelongToRegions(string const & fileName, IdSet const & regions) const;
 
-  // Clears regions cache.
+  // Frees memory of loaded regions.
   void ClearCaches() const;
 
+  // At most this number of countries keep their regions loaded.
+  static size_t constexpr kMaxLoadedRegions = 16;
+
+  // Returns number of countries with loaded regions, for tests.
+  size_t GetLoadedRegionsCount() const;
+
 private:
+  using RegionsPtr = shared_ptr<vector<m2::RegionD> const>;
+
+  // Returns regions of a country identified by |id|, loads them if needed.
+  RegionsPtr GetRegions(IdType id) const;
+
   // Returns true when |pt| belongs to a country identified by |id|.
   bool IsBelongToRegion(size_t id, m2::PointD const & pt) const;
 
@@ -76,10 +93,17 @@ private:
   // Maps country file name without an extension to a country info.
   map<string, CountryInfo> m_id2info;
 
-  // Only cache and reader can be modified from different threads, so
-  // they're guarded by m_cacheMutex.
+  // Grid of candidate countries, it's empty when polygons file has no
+  // grid section.
+  CountryGrid m_grid;
+
+  // Loaded regions of countries, lookups read them without locks via
+  // atomic_load(). The reader and the order of loads are guarded by
+  // m_readerMutex. When more than kMaxLoadedRegions countries are
+  // loaded, the earliest loaded one is dropped.
   FilesContainerR m_reader;
-  mutable my::Cache<uint32_t, vector<m2::RegionD>> m_cache;
-  mutable mutex m_cacheMutex;
+  mutable vector<RegionsPtr> m_regions;
+  mutable deque<IdType> m_loadedIds;
+  mutable mutex m_readerMutex;
 };
 }  // namespace storage
@@ -25,14 +25,15 @@ void HttpMapFilesDownloader::GetServersList(int64_t const mapVersion, string con
 }
 
 void HttpMapFilesDownloader::DownloadMapFile(vector<string> const & urls, string const & path,
-                                             int64_t size,
+                                             int64_t size, string const & sha256,
                                              TFileDownloadedCallback const & onDownloaded,
                                              TDownloadingProgressCallback const & onProgress)
 {
   ASSERT(m_checker.CalledOnOriginalThread(), ());
   m_request.reset(downloader::HttpRequest::GetFile(
       urls, path, size, bind(&HttpMapFilesDownloader::OnMapFileDownloaded, this, onDownloaded, _1),
-      bind(&HttpMapFilesDownloader::OnMapFileDownloadingProgress, this, onProgress, _1)));
+      bind(&HttpMapFilesDownloader::OnMapFileDownloadingProgress, this, onProgress, _1),
+      512 * 1024 /* chunkSize */, true /* doCleanOnCancel */, sha256));
 }
 
 MapFilesDownloader::TProgress HttpMapFilesDownloader::GetDownloadingProgress()
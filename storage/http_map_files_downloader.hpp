@@ -19,7 +19,7 @@ public:
   // MapFilesDownloader overrides:
   void GetServersList(int64_t const mapVersion, string const & mapFileName, TServersListCallback const & callback) override;
   void DownloadMapFile(vector<string> const & urls, string const & path, int64_t size,
-                       TFileDownloadedCallback const & onDownloaded,
+                       string const & sha256, TFileDownloadedCallback const & onDownloaded,
                        TDownloadingProgressCallback const & onProgress) override;
   TProgress GetDownloadingProgress() override;
   bool IsIdle() override;
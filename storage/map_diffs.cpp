@@ -0,0 +1,68 @@
+#include "storage/map_diffs.hpp"
+
+#include "coding/file_writer.hpp"
+#include "coding/mwm_diff.hpp"
+
+#include "base/assert.hpp"
+#include "base/string_utils.hpp"
+
+#include "defines.hpp"
+
+#include "std/algorithm.hpp"
+#include "std/sstream.hpp"
+
+namespace storage
+{
+TMapDiffs GetDiffsChain(TMapDiffs const & diffs, int64_t localVersion, uint64_t mapSize)
+{
+  auto const it = find_if(diffs.begin(), diffs.end(), [localVersion](MapDiff const & diff)
+  {
+    return diff.m_fromVersion == localVersion;
+  });
+  if (it == diffs.end() || static_cast<size_t>(diffs.end() - it) > kMaxDiffsChainLength)
+    return TMapDiffs();
+
+  uint64_t size = 0;
+  for (auto i = it; i != diffs.end(); ++i)
+    size += i->m_size;
+  // Applying is much slower than downloading, the full map is downloaded when the gain is small.
+  if (2 * size >= mapSize)
+    return TMapDiffs();
+
+  return TMapDiffs(it, diffs.end());
+}
+
+int64_t GetDiffTargetVersion(TMapDiffs const & chain, size_t i, int64_t currentVersion)
+{
+  ASSERT_LESS(i, chain.size(), ());
+  return i + 1 < chain.size() ? chain[i + 1].m_fromVersion : currentVersion;
+}
+
+bool ApplyDiffsChain(string const & oldFile, vector<string> const & diffFiles,
+                     string const & newFile)
+{
+  ASSERT(!diffFiles.empty(), ());
+  string source = oldFile;
+  for (size_t i = 0; i < diffFiles.size(); ++i)
+  {
+    string const result = i + 1 == diffFiles.size()
+                              ? newFile
+                              : newFile + "." + strings::to_string(i) + EXTENSION_TMP;
+    bool const ok = diff::ApplyMwmDiff(source, diffFiles[i], result);
+    // Intermediate versions are deleted as soon as they are applied.
+    if (source != oldFile)
+      FileWriter::DeleteFileX(source);
+    if (!ok)
+      return false;
+    source = result;
+  }
+  return true;
+}
+
+string DebugPrint(MapDiff const & diff)
+{
+  ostringstream os;
+  os << "MapDiff [ " << diff.m_fromVersion << ", " << diff.m_size << " ]";
+  return os.str();
+}
+}  // namespace storage
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "std/cstdint.hpp"
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace storage
+{
+// Diff of a map file which updates it from m_fromVersion to the next version of the chain,
+// see coding/mwm_diff.hpp for the format.
+struct MapDiff
+{
+  MapDiff() : m_fromVersion(0), m_size(0) {}
+  MapDiff(int64_t fromVersion, uint32_t size) : m_fromVersion(fromVersion), m_size(size) {}
+
+  bool operator==(MapDiff const & rhs) const
+  {
+    return m_fromVersion == rhs.m_fromVersion && m_size == rhs.m_size;
+  }
+
+  int64_t m_fromVersion;
+  uint32_t m_size;
+};
+
+// Chain of diffs sorted by versions: i-th diff updates the map to the version of (i + 1)-th
+// diff, the last one updates the map to the current data version.
+using TMapDiffs = vector<MapDiff>;
+
+// Every diff is applied to the whole map, so long chains are slower than a full download.
+size_t const kMaxDiffsChainLength = 4;
+
+// Returns the tail of |diffs| which updates the map of |localVersion|, or an empty chain when
+// the map should be downloaded as a whole: there are no diffs for |localVersion|, the chain is
+// longer than kMaxDiffsChainLength or diffs aren't much smaller than the map of |mapSize|.
+TMapDiffs GetDiffsChain(TMapDiffs const & diffs, int64_t localVersion, uint64_t mapSize);
+
+// Returns the version which the map has after |chain[i]| is applied.
+int64_t GetDiffTargetVersion(TMapDiffs const & chain, size_t i, int64_t currentVersion);
+
+// Applies |diffFiles| one by one to |oldFile| and writes the result to |newFile|.
+// Intermediate versions are written next to |newFile| and are deleted after use.
+bool ApplyDiffsChain(string const & oldFile, vector<string> const & diffFiles,
+                     string const & newFile);
+
+string DebugPrint(MapDiff const & diff);
+}  // namespace storage
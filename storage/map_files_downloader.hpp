@@ -30,7 +30,10 @@ public:
   /// Asynchronously downloads a map file, periodically invokes
   /// onProgress callback and finally invokes onDownloaded
   /// callback. Both callbacks will be invoked on the original thread.
+  /// Downloading fails when the file doesn't have the expected SHA-256
+  /// (a hex string), an empty hash isn't checked.
   virtual void DownloadMapFile(vector<string> const & urls, string const & path, int64_t size,
+                               string const & sha256,
                                TFileDownloadedCallback const & onDownloaded,
                                TDownloadingProgressCallback const & onProgress) = 0;
 
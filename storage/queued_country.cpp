@@ -5,7 +5,12 @@
 namespace storage
 {
 QueuedCountry::QueuedCountry(TIndex const & index, MapOptions opt)
-    : m_index(index), m_init(opt), m_left(opt), m_current(MapOptions::Nothing)
+    : m_index(index)
+    , m_init(opt)
+    , m_left(opt)
+    , m_current(MapOptions::Nothing)
+    , m_currentDiff(0)
+    , m_diffsRejected(false)
 {
   ASSERT(GetIndex().IsValid(), ("Only valid countries may be downloaded."));
   ASSERT(m_left != MapOptions::Nothing, ("Empty file set was requested for downloading."));
@@ -46,4 +51,26 @@ bool QueuedCountry::SwitchToNextFile()
   m_current = LeastSignificantOption(m_left);
   return m_current != MapOptions::Nothing;
 }
+
+void QueuedCountry::SetDiffs(TMapDiffs const & diffs)
+{
+  ASSERT(CanUseDiffs(), ());
+  ASSERT_EQUAL(m_current, MapOptions::Map, ());
+  m_diffs = diffs;
+  m_currentDiff = 0;
+}
+
+bool QueuedCountry::SwitchToNextDiff()
+{
+  ASSERT(IsDownloadingDiff(), ());
+  ++m_currentDiff;
+  return m_currentDiff < m_diffs.size();
+}
+
+void QueuedCountry::RejectDiffs()
+{
+  m_diffs.clear();
+  m_currentDiff = 0;
+  m_diffsRejected = true;
+}
 }  // namespace storage
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "storage/index.hpp"
+#include "storage/map_diffs.hpp"
 #include "platform/country_defines.hpp"
 
 namespace storage
@@ -20,6 +21,20 @@ public:
   inline MapOptions GetCurrentFile() const { return m_current; }
   inline MapOptions GetDownloadedFiles() const { return UnsetOptions(m_init, m_left); }
 
+  /// Diffs are downloaded one by one instead of the map file and are applied to the local map.
+  void SetDiffs(TMapDiffs const & diffs);
+  bool SwitchToNextDiff();
+  /// Switches to the download of the whole map file, diffs aren't used anymore.
+  void RejectDiffs();
+
+  inline bool IsDownloadingDiff() const
+  {
+    return m_current == MapOptions::Map && m_currentDiff < m_diffs.size();
+  }
+  inline bool CanUseDiffs() const { return !m_diffsRejected; }
+  inline TMapDiffs const & GetDiffs() const { return m_diffs; }
+  inline size_t GetCurrentDiff() const { return m_currentDiff; }
+
   inline bool operator==(TIndex const & index) const { return m_index == index; }
 
 private:
@@ -27,5 +42,9 @@ private:
   MapOptions m_init;
   MapOptions m_left;
   MapOptions m_current;
+
+  TMapDiffs m_diffs;
+  size_t m_currentDiff;
+  bool m_diffsRejected;
 };
 }  // namespace storage
@@ -20,6 +20,7 @@
 #include "std/bind.hpp"
 #include "std/sstream.hpp"
 #include "std/target_os.hpp"
+#include "std/weak_ptr.hpp"
 
 #include "3party/Alohalytics/src/alohalytics.h"
 
@@ -30,6 +31,9 @@ namespace storage
 {
 namespace
 {
+// Two countries with two servers each use the whole default
+// connections budget of downloader::HttpRequest.
+size_t constexpr kDefaultMaxDownloadingCountries = 2;
 
 template <typename T>
 void RemoveIf(vector<T> & v, function<bool(T const & t)> const & p)
@@ -89,7 +93,14 @@ public:
 };
 }  // namespace
 
-Storage::Storage() : m_downloader(new HttpMapFilesDownloader()), m_currentSlotId(0)
+Storage::Storage()
+  : m_downloaderFactory([]()
+                        {
+                          return make_unique<HttpMapFilesDownloader>();
+                        }),
+    m_maxDownloadingCountries(kDefaultMaxDownloadingCountries),
+    m_diffsTasksCount(0),
+    m_currentSlotId(0)
 {
   LoadCountriesFile(false /* forceReload */);
 }
@@ -98,8 +109,10 @@ void Storage::Init(TUpdate const & update) { m_update = update; }
 
 void Storage::Clear()
 {
-  m_downloader->Reset();
+  while (!m_downloaders.empty())
+    ReleaseDownloader(m_downloaders.begin()->first);
   m_queue.clear();
+  m_diffsTickets.clear();
   m_failedCountries.clear();
   m_localFiles.clear();
   m_localFilesForFakeCountries.clear();
@@ -226,9 +239,9 @@ LocalAndRemoteSizeT Storage::CountrySizeInBytes(TIndex const & index, MapOptions
   }
 
   LocalAndRemoteSizeT sizes(0, GetRemoteSize(countryFile, opt));
-  if (!m_downloader->IsIdle() && IsCountryFirstInQueue(index))
+  if (IsCountryDownloading(index) && !GetDownloader(index).IsIdle())
   {
-    sizes.first = m_downloader->GetDownloadingProgress().first +
+    sizes.first = GetDownloader(index).GetDownloadingProgress().first +
                   GetRemoteSize(countryFile, queuedCountry->GetDownloadedFiles());
   }
   return sizes;
@@ -277,7 +290,7 @@ TStatus Storage::CountryStatus(TIndex const & index) const
   // Check if we already downloading this country or have it in the queue
   if (IsCountryInQueue(index))
   {
-    if (IsCountryFirstInQueue(index))
+    if (IsCountryDownloading(index))
       return TStatus::EDownloading;
     else
       return TStatus::EInQueue;
@@ -324,8 +337,8 @@ void Storage::DownloadCountry(TIndex const & index, MapOptions opt)
 
   m_failedCountries.erase(index);
   m_queue.push_back(QueuedCountry(index, opt));
-  if (m_queue.size() == 1)
-    DownloadNextCountryFromQueue();
+  if (m_downloaders.size() < m_maxDownloadingCountries)
+    DownloadNextCountriesFromQueue();
   else
     NotifyStatusChanged(index);
 }
@@ -390,33 +403,52 @@ void Storage::NotifyStatusChanged(TIndex const & index)
     observer.m_changeCountryFn(index);
 }
 
-void Storage::DownloadNextCountryFromQueue()
+void Storage::DownloadNextCountriesFromQueue()
 {
-  if (m_queue.empty())
-    return;
+  while (m_downloaders.size() < m_maxDownloadingCountries)
+  {
+    // Countries are downloaded in the order of the queue, so the first
+    // country which isn't downloaded yet is the next one.
+    auto const it = find_if(m_queue.begin(), m_queue.end(), [this](QueuedCountry const & country)
+    {
+      return !IsCountryDownloading(country.GetIndex());
+    });
+    if (it == m_queue.end())
+      return;
 
-  QueuedCountry & queuedCountry = m_queue.front();
-  TIndex const & index = queuedCountry.GetIndex();
+    TIndex const index = it->GetIndex();
 
-  // It's not even possible to prepare directory for files before
-  // downloading.  Mark this country as failed and switch to next
-  // country.
-  if (!PreparePlaceForCountryFiles(GetCountryFile(index), GetCurrentDataVersion()))
-  {
-    OnMapDownloadFinished(index, false /* success */, queuedCountry.GetInitOptions());
-    NotifyStatusChanged(index);
-    m_queue.pop_front();
-    DownloadNextCountryFromQueue();
-    return;
-  }
+    // It's not even possible to prepare directory for files before
+    // downloading.  Mark this country as failed and switch to next
+    // country.
+    if (!PreparePlaceForCountryFiles(GetCountryFile(index), GetCurrentDataVersion()))
+    {
+      OnMapDownloadFinished(index, false /* success */, it->GetInitOptions());
+      m_queue.erase(it);
+      NotifyStatusChanged(index);
+      continue;
+    }
+
+    if (m_idleDownloaders.empty())
+    {
+      m_downloaders[index] = m_downloaderFactory();
+    }
+    else
+    {
+      m_downloaders[index] = move(m_idleDownloaders.back());
+      m_idleDownloaders.pop_back();
+    }
 
-  DownloadNextFile(queuedCountry);
+    // The file may be already downloaded, so the country may be
+    // finished and removed from the queue here.
+    DownloadNextFile(*it);
 
-  // New status for the country, "Downloading"
-  NotifyStatusChanged(queuedCountry.GetIndex());
+    // New status for the country, "Downloading"
+    NotifyStatusChanged(index);
+  }
 }
 
-void Storage::DownloadNextFile(QueuedCountry const & country)
+void Storage::DownloadNextFile(QueuedCountry & country)
 {
   TIndex const & index = country.GetIndex();
   CountryFile const & countryFile = GetCountryFile(index);
@@ -429,13 +461,21 @@ void Storage::DownloadNextFile(QueuedCountry const & country)
   // switch to next file.
   if (GetPlatform().GetFileSizeByFullPath(filePath, size))
   {
-    OnMapFileDownloadFinished(true /* success */, MapFilesDownloader::TProgress(size, size));
+    OnMapFileDownloadFinished(index, true /* success */,
+                              MapFilesDownloader::TProgress(size, size));
     return;
   }
 
+  // An old map is updated with diffs when it's possible.
+  if (country.GetCurrentFile() == MapOptions::Map && country.CanUseDiffs() &&
+      country.GetDiffs().empty())
+  {
+    country.SetDiffs(GetDiffsForLocalMap(index));
+  }
+
   // send Country name for statistics
-  m_downloader->GetServersList(GetCurrentDataVersion(), countryFile.GetNameWithoutExt(),
-                               bind(&Storage::OnServerListDownloaded, this, _1));
+  GetDownloader(index).GetServersList(GetCurrentDataVersion(), countryFile.GetNameWithoutExt(),
+                                      bind(&Storage::OnServerListDownloaded, this, index, _1));
 }
 
 bool Storage::DeleteFromDownloader(TIndex const & index)
@@ -450,6 +490,13 @@ bool Storage::IsDownloadInProgress() const { return !m_queue.empty(); }
 
 TIndex Storage::GetCurrentDownloadingCountryIndex() const { return IsDownloadInProgress() ? m_queue.front().GetIndex() : storage::TIndex(); }
 
+void Storage::SetMaxDownloadingCountries(size_t maxCountries)
+{
+  ASSERT_GREATER(maxCountries, 0, ());
+  m_maxDownloadingCountries = maxCountries;
+  DownloadNextCountriesFromQueue();
+}
+
 void Storage::LoadCountriesFile(bool forceReload)
 {
   if (forceReload)
@@ -490,14 +537,55 @@ void Storage::Unsubscribe(int slotId)
   }
 }
 
-void Storage::OnMapFileDownloadFinished(bool success,
+void Storage::OnMapFileDownloadFinished(TIndex const & index, bool success,
                                         MapFilesDownloader::TProgress const & progress)
 {
-  if (m_queue.empty())
+  // Country can be deleted from the queue.
+  if (!IsCountryDownloading(index))
     return;
 
-  QueuedCountry & queuedCountry = m_queue.front();
-  TIndex const index = queuedCountry.GetIndex();
+  QueuedCountry & queuedCountry = *FindCountryInQueue(index);
+  if (queuedCountry.IsDownloadingDiff())
+  {
+    if (success && queuedCountry.SwitchToNextDiff())
+    {
+      DownloadNextFile(queuedCountry);
+      return;
+    }
+
+    if (success)
+      ApplyDiffs(queuedCountry);
+    else
+      OnDiffsApplied(index, false /* applied */);
+    return;
+  }
+
+  OnCurrentFileFinished(index, success);
+}
+
+void Storage::OnDiffsApplied(TIndex const & index, bool applied)
+{
+  QueuedCountry * queuedCountry = FindCountryInQueue(index);
+  ASSERT(queuedCountry, (index));
+  DeleteDiffFiles(*queuedCountry);
+  if (!applied)
+  {
+    LOG(LWARNING, ("Can't update", GetCountryFile(index), "with diffs",
+                   queuedCountry->GetDiffs(), ", the whole map is downloaded."));
+    queuedCountry->RejectDiffs();
+    DownloadNextFile(*queuedCountry);
+    return;
+  }
+
+  OnCurrentFileFinished(index, true /* success */);
+}
+
+void Storage::OnCurrentFileFinished(TIndex const & countryIndex, bool success)
+{
+  // |countryIndex| may be owned by a downloader's callback, which is
+  // destroyed when the downloader is released.
+  TIndex const index = countryIndex;
+  QueuedCountry & queuedCountry = *FindCountryInQueue(index);
 
   if (success && queuedCountry.SwitchToNextFile())
   {
@@ -506,11 +594,11 @@ void Storage::OnMapFileDownloadFinished(bool success,
   }
 
   OnMapDownloadFinished(index, success, queuedCountry.GetInitOptions());
-  m_queue.pop_front();
+  m_queue.erase(find(m_queue.begin(), m_queue.end(), index));
+  ReleaseDownloader(index);
 
   NotifyStatusChanged(index);
-  m_downloader->Reset();
-  DownloadNextCountryFromQueue();
+  DownloadNextCountriesFromQueue();
 }
 
 void Storage::ReportProgress(TIndex const & idx, pair<int64_t, int64_t> const & p)
@@ -519,42 +607,79 @@ void Storage::ReportProgress(TIndex const & idx, pair<int64_t, int64_t> const &
     o.m_progressFn(idx, p);
 }
 
-void Storage::OnServerListDownloaded(vector<string> const & urls)
+void Storage::OnServerListDownloaded(TIndex const & index, vector<string> const & urls)
 {
-  // Queue can be empty because countries were deleted from queue.
-  if (m_queue.empty())
+  // Country can be deleted from the queue.
+  if (!IsCountryDownloading(index))
     return;
 
-  QueuedCountry const & queuedCountry = m_queue.front();
-  TIndex const & index = queuedCountry.GetIndex();
+  QueuedCountry const & queuedCountry = *FindCountryInQueue(index);
   MapOptions const file = queuedCountry.GetCurrentFile();
 
   vector<string> fileUrls;
   fileUrls.reserve(urls.size());
-  for (string const & url : urls)
-    fileUrls.push_back(GetFileDownloadUrl(url, index, file));
+  string filePath;
+  // Diffs aren't listed in countries.txt together with their hashes,
+  // and they contain the hash of the map they produce.
+  string sha256;
+  if (queuedCountry.IsDownloadingDiff())
+  {
+    // A diff lies in the directory of the version which it updates the map to.
+    size_t const i = queuedCountry.GetCurrentDiff();
+    int64_t const version =
+        GetDiffTargetVersion(queuedCountry.GetDiffs(), i, GetCurrentDataVersion());
+    string const fileName = GetCountryFile(index).GetNameWithoutExt() + DIFF_FILE_EXTENSION;
+    for (string const & url : urls)
+    {
+      fileUrls.push_back(url + OMIM_OS_NAME "/" + strings::to_string(version) + "/" +
+                         UrlEncode(fileName));
+    }
+    filePath = GetDiffDownloadPath(index, i);
+  }
+  else
+  {
+    for (string const & url : urls)
+      fileUrls.push_back(GetFileDownloadUrl(url, index, file));
+    filePath = GetFileDownloadPath(index, file);
+    sha256 = GetCountryFile(index).GetRemoteHash(file);
+  }
 
-  string const filePath = GetFileDownloadPath(index, file);
-  m_downloader->DownloadMapFile(fileUrls, filePath, GetDownloadSize(queuedCountry),
-                                bind(&Storage::OnMapFileDownloadFinished, this, _1, _2),
-                                bind(&Storage::OnMapFileDownloadProgress, this, _1));
+  GetDownloader(index).DownloadMapFile(
+      fileUrls, filePath, GetDownloadSize(queuedCountry), sha256,
+      bind(&Storage::OnMapFileDownloadFinished, this, index, _1, _2),
+      bind(&Storage::OnMapFileDownloadProgress, this, index, _1));
 }
 
-void Storage::OnMapFileDownloadProgress(MapFilesDownloader::TProgress const & progress)
+void Storage::OnMapFileDownloadProgress(TIndex const & index,
+                                        MapFilesDownloader::TProgress const & progress)
 {
-  // Queue can be empty because countries were deleted from queue.
-  if (m_queue.empty())
+  // Country can be deleted from the queue.
+  if (!IsCountryDownloading(index))
     return;
 
   if (!m_observers.empty())
   {
-    QueuedCountry & queuedCountry = m_queue.front();
-    CountryFile const & countryFile = GetCountryFile(queuedCountry.GetIndex());
+    QueuedCountry & queuedCountry = *FindCountryInQueue(index);
+    CountryFile const & countryFile = GetCountryFile(index);
     MapFilesDownloader::TProgress p = progress;
+    if (queuedCountry.IsDownloadingDiff())
+    {
+      // Diffs replace the map file, so their progress is scaled to the size of the map.
+      TMapDiffs const & diffs = queuedCountry.GetDiffs();
+      int64_t downloaded = progress.first;
+      int64_t total = 0;
+      for (size_t i = 0; i < diffs.size(); ++i)
+      {
+        total += diffs[i].m_size;
+        if (i < queuedCountry.GetCurrentDiff())
+          downloaded += diffs[i].m_size;
+      }
+      p.first = total == 0 ? 0 : downloaded * GetRemoteSize(countryFile, MapOptions::Map) / total;
+    }
     p.first += GetRemoteSize(countryFile, queuedCountry.GetDownloadedFiles());
     p.second = GetRemoteSize(countryFile, queuedCountry.GetInitOptions());
 
-    ReportProgress(m_queue.front().GetIndex(), p);
+    ReportProgress(index, p);
   }
 }
 
@@ -703,7 +828,7 @@ TStatus Storage::CountryStatusWithoutFailed(TIndex const & index) const
   // First, check if we already downloading this country or have in in the queue.
   if (!IsCountryInQueue(index))
     return CountryStatusFull(index, TStatus::EUnknown);
-  return IsCountryFirstInQueue(index) ? TStatus::EDownloading : TStatus::EInQueue;
+  return IsCountryDownloading(index) ? TStatus::EDownloading : TStatus::EInQueue;
 }
 
 TStatus Storage::CountryStatusFull(TIndex const & index, TStatus const status) const
@@ -778,14 +903,32 @@ bool Storage::IsCountryInQueue(TIndex const & index) const
   return FindCountryInQueue(index) != nullptr;
 }
 
-bool Storage::IsCountryFirstInQueue(TIndex const & index) const
+bool Storage::IsCountryDownloading(TIndex const & index) const
+{
+  return m_downloaders.count(index) != 0;
+}
+
+MapFilesDownloader & Storage::GetDownloader(TIndex const & index) const
+{
+  auto const it = m_downloaders.find(index);
+  CHECK(it != m_downloaders.end(), (index));
+  return *it->second;
+}
+
+void Storage::ReleaseDownloader(TIndex const & index)
 {
-  return !m_queue.empty() && m_queue.front().GetIndex() == index;
+  auto const it = m_downloaders.find(index);
+  ASSERT(it != m_downloaders.end(), (index));
+  it->second->Reset();
+  m_idleDownloaders.push_back(move(it->second));
+  m_downloaders.erase(it);
 }
 
-void Storage::SetDownloaderForTesting(unique_ptr<MapFilesDownloader> && downloader)
+void Storage::SetDownloaderFactoryForTesting(TDownloaderFactory const & factory)
 {
-  m_downloader = move(downloader);
+  ASSERT(m_downloaders.empty(), ());
+  m_downloaderFactory = factory;
+  m_idleDownloaders.clear();
 }
 
 void Storage::SetCurrentDataVersionForTesting(int64_t currentVersion)
@@ -871,35 +1014,46 @@ bool Storage::DeleteCountryFilesFromDownloader(TIndex const & index, MapOptions
 
   opt = IntersectOptions(opt, queuedCountry->GetInitOptions());
 
-  if (IsCountryFirstInQueue(index))
+  if (IsCountryDownloading(index))
   {
     // Abrupt downloading of the current file if it should be removed.
     if (HasOptions(opt, queuedCountry->GetCurrentFile()))
-      m_downloader->Reset();
+      GetDownloader(index).Reset();
 
     // Remove all files downloader had been created for a country.
     DeleteDownloaderFilesForCountry(GetCountryFile(index), GetCurrentDataVersion());
+    if (HasOptions(opt, MapOptions::Map))
+    {
+      // The background task deletes its result when it finds out that it's cancelled.
+      m_diffsTickets.erase(index);
+      DeleteDiffFiles(*queuedCountry);
+    }
   }
 
   queuedCountry->RemoveOptions(opt);
 
-  // Remove country from the queue if there's nothing to download.
+  // Remove country from the queue if there's nothing to download, the
+  // next queued country takes its place.
   if (queuedCountry->GetInitOptions() == MapOptions::Nothing)
+  {
     m_queue.erase(find(m_queue.begin(), m_queue.end(), index));
-
-  if (!m_queue.empty() && m_downloader->IsIdle())
+    if (IsCountryDownloading(index))
+      ReleaseDownloader(index);
+    DownloadNextCountriesFromQueue();
+  }
+  else if (IsCountryDownloading(index) && GetDownloader(index).IsIdle() &&
+           !IsApplyingDiffs(index))
   {
     // Kick possibly interrupted downloader.
-    if (IsCountryFirstInQueue(index))
-      DownloadNextFile(m_queue.front());
-    else
-      DownloadNextCountryFromQueue();
+    DownloadNextFile(*queuedCountry);
   }
   return true;
 }
 
 uint64_t Storage::GetDownloadSize(QueuedCountry const & queuedCountry) const
 {
+  if (queuedCountry.IsDownloadingDiff())
+    return queuedCountry.GetDiffs()[queuedCountry.GetCurrentDiff()].m_size;
   CountryFile const & file = GetCountryFile(queuedCountry.GetIndex());
   return GetRemoteSize(file, queuedCountry.GetCurrentFile());
 }
@@ -908,4 +1062,83 @@ string Storage::GetFileDownloadPath(TIndex const & index, MapOptions file) const
 {
   return platform::GetFileDownloadPath(GetCountryFile(index), file, GetCurrentDataVersion());
 }
+
+TMapDiffs Storage::GetDiffsForLocalMap(TIndex const & index) const
+{
+  TLocalFilePtr const localFile = GetLatestLocalFile(index);
+  if (!localFile || localFile->GetVersion() >= GetCurrentDataVersion() ||
+      !HasOptions(localFile->GetFiles(), MapOptions::Map))
+  {
+    return TMapDiffs();
+  }
+  return GetDiffsChain(CountryByIndex(index).GetDiffs(), localFile->GetVersion(),
+                       GetCountryFile(index).GetRemoteSize(MapOptions::Map));
+}
+
+string Storage::GetDiffDownloadPath(TIndex const & index, size_t i) const
+{
+  return GetFileDownloadPath(index, MapOptions::Map) + "." + strings::to_string(i) +
+         DIFF_FILE_EXTENSION;
+}
+
+void Storage::ApplyDiffs(QueuedCountry const & queuedCountry)
+{
+  TIndex const index = queuedCountry.GetIndex();
+  ASSERT(!IsApplyingDiffs(index), ());
+  TMapDiffs const & diffs = queuedCountry.GetDiffs();
+  ASSERT(!diffs.empty(), ());
+  TLocalFilePtr const localFile = GetLocalFile(index, diffs.front().m_fromVersion);
+  if (!localFile)
+  {
+    OnDiffsApplied(index, false /* applied */);
+    return;
+  }
+
+  string const oldFile = localFile->GetPath(MapOptions::Map);
+  vector<string> diffFiles;
+  for (size_t i = 0; i < diffs.size(); ++i)
+    diffFiles.push_back(GetDiffDownloadPath(index, i));
+  string const newFile = GetFileDownloadPath(index, MapOptions::Map);
+  // A cancelled task may still be running when the country is downloaded again, so every task
+  // writes its own file, and only the main thread moves it to the download path.
+  string const taskFile = newFile + "." + strings::to_string(++m_diffsTasksCount) + EXTENSION_TMP;
+
+  shared_ptr<TIndex> & ticketOwner = m_diffsTickets[index];
+  ticketOwner = make_shared<TIndex>(index);
+  weak_ptr<TIndex> const ticket = ticketOwner;
+
+  // Streaming the map through diffs and hashing takes seconds, so it's not done on the main
+  // thread.
+  GetPlatform().RunAsync([this, ticket, index, oldFile, diffFiles, newFile, taskFile]()
+  {
+    bool const applied = ApplyDiffsChain(oldFile, diffFiles, taskFile);
+    GetPlatform().RunOnGuiThread([this, ticket, index, applied, newFile, taskFile]()
+    {
+      // The ticket is dropped when the country is removed from the queue, and it's
+      // destroyed together with the storage, so |this| is valid only with the ticket.
+      if (ticket.expired())
+      {
+        my::DeleteFileX(taskFile);
+        return;
+      }
+      m_diffsTickets.erase(index);
+
+      bool const moved = applied && my::RenameFileX(taskFile, newFile);
+      if (!moved)
+        my::DeleteFileX(taskFile);
+      OnDiffsApplied(index, moved);
+    });
+  });
+}
+
+void Storage::DeleteDiffFiles(QueuedCountry const & queuedCountry) const
+{
+  for (size_t i = 0; i < queuedCountry.GetDiffs().size(); ++i)
+  {
+    string const path = GetDiffDownloadPath(queuedCountry.GetIndex(), i);
+    my::DeleteFileX(path);
+    my::DeleteFileX(path + RESUME_FILE_EXTENSION);
+    my::DeleteFileX(path + DOWNLOADING_FILE_EXTENSION);
+  }
+}
 }  // namespace storage
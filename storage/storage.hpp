@@ -10,6 +10,7 @@
 
 #include "std/function.hpp"
 #include "std/list.hpp"
+#include "std/map.hpp"
 #include "std/set.hpp"
 #include "std/shared_ptr.hpp"
 #include "std/string.hpp"
@@ -23,10 +24,20 @@ class Storage
 {
 public:
   using TUpdate = function<void(platform::LocalCountryFile const &)>;
+  using TDownloaderFactory = function<unique_ptr<MapFilesDownloader>()>;
 
 private:
-  /// We support only one simultaneous request at the moment
-  unique_ptr<MapFilesDownloader> m_downloader;
+  /// Several first countries from m_queue are downloaded simultaneously, each one by its own
+  /// downloader. All files share the global connections budget,
+  /// see downloader::HttpRequest::SetConnectionsLimits().
+  TDownloaderFactory m_downloaderFactory;
+  size_t m_maxDownloadingCountries;
+
+  /// Downloaders of the countries which are downloaded now.
+  map<TIndex, unique_ptr<MapFilesDownloader>> m_downloaders;
+  /// A downloader may finish a country from its own callback, so it's never destroyed there
+  /// but is kept here for the next country.
+  vector<unique_ptr<MapFilesDownloader>> m_idleDownloaders;
 
   /// stores timestamp for update checks
   int64_t m_currentVersion;
@@ -43,6 +54,12 @@ private:
   /// RunOnUIThread.  If not, at least use a syncronization object.
   TQueue m_queue;
 
+  /// Diffs of a downloaded country are applied on a background thread while the country
+  /// has a ticket. The result of the task is dropped when the ticket is erased.
+  map<TIndex, shared_ptr<TIndex>> m_diffsTickets;
+  /// Makes names of files written by diffs tasks unique.
+  uint64_t m_diffsTasksCount;
+
   /// stores countries whose download has failed recently
   typedef set<TIndex> TCountriesSet;
   TCountriesSet m_failedCountries;
@@ -54,10 +71,6 @@ private:
   // folder.
   map<platform::CountryFile, TLocalFilePtr> m_localFilesForFakeCountries;
 
-  /// used to correctly calculate total country download progress with more than 1 file
-  /// <current, total>
-  MapFilesDownloader::TProgress m_countryProgress;
-
   /// @name Communicate with GUI
   //@{
   typedef function<void(TIndex const &)> TChangeCountryFunction;
@@ -80,7 +93,9 @@ private:
   // country were successfully downloaded.
   TUpdate m_update;
 
-  void DownloadNextCountryFromQueue();
+  /// Starts downloading of the queued countries until there're
+  /// m_maxDownloadingCountries of them.
+  void DownloadNextCountriesFromQueue();
 
   void LoadCountriesFile(bool forceReload);
 
@@ -88,21 +103,23 @@ private:
 
   /// Called on the main thread by MapFilesDownloader when list of
   /// suitable servers is received.
-  void OnServerListDownloaded(vector<string> const & urls);
+  void OnServerListDownloaded(TIndex const & index, vector<string> const & urls);
 
   /// Called on the main thread by MapFilesDownloader when
   /// downloading of a map file succeeds/fails.
-  void OnMapFileDownloadFinished(bool success, MapFilesDownloader::TProgress const & progress);
+  void OnMapFileDownloadFinished(TIndex const & index, bool success,
+                                 MapFilesDownloader::TProgress const & progress);
 
   /// Periodically called on the main thread by MapFilesDownloader
   /// during the downloading process.
-  void OnMapFileDownloadProgress(MapFilesDownloader::TProgress const & progress);
+  void OnMapFileDownloadProgress(TIndex const & index,
+                                 MapFilesDownloader::TProgress const & progress);
 
   bool RegisterDownloadedFiles(TIndex const & index, MapOptions files);
   void OnMapDownloadFinished(TIndex const & index, bool success, MapOptions files);
 
   /// Initiates downloading of the next file from the queue.
-  void DownloadNextFile(QueuedCountry const & country);
+  void DownloadNextFile(QueuedCountry & country);
 
 public:
   Storage();
@@ -167,8 +184,12 @@ public:
   bool DeleteFromDownloader(TIndex const & index);
   bool IsDownloadInProgress() const;
 
+  /// @return The first of the countries which are downloaded now.
   TIndex GetCurrentDownloadingCountryIndex() const;
 
+  /// Sets how many countries from the queue are downloaded simultaneously.
+  void SetMaxDownloadingCountries(size_t maxCountries);
+
   void NotifyStatusChanged(TIndex const & index);
 
   /// get download url by index & options(first search file name by index, then format url)
@@ -181,7 +202,7 @@ public:
 
   inline int64_t GetCurrentDataVersion() const { return m_currentVersion; }
 
-  void SetDownloaderForTesting(unique_ptr<MapFilesDownloader> && downloader);
+  void SetDownloaderFactoryForTesting(TDownloaderFactory const & factory);
   void SetCurrentDataVersionForTesting(int64_t currentVersion);
 
 private:
@@ -208,8 +229,16 @@ private:
   // Returns true when country is in the downloader's queue.
   bool IsCountryInQueue(TIndex const & index) const;
 
-  // Returns true when country is first in the downloader's queue.
-  bool IsCountryFirstInQueue(TIndex const & index) const;
+  // Returns true when country's files are being downloaded, other
+  // countries in the downloader's queue wait for their turn.
+  bool IsCountryDownloading(TIndex const & index) const;
+
+  // Returns the downloader of a country which is being downloaded.
+  MapFilesDownloader & GetDownloader(TIndex const & index) const;
+
+  // Returns the downloader of a finished or cancelled country to the
+  // idle ones.
+  void ReleaseDownloader(TIndex const & index);
 
   // Returns local country files of a particular version, or wrapped
   // nullptr if there're no country files corresponding to the
@@ -242,5 +271,30 @@ private:
   // Returns a path to a place on disk downloader can use for
   // downloaded files.
   string GetFileDownloadPath(TIndex const & index, MapOptions file) const;
+
+  // Returns diffs which update the latest local map of the country to
+  // the current version, or an empty chain when the map should be
+  // downloaded as a whole.
+  TMapDiffs GetDiffsForLocalMap(TIndex const & index) const;
+
+  // Returns a path for the |i|-th diff of the queued country.
+  string GetDiffDownloadPath(TIndex const & index, size_t i) const;
+
+  // Applies downloaded diffs of the queued country to the local map
+  // on a background thread, the result is moved to the download path
+  // of the map file. OnDiffsApplied() is called on the main thread
+  // when it's done.
+  void ApplyDiffs(QueuedCountry const & queuedCountry);
+
+  void OnDiffsApplied(TIndex const & index, bool applied);
+
+  bool IsApplyingDiffs(TIndex const & index) const { return m_diffsTickets.count(index) != 0; }
+
+  // Switches the queued country to the next file or finishes the
+  // country when the current file is downloaded or failed.
+  void OnCurrentFileFinished(TIndex const & index, bool success);
+
+  // Removes diffs downloader had been created for the queued country.
+  void DeleteDiffFiles(QueuedCountry const & queuedCountry) const;
 };
 }  // storage
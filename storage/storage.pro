@@ -13,10 +13,12 @@ INCLUDEPATH += $$ROOT_DIR/3party/jansson/src
 HEADERS += \
   country.hpp \
   country_decl.hpp \
+  country_grid.hpp \
   country_info_getter.hpp \
   country_polygon.hpp \
   http_map_files_downloader.hpp \
   index.hpp \
+  map_diffs.hpp \
   map_files_downloader.hpp \
   queued_country.hpp \
   simple_tree.hpp \
@@ -26,9 +28,11 @@ HEADERS += \
 SOURCES += \
   country.cpp \
   country_decl.cpp \
+  country_grid.cpp \
   country_info_getter.cpp \
   http_map_files_downloader.cpp \
   index.cpp \
+  map_diffs.cpp \
   queued_country.cpp \
   storage.cpp \
   storage_defines.cpp \
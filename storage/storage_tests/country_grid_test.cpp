@@ -0,0 +1,152 @@
+#include "testing/testing.hpp"
+
+#include "storage/country_grid.hpp"
+#include "storage/country_polygon.hpp"
+
+#include "indexer/geometry_serialization.hpp"
+#include "indexer/mercator.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/string_utils.hpp"
+
+#include "std/limits.hpp"
+#include "std/random.hpp"
+
+
+using namespace storage;
+
+namespace
+{
+size_t const kInvalidId = numeric_limits<size_t>::max();
+
+void LoadCountries(vector<CountryDef> & countries, vector<vector<m2::RegionD>> & regions)
+{
+  FilesContainerR reader(GetPlatform().GetReader(PACKED_POLYGONS_FILE));
+  ReaderSource<ModelReaderPtr> src(reader.GetReader(PACKED_POLYGONS_INFO_TAG));
+  rw::Read(src, countries);
+
+  regions.resize(countries.size());
+  for (size_t id = 0; id < countries.size(); ++id)
+  {
+    ReaderSource<ModelReaderPtr> src(reader.GetReader(strings::to_string(id)));
+    uint32_t const count = ReadVarUint<uint32_t>(src);
+    for (size_t i = 0; i < count; ++i)
+    {
+      vector<m2::PointD> points;
+      serial::LoadOuterPath(src, serial::CodingParams(), points);
+      regions[id].emplace_back(move(points));
+    }
+  }
+}
+
+bool IsInside(vector<m2::RegionD> const & regions, m2::PointD const & pt)
+{
+  for (auto const & rgn : regions)
+  {
+    if (rgn.Contains(pt))
+      return true;
+  }
+  return false;
+}
+
+size_t FindFirstCountry(vector<vector<m2::RegionD>> const & regions, m2::PointD const & pt)
+{
+  for (size_t id = 0; id < regions.size(); ++id)
+  {
+    if (IsInside(regions[id], pt))
+      return id;
+  }
+  return kInvalidId;
+}
+}  // namespace
+
+UNIT_TEST(CountryGrid_Square)
+{
+  CountryGrid::Builder builder(16);
+  // Cells are 22.5 x 22.5, the square covers cells [9, 11] x [9, 11] entirely.
+  vector<m2::PointD> points = {{10.0, 10.0}, {80.0, 10.0}, {80.0, 80.0}, {10.0, 80.0}};
+  builder.AddCountry({m2::RegionD(points.begin(), points.end())});
+
+  CountryGrid grid;
+  TEST(grid.IsEmpty(), ());
+  builder.Finish(grid);
+  TEST(!grid.IsEmpty(), ());
+
+  auto const check = [&grid](m2::PointD const & pt, size_t expectedCount, bool expectedCovers)
+  {
+    size_t count = 0;
+    bool covers = false;
+    TEST(grid.ForEachCountryInCell(pt, [&](size_t id, bool c)
+    {
+      TEST_EQUAL(id, 0, ());
+      ++count;
+      covers = c;
+      return false;
+    }), (pt));
+    TEST_EQUAL(count, expectedCount, (pt));
+    TEST_EQUAL(covers, expectedCovers, (pt));
+  };
+
+  check(m2::PointD(40.0, 40.0), 1, true);
+  check(m2::PointD(15.0, 15.0), 1, false);
+  check(m2::PointD(75.0, 30.0), 1, false);
+  check(m2::PointD(-40.0, 40.0), 0, false);
+  check(m2::PointD(100.0, 100.0), 0, false);
+
+  TEST(!grid.ForEachCountryInCell(m2::PointD(200.0, 0.0), [](size_t, bool) { return false; }), ());
+}
+
+UNIT_TEST(CountryGrid_CompareWithPolygons)
+{
+  vector<CountryDef> countries;
+  vector<vector<m2::RegionD>> regions;
+  LoadCountries(countries, regions);
+
+  CountryGrid::Builder builder;
+  for (auto const & rgns : regions)
+    builder.AddCountry(rgns);
+
+  CountryGrid built;
+  builder.Finish(built);
+
+  vector<char> buffer;
+  MemWriter<vector<char>> writer(buffer);
+  built.Write(writer);
+
+  CountryGrid grid;
+  MemReader reader(buffer.data(), buffer.size());
+  ReaderSource<MemReader> src(reader);
+  grid.Read(src);
+
+  mt19937 rng(0);
+  uniform_real_distribution<double> x(MercatorBounds::minX, MercatorBounds::maxX);
+  uniform_real_distribution<double> y(MercatorBounds::minY, MercatorBounds::maxY);
+
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    m2::PointD const pt(x(rng), y(rng));
+
+    size_t res = kInvalidId;
+    TEST(grid.ForEachCountryInCell(pt, [&](size_t id, bool covers)
+    {
+      TEST_LESS(id, regions.size(), ());
+      if (covers)
+        TEST(IsInside(regions[id], pt), (countries[id].m_name, pt));
+
+      if (covers || IsInside(regions[id], pt))
+      {
+        res = id;
+        return true;
+      }
+      return false;
+    }), (pt));
+
+    TEST_EQUAL(res, FindFirstCountry(regions, pt), (pt));
+  }
+}
@@ -51,6 +51,31 @@ UNIT_TEST(CountryInfoGetter_GetByPoint_Smoke)
   TEST_EQUAL(info.m_flag, "jp", ());
 }
 
+UNIT_TEST(CountryInfoGetter_GetByPoints_Smoke)
+{
+  auto const getter = CreateCountryInfoGetter();
+
+  vector<m2::PointD> const pts = {
+    MercatorBounds::FromLatLon(53.9022651, 27.5618818),
+    MercatorBounds::FromLatLon(34.6509, 135.5018),
+    MercatorBounds::FromLatLon(53.8, 27.6),
+    MercatorBounds::FromLatLon(-6.4146288, -38.0098101)
+  };
+
+  vector<CountryInfo> infos;
+  getter->GetRegionInfo(pts, infos);
+  TEST_EQUAL(infos.size(), pts.size(), ());
+
+  for (size_t i = 0; i < pts.size(); ++i)
+  {
+    CountryInfo info;
+    getter->GetRegionInfo(pts[i], info);
+    TEST_EQUAL(infos[i].m_name, info.m_name, (i));
+    TEST_EQUAL(infos[i].m_flag, info.m_flag, (i));
+  }
+  TEST_EQUAL(infos[2].m_name, "Belarus", ());
+}
+
 UNIT_TEST(CountryInfoGetter_ValidName_Smoke)
 {
   string buffer;
@@ -79,3 +104,31 @@ UNIT_TEST(CountryInfoGetter_SomeRects)
 
   LOG(LINFO, ("Canada: ", getter->CalcLimitRect("Canada_")));
 }
+
+UNIT_TEST(CountryInfoGetter_LoadedRegionsLimit)
+{
+  auto const getter = CreateCountryInfoGetter();
+
+  // Points on a world grid hit regions of much more countries than the limit.
+  vector<m2::PointD> pts;
+  for (double lat = -60.0; lat <= 70.0; lat += 2.5)
+  {
+    for (double lon = -180.0; lon < 180.0; lon += 2.5)
+      pts.push_back(MercatorBounds::FromLatLon(lat, lon));
+  }
+
+  vector<string> files;
+  for (auto const & pt : pts)
+  {
+    files.push_back(getter->GetRegionFile(pt));
+    TEST_LESS_OR_EQUAL(getter->GetLoadedRegionsCount(), CountryInfoGetter::kMaxLoadedRegions,
+                       ());
+  }
+
+  // Evicted regions are loaded again with the same result.
+  for (size_t i = 0; i < pts.size(); ++i)
+    TEST_EQUAL(getter->GetRegionFile(pts[i]), files[i], (i));
+
+  getter->ClearCaches();
+  TEST_EQUAL(getter->GetLoadedRegionsCount(), 0, ());
+}
@@ -30,7 +30,7 @@ void FakeMapFilesDownloader::GetServersList(int64_t const mapVersion, string con
 }
 
 void FakeMapFilesDownloader::DownloadMapFile(vector<string> const & urls, string const & path,
-                                             int64_t size,
+                                             int64_t size, string const & sha256,
                                              TFileDownloadedCallback const & onDownloaded,
                                              TDownloadingProgressCallback const & onProgress)
 {
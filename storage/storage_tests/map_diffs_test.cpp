@@ -0,0 +1,112 @@
+#include "testing/testing.hpp"
+
+#include "storage/country.hpp"
+#include "storage/map_diffs.hpp"
+
+#include "coding/file_container.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/mwm_diff.hpp"
+
+#include "base/scope_guard.hpp"
+
+#include "defines.hpp"
+
+#include "std/string.hpp"
+#include "std/vector.hpp"
+
+namespace storage
+{
+namespace
+{
+void WriteMap(string const & fileName, string const & geometry)
+{
+  FilesContainerW writer(fileName);
+  FileWriter w = writer.GetWriter(GEOMETRY_FILE_TAG);
+  w.Write(geometry.data(), geometry.size());
+}
+
+string ReadFile(string const & fileName)
+{
+  string bytes;
+  FileReader(fileName).ReadAsString(bytes);
+  return bytes;
+}
+}  // namespace
+
+UNIT_TEST(MapDiffs_GetDiffsChain)
+{
+  TMapDiffs const diffs = {{150101, 100}, {150201, 200}, {150301, 300}};
+
+  TEST_EQUAL(GetDiffsChain(diffs, 150101, 10000), diffs, ());
+  TEST_EQUAL(GetDiffsChain(diffs, 150301, 10000), TMapDiffs({{150301, 300}}), ());
+  // There are no diffs for the version.
+  TEST(GetDiffsChain(diffs, 150115, 10000).empty(), ());
+  // Diffs are too big.
+  TEST(GetDiffsChain(diffs, 150101, 1000).empty(), ());
+  TEST_EQUAL(GetDiffsChain(diffs, 150201, 1001), TMapDiffs(diffs.begin() + 1, diffs.end()), ());
+
+  // The chain is too long.
+  TMapDiffs longChain;
+  for (size_t i = 0; i <= kMaxDiffsChainLength; ++i)
+    longChain.emplace_back(150101 + i, 1);
+  TEST(GetDiffsChain(longChain, 150101, 10000).empty(), ());
+  TEST_EQUAL(GetDiffsChain(longChain, 150102, 10000).size(), kMaxDiffsChainLength, ());
+
+  TEST_EQUAL(GetDiffTargetVersion(diffs, 0, 150401), 150201, ());
+  TEST_EQUAL(GetDiffTargetVersion(diffs, 2, 150401), 150401, ());
+}
+
+UNIT_TEST(MapDiffs_LoadAndSaveCountries)
+{
+  string const json =
+      "{\"v\":150401,\"n\":\"World\",\"g\":[{\"n\":\"Andorra\",\"s\":10000,\"rs\":500,"
+      "\"d\":[{\"v\":150201,\"s\":700},{\"v\":150301,\"s\":300}]},{\"n\":\"Angola\",\"s\":300}]}";
+
+  CountriesContainerT countries;
+  TEST_EQUAL(LoadCountries(json, countries), 150401, ());
+  TEST_EQUAL(countries.SiblingsCount(), 2, ());
+  TEST_EQUAL(countries[0].Value().GetDiffs(), TMapDiffs({{150201, 700}, {150301, 300}}), ());
+  TEST(countries[1].Value().GetDiffs().empty(), ());
+
+  string saved;
+  TEST(SaveCountries(150401, countries, saved), ());
+  CountriesContainerT loaded;
+  TEST_EQUAL(LoadCountries(saved, loaded), 150401, ());
+  TEST_EQUAL(loaded[0].Value().GetDiffs(), countries[0].Value().GetDiffs(), ());
+  TEST(loaded[1].Value().GetDiffs().empty(), ());
+}
+
+UNIT_TEST(MapDiffs_ApplyDiffsChain)
+{
+  vector<string> const maps = {"map_diffs_0.tmp", "map_diffs_1.tmp", "map_diffs_2.tmp"};
+  vector<string> const diffFiles = {"map_diffs_0.mwmdiff", "map_diffs_1.mwmdiff"};
+  string const result = "map_diffs_result.tmp";
+  MY_SCOPE_GUARD(deleteFiles, [&]()
+  {
+    for (string const & file : maps)
+      FileWriter::DeleteFileX(file);
+    for (string const & file : diffFiles)
+      FileWriter::DeleteFileX(file);
+    FileWriter::DeleteFileX(result);
+  });
+
+  string geometry(10000, 0);
+  for (size_t i = 0; i < geometry.size(); ++i)
+    geometry[i] = static_cast<char>(i * i % 251);
+  WriteMap(maps[0], geometry);
+  geometry.replace(1000, 10, "0123456789");
+  WriteMap(maps[1], geometry);
+  geometry.insert(5000, "inserted");
+  WriteMap(maps[2], geometry);
+
+  TEST(diff::MakeMwmDiff(maps[0], maps[1], diffFiles[0]), ());
+  TEST(diff::MakeMwmDiff(maps[1], maps[2], diffFiles[1]), ());
+
+  TEST(ApplyDiffsChain(maps[0], diffFiles, result), ());
+  TEST_EQUAL(ReadFile(result), ReadFile(maps[2]), ());
+
+  // Diffs are applied in the wrong order.
+  TEST(!ApplyDiffsChain(maps[0], {diffFiles[1], diffFiles[0]}, result), ());
+}
+}  // namespace storage
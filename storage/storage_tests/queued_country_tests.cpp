@@ -103,4 +103,24 @@ UNIT_TEST(QueuedCountry_Bits)
   TEST(!country.SwitchToNextFile(), ());
   TEST_EQUAL(MapOptions::MapWithCarRouting, country.GetDownloadedFiles(), ());
 }
+
+UNIT_TEST(QueuedCountry_Diffs)
+{
+  QueuedCountry country(TIndex(0, 0, 0), MapOptions::MapWithCarRouting);
+  TEST_EQUAL(MapOptions::Map, country.GetCurrentFile(), ());
+  TEST(!country.IsDownloadingDiff(), ());
+  TEST(country.CanUseDiffs(), ());
+
+  country.SetDiffs({{150101, 100}, {150201, 200}});
+  TEST(country.IsDownloadingDiff(), ());
+  TEST_EQUAL(country.GetCurrentDiff(), 0, ());
+  TEST(country.SwitchToNextDiff(), ());
+  TEST_EQUAL(country.GetCurrentDiff(), 1, ());
+
+  country.RejectDiffs();
+  TEST(!country.IsDownloadingDiff(), ());
+  TEST(!country.CanUseDiffs(), ());
+  TEST(country.GetDiffs().empty(), ());
+  TEST_EQUAL(MapOptions::Map, country.GetCurrentFile(), ());
+}
 }  // namespace storage
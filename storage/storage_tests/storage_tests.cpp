@@ -1,5 +1,6 @@
 #include "testing/testing.hpp"
 
+#include "storage/country.hpp"
 #include "storage/storage.hpp"
 #include "storage/storage_defines.hpp"
 #include "storage/storage_tests/fake_map_files_downloader.hpp"
@@ -320,7 +321,10 @@ void InitStorage(Storage & storage, TaskRunner & runner,
 {
   storage.Init(update);
   storage.RegisterAllLocalMaps();
-  storage.SetDownloaderForTesting(make_unique<FakeMapFilesDownloader>(runner));
+  storage.SetDownloaderFactoryForTesting([&runner]()
+                                        {
+                                          return make_unique<FakeMapFilesDownloader>(runner);
+                                        });
 }
 }  // namespace
 
@@ -392,15 +396,47 @@ UNIT_TEST(StorageTest_TwoCountriesDownloading)
   MY_SCOPE_GUARD(cleanupVenezuelaFiles, bind(&Storage::DeleteCountry, &storage, venezuelaIndex,
                                              MapOptions::MapWithCarRouting));
 
+  // Both countries are downloaded simultaneously.
   unique_ptr<CountryDownloaderChecker> uruguayChecker =
       AbsentCountryDownloaderChecker(storage, uruguayIndex, MapOptions::Map);
   unique_ptr<CountryDownloaderChecker> venezuelaChecker =
-      QueuedCountryDownloaderChecker(storage, venezuelaIndex, MapOptions::MapWithCarRouting);
+      AbsentCountryDownloaderChecker(storage, venezuelaIndex, MapOptions::MapWithCarRouting);
   uruguayChecker->StartDownload();
   venezuelaChecker->StartDownload();
   runner.Run();
 }
 
+UNIT_TEST(StorageTest_MaxDownloadingCountries)
+{
+  Storage storage;
+  TaskRunner runner;
+  InitStorage(storage, runner);
+  storage.SetMaxDownloadingCountries(2);
+
+  vector<TIndex> indexes;
+  for (string const name : {"Uruguay", "Venezuela", "Azerbaijan"})
+  {
+    TIndex const index = storage.FindIndexByFile(name);
+    TEST(index.IsValid(), (name));
+    storage.DeleteCountry(index, MapOptions::MapWithCarRouting);
+    indexes.push_back(index);
+  }
+  MY_SCOPE_GUARD(cleanupFiles, [&]()
+  {
+    for (TIndex const & index : indexes)
+      storage.DeleteCountry(index, MapOptions::MapWithCarRouting);
+  });
+
+  // The third country waits until one of the first two is downloaded.
+  vector<unique_ptr<CountryDownloaderChecker>> checkers;
+  checkers.push_back(AbsentCountryDownloaderChecker(storage, indexes[0], MapOptions::Map));
+  checkers.push_back(AbsentCountryDownloaderChecker(storage, indexes[1], MapOptions::Map));
+  checkers.push_back(QueuedCountryDownloaderChecker(storage, indexes[2], MapOptions::Map));
+  for (auto & checker : checkers)
+    checker->StartDownload();
+  runner.Run();
+}
+
 UNIT_TEST(StorageTest_DeleteTwoVersionsOfTheSameCountry)
 {
   Storage storage;
@@ -600,14 +636,13 @@ UNIT_TEST(StorageTest_DownloadTwoCountriesAndDelete)
         storage, uruguayIndex, MapOptions::MapWithCarRouting,
         vector<TStatus>{TStatus::ENotDownloaded, TStatus::EDownloading, TStatus::ENotDownloaded});
     // Only routing file will be deleted for Venezuela, thus, Venezuela should pass through
-    // following
-    // states:
-    // NotDownloaded -> InQueue (Venezuela is added after Uruguay) -> Downloading -> Downloading
-    // (second notification will be sent after deletion of a routing file) -> OnDisk.
+    // following states:
+    // NotDownloaded -> Downloading (together with Uruguay) -> Downloading (second notification
+    // will be sent after deletion of a routing file) -> OnDisk.
     unique_ptr<CountryDownloaderChecker> venezuelaChecker = make_unique<CountryDownloaderChecker>(
         storage, venezuelaIndex, MapOptions::MapWithCarRouting,
-        vector<TStatus>{TStatus::ENotDownloaded, TStatus::EInQueue, TStatus::EDownloading,
-                        TStatus::EDownloading, TStatus::EOnDisk});
+        vector<TStatus>{TStatus::ENotDownloaded, TStatus::EDownloading, TStatus::EDownloading,
+                        TStatus::EOnDisk});
     uruguayChecker->StartDownload();
     venezuelaChecker->StartDownload();
     storage.DeleteCountry(uruguayIndex, MapOptions::Map);
@@ -680,7 +715,10 @@ UNIT_TEST(StorageTest_FailedDownloading)
 {
   Storage storage;
   storage.Init(&OnCountryDownloaded);
-  storage.SetDownloaderForTesting(make_unique<TestMapFilesDownloader>());
+  storage.SetDownloaderFactoryForTesting([]()
+                                        {
+                                          return make_unique<TestMapFilesDownloader>();
+                                        });
   storage.SetCurrentDataVersionForTesting(1234);
 
   TIndex const index = storage.FindIndexByFile("Uruguay");
@@ -734,6 +772,29 @@ UNIT_TEST(StorageTest_EmptyRoutingFile)
   runner.Run();
 }
 
+UNIT_TEST(StorageTest_LoadCountriesWithHashes)
+{
+  string const json =
+      "{\"v\":150401,\"n\":\"World\",\"g\":[{\"n\":\"Andorra\",\"s\":10000,\"rs\":500,"
+      "\"sh\":\"aa\",\"rsh\":\"bb\"},{\"n\":\"Angola\",\"s\":300}]}";
+
+  CountriesContainerT countries;
+  TEST_EQUAL(LoadCountries(json, countries), 150401, ());
+  TEST_EQUAL(countries.SiblingsCount(), 2, ());
+  CountryFile const & andorra = countries[0].Value().GetFile();
+  TEST_EQUAL(andorra.GetRemoteHash(MapOptions::Map), "aa", ());
+  TEST_EQUAL(andorra.GetRemoteHash(MapOptions::CarRouting), "bb", ());
+  TEST_EQUAL(countries[1].Value().GetFile().GetRemoteHash(MapOptions::Map), "", ());
+
+  string saved;
+  TEST(SaveCountries(150401, countries, saved), ());
+  CountriesContainerT loaded;
+  TEST_EQUAL(LoadCountries(saved, loaded), 150401, ());
+  TEST_EQUAL(loaded[0].Value().GetFile().GetRemoteHash(MapOptions::Map), "aa", ());
+  TEST_EQUAL(loaded[0].Value().GetFile().GetRemoteHash(MapOptions::CarRouting), "bb", ());
+  TEST_EQUAL(loaded[1].Value().GetFile().GetRemoteHash(MapOptions::Map), "", ());
+}
+
 UNIT_TEST(StorageTest_ObsoleteMapsRemoval)
 {
   CountryFile country("Azerbaijan");
@@ -29,8 +29,10 @@ HEADERS += \
 
 SOURCES += \
   ../../testing/testingmain.cpp \
+  country_grid_test.cpp \
   country_info_getter_test.cpp \
   fake_map_files_downloader.cpp \
+  map_diffs_test.cpp \
   queued_country_tests.cpp \
   simple_tree_test.cpp \
   storage_tests.cpp \